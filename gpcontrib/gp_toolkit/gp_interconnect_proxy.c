@@ -0,0 +1,118 @@
+/*-------------------------------------------------------------------------
+ *
+ * gp_interconnect_proxy.c
+ *	  Report per-peer statistics of the interconnect proxy (ic-proxy).
+ *
+ * Portions Copyright (c) 2024-Present VMware, Inc. or its affiliates.
+ *
+ * IDENTIFICATION
+ *	  gpcontrib/gp_toolkit/gp_interconnect_proxy.c
+ *
+ *-------------------------------------------------------------------------
+ */
+#include "postgres.h"
+
+#include "access/htup_details.h"
+#include "cdb/cdbvars.h"
+#include "cdb/ic_proxy_bgworker.h"
+#include "funcapi.h"
+#include "utils/builtins.h"
+
+#define NUM_PEER_STATS_ATTRS 13
+
+extern Datum gp_interconnect_proxy_peer_stats(PG_FUNCTION_ARGS);
+
+/*
+ * Return one row per peer of the local ic-proxy, with its traffic counters,
+ * the depth of its outgoing queues and its recent throughput. The result is
+ * empty unless gp_interconnect_type is proxy, or when ic-proxy is not
+ * supported by this build.
+ */
+PG_FUNCTION_INFO_V1(gp_interconnect_proxy_peer_stats);
+Datum
+gp_interconnect_proxy_peer_stats(PG_FUNCTION_ARGS)
+{
+	FuncCallContext *funcctx;
+
+	if (SRF_IS_FIRSTCALL())
+	{
+		MemoryContext oldContext;
+		TupleDesc	tupdesc;
+
+		funcctx = SRF_FIRSTCALL_INIT();
+
+		oldContext = MemoryContextSwitchTo(funcctx->multi_call_memory_ctx);
+
+		tupdesc = CreateTemplateTupleDesc(NUM_PEER_STATS_ATTRS);
+		TupleDescInitEntry(tupdesc, (AttrNumber) 1, "gp_segment_id", INT4OID, -1, 0);
+		TupleDescInitEntry(tupdesc, (AttrNumber) 2, "peer_content", INT4OID, -1, 0);
+		TupleDescInitEntry(tupdesc, (AttrNumber) 3, "peer_dbid", INT4OID, -1, 0);
+		TupleDescInitEntry(tupdesc, (AttrNumber) 4, "connected", BOOLOID, -1, 0);
+		TupleDescInitEntry(tupdesc, (AttrNumber) 5, "sent_bytes", INT8OID, -1, 0);
+		TupleDescInitEntry(tupdesc, (AttrNumber) 6, "sent_packets", INT8OID, -1, 0);
+		TupleDescInitEntry(tupdesc, (AttrNumber) 7, "writes", INT8OID, -1, 0);
+		TupleDescInitEntry(tupdesc, (AttrNumber) 8, "recv_bytes", INT8OID, -1, 0);
+		TupleDescInitEntry(tupdesc, (AttrNumber) 9, "recv_packets", INT8OID, -1, 0);
+		TupleDescInitEntry(tupdesc, (AttrNumber) 10, "queued_packets", INT8OID, -1, 0);
+		TupleDescInitEntry(tupdesc, (AttrNumber) 11, "write_queue_bytes", INT8OID, -1, 0);
+		TupleDescInitEntry(tupdesc, (AttrNumber) 12, "send_bytes_per_sec", INT8OID, -1, 0);
+		TupleDescInitEntry(tupdesc, (AttrNumber) 13, "recv_bytes_per_sec", INT8OID, -1, 0);
+
+		funcctx->tuple_desc = BlessTupleDesc(tupdesc);
+		funcctx->user_fctx = NULL;
+
+#ifdef ENABLE_IC_PROXY
+		/* the slot index of the next peer to report */
+		funcctx->user_fctx = palloc0(sizeof(int));
+#endif
+
+		MemoryContextSwitchTo(oldContext);
+	}
+
+	funcctx = SRF_PERCALL_SETUP();
+
+#ifdef ENABLE_IC_PROXY
+	if (Gp_interconnect_type == INTERCONNECT_TYPE_PROXY)
+	{
+		int		   *slot = (int *) funcctx->user_fctx;
+
+		for (; *slot < IC_PROXY_MAX_PEER_STATS; (*slot)++)
+		{
+			ICProxyPeerStats *stats = &ic_proxy_peer_stats[*slot];
+			Datum		values[NUM_PEER_STATS_ATTRS];
+			bool		nulls[NUM_PEER_STATS_ATTRS];
+			HeapTuple	tuple;
+			uint32		dbid;
+
+			dbid = pg_atomic_read_u32(&stats->dbid);
+			if (dbid == 0)
+				continue;
+			pg_read_barrier();
+
+			MemSet(values, 0, sizeof(values));
+			MemSet(nulls, 0, sizeof(nulls));
+
+			values[0] = Int32GetDatum(GpIdentity.segindex);
+			values[1] = Int32GetDatum(stats->content);
+			values[2] = Int32GetDatum(dbid);
+			values[3] = BoolGetDatum(pg_atomic_read_u32(&stats->connected) != 0);
+			values[4] = Int64GetDatum(pg_atomic_read_u64(&stats->sentBytes));
+			values[5] = Int64GetDatum(pg_atomic_read_u64(&stats->sentPackets));
+			values[6] = Int64GetDatum(pg_atomic_read_u64(&stats->writes));
+			values[7] = Int64GetDatum(pg_atomic_read_u64(&stats->recvBytes));
+			values[8] = Int64GetDatum(pg_atomic_read_u64(&stats->recvPackets));
+			values[9] = Int64GetDatum(pg_atomic_read_u64(&stats->queuedPackets));
+			values[10] = Int64GetDatum(pg_atomic_read_u64(&stats->writeQueueBytes));
+			values[11] = Int64GetDatum(pg_atomic_read_u64(&stats->sendRate));
+			values[12] = Int64GetDatum(pg_atomic_read_u64(&stats->recvRate));
+
+			tuple = heap_form_tuple(funcctx->tuple_desc, values, nulls);
+
+			(*slot)++;
+			SRF_RETURN_NEXT(funcctx, HeapTupleGetDatum(tuple));
+		}
+	}
+#endif
+
+	SRF_RETURN_DONE(funcctx);
+}
@@ -0,0 +1,110 @@
+/*-------------------------------------------------------------------------
+ *
+ * gp_optimizer_cache.c
+ *	  Report counters of the GPORCA optimizer's per-backend caches.
+ *
+ * Portions Copyright (c) 2024-Present VMware, Inc. or its affiliates.
+ *
+ * IDENTIFICATION
+ *	  gpcontrib/gp_toolkit/gp_optimizer_cache.c
+ *
+ *-------------------------------------------------------------------------
+ */
+#include "postgres.h"
+
+#include "access/htup_details.h"
+#include "funcapi.h"
+#include "nodes/params.h"
+#include "nodes/parsenodes.h"
+#include "nodes/plannodes.h"
+#include "optimizer/orca.h"
+#include "utils/builtins.h"
+
+extern Datum gp_optimizer_cache_stats(PG_FUNCTION_ARGS);
+
+/*
+ * Return one row per optimizer cache of the current backend, with its size
+ * and hit/miss/eviction/invalidation counters. For the metadata cache,
+ * retained_entries counts the objects that survived catalog changes and did
+ * not have to be reloaded. Without ORCA, there are no
+ * caches to report on and the result is empty.
+ */
+PG_FUNCTION_INFO_V1(gp_optimizer_cache_stats);
+Datum
+gp_optimizer_cache_stats(PG_FUNCTION_ARGS)
+{
+	FuncCallContext *funcctx;
+
+	if (SRF_IS_FIRSTCALL())
+	{
+		int			nattr = 10;
+		MemoryContext oldContext;
+		TupleDesc	tupdesc;
+
+		funcctx = SRF_FIRSTCALL_INIT();
+
+		oldContext = MemoryContextSwitchTo(funcctx->multi_call_memory_ctx);
+
+		tupdesc = CreateTemplateTupleDesc(nattr);
+		TupleDescInitEntry(tupdesc, (AttrNumber) 1, "cache", TEXTOID, -1, 0);
+		TupleDescInitEntry(tupdesc, (AttrNumber) 2, "entries", INT8OID, -1, 0);
+		TupleDescInitEntry(tupdesc, (AttrNumber) 3, "size_bytes", INT8OID, -1, 0);
+		TupleDescInitEntry(tupdesc, (AttrNumber) 4, "quota_bytes", INT8OID, -1, 0);
+		TupleDescInitEntry(tupdesc, (AttrNumber) 5, "hits", INT8OID, -1, 0);
+		TupleDescInitEntry(tupdesc, (AttrNumber) 6, "misses", INT8OID, -1, 0);
+		TupleDescInitEntry(tupdesc, (AttrNumber) 7, "evictions", INT8OID, -1, 0);
+		TupleDescInitEntry(tupdesc, (AttrNumber) 8, "invalidations", INT8OID, -1, 0);
+		TupleDescInitEntry(tupdesc, (AttrNumber) 9, "invalidated_entries", INT8OID, -1, 0);
+		TupleDescInitEntry(tupdesc, (AttrNumber) 10, "retained_entries", INT8OID, -1, 0);
+
+		funcctx->tuple_desc = BlessTupleDesc(tupdesc);
+
+#ifdef USE_ORCA
+		{
+			OptimizerCacheStats *stats;
+
+			stats = palloc0(sizeof(OptimizerCacheStats) * MAX_OPTIMIZER_CACHE_STATS);
+			funcctx->max_calls = GetOptimizerCacheStats(stats, MAX_OPTIMIZER_CACHE_STATS);
+			funcctx->user_fctx = stats;
+		}
+#else
+		funcctx->max_calls = 0;
+#endif
+
+		MemoryContextSwitchTo(oldContext);
+	}
+
+	funcctx = SRF_PERCALL_SETUP();
+
+#ifdef USE_ORCA
+	if (funcctx->call_cntr < funcctx->max_calls)
+	{
+		Datum		values[10];
+		bool		nulls[10];
+		HeapTuple	tuple;
+		OptimizerCacheStats *stat;
+
+		stat = &((OptimizerCacheStats *) funcctx->user_fctx)[funcctx->call_cntr];
+
+		MemSet(values, 0, sizeof(values));
+		MemSet(nulls, 0, sizeof(nulls));
+
+		values[0] = CStringGetTextDatum(stat->name);
+		values[1] = Int64GetDatum(stat->entries);
+		values[2] = Int64GetDatum(stat->size);
+		values[3] = Int64GetDatum(stat->quota);
+		values[4] = Int64GetDatum(stat->hits);
+		values[5] = Int64GetDatum(stat->misses);
+		values[6] = Int64GetDatum(stat->evictions);
+		values[7] = Int64GetDatum(stat->invalidations);
+		values[8] = Int64GetDatum(stat->invalidated_entries);
+		values[9] = Int64GetDatum(stat->retained_entries);
+
+		tuple = heap_form_tuple(funcctx->tuple_desc, values, nulls);
+
+		SRF_RETURN_NEXT(funcctx, HeapTupleGetDatum(tuple));
+	}
+#endif
+
+	SRF_RETURN_DONE(funcctx);
+}
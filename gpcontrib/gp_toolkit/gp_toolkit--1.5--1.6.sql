@@ -0,0 +1,143 @@
+/* gpcontrib/gp_toolkit/gp_toolkit--1.5--1.6.sql */
+
+-- complain if script is sourced in psql, rather than via ALTER EXTENSION
+\echo Use "ALTER EXTENSION gp_toolkit UPDATE TO '1.6'" to load this file. \quit
+
+--------------------------------------------------------------------------------
+-- @function:
+--        gp_toolkit.__gp_optimizer_cache_stats
+--
+-- @in:
+--
+-- @out:
+--        text - name of the cache,
+--        bigint - number of cached objects,
+--        bigint - memory used by the cache in bytes,
+--        bigint - memory quota of the cache in bytes, 0 means unlimited,
+--        bigint - lookups that found an object,
+--        bigint - lookups that did not find an object,
+--        bigint - times entries were evicted to stay within the quota,
+--        bigint - times catalog changes were applied to the cache,
+--        bigint - objects dropped because of catalog changes,
+--        bigint - objects kept across catalog changes
+--
+-- @doc:
+--        Counters of the GPORCA optimizer's caches in the current session,
+--        and of the metadata cache shared by all sessions, if enabled
+--
+--------------------------------------------------------------------------------
+CREATE FUNCTION gp_toolkit.__gp_optimizer_cache_stats(
+    OUT cache text,
+    OUT entries bigint,
+    OUT size_bytes bigint,
+    OUT quota_bytes bigint,
+    OUT hits bigint,
+    OUT misses bigint,
+    OUT evictions bigint,
+    OUT invalidations bigint,
+    OUT invalidated_entries bigint,
+    OUT retained_entries bigint)
+RETURNS SETOF record
+AS '$libdir/gp_toolkit', 'gp_optimizer_cache_stats'
+LANGUAGE C VOLATILE EXECUTE ON COORDINATOR;
+
+GRANT EXECUTE ON FUNCTION gp_toolkit.__gp_optimizer_cache_stats() TO public;
+
+--------------------------------------------------------------------------------
+-- @view:
+--        gp_toolkit.gp_optimizer_cache_stats
+--
+-- @doc:
+--        Size and hit/miss/eviction/invalidation counters of the GPORCA
+--        optimizer's caches in the current session, and of the metadata
+--        cache shared by all sessions, if enabled
+--
+--------------------------------------------------------------------------------
+CREATE VIEW gp_toolkit.gp_optimizer_cache_stats AS
+    SELECT * FROM gp_toolkit.__gp_optimizer_cache_stats();
+
+GRANT SELECT ON gp_toolkit.gp_optimizer_cache_stats TO public;
+
+--------------------------------------------------------------------------------
+-- @function:
+--        gp_toolkit.__gp_interconnect_proxy_peer_stats_on_coordinator
+--        gp_toolkit.__gp_interconnect_proxy_peer_stats_on_segments
+--
+-- @in:
+--
+-- @out:
+--        int - segment id of the proxy,
+--        int - content of the peer,
+--        int - dbid of the peer,
+--        boolean - whether the peer is ready to send and receive data,
+--        bigint - bytes sent to the peer,
+--        bigint - packets sent to the peer,
+--        bigint - writes to the peer socket,
+--        bigint - bytes received from the peer,
+--        bigint - packets received from the peer,
+--        bigint - packets waiting to be written,
+--        bigint - bytes being written to the peer socket,
+--        bigint - bytes per second sent in the last second,
+--        bigint - bytes per second received in the last second
+--
+-- @doc:
+--        Statistics of the peers of the interconnect proxy on the coordinator,
+--        or on each segment
+--
+--------------------------------------------------------------------------------
+CREATE FUNCTION gp_toolkit.__gp_interconnect_proxy_peer_stats_on_coordinator(
+    OUT gp_segment_id int,
+    OUT peer_content int,
+    OUT peer_dbid int,
+    OUT connected boolean,
+    OUT sent_bytes bigint,
+    OUT sent_packets bigint,
+    OUT writes bigint,
+    OUT recv_bytes bigint,
+    OUT recv_packets bigint,
+    OUT queued_packets bigint,
+    OUT write_queue_bytes bigint,
+    OUT send_bytes_per_sec bigint,
+    OUT recv_bytes_per_sec bigint)
+RETURNS SETOF record
+AS '$libdir/gp_toolkit', 'gp_interconnect_proxy_peer_stats'
+LANGUAGE C VOLATILE EXECUTE ON COORDINATOR;
+
+GRANT EXECUTE ON FUNCTION gp_toolkit.__gp_interconnect_proxy_peer_stats_on_coordinator() TO public;
+
+CREATE FUNCTION gp_toolkit.__gp_interconnect_proxy_peer_stats_on_segments(
+    OUT gp_segment_id int,
+    OUT peer_content int,
+    OUT peer_dbid int,
+    OUT connected boolean,
+    OUT sent_bytes bigint,
+    OUT sent_packets bigint,
+    OUT writes bigint,
+    OUT recv_bytes bigint,
+    OUT recv_packets bigint,
+    OUT queued_packets bigint,
+    OUT write_queue_bytes bigint,
+    OUT send_bytes_per_sec bigint,
+    OUT recv_bytes_per_sec bigint)
+RETURNS SETOF record
+AS '$libdir/gp_toolkit', 'gp_interconnect_proxy_peer_stats'
+LANGUAGE C VOLATILE EXECUTE ON ALL SEGMENTS;
+
+GRANT EXECUTE ON FUNCTION gp_toolkit.__gp_interconnect_proxy_peer_stats_on_segments() TO public;
+
+--------------------------------------------------------------------------------
+-- @view:
+--        gp_toolkit.gp_interconnect_proxy_peer_stats
+--
+-- @doc:
+--        Traffic counters, outgoing queue depth and throughput of the
+--        connections between the interconnect proxies, one row per peer of
+--        the proxy on each segment, when gp_interconnect_type is proxy
+--
+--------------------------------------------------------------------------------
+CREATE VIEW gp_toolkit.gp_interconnect_proxy_peer_stats AS
+    SELECT * FROM gp_toolkit.__gp_interconnect_proxy_peer_stats_on_coordinator()
+    UNION ALL
+    SELECT * FROM gp_toolkit.__gp_interconnect_proxy_peer_stats_on_segments();
+
+GRANT SELECT ON gp_toolkit.gp_interconnect_proxy_peer_stats TO public;
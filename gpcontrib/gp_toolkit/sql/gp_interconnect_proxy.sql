@@ -0,0 +1,25 @@
+-- Tests for gp_toolkit.gp_interconnect_proxy_peer_stats
+--
+-- The view only reports peers when gp_interconnect_type is proxy, so the
+-- checks must pass with any interconnect type. The traffic counters are
+-- tested under proxy by isolation2's ic_proxy_peer_stats.
+CREATE TABLE icproxy_t (a int, b int) DISTRIBUTED BY (a);
+INSERT INTO icproxy_t SELECT i, i % 10 FROM generate_series(1, 1000) i;
+-- redistribute and gather some rows, through the proxies if they are in use
+SELECT count(*) FROM (SELECT b, count(*) FROM icproxy_t GROUP BY b) s;
+SELECT current_setting('gp_interconnect_type') <> 'proxy' OR
+       (count(*) > 0 AND sum(sent_bytes) > 0 AND sum(recv_bytes) > 0) AS ok
+FROM gp_toolkit.gp_interconnect_proxy_peer_stats;
+-- every proxy reports every peer only once, and never itself
+SELECT count(*) AS duplicates FROM (
+    SELECT gp_segment_id, peer_dbid FROM gp_toolkit.gp_interconnect_proxy_peer_stats
+    GROUP BY 1, 2 HAVING count(*) > 1) s;
+SELECT count(*) AS self_peers
+FROM gp_toolkit.gp_interconnect_proxy_peer_stats s
+JOIN gp_segment_configuration c ON c.dbid = s.peer_dbid
+WHERE c.content = s.gp_segment_id AND c.role = 'p';
+SELECT count(*) AS negative_values FROM gp_toolkit.gp_interconnect_proxy_peer_stats
+WHERE sent_bytes < 0 OR sent_packets < 0 OR writes < 0 OR
+      recv_bytes < 0 OR recv_packets < 0 OR queued_packets < 0 OR
+      write_queue_bytes < 0 OR send_bytes_per_sec < 0 OR recv_bytes_per_sec < 0;
+DROP TABLE icproxy_t;
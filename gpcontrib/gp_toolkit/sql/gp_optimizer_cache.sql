@@ -0,0 +1,44 @@
+-- Tests for gp_toolkit.gp_optimizer_cache_stats
+CREATE TABLE optcache_t (a int, b int) DISTRIBUTED BY (a);
+INSERT INTO optcache_t SELECT i, i % 10 FROM generate_series(1, 100) i;
+ANALYZE optcache_t;
+
+SET optimizer = on;
+SET optimizer_plan_caching = on;
+
+CREATE TEMP TABLE optcache_before AS
+    SELECT * FROM gp_toolkit.gp_optimizer_cache_stats;
+
+-- the first execution populates the cache, the second one is served from it
+SELECT count(*) FROM optcache_t WHERE b = 3;
+SELECT count(*) FROM optcache_t WHERE b = 3;
+
+SELECT s.hits - b.hits AS hits, s.misses > b.misses AS missed, s.entries > 0 AS has_entries
+FROM gp_toolkit.gp_optimizer_cache_stats s JOIN optcache_before b USING (cache)
+WHERE cache = 'plan';
+
+-- a different constant is a different query
+SELECT count(*) FROM optcache_t WHERE b = 4;
+
+SELECT s.hits - b.hits AS hits
+FROM gp_toolkit.gp_optimizer_cache_stats s JOIN optcache_before b USING (cache)
+WHERE cache = 'plan';
+
+-- DDL on the table must invalidate the cached plans
+ALTER TABLE optcache_t ADD COLUMN c int;
+SELECT count(*) FROM optcache_t WHERE b = 3;
+
+SELECT s.invalidations > b.invalidations AS invalidated
+FROM gp_toolkit.gp_optimizer_cache_stats s JOIN optcache_before b USING (cache)
+WHERE cache = 'plan';
+
+-- the metadata cache only dropped the objects of the altered table
+SELECT s.invalidations > b.invalidations AS invalidated,
+       s.invalidated_entries > b.invalidated_entries AS dropped,
+       s.retained_entries > b.retained_entries AS retained
+FROM gp_toolkit.gp_optimizer_cache_stats s JOIN optcache_before b USING (cache)
+WHERE cache = 'metadata';
+
+RESET optimizer_plan_caching;
+RESET optimizer;
+DROP TABLE optcache_t;
@@ -93,6 +93,19 @@ open_datumstreamread_segfile(
 							  fileSegNo, segInfo->formatversion);
 }
 
+/*
+ * Does the scan skip the varblocks that the zone maps exclude? Only plain
+ * sequential scans, which read batches with aocs_getnext_batch(), do.
+ */
+static inline bool
+aocs_use_zonemaps(AOCSScanDesc scan)
+{
+	return scan->zoneMapScan != NULL &&
+		!scan->partialScan &&
+		scan->blockDirectory == NULL &&
+		(scan->rs_base.rs_flags & (SO_TYPE_ANALYZE | SO_TYPE_SAMPLESCAN)) == 0;
+}
+
 /*
  * Open all segment files associted with the datum stream.
  *
@@ -119,6 +132,18 @@ open_all_datumstreamread_segfiles(AOCSScanDesc scan, AOCSFileSegInfo *segInfo)
 
 		open_datumstreamread_segfile(basepath, rel, segInfo, ds[attno], attno);
 
+		/*
+		 * With zone maps, aocs_zonemap_seek() decides which blocks to read.
+		 * Forget about the last block of the previous segment file.
+		 */
+		if (aocs_use_zonemaps(scan))
+		{
+			datumstreamread_reset_block(ds[attno]);
+			ds[attno]->blockFirstRowNum = 1;
+			ds[attno]->blockRowCount = 0;
+			continue;
+		}
+
 		/* skip reading block for ANALYZE/SampleScan/partial scan */
 		if ((scan->rs_base.rs_flags & SO_TYPE_ANALYZE) != 0 ||
 			(scan->rs_base.rs_flags & SO_TYPE_SAMPLESCAN) != 0 ||
@@ -476,6 +501,9 @@ open_next_scan_seg(AOCSScanDesc scan)
 															true);
 				}
 
+				if (aocs_use_zonemaps(scan))
+					AOZoneMapScan_BeginSegment(scan->zoneMapScan, curSegInfo->segno);
+
 				open_all_datumstreamread_segfiles(scan, curSegInfo);
 
 				return scan->cur_seg;
@@ -762,6 +790,13 @@ aocs_rescan(AOCSScanDesc scan)
 		close_ds_read(scan->columnScanInfo.ds, scan->columnScanInfo.relationTupleDesc->natts);
 	initscan_with_colinfo(scan);
 
+	/* forget the rows of the current batch */
+	if (scan->batch)
+	{
+		scan->batch->nrows = 0;
+		scan->batch->nsel = 0;
+		scan->batch->nextsel = 0;
+	}
 
 	/* TABLESAMPLE related state */
 	scan->segrowsprocessed = 0;
@@ -837,6 +872,24 @@ aocs_endscan(AOCSScanDesc scan)
 {
 	close_cur_scan_seg(scan);
 
+	if (scan->batch)
+	{
+		aocs_end_batch(scan->batch);
+		scan->batch = NULL;
+	}
+
+	if (scan->zoneMapScan)
+	{
+		AOZoneMapScan_End(scan->zoneMapScan);
+		scan->zoneMapScan = NULL;
+	}
+
+	if (scan->rs_base.rs_key)
+	{
+		pfree(scan->rs_base.rs_key);
+		scan->rs_base.rs_key = NULL;
+	}
+
 	if (scan->columnScanInfo.ds)
 	{
 		Assert(scan->columnScanInfo.proj_atts);
@@ -1409,6 +1462,22 @@ aocs_get_target_tuple(AOCSScanDesc aoscan, int64 targrow, TupleTableSlot *slot)
 	return aocs_gettuple(aoscan, targrow, slot);
 }
 
+/*
+ * Finish the lazy initialization of a scan, once the descriptor of the tuples
+ * to return is known.
+ */
+static void
+aocs_initscan_with_tupdesc(AOCSScanDesc scan, TupleDesc tupdesc)
+{
+	if (scan->columnScanInfo.relationTupleDesc == NULL)
+	{
+		scan->columnScanInfo.relationTupleDesc = tupdesc;
+		/* Pin it! ... and of course release it upon destruction / rescan */
+		PinTupleDesc(scan->columnScanInfo.relationTupleDesc);
+		initscan_with_colinfo(scan);
+	}
+}
+
 bool
 aocs_getnext(AOCSScanDesc scan, ScanDirection direction, TupleTableSlot *slot)
 {
@@ -1428,13 +1497,7 @@ aocs_getnext(AOCSScanDesc scan, ScanDirection direction, TupleTableSlot *slot)
 	Assert((scan->rs_base.rs_flags & SO_TYPE_ANALYZE) == 0);
 	Assert((scan->rs_base.rs_flags & SO_TYPE_SAMPLESCAN) == 0);
 
-	if (scan->columnScanInfo.relationTupleDesc == NULL)
-	{
-		scan->columnScanInfo.relationTupleDesc = slot->tts_tupleDescriptor;
-		/* Pin it! ... and of course release it upon destruction / rescan */
-		PinTupleDesc(scan->columnScanInfo.relationTupleDesc);
-		initscan_with_colinfo(scan);
-	}
+	aocs_initscan_with_tupdesc(scan, slot->tts_tupleDescriptor);
 
 	natts = slot->tts_tupleDescriptor->natts;
 	Assert(natts <= scan->columnScanInfo.relationTupleDesc->natts);
@@ -1577,6 +1640,459 @@ ReadNext:
 	return false;
 }
 
+/*
+ * Allocate a batch for reading rows of the scan with aocs_getnext_batch(),
+ * with room for maxrows rows of the projected columns.
+ */
+AOCSBatch
+aocs_begin_batch(AOCSScanDesc scan, TupleDesc tupdesc, int maxrows)
+{
+	MemoryContext oldCtx;
+	AOCSBatch	batch;
+	int			natts;
+
+	Assert(maxrows > 0);
+
+	aocs_initscan_with_tupdesc(scan, tupdesc);
+
+	oldCtx = MemoryContextSwitchTo(scan->columnScanInfo.scanCtx);
+
+	natts = scan->columnScanInfo.relationTupleDesc->natts;
+
+	batch = (AOCSBatch) palloc0(sizeof(AOCSBatchData));
+	batch->tupdesc = tupdesc;
+	batch->maxrows = maxrows;
+	batch->natts = natts;
+	batch->values = (Datum **) palloc0(natts * sizeof(Datum *));
+	batch->isnull = (bool **) palloc0(natts * sizeof(bool *));
+	batch->hasnull = (bool *) palloc0(natts * sizeof(bool));
+
+	for (AttrNumber i = 0; i < scan->columnScanInfo.num_proj_atts; i++)
+	{
+		AttrNumber	attno = scan->columnScanInfo.proj_atts[i];
+
+		batch->values[attno] = (Datum *) palloc(maxrows * sizeof(Datum));
+		batch->isnull[attno] = (bool *) palloc(maxrows * sizeof(bool));
+	}
+
+	batch->tids = (AOTupleId *) palloc(maxrows * sizeof(AOTupleId));
+	batch->sel = (int *) palloc(maxrows * sizeof(int));
+
+	MemoryContextSwitchTo(oldCtx);
+
+	return batch;
+}
+
+void
+aocs_end_batch(AOCSBatch batch)
+{
+	for (AttrNumber attno = 0; attno < batch->natts; attno++)
+	{
+		if (batch->values[attno])
+		{
+			pfree(batch->values[attno]);
+			pfree(batch->isnull[attno]);
+		}
+	}
+
+	pfree(batch->values);
+	pfree(batch->isnull);
+	pfree(batch->hasnull);
+	pfree(batch->tids);
+	pfree(batch->sel);
+	pfree(batch);
+}
+
+/*
+ * Read the next varblock of a column, for aocs_getnext_batch(). Returns false
+ * at the end of the segment file.
+ */
+static bool
+aocs_batch_read_block(AOCSScanDesc scan, AttrNumber attno)
+{
+	if (datumstreamread_block(scan->columnScanInfo.ds[attno], scan->blockDirectory, attno) < 0)
+		return false;
+
+	AOCSScanDesc_UpdateTotalBytesRead(scan, attno);
+	pgstat_count_buffer_read_ao(scan->rs_base.rs_rd,
+								RelationGuessNumberOfBlocksFromSize(scan->totalBytesRead));
+
+	return true;
+}
+
+/*
+ * Read the header of the next varblock of a column, for aocs_zonemap_seek().
+ * Returns false at the end of the segment file.
+ */
+static bool
+aocs_zonemap_read_header(DatumStreamRead *ds)
+{
+	int64		nextRowNum = ds->blockFirstRowNum + ds->blockRowCount;
+
+	if (!datumstreamread_block_info(ds))
+		return false;
+
+	/* Pre-4.0 blocks don't store their first row number */
+	if (ds->getBlockInfo.firstRow < 0)
+		ds->blockFirstRowNum = nextRowNum;
+
+	return true;
+}
+
+/*
+ * Position a column at the first row, at or after both *rowNum and the
+ * column's current position, that the zone maps don't exclude, and return
+ * that row in *rowNum. The varblocks that are entirely excluded are skipped
+ * without reading (or decompressing) their content.
+ *
+ * Returns false at the end of the segment file.
+ */
+static bool
+aocs_zonemap_seek(AOCSScanDesc scan, AttrNumber attno, int64 *rowNum)
+{
+	DatumStreamRead *ds = scan->columnScanInfo.ds[attno];
+	int64		target = *rowNum;
+
+	for (;;)
+	{
+		int			remaining = datumstreamread_remaining(ds);
+
+		if (remaining > 0)
+		{
+			int64		nextRowNum = ds->blockFirstRowNum +
+				DatumStreamBlockRead_Nth(&ds->blockRead) + 1;
+
+			target = AOZoneMapScan_SkipTo(scan->zoneMapScan,
+										  Max(target, nextRowNum));
+			if (target < nextRowNum + remaining)
+			{
+				if (target > nextRowNum)
+					datumstreamread_find(ds, target - ds->blockFirstRowNum - 1);
+
+				*rowNum = target;
+				return true;
+			}
+
+			/* The rest of the block is excluded */
+			datumstreamread_reset_block(ds);
+		}
+
+		if (!aocs_zonemap_read_header(ds))
+			return false;
+
+		target = AOZoneMapScan_SkipTo(scan->zoneMapScan,
+									  Max(target, ds->blockFirstRowNum));
+		if (target >= ds->blockFirstRowNum + ds->blockRowCount)
+		{
+			datumstreamread_skip_block(ds);
+			scan->rs_base.rs_nblocks_skipped++;
+			continue;
+		}
+
+		datumstreamread_block_content(ds);
+
+		AOCSScanDesc_UpdateTotalBytesRead(scan, attno);
+		pgstat_count_buffer_read_ao(scan->rs_base.rs_rd,
+									RelationGuessNumberOfBlocksFromSize(scan->totalBytesRead));
+	}
+}
+
+/*
+ * Read the next batch of rows of the scan, a column at a time.
+ *
+ * The batch ends at the first varblock boundary of any of the projected
+ * columns, and at the last missing value of a column added by ADD COLUMN, so
+ * that each column vector is either decoded from a single varblock with
+ * datumstreamread_get_batch(), or filled with the column's missing value.
+ * Rows that are not visible are left out of the selection vector, which may
+ * thus be empty.
+ *
+ * Returns false when there are no more rows to read.
+ */
+bool
+aocs_getnext_batch(AOCSScanDesc scan, AOCSBatch batch)
+{
+	bool		isSnapshotAny = (scan->rs_base.rs_snapshot == SnapshotAny);
+	bool		useZoneMaps = aocs_use_zonemaps(scan);
+	bool		segdone = false;
+
+	/* should not be in ANALYZE/SampleScan - we use a different API */
+	Assert((scan->rs_base.rs_flags & SO_TYPE_ANALYZE) == 0);
+	Assert((scan->rs_base.rs_flags & SO_TYPE_SAMPLESCAN) == 0);
+	Assert(scan->columnScanInfo.relationTupleDesc != NULL);
+
+	batch->nrows = 0;
+	batch->nsel = 0;
+	batch->nextsel = 0;
+
+	/* Bail out early if we do not have any column in the projection. */
+	if (scan->columnScanInfo.num_proj_atts == 0)
+		return false;
+
+	while (1)
+	{
+		AOCSFileSegInfo *curseginfo;
+		AttrNumber	anchor_attno = scan->columnScanInfo.proj_atts[ANCHOR_COL_IN_PROJ];
+		DatumStreamRead *anchor_ds = scan->columnScanInfo.ds[anchor_attno];
+		int64		firstRowNum;
+		int			nrows;
+
+		/* If necessary, open next seg */
+		if (scan->cur_seg < 0 || segdone)
+		{
+			if (open_next_scan_seg(scan) < 0)
+			{
+				/* No more seg, we are at the end */
+				scan->cur_seg = -1;
+				return false;
+			}
+			scan->segrowsprocessed = 0;
+			segdone = false;
+		}
+
+		Assert(scan->cur_seg >= 0);
+		curseginfo = scan->seginfo[scan->cur_seg];
+
+		/*
+		 * The anchor column has no missing values, so the segment ends where
+		 * the anchor column does.
+		 */
+		if (useZoneMaps)
+		{
+			/* The batch starts at the next row that isn't excluded */
+			firstRowNum = 1;
+			if (!aocs_zonemap_seek(scan, anchor_attno, &firstRowNum))
+				segdone = true;
+		}
+		else
+		{
+			while (datumstreamread_remaining(anchor_ds) == 0)
+			{
+				if (!aocs_batch_read_block(scan, anchor_attno))
+				{
+					segdone = true;
+					break;
+				}
+			}
+		}
+		if (segdone)
+		{
+			close_cur_scan_seg(scan);
+			continue;
+		}
+
+		if (!useZoneMaps)
+		{
+			if (anchor_ds->blockFirstRowNum != InvalidAORowNum)
+			{
+				Assert(anchor_ds->blockFirstRowNum > 0);
+				firstRowNum = anchor_ds->blockFirstRowNum +
+					DatumStreamBlockRead_Nth(&anchor_ds->blockRead) + 1;
+			}
+			else
+				firstRowNum = scan->segrowsprocessed + 1;
+		}
+
+		nrows = Min(batch->maxrows, datumstreamread_remaining(anchor_ds));
+
+		/* ... and ends before the next row excluded by the zone maps */
+		if (useZoneMaps)
+			nrows = (int) Min((int64) nrows,
+							  AOZoneMapScan_NextExcluded(scan->zoneMapScan, firstRowNum) -
+							  firstRowNum);
+
+		/* Size the batch so that it doesn't cross any column's boundaries */
+		for (AttrNumber i = 0; i < scan->columnScanInfo.num_proj_atts; i++)
+		{
+			AttrNumber	attno = scan->columnScanInfo.proj_atts[i];
+			DatumStreamRead *ds = scan->columnScanInfo.ds[attno];
+
+			if (attno == anchor_attno)
+				continue;
+
+			if (AO_ATTR_VAL_IS_MISSING(firstRowNum,
+									   attno,
+									   curseginfo->segno,
+									   scan->columnScanInfo.attnum_to_rownum))
+			{
+				int64		lastMissingRowNum;
+
+				lastMissingRowNum = scan->columnScanInfo.attnum_to_rownum[attno * MAX_AOREL_CONCURRENCY +
+																		  curseginfo->segno];
+				nrows = Min(nrows, lastMissingRowNum - firstRowNum + 1);
+				continue;
+			}
+
+			if (useZoneMaps)
+			{
+				int64		rowNum = firstRowNum;
+
+				if (!aocs_zonemap_seek(scan, attno, &rowNum))
+				{
+					segdone = true;
+					break;
+				}
+				if (rowNum != firstRowNum)
+					elog(ERROR, "could not position column %d of AOCO table %s at row " INT64_FORMAT,
+						 attno + 1, RelationGetRelationName(scan->rs_base.rs_rd), firstRowNum);
+			}
+			else
+			{
+				while (datumstreamread_remaining(ds) == 0)
+				{
+					if (!aocs_batch_read_block(scan, attno))
+					{
+						/* Ha, cannot read next block, we need to go to next seg */
+						segdone = true;
+						break;
+					}
+				}
+			}
+			if (segdone)
+				break;
+
+			nrows = Min(nrows, datumstreamread_remaining(ds));
+		}
+		if (segdone)
+		{
+			close_cur_scan_seg(scan);
+			continue;
+		}
+
+		Assert(nrows > 0);
+
+		/* Now decode the column vectors */
+		for (AttrNumber i = 0; i < scan->columnScanInfo.num_proj_atts; i++)
+		{
+			AttrNumber	attno = scan->columnScanInfo.proj_atts[i];
+			DatumStreamRead *ds = scan->columnScanInfo.ds[attno];
+			Datum	   *values = batch->values[attno];
+			bool	   *isnull = batch->isnull[attno];
+
+			if (attno != anchor_attno &&
+				AO_ATTR_VAL_IS_MISSING(firstRowNum,
+									   attno,
+									   curseginfo->segno,
+									   scan->columnScanInfo.attnum_to_rownum))
+			{
+				Datum		missing;
+				bool		missingIsNull;
+
+				missing = getmissingattr(batch->tupdesc, attno + 1, &missingIsNull);
+				for (int row = 0; row < nrows; row++)
+				{
+					values[row] = missing;
+					isnull[row] = missingIsNull;
+				}
+				batch->hasnull[attno] = missingIsNull;
+				continue;
+			}
+
+			/* the row number from every column should match */
+			Assert(ds->blockFirstRowNum == InvalidAORowNum ||
+				   ds->blockFirstRowNum + DatumStreamBlockRead_Nth(&ds->blockRead) + 1 == firstRowNum);
+
+			if (datumstreamread_get_batch(ds, values, isnull, nrows) != nrows)
+				elog(ERROR, "could not read %d values of column %d from the current block of AOCO table %s",
+					 nrows, attno + 1, RelationGetRelationName(scan->rs_base.rs_rd));
+
+			batch->hasnull[attno] = (memchr(isnull, true, nrows * sizeof(bool)) != NULL);
+		}
+
+		for (int row = 0; row < nrows; row++)
+		{
+			AOTupleIdInit(&batch->tids[row], curseginfo->segno, firstRowNum + row);
+
+			if (isSnapshotAny || AppendOnlyVisimap_IsVisible(&scan->visibilityMap, &batch->tids[row]))
+				batch->sel[batch->nsel++] = row;
+		}
+
+		batch->nrows = nrows;
+		scan->segrowsprocessed += nrows;
+
+		return true;
+	}
+
+	Assert(!"Never here");
+	return false;
+}
+
+/*
+ * Evaluate scan keys on the column vectors of a batch, removing the rows that
+ * fail any of them from the selection vector. This gives the same result as
+ * HeapKeyTest() on each row, but without forming the tuples.
+ */
+void
+aocs_batch_filter(AOCSBatch batch, int nkeys, ScanKey keys)
+{
+	for (int k = 0; k < nkeys && batch->nsel > 0; k++)
+	{
+		ScanKey		key = &keys[k];
+		AttrNumber	attno = key->sk_attno - 1;
+		Datum	   *values;
+		bool	   *isnull;
+		int			nsel = 0;
+
+		/* A NULL argument never matches */
+		if (key->sk_flags & SK_ISNULL)
+		{
+			batch->nsel = 0;
+			break;
+		}
+
+		if (attno < 0 || attno >= batch->natts || batch->values[attno] == NULL)
+			elog(ERROR, "scan key on column %d which is not projected", key->sk_attno);
+
+		values = batch->values[attno];
+		isnull = batch->isnull[attno];
+
+		for (int i = 0; i < batch->nsel; i++)
+		{
+			int			row = batch->sel[i];
+
+			if (batch->hasnull[attno] && isnull[row])
+				continue;
+
+			if (DatumGetBool(FunctionCall2Coll(&key->sk_func,
+											   key->sk_collation,
+											   values[row],
+											   key->sk_argument)))
+				batch->sel[nsel++] = row;
+		}
+
+		batch->nsel = nsel;
+	}
+}
+
+/*
+ * Store the next selected row of a batch in the slot. Returns false once all
+ * the selected rows have been returned.
+ */
+bool
+aocs_batch_getnext(AOCSScanDesc scan, AOCSBatch batch, TupleTableSlot *slot)
+{
+	int			row;
+
+	if (batch->nextsel >= batch->nsel)
+		return false;
+
+	row = batch->sel[batch->nextsel++];
+
+	for (AttrNumber i = 0; i < scan->columnScanInfo.num_proj_atts; i++)
+	{
+		AttrNumber	attno = scan->columnScanInfo.proj_atts[i];
+
+		slot->tts_values[attno] = batch->values[attno][row];
+		slot->tts_isnull[attno] = batch->isnull[attno][row];
+	}
+
+	scan->cdb_fake_ctid = *((ItemPointer) &batch->tids[row]);
+
+	slot->tts_nvalid = slot->tts_tupleDescriptor->natts;
+	slot->tts_tid = scan->cdb_fake_ctid;
+	return true;
+}
+
 
 /* Open next file segment for write.  See SetCurrentFileSegForWrite */
 /* XXX Right now, we put each column to different files */
@@ -578,6 +578,10 @@ aoco_beginscan_extractcolumns(Relation rel, Snapshot snapshot,
 							projKind,
 							flags);
 
+	aoscan->zoneMapScan = AOZoneMapScan_Begin(rel,
+											  aoscan->appendOnlyMetaDataSnapshot,
+											  qual);
+
 	if (needFree)
 		pfree(proj);
 	return (TableScanDesc)aoscan;
@@ -637,7 +641,8 @@ aoco_beginscan_extractcolumns_bm(Relation rel, Snapshot snapshot,
 }
 
 /*
- * This function intentionally ignores key and nkeys
+ * The scan keys, if any, are evaluated on batches of rows by
+ * aoco_getnextslot(), before the tuples are formed.
  */
 static TableScanDesc
 aoco_beginscan(Relation relation,
@@ -657,6 +662,15 @@ aoco_beginscan(Relation relation,
 							AOCS_PROJ_ALL,
 							flags);
 
+	aoscan->rs_base.rs_nkeys = nkeys;
+	if (nkeys > 0)
+	{
+		aoscan->rs_base.rs_key = (ScanKey) palloc(sizeof(ScanKeyData) * nkeys);
+		memcpy(aoscan->rs_base.rs_key, key, sizeof(ScanKeyData) * nkeys);
+	}
+	else
+		aoscan->rs_base.rs_key = NULL;
+
 	return (TableScanDesc) aoscan;
 }
 
@@ -706,7 +720,12 @@ aoco_rescan(TableScanDesc scan, ScanKey key,
 	AOCSScanDesc  aoscan = (AOCSScanDesc) scan;
 
 	if (aoscan->descIdentifier == AOCSSCANDESCDATA)
+	{
+		if (key != NULL && aoscan->rs_base.rs_nkeys > 0)
+			memcpy(aoscan->rs_base.rs_key, key,
+				   aoscan->rs_base.rs_nkeys * sizeof(ScanKeyData));
 		aocs_rescan(aoscan);
+	}
 }
 
 static bool
@@ -715,6 +734,36 @@ aoco_getnextslot(TableScanDesc scan, ScanDirection direction, TupleTableSlot *sl
 	AOCSScanDesc  aoscan = (AOCSScanDesc)scan;
 
 	ExecClearTuple(slot);
+
+	/*
+	 * Partial scans, used for index builds, are positioned at a given row and
+	 * read one row at a time. Other scans decode a batch of rows a column at
+	 * a time, and evaluate the scan keys on it, before forming the tuples.
+	 */
+	if (!aoscan->partialScan)
+	{
+		Assert(ScanDirectionIsForward(direction));
+
+		if (aoscan->batch == NULL)
+			aoscan->batch = aocs_begin_batch(aoscan, slot->tts_tupleDescriptor,
+											 AOCS_SCAN_BATCH_SIZE);
+
+		while (!aocs_batch_getnext(aoscan, aoscan->batch, slot))
+		{
+			if (!aocs_getnext_batch(aoscan, aoscan->batch))
+				return false;
+
+			aocs_batch_filter(aoscan->batch,
+							  aoscan->rs_base.rs_nkeys,
+							  aoscan->rs_base.rs_key);
+		}
+
+		ExecStoreVirtualTuple(slot);
+		pgstat_count_heap_getnext(aoscan->rs_base.rs_rd);
+
+		return true;
+	}
+
 	if (aocs_getnext(aoscan, direction, slot))
 	{
 		ExecStoreVirtualTuple(slot);
@@ -367,10 +367,88 @@ AppendOnlyThrowAwayTuple(Relation rel, TupleTableSlot *slot, MemTupleBinding *mt
 						AOTupleIdGet_rowNum(aoTupleId))));
 }
 
+/*
+ * Does the visimap hide none of the tuples of the varblock that the scan is
+ * positioned on?
+ */
+static bool
+AppendOnlyCompaction_IsBlockVisible(AppendOnlyScanDesc scanDesc)
+{
+	AppendOnlyExecutorReadBlock *readBlock = &scanDesc->executorReadBlock;
+	AOTupleId	aoTupleId;
+	int64		rowNum;
+
+	for (rowNum = readBlock->blockFirstRowNum;
+		 rowNum < readBlock->blockFirstRowNum + readBlock->rowCount;
+		 rowNum++)
+	{
+		AOTupleIdInit(&aoTupleId, readBlock->segmentFileNum, rowNum);
+		if (!AppendOnlyVisimap_IsVisible(&scanDesc->visibilityMap, &aoTupleId))
+			return false;
+	}
+
+	return true;
+}
+
+/*
+ * Copy the varblock that the scan is positioned on as it is stored, if it
+ * can be, and insert index entries for the new TIDs of its tuples.
+ *
+ * Returns the number of tuples moved, or -1 if the varblock couldn't be
+ * copied.
+ */
+static int64
+AppendOnlyMoveBlock(AppendOnlyScanDesc scanDesc,
+					TupleTableSlot *slot,
+					AppendOnlyInsertDesc insertDesc,
+					ResultRelInfo *resultRelInfo,
+					EState *estate)
+{
+	int64		oldFirstRowNum = scanDesc->executorReadBlock.blockFirstRowNum;
+	int64		newFirstRowNum;
+	int			rowCount = scanDesc->executorReadBlock.rowCount;
+
+	if (!appendonly_insert_block(insertDesc, scanDesc, &newFirstRowNum))
+		return -1;
+
+	/* insert index' tuples if needed */
+	if (resultRelInfo->ri_NumIndices > 0)
+	{
+		while (appendonly_getnextblockslot(scanDesc, slot))
+		{
+			AOTupleId  *aoTupleId = (AOTupleId *) &slot->tts_tid;
+			AOTupleId	newAoTupleId;
+
+			AOTupleIdInit(&newAoTupleId, insertDesc->cur_segno,
+						  newFirstRowNum + AOTupleIdGet_rowNum(aoTupleId) - oldFirstRowNum);
+			slot->tts_tid = *((ItemPointerData *) &newAoTupleId);
+
+			ExecInsertIndexTuples(slot,
+								  estate,
+								  false, /* noDupError */
+								  NULL, /* specConflict */
+								  NIL /* arbiterIndexes */);
+			ResetPerTupleExprContext(estate);
+		}
+	}
+
+	if (Debug_appendonly_print_compaction)
+		ereport(DEBUG5,
+				(errmsg("Compaction: Copied varblock (%d," INT64_FORMAT ") -> (%d," INT64_FORMAT "), %d tuples",
+						scanDesc->executorReadBlock.segmentFileNum, oldFirstRowNum,
+						insertDesc->cur_segno, newFirstRowNum,
+						rowCount)));
+
+	return rowCount;
+}
+
 /*
  * Assumes that the segment file lock is already held.
  * Assumes that the segment file should be compacted.
  *
+ * The varblocks that have no hidden tuples are copied as they are stored,
+ * without decompressing and compressing them again.  The visible tuples of
+ * the other varblocks are moved one by one.
  */
 static void
 AppendOnlySegmentFileFullCompaction(Relation aorel,
@@ -387,6 +465,7 @@ AppendOnlySegmentFileFullCompaction(Relation aorel,
 	MemTupleBinding *mt_bind;
 	int			compact_segno;
 	int64		movedTupleCount = 0;
+	int64		copiedBlockCount = 0;
 	ResultRelInfo *resultRelInfo;
 	EState	   *estate;
 	AOTupleId  *aoTupleId;
@@ -458,40 +537,66 @@ AppendOnlySegmentFileFullCompaction(Relation aorel,
 	estate->gp_bypass_unique_check = true;
 
 	/*
-	 * Go through all visible tuples and move them to a new segfile.
+	 * Go through all visible tuples and move them to a new segfile, a whole
+	 * varblock at a time when none of its tuples is hidden.
 	 */
-	while (appendonly_getnextslot(&scanDesc->rs_base, ForwardScanDirection, slot))
+	while (appendonly_getnextblock(scanDesc))
 	{
 		/* Check interrupts as this may take time. */
 		CHECK_FOR_INTERRUPTS();
 
-		aoTupleId = (AOTupleId *) &slot->tts_tid;
-		if (AppendOnlyVisimap_IsVisible(&scanDesc->visibilityMap, aoTupleId))
-		{
-			AppendOnlyMoveTuple(slot,
-								mt_bind,
-								insertDesc,
-								resultRelInfo,
-								estate);
-			movedTupleCount++;
-		}
-		else
+		if (gp_appendonly_compaction_copy_blocks &&
+			AppendOnlyCompaction_IsBlockVisible(scanDesc))
 		{
-			/* Tuple is invisible and needs to be dropped */
-			AppendOnlyThrowAwayTuple(aorel, slot, mt_bind);
-			vacrelstats->num_dead_tuples++;
-			// TODO: need to evaluate performance impact of reporting with such granularity
-			pgstat_progress_update_param(PROGRESS_VACUUM_NUM_DEAD_TUPLES,
-										 vacrelstats->num_dead_tuples);
+			int64		blockTupleCount;
+
+			blockTupleCount = AppendOnlyMoveBlock(scanDesc,
+												  slot,
+												  insertDesc,
+												  resultRelInfo,
+												  estate);
+			if (blockTupleCount >= 0)
+			{
+				movedTupleCount += blockTupleCount;
+				tupleCount += blockTupleCount;
+				copiedBlockCount++;
+
+				if (VacuumCostActive)
+					vacuum_delay_point();
+				continue;
+			}
 		}
 
-		/*
-		 * Check for vacuum delay point after approximately a var block
-		 */
-		tupleCount++;
-		if (VacuumCostActive && tupleCount % tuplePerPage == 0)
+		while (appendonly_getnextblockslot(scanDesc, slot))
 		{
-			vacuum_delay_point();
+			aoTupleId = (AOTupleId *) &slot->tts_tid;
+			if (AppendOnlyVisimap_IsVisible(&scanDesc->visibilityMap, aoTupleId))
+			{
+				AppendOnlyMoveTuple(slot,
+									mt_bind,
+									insertDesc,
+									resultRelInfo,
+									estate);
+				movedTupleCount++;
+			}
+			else
+			{
+				/* Tuple is invisible and needs to be dropped */
+				AppendOnlyThrowAwayTuple(aorel, slot, mt_bind);
+				vacrelstats->num_dead_tuples++;
+				// TODO: need to evaluate performance impact of reporting with such granularity
+				pgstat_progress_update_param(PROGRESS_VACUUM_NUM_DEAD_TUPLES,
+											 vacrelstats->num_dead_tuples);
+			}
+
+			/*
+			 * Check for vacuum delay point after approximately a var block
+			 */
+			tupleCount++;
+			if (VacuumCostActive && tupleCount % tuplePerPage == 0)
+			{
+				vacuum_delay_point();
+			}
 		}
 	}
 
@@ -510,8 +615,8 @@ AppendOnlySegmentFileFullCompaction(Relation aorel,
 												compact_segno);
 
 	if (Debug_appendonly_print_compaction)
-		elog(LOG, "Finished compaction: AO segfile %d, relation %s, moved tuple count " INT64_FORMAT,
-			 compact_segno, relname, movedTupleCount);
+		elog(LOG, "Finished compaction: AO segfile %d, relation %s, moved tuple count " INT64_FORMAT ", copied varblock count " INT64_FORMAT,
+			 compact_segno, relname, movedTupleCount, copiedBlockCount);
 
 	AppendOnlyVisimap_Finish(&visiMap, NoLock);
 
@@ -0,0 +1,520 @@
+/*------------------------------------------------------------------------------
+ *
+ * appendonly_zonemap.c
+ *   Skip the blocks of append-optimized tables that can't have rows
+ *   satisfying a scan's qual, using per-block min/max synopses.
+ *
+ * When gp_appendonly_zone_maps is on, the block directory of an AO/AOCS table
+ * records, next to each minipage entry, the minimum, maximum and number of
+ * NULLs of the block's values for the columns of integer and date/time
+ * types.  The insert paths maintain them, see
+ * AppendOnlyBlockDirectory_InsertEntryWithZoneMap().  A sequential scan
+ * reads them for each segment file it opens, and turns the restrictions of
+ * its qual that they refute into row ranges it can skip over without reading
+ * or decompressing the blocks.
+ *
+ * Portions Copyright (c) 2012-Present VMware, Inc. or its affiliates.
+ *
+ *
+ * IDENTIFICATION
+ *	    src/backend/access/appendonly/appendonly_zonemap.c
+ *
+ *------------------------------------------------------------------------------
+ */
+#include "postgres.h"
+
+#include "access/appendonly_zonemap.h"
+#include "access/genam.h"
+#include "access/nbtree.h"
+#include "access/table.h"
+#include "catalog/aoblkdir.h"
+#include "catalog/aocatalog.h"
+#include "catalog/pg_appendonly.h"
+#include "catalog/pg_type.h"
+#include "cdb/cdbappendonlyblockdirectory.h"
+#include "nodes/nodeFuncs.h"
+#include "utils/fmgroids.h"
+#include "utils/lsyscache.h"
+#include "utils/memutils.h"
+#include "utils/rel.h"
+#include "utils/typcache.h"
+
+bool		gp_appendonly_zone_maps = false;
+
+static void extract_keys(TupleDesc tupdesc, Node *clause, List **keys);
+static bool extract_key(TupleDesc tupdesc, Node *clause, AOZoneMapKey *key);
+static bool var_is_supported(TupleDesc tupdesc, Node *node);
+static void add_excluded_range(AOZoneMapKeyRanges *keyRanges,
+							   int64 firstRowNum, int64 rowCount);
+static void scan_key_ranges(AOZoneMapScan zms, int segno, int keyno);
+
+/*
+ * Types whose values have a synopsis. They are all passed by value and
+ * compare the same way as their representation as signed integers.
+ */
+bool
+AOZoneMap_TypeIsSupported(Oid typid)
+{
+	switch (typid)
+	{
+		case INT2OID:
+		case INT4OID:
+		case INT8OID:
+		case DATEOID:
+		case TIMEOID:
+		case TIMESTAMPOID:
+		case TIMESTAMPTZOID:
+			return true;
+		default:
+			return false;
+	}
+}
+
+/*
+ * Columns of an AO row table that get a synopsis: the first
+ * AOZONEMAP_MAX_ROW_ATTS columns of a supported type.  Their 1-based numbers
+ * are stored in attnums[], and their count returned.
+ */
+int
+AOZoneMap_SummarizedAtts(TupleDesc tupdesc, AttrNumber *attnums)
+{
+	int			natts = 0;
+
+	for (int i = 0; i < tupdesc->natts && natts < AOZONEMAP_MAX_ROW_ATTS; i++)
+	{
+		Form_pg_attribute attr = TupleDescAttr(tupdesc, i);
+
+		if (!attr->attisdropped && AOZoneMap_TypeIsSupported(attr->atttypid))
+			attnums[natts++] = attr->attnum;
+	}
+
+	return natts;
+}
+
+/*
+ * Does the synopsis prove that no row of the block satisfies the key?
+ */
+bool
+AOZoneMapEntry_Excludes(const AOZoneMapEntry *entry, const AOZoneMapKey *key)
+{
+	if ((entry->flags & AOZONEMAP_VALID) == 0 || entry->attnum != key->attnum)
+		return false;
+
+	if (key->strategy == InvalidStrategy)
+	{
+		if (key->isnull)
+			return entry->nullCount == 0;
+		else
+			return (entry->flags & AOZONEMAP_HASVALUES) == 0;
+	}
+
+	/* The comparison operators are strict, a block of NULLs has no match */
+	if ((entry->flags & AOZONEMAP_HASVALUES) == 0)
+		return true;
+
+	switch (key->strategy)
+	{
+		case BTLessStrategyNumber:
+			return entry->minValue >= key->value;
+		case BTLessEqualStrategyNumber:
+			return entry->minValue > key->value;
+		case BTEqualStrategyNumber:
+			return entry->minValue > key->value || entry->maxValue < key->value;
+		case BTGreaterEqualStrategyNumber:
+			return entry->maxValue < key->value;
+		case BTGreaterStrategyNumber:
+			return entry->maxValue <= key->value;
+		default:
+			elog(ERROR, "unrecognized strategy number: %d", key->strategy);
+	}
+
+	return false;
+}
+
+static bool
+var_is_supported(TupleDesc tupdesc, Node *node)
+{
+	Var		   *var = (Var *) node;
+	Form_pg_attribute attr;
+
+	if (!IsA(node, Var) || var->varlevelsup != 0 ||
+		var->varattno <= 0 || var->varattno > tupdesc->natts)
+		return false;
+
+	attr = TupleDescAttr(tupdesc, var->varattno - 1);
+
+	return !attr->attisdropped &&
+		attr->atttypid == var->vartype &&
+		AOZoneMap_TypeIsSupported(var->vartype);
+}
+
+/*
+ * Turn a clause of the qual into a key, if it is "column op constant" with a
+ * btree comparison operator, or "column IS [NOT] NULL".
+ */
+static bool
+extract_key(TupleDesc tupdesc, Node *clause, AOZoneMapKey *key)
+{
+	if (IsA(clause, OpExpr))
+	{
+		OpExpr	   *opexpr = (OpExpr *) clause;
+		Node	   *leftop;
+		Node	   *rightop;
+		Var		   *var;
+		Const	   *con;
+		bool		varonleft;
+		TypeCacheEntry *typentry;
+		StrategyNumber strategy;
+
+		if (list_length(opexpr->args) != 2)
+			return false;
+
+		leftop = (Node *) linitial(opexpr->args);
+		rightop = (Node *) lsecond(opexpr->args);
+
+		if (var_is_supported(tupdesc, leftop) && IsA(rightop, Const))
+		{
+			var = (Var *) leftop;
+			con = (Const *) rightop;
+			varonleft = true;
+		}
+		else if (var_is_supported(tupdesc, rightop) && IsA(leftop, Const))
+		{
+			var = (Var *) rightop;
+			con = (Const *) leftop;
+			varonleft = false;
+		}
+		else
+			return false;
+
+		if (con->constisnull)
+			return false;
+
+		/*
+		 * Date/time values of different types don't compare as their
+		 * representation does, only the integer types mix.
+		 */
+		if (con->consttype != var->vartype &&
+			!((con->consttype == INT2OID || con->consttype == INT4OID ||
+			   con->consttype == INT8OID) &&
+			  (var->vartype == INT2OID || var->vartype == INT4OID ||
+			   var->vartype == INT8OID)))
+			return false;
+
+		typentry = lookup_type_cache(var->vartype, TYPECACHE_BTREE_OPFAMILY);
+		if (!OidIsValid(typentry->btree_opf))
+			return false;
+
+		strategy = get_op_opfamily_strategy(opexpr->opno, typentry->btree_opf);
+		if (strategy == InvalidStrategy)
+			return false;
+
+		key->attnum = var->varattno;
+		key->strategy = varonleft ? strategy : BTCommuteStrategyNumber(strategy);
+		key->isnull = false;
+		key->value = AOZoneMap_DatumGetValue(con->constvalue, con->constlen);
+
+		return true;
+	}
+	else if (IsA(clause, NullTest))
+	{
+		NullTest   *ntest = (NullTest *) clause;
+
+		if (ntest->argisrow || !var_is_supported(tupdesc, (Node *) ntest->arg))
+			return false;
+
+		key->attnum = ((Var *) ntest->arg)->varattno;
+		key->strategy = InvalidStrategy;
+		key->isnull = (ntest->nulltesttype == IS_NULL);
+		key->value = 0;
+
+		return true;
+	}
+
+	return false;
+}
+
+static void
+extract_keys(TupleDesc tupdesc, Node *clause, List **keys)
+{
+	AOZoneMapKey key;
+
+	if (clause == NULL)
+		return;
+
+	if (IsA(clause, List))
+	{
+		ListCell   *lc;
+
+		foreach(lc, (List *) clause)
+			extract_keys(tupdesc, (Node *) lfirst(lc), keys);
+	}
+	else if (is_andclause(clause))
+		extract_keys(tupdesc, (Node *) ((BoolExpr *) clause)->args, keys);
+	else if (extract_key(tupdesc, clause, &key))
+	{
+		AOZoneMapKey *k = palloc(sizeof(AOZoneMapKey));
+
+		*k = key;
+		*keys = lappend(*keys, k);
+	}
+}
+
+/*
+ * Set up a scan of an AO/AOCS relation to skip blocks using the zone maps.
+ *
+ * Returns NULL if zone maps are disabled, if the relation doesn't have them,
+ * or if none of the restrictions in the scan's qual can use them.
+ */
+AOZoneMapScan
+AOZoneMapScan_Begin(Relation aoRel, Snapshot appendOnlyMetaDataSnapshot,
+					List *qual)
+{
+	AOZoneMapScan zms;
+	List	   *keys = NIL;
+	ListCell   *lc;
+	Oid			blkdirrelid;
+	Relation	blkdirRel;
+	int			i;
+
+	if (!gp_appendonly_zone_maps || qual == NIL)
+		return NULL;
+
+	GetAppendOnlyEntryAuxOids(aoRel, NULL, &blkdirrelid, NULL);
+	if (!OidIsValid(blkdirrelid))
+		return NULL;
+
+	extract_keys(RelationGetDescr(aoRel), (Node *) qual, &keys);
+	if (keys == NIL)
+		return NULL;
+
+	/* Block directories created before zone maps don't have them */
+	blkdirRel = table_open(blkdirrelid, AccessShareLock);
+	if (RelationGetDescr(blkdirRel)->natts != Natts_pg_aoblkdir)
+	{
+		table_close(blkdirRel, AccessShareLock);
+		list_free_deep(keys);
+		return NULL;
+	}
+
+	zms = palloc0(sizeof(AOZoneMapScanData));
+	zms->aoRel = aoRel;
+	zms->appendOnlyMetaDataSnapshot = appendOnlyMetaDataSnapshot;
+	zms->isAOCol = RelationIsAoCols(aoRel);
+	zms->blkdirRel = blkdirRel;
+	zms->blkdirIdx = index_open(AppendonlyGetAuxIndex(blkdirRel), AccessShareLock);
+
+	zms->nkeys = list_length(keys);
+	zms->keys = palloc(zms->nkeys * sizeof(AOZoneMapKey));
+	i = 0;
+	foreach(lc, keys)
+		zms->keys[i++] = *(AOZoneMapKey *) lfirst(lc);
+	list_free_deep(keys);
+
+	zms->segmentContext = AllocSetContextCreate(CurrentMemoryContext,
+												"AO zone map scan",
+												ALLOCSET_SMALL_SIZES);
+
+	return zms;
+}
+
+static void
+add_excluded_range(AOZoneMapKeyRanges *keyRanges, int64 firstRowNum,
+				   int64 rowCount)
+{
+	AOZoneMapRange *last;
+
+	/* Merge with the previous range if they are adjacent */
+	if (keyRanges->nranges > 0)
+	{
+		last = &keyRanges->ranges[keyRanges->nranges - 1];
+		if (last->endRowNum == firstRowNum)
+		{
+			last->endRowNum += rowCount;
+			return;
+		}
+	}
+
+	if (keyRanges->nranges == keyRanges->maxranges)
+	{
+		keyRanges->maxranges = Max(keyRanges->maxranges * 2, 16);
+		if (keyRanges->ranges == NULL)
+			keyRanges->ranges = palloc(keyRanges->maxranges * sizeof(AOZoneMapRange));
+		else
+			keyRanges->ranges = repalloc(keyRanges->ranges,
+										 keyRanges->maxranges * sizeof(AOZoneMapRange));
+	}
+
+	last = &keyRanges->ranges[keyRanges->nranges++];
+	last->firstRowNum = firstRowNum;
+	last->endRowNum = firstRowNum + rowCount;
+}
+
+/*
+ * Collect the row ranges of segment file 'segno' whose synopsis refutes the
+ * key, in row number order.
+ */
+static void
+scan_key_ranges(AOZoneMapScan zms, int segno, int keyno)
+{
+	AOZoneMapKey *key = &zms->keys[keyno];
+	AOZoneMapKeyRanges *keyRanges = &zms->keyRanges[keyno];
+	TupleDesc	tupdesc = RelationGetDescr(zms->blkdirRel);
+	Datum		values[Natts_pg_aoblkdir];
+	bool		nulls[Natts_pg_aoblkdir];
+	ScanKeyData scanKey[2];
+	SysScanDesc indexScan;
+	HeapTuple	tuple;
+	int			columnGroupNo = zms->isAOCol ? key->attnum - 1 : 0;
+
+	ScanKeyInit(&scanKey[0],
+				Anum_pg_aoblkdir_segno,
+				BTEqualStrategyNumber,
+				F_INT4EQ,
+				Int32GetDatum(segno));
+	ScanKeyInit(&scanKey[1],
+				Anum_pg_aoblkdir_columngroupno,
+				BTEqualStrategyNumber,
+				F_INT4EQ,
+				Int32GetDatum(columnGroupNo));
+
+	indexScan = systable_beginscan_ordered(zms->blkdirRel,
+										   zms->blkdirIdx,
+										   zms->appendOnlyMetaDataSnapshot,
+										   2 /* nkeys */,
+										   scanKey);
+
+	while ((tuple = systable_getnext_ordered(indexScan, ForwardScanDirection)) != NULL)
+	{
+		Minipage   *minipage;
+		AOZoneMap  *zonemap;
+
+		heap_deform_tuple(tuple, tupdesc, values, nulls);
+
+		if (nulls[Anum_pg_aoblkdir_zonemap - 1])
+			continue;
+
+		minipage = (Minipage *)
+			pg_detoast_datum_copy((struct varlena *) DatumGetPointer(values[Anum_pg_aoblkdir_minipage - 1]));
+		zonemap = (AOZoneMap *)
+			pg_detoast_datum_copy((struct varlena *) DatumGetPointer(values[Anum_pg_aoblkdir_zonemap - 1]));
+
+		if (zonemap->version == AOZONEMAP_VERSION &&
+			zonemap->nEntry == minipage->nEntry)
+		{
+			for (uint32 i = 0; i < minipage->nEntry; i++)
+			{
+				for (uint32 j = 0; j < zonemap->nAtts; j++)
+				{
+					AOZoneMapEntry *entry = &zonemap->entry[i * zonemap->nAtts + j];
+
+					if (entry->attnum != key->attnum)
+						continue;
+
+					if (AOZoneMapEntry_Excludes(entry, key))
+						add_excluded_range(keyRanges,
+										   minipage->entry[i].firstRowNum,
+										   minipage->entry[i].rowCount);
+					break;
+				}
+			}
+		}
+
+		pfree(minipage);
+		pfree(zonemap);
+	}
+
+	systable_endscan_ordered(indexScan);
+}
+
+/*
+ * Load the ranges of rows to skip in segment file 'segno', which the scan is
+ * about to read.
+ */
+void
+AOZoneMapScan_BeginSegment(AOZoneMapScan zms, int segno)
+{
+	MemoryContext oldcxt;
+
+	MemoryContextReset(zms->segmentContext);
+	oldcxt = MemoryContextSwitchTo(zms->segmentContext);
+
+	zms->keyRanges = palloc0(zms->nkeys * sizeof(AOZoneMapKeyRanges));
+	for (int keyno = 0; keyno < zms->nkeys; keyno++)
+		scan_key_ranges(zms, segno, keyno);
+
+	MemoryContextSwitchTo(oldcxt);
+}
+
+/*
+ * Returns the first row number at or after rowNum that isn't in a range that
+ * some key excludes.  The scan must ask for non-decreasing row numbers within
+ * a segment file.
+ */
+int64
+AOZoneMapScan_SkipTo(AOZoneMapScan zms, int64 rowNum)
+{
+	bool		moved;
+
+	do
+	{
+		moved = false;
+
+		for (int keyno = 0; keyno < zms->nkeys; keyno++)
+		{
+			AOZoneMapKeyRanges *keyRanges = &zms->keyRanges[keyno];
+
+			while (keyRanges->cur < keyRanges->nranges &&
+				   keyRanges->ranges[keyRanges->cur].endRowNum <= rowNum)
+				keyRanges->cur++;
+
+			if (keyRanges->cur < keyRanges->nranges &&
+				keyRanges->ranges[keyRanges->cur].firstRowNum <= rowNum)
+			{
+				rowNum = keyRanges->ranges[keyRanges->cur].endRowNum;
+				moved = true;
+			}
+		}
+	} while (moved);
+
+	return rowNum;
+}
+
+/*
+ * Returns the first row number after rowNum that is in a range that some key
+ * excludes, or PG_INT64_MAX if there's none.  rowNum itself must not be
+ * excluded.
+ */
+int64
+AOZoneMapScan_NextExcluded(AOZoneMapScan zms, int64 rowNum)
+{
+	int64		next = PG_INT64_MAX;
+
+	for (int keyno = 0; keyno < zms->nkeys; keyno++)
+	{
+		AOZoneMapKeyRanges *keyRanges = &zms->keyRanges[keyno];
+
+		while (keyRanges->cur < keyRanges->nranges &&
+			   keyRanges->ranges[keyRanges->cur].endRowNum <= rowNum)
+			keyRanges->cur++;
+
+		if (keyRanges->cur < keyRanges->nranges)
+		{
+			Assert(keyRanges->ranges[keyRanges->cur].firstRowNum > rowNum);
+			next = Min(next, keyRanges->ranges[keyRanges->cur].firstRowNum);
+		}
+	}
+
+	return next;
+}
+
+void
+AOZoneMapScan_End(AOZoneMapScan zms)
+{
+	index_close(zms->blkdirIdx, AccessShareLock);
+	table_close(zms->blkdirRel, AccessShareLock);
+
+	MemoryContextDelete(zms->segmentContext);
+	pfree(zms->keys);
+	pfree(zms);
+}
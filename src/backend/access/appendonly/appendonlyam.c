@@ -115,6 +115,7 @@ initscan(AppendOnlyScanDesc scan, ScanKey key)
 	scan->aos_need_new_segfile = true;	/* need to assign a file to be scanned */
 	scan->aos_done_all_segfiles = false;
 	scan->needNextBuffer = true;
+	scan->needBlockContents = false;
 
 	if (scan->initedStorageRoutines)
 		AppendOnlyExecutorReadBlock_ResetCounts(
@@ -271,6 +272,9 @@ SetNextFileSegForRead(AppendOnlyScanDesc scan)
 												 &scan->executorReadBlock,
 												  /* blockFirstRowNum */ 1);
 
+	if (scan->zoneMapScan)
+		AOZoneMapScan_BeginSegment(scan->zoneMapScan, segno);
+
 	/* ready to go! */
 	scan->aos_need_new_segfile = false;
 
@@ -1114,9 +1118,11 @@ AppendOnlyExecutorReadBlock_FetchTuple(AppendOnlyExecutorReadBlock *executorRead
 
 /*
  * You can think of this scan routine as get next "executor" AO block.
+ *
+ * This only positions the scan on the block; getBlockContents() reads it.
  */
 static bool
-getNextBlock(AppendOnlyScanDesc scan)
+getNextBlockInfo(AppendOnlyScanDesc scan)
 {
 	if (scan->aos_need_new_segfile)
 	{
@@ -1142,6 +1148,30 @@ getNextBlock(AppendOnlyScanDesc scan)
 		return false;
 	}
 
+	/*
+	 * Skip over the varblocks that the zone maps prove to have no row
+	 * satisfying the qual, without reading their content.
+	 */
+	while (scan->zoneMapScan != NULL &&
+		   AOZoneMapScan_SkipTo(scan->zoneMapScan,
+								scan->executorReadBlock.blockFirstRowNum) >=
+		   scan->executorReadBlock.blockFirstRowNum + scan->executorReadBlock.rowCount)
+	{
+		Assert(scan->blockDirectory == NULL);
+
+		AppendOnlyExecutionReadBlock_FinishedScanBlock(&scan->executorReadBlock);
+		AppendOnlyStorageRead_SkipCurrentBlock(&scan->storageRead);
+		scan->rs_base.rs_nblocks_skipped++;
+
+		if (!AppendOnlyExecutorReadBlock_GetBlockInfo(&scan->storageRead,
+													  &scan->executorReadBlock))
+		{
+			CloseScannedFileSeg(scan);
+
+			return false;
+		}
+	}
+
 	if (scan->blockDirectory)
 	{
 		AppendOnlyBlockDirectory_InsertEntry(
@@ -1151,12 +1181,31 @@ getNextBlock(AppendOnlyScanDesc scan)
 			scan->executorReadBlock.rowCount);
 	}
 
+	return true;
+}
+
+/*
+ * Read the content of the varblock that getNextBlockInfo() positioned the
+ * scan on.
+ */
+static void
+getBlockContents(AppendOnlyScanDesc scan)
+{
 	AppendOnlyExecutorReadBlock_GetContents(
 											&scan->executorReadBlock);
 
 	AppendOnlyScanDesc_UpdateTotalBytesRead(scan);
 	pgstat_count_buffer_read_ao(scan->aos_rd,
 								RelationGuessNumberOfBlocksFromSize(scan->totalBytesRead));
+}
+
+static bool
+getNextBlock(AppendOnlyScanDesc scan)
+{
+	if (!getNextBlockInfo(scan))
+		return false;
+
+	getBlockContents(scan);
 
 	return true;
 }
@@ -1606,6 +1655,24 @@ setupNextWriteBlock(AppendOnlyInsertDesc aoInsertDesc)
 	aoInsertDesc->bufferCount++;
 }
 
+/*
+ * Add a tuple's values to the synopses of the current varblock.
+ */
+static void
+addToZoneMap(AppendOnlyInsertDesc aoInsertDesc, MemTuple tuple)
+{
+	for (int i = 0; i < aoInsertDesc->zonemapNAtts; i++)
+	{
+		Datum		d;
+		bool		isnull;
+
+		d = memtuple_getattr(tuple, aoInsertDesc->mt_bind,
+							 aoInsertDesc->zonemapAtts[i], &isnull);
+		AOZoneMapEntry_AddDatum(&aoInsertDesc->zonemap[i], d, isnull,
+								aoInsertDesc->zonemapTypLens[i]);
+	}
+}
+
 static void
 finishWriteBlock(AppendOnlyInsertDesc aoInsertDesc)
 {
@@ -1659,13 +1726,18 @@ finishWriteBlock(AppendOnlyInsertDesc aoInsertDesc)
 			itemCount,
 			aoInsertDesc->bufferCount);
 
-	/* Insert an entry to the block directory */
-	AppendOnlyBlockDirectory_InsertEntry(
+	/* Insert an entry, and the varblock's synopses, to the block directory */
+	AppendOnlyBlockDirectory_InsertEntryWithZoneMap(
 		&aoInsertDesc->blockDirectory,
 		0,
 		aoInsertDesc->blockFirstRowNum,
 		AppendOnlyStorageWrite_LogicalBlockStartOffset(&aoInsertDesc->storageWrite),
-		itemCount);
+		itemCount,
+		aoInsertDesc->zonemap,
+		aoInsertDesc->zonemapNAtts);
+
+	for (int i = 0; i < aoInsertDesc->zonemapNAtts; i++)
+		AOZoneMapEntry_Init(&aoInsertDesc->zonemap[i], aoInsertDesc->zonemapAtts[i]);
 
 	Assert(aoInsertDesc->nonCompressedData == NULL);
 	Assert(!AppendOnlyStorageWrite_IsBufferAllocated(&aoInsertDesc->storageWrite));
@@ -1944,6 +2016,34 @@ appendonly_beginscan(Relation relation,
 	return (TableScanDesc) aoscan;
 }
 
+/* ----------------
+ *		appendonly_beginscan_extractcolumns	- begin a sequential scan
+ *
+ * Like appendonly_beginscan(), but also looks at the scan's qual, to skip the
+ * varblocks that the zone maps prove to have no matching rows.
+ * ----------------
+ */
+TableScanDesc
+appendonly_beginscan_extractcolumns(Relation rel,
+									Snapshot snapshot,
+									List *targetlist,
+									List *qual,
+									bool *proj,
+									List *constraintList,
+									uint32 flags)
+{
+	AppendOnlyScanDesc aoscan;
+
+	aoscan = (AppendOnlyScanDesc) appendonly_beginscan(rel, snapshot,
+													   0, NULL, NULL, flags);
+
+	aoscan->zoneMapScan = AOZoneMapScan_Begin(rel,
+											  aoscan->appendOnlyMetaDataSnapshot,
+											  qual);
+
+	return (TableScanDesc) aoscan;
+}
+
 /* ----------------
  *		appendonly_rescan		- restart a relation scan
  *
@@ -2069,6 +2169,9 @@ appendonly_endscan(TableScanDesc scan)
 	if (aoscan->blkdirscan != NULL)
 		appendonly_blkdirscan_finish(aoscan);
 
+	if (aoscan->zoneMapScan != NULL)
+		AOZoneMapScan_End(aoscan->zoneMapScan);
+
 	if (aoscan->aofetch)
 	{
 		appendonly_fetch_finish(aoscan->aofetch);
@@ -2107,6 +2210,88 @@ appendonly_getnextslot(TableScanDesc scan, ScanDirection direction, TupleTableSl
 	}
 }
 
+/* ----------------
+ *		appendonly_getnextblock - position the scan on its next varblock
+ *
+ * The varblock's content isn't read, so that compaction can copy the
+ * varblock as it is stored (see appendonly_insert_block()).  Its tuples are
+ * returned by appendonly_getnextblockslot().  Don't mix these with
+ * appendonly_getnextslot() in the same scan.
+ *
+ * Returns false when there are no more varblocks.
+ * ----------------
+ */
+bool
+appendonly_getnextblock(AppendOnlyScanDesc scan)
+{
+	/* Done with the current varblock, even if its tuples weren't all read */
+	if (!scan->needNextBuffer)
+	{
+		if (scan->needBlockContents)
+			AppendOnlyStorageRead_SkipCurrentBlock(&scan->storageRead);
+		AppendOnlyExecutionReadBlock_FinishedScanBlock(&scan->executorReadBlock);
+		scan->needNextBuffer = true;
+	}
+
+	while (!getNextBlockInfo(scan))
+	{
+		/* have we read all this relation's data. done! */
+		if (scan->aos_done_all_segfiles)
+			return false;
+	}
+
+	scan->needNextBuffer = false;
+	scan->needBlockContents = true;
+
+	return true;
+}
+
+/* ----------------
+ *		appendonly_getnextblockslot - retrieve next tuple of the varblock
+ *
+ * Returns the tuples of the varblock that appendonly_getnextblock()
+ * positioned the scan on, reading its content first if needed.  Returns
+ * false at the end of the varblock.
+ * ----------------
+ */
+bool
+appendonly_getnextblockslot(AppendOnlyScanDesc scan, TupleTableSlot *slot)
+{
+	bool		isSnapshotAny = (scan->snapshot == SnapshotAny);
+
+	if (scan->needNextBuffer)
+	{
+		ExecClearTuple(slot);
+		return false;
+	}
+
+	if (scan->needBlockContents)
+	{
+		getBlockContents(scan);
+		scan->needBlockContents = false;
+	}
+
+	while (AppendOnlyExecutorReadBlock_ScanNextTuple(&scan->executorReadBlock,
+													 scan->rs_base.rs_nkeys,
+													 scan->aos_key,
+													 slot))
+	{
+		AOTupleId  *aoTupleId = (AOTupleId *) &slot->tts_tid;
+
+		if (isSnapshotAny || AppendOnlyVisimap_IsVisible(&scan->visibilityMap, aoTupleId))
+		{
+			pgstat_count_heap_getnext(scan->aos_rd);
+			return true;
+		}
+	}
+
+	/* no more items in the varblock */
+	scan->needNextBuffer = true;
+	ExecClearTuple(slot);
+
+	return false;
+}
+
 static void
 closeFetchSegmentFile(AppendOnlyFetchDesc aoFetchDesc)
 {
@@ -3178,6 +3363,26 @@ aoInsertDesc->appendOnlyMetaDataSnapshot, //CONCERN:Safe to assume all block dir
 											aoInsertDesc->fsInfo, aoInsertDesc->lastSequence,
 											rel, segno, 1, false);
 
+	/*
+	 * Summarize the varblocks in the zone map, if the block directory records
+	 * one (see init_zonemaps()).
+	 */
+	if (aoInsertDesc->blockDirectory.minipages != NULL &&
+		aoInsertDesc->blockDirectory.minipages[0].zonemap != NULL)
+	{
+		TupleDesc	tupdesc = RelationGetDescr(rel);
+
+		aoInsertDesc->zonemapNAtts =
+			AOZoneMap_SummarizedAtts(tupdesc, aoInsertDesc->zonemapAtts);
+		for (int i = 0; i < aoInsertDesc->zonemapNAtts; i++)
+		{
+			AttrNumber	attnum = aoInsertDesc->zonemapAtts[i];
+
+			aoInsertDesc->zonemapTypLens[i] = TupleDescAttr(tupdesc, attnum - 1)->attlen;
+			AOZoneMapEntry_Init(&aoInsertDesc->zonemap[i], attnum);
+		}
+	}
+
 	return aoInsertDesc;
 }
 
@@ -3344,6 +3549,12 @@ appendonly_insert(AppendOnlyInsertDesc aoInsertDesc,
 
 		if (itemLen > 0)
 			memcpy(itemPtr, tup, itemLen);
+
+		/*
+		 * Add the tuple to the varblock's synopses. Large content isn't
+		 * summarized: it has no block directory entry of its own.
+		 */
+		addToZoneMap(aoInsertDesc, instup);
 	}
 	else
 	{
@@ -3412,6 +3623,174 @@ appendonly_insert(AppendOnlyInsertDesc aoInsertDesc,
 		pfree(tup);
 }
 
+/*
+ *	appendonly_insert_block	- copy a varblock as it is stored
+ *
+ * Appends the varblock that appendonly_getnextblock() positioned 'scan' on
+ * to the segment file being inserted into, without decompressing and
+ * compressing its content again.  The varblock gets new row numbers,
+ * starting at *firstRowNum, and its own block directory entry.
+ *
+ * This is for compaction: the caller has checked that the visimap hides
+ * none of the varblock's tuples.  The tuples can still be read with
+ * appendonly_getnextblockslot() afterwards, to insert index entries for
+ * their new TIDs.
+ *
+ * Returns false, without inserting anything, when the varblock can't be
+ * copied as it is.  The caller then inserts its tuples one by one.
+ */
+bool
+appendonly_insert_block(AppendOnlyInsertDesc aoInsertDesc,
+						AppendOnlyScanDesc scan,
+						int64 *firstRowNum)
+{
+	AppendOnlyExecutorReadBlock *readBlock = &scan->executorReadBlock;
+	int			natts = RelationGetDescr(aoInsertDesc->aoi_rel)->natts;
+	uint8	   *content;
+	int32		contentLen;
+
+	Assert(!scan->needNextBuffer);
+	Assert(scan->needBlockContents);
+
+	/*
+	 * Large rows span several storage blocks, and the formats of older
+	 * segment files are converted while they are read.
+	 */
+	if (readBlock->isLarge ||
+		scan->storageRead.formatVersion != aoInsertDesc->storageWrite.formatVersion)
+		return false;
+
+	/*
+	 * The tuples are copied as they are, so they must have all the
+	 * attributes, not rely on the missing values of columns that were added
+	 * later to this segment file's rows.  Row numbers only grow, so it's
+	 * enough to look at the first row.
+	 */
+	for (int attno = 1; attno < natts; attno++)
+	{
+		if (AO_ATTR_VAL_IS_MISSING(readBlock->blockFirstRowNum, attno,
+								   readBlock->segmentFileNum,
+								   readBlock->attnum_to_rownum))
+			return false;
+	}
+
+	/* Finish the varblock that the rows inserted so far went into */
+	finishWriteBlock(aoInsertDesc);
+	Assert(aoInsertDesc->nonCompressedData == NULL);
+	Assert(!AppendOnlyStorageWrite_IsBufferAllocated(&aoInsertDesc->storageWrite));
+
+	/* Make sure the row numbers are reserved, and keep some to spare */
+	if (aoInsertDesc->numSequences <= readBlock->rowCount)
+	{
+		int64		numSequences;
+		int64 firstSequence PG_USED_FOR_ASSERTS_ONLY;
+
+		numSequences = readBlock->rowCount - aoInsertDesc->numSequences + NUM_FAST_SEQUENCES;
+		firstSequence = GetFastSequences(aoInsertDesc->segrelid,
+										 aoInsertDesc->cur_segno,
+										 numSequences);
+		Assert(firstSequence == aoInsertDesc->lastSequence + aoInsertDesc->numSequences + 1);
+		aoInsertDesc->numSequences += numSequences;
+	}
+
+	*firstRowNum = aoInsertDesc->lastSequence + 1;
+	AppendOnlyStorageWrite_SetFirstRowNum(&aoInsertDesc->storageWrite,
+										  *firstRowNum);
+
+	/*
+	 * To verify the written block, the storage layer needs the content the
+	 * block decompresses to, so the varblock is read after all.
+	 */
+	if (gp_appendonly_verify_write_block)
+	{
+		getBlockContents(scan);
+		scan->needBlockContents = false;
+	}
+
+	content = AppendOnlyStorageRead_GetRawContent(&scan->storageRead,
+												  &contentLen);
+
+	aoInsertDesc->storageWrite.logicalBlockStartOffset =
+		BufferedAppendNextBufferPosition(&(aoInsertDesc->storageWrite.bufferedAppend));
+
+	if (!AppendOnlyStorageWrite_RawContent(&aoInsertDesc->storageWrite,
+										   content,
+										   gp_appendonly_verify_write_block ? readBlock->dataBuffer : NULL,
+										   readBlock->dataLen,
+										   readBlock->isCompressed ? contentLen : 0,
+										   readBlock->executorBlockKind,
+										   readBlock->rowCount))
+	{
+		setupNextWriteBlock(aoInsertDesc);
+		return false;
+	}
+
+	aoInsertDesc->insertCount += readBlock->rowCount;
+	aoInsertDesc->lastSequence += readBlock->rowCount;
+	aoInsertDesc->numSequences -= readBlock->rowCount;
+	aoInsertDesc->varblockCount++;
+	aoInsertDesc->bufferCount++;
+	Assert(aoInsertDesc->numSequences > 0);
+
+	/*
+	 * The synopses need the values, so the varblock is read after all. It's
+	 * still not compressed again, and the caller gets its tuples without
+	 * reading it another time.
+	 */
+	if (aoInsertDesc->zonemapNAtts > 0)
+	{
+		if (scan->needBlockContents)
+		{
+			getBlockContents(scan);
+			scan->needBlockContents = false;
+		}
+
+		if (readBlock->executorBlockKind == AoExecutorBlockKind_SingleRow)
+			addToZoneMap(aoInsertDesc, (MemTuple) readBlock->singleRow);
+		else
+		{
+			VarBlockReader varBlockReader;
+			uint8	   *itemPtr;
+			int			itemLen;
+
+			VarBlockReaderInit(&varBlockReader,
+							   readBlock->dataBuffer,
+							   readBlock->dataLen);
+			while ((itemPtr = VarBlockReaderGetNextItemPtr(&varBlockReader,
+														   &itemLen)) != NULL)
+			{
+				if (itemLen > 0)
+					addToZoneMap(aoInsertDesc, (MemTuple) itemPtr);
+			}
+		}
+	}
+
+	AppendOnlyBlockDirectory_InsertEntryWithZoneMap(
+		&aoInsertDesc->blockDirectory,
+		0,
+		*firstRowNum,
+		AppendOnlyStorageWrite_LogicalBlockStartOffset(&aoInsertDesc->storageWrite),
+		readBlock->rowCount,
+		aoInsertDesc->zonemap,
+		aoInsertDesc->zonemapNAtts);
+
+	for (int i = 0; i < aoInsertDesc->zonemapNAtts; i++)
+		AOZoneMapEntry_Init(&aoInsertDesc->zonemap[i], aoInsertDesc->zonemapAtts[i]);
+
+	elogif(Debug_appendonly_print_insert, LOG,
+		   "Append-only insert copied block for table '%s' "
+		   "(first row number " INT64_FORMAT ", item count %d, block count " INT64_FORMAT ")",
+		   NameStr(aoInsertDesc->aoi_rel->rd_rel->relname),
+		   *firstRowNum,
+		   readBlock->rowCount,
+		   aoInsertDesc->bufferCount);
+
+	/* Carry on inserting rows into a new varblock */
+	setupNextWriteBlock(aoInsertDesc);
+
+	return true;
+}
+
 /*
  * appendonly_insert_finish
  *
@@ -2415,6 +2415,7 @@ static const TableAmRoutine ao_row_methods = {
 	.slot_callbacks = appendonly_slot_callbacks,
 
 	.scan_begin = appendonly_beginscan,
+	.scan_begin_extractcolumns = appendonly_beginscan_extractcolumns,
 	.scan_end = appendonly_endscan,
 	.scan_rescan = appendonly_rescan,
 	.scan_getnextslot = appendonly_getnextslot,
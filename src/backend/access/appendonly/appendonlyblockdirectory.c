@@ -50,6 +50,9 @@ static void extract_minipage(
 				 HeapTuple tuple,
 				 TupleDesc tupleDesc,
 				 int columnGroupNo);
+static void copy_out_zonemap(MinipagePerColumnGroup *minipageInfo,
+							 Datum zonemap_value,
+							 bool zonemap_isnull);
 static void write_minipage(AppendOnlyBlockDirectory *blockDirectory,
 			   int columnGroupNo,
 			   MinipagePerColumnGroup *minipageInfo);
@@ -58,8 +61,11 @@ insert_new_entry(AppendOnlyBlockDirectory *blockDirectory,
 				 int columnGroupNo,
 				 int64 firstRowNum,
 				 int64 fileOffset,
-				 int64 rowCount);
+				 int64 rowCount,
+				 const AOZoneMapEntry *synopses,
+				 int nsynopses);
 static void clear_minipage(MinipagePerColumnGroup *minipagePerColumnGroup);
+static void init_zonemaps(AppendOnlyBlockDirectory *blockDirectory);
 
 static int findFileSegInfo(AppendOnlyBlockDirectory *blockDirectory,
 						   int segmentFileNum);
@@ -121,6 +127,7 @@ init_internal(AppendOnlyBlockDirectory *blockDirectory)
 	heapTupleDesc = RelationGetDescr(blockDirectory->blkdirRel);
 	blockDirectory->values = palloc0(sizeof(Datum) * heapTupleDesc->natts);
 	blockDirectory->nulls = palloc0(sizeof(bool) * heapTupleDesc->natts);
+	blockDirectory->hasZoneMaps = (heapTupleDesc->natts >= Anum_pg_aoblkdir_zonemap);
 	blockDirectory->numScanKeys = 3;
 	numScanKeys = blockDirectory->numScanKeys;
 	blockDirectory->scanKeys = palloc0(numScanKeys * sizeof(ScanKeyData));
@@ -150,6 +157,61 @@ init_internal(AppendOnlyBlockDirectory *blockDirectory)
 		minipageInfo->numMinipageEntries = 0;
 		ItemPointerSetInvalid(&minipageInfo->tupleTid);
 		minipageInfo->cached_entry_no = InvalidEntryNum;
+		minipageInfo->zonemap = NULL;
+	}
+
+	MemoryContextSwitchTo(oldcxt);
+}
+
+/*
+ * init_zonemaps
+ *
+ * Allocate the in-memory synopses of the minipages, for the block directories
+ * with zone maps that are open for writing while gp_appendonly_zone_maps is
+ * on.  With the GUC off, no synopses are recorded, and a minipage that is
+ * written again loses those it had.
+ *
+ * Each entry of a column-oriented table's minipage only has a synopsis of its
+ * own column, if its type has one, while row-oriented tables keep one for each
+ * of the columns picked by AOZoneMap_SummarizedAtts().
+ */
+static void
+init_zonemaps(AppendOnlyBlockDirectory *blockDirectory)
+{
+	TupleDesc	tupdesc = RelationGetDescr(blockDirectory->aoRel);
+	MemoryContext oldcxt;
+	uint32		nAtts;
+
+	if (!blockDirectory->hasZoneMaps || !gp_appendonly_zone_maps)
+		return;
+
+	if (blockDirectory->isAOCol)
+		nAtts = 1;
+	else
+	{
+		AttrNumber	attnums[AOZONEMAP_MAX_ROW_ATTS];
+
+		nAtts = AOZoneMap_SummarizedAtts(tupdesc, attnums);
+		if (nAtts == 0)
+			return;
+	}
+
+	oldcxt = MemoryContextSwitchTo(blockDirectory->memoryContext);
+
+	for (int i = 0; i < blockDirectory->num_proj_atts; i++)
+	{
+		AttrNumber	groupNo = blockDirectory->proj_atts[i];
+		MinipagePerColumnGroup *minipageInfo =
+			&blockDirectory->minipages[groupNo];
+
+		if (blockDirectory->isAOCol &&
+			!AOZoneMap_TypeIsSupported(TupleDescAttr(tupdesc, groupNo)->atttypid))
+			continue;
+
+		minipageInfo->zonemap =
+			palloc0(AOZoneMapSize(NUM_MINIPAGE_ENTRIES, nAtts));
+		minipageInfo->zonemap->version = AOZONEMAP_VERSION;
+		minipageInfo->zonemap->nAtts = nAtts;
 	}
 
 	MemoryContextSwitchTo(oldcxt);
@@ -463,6 +525,8 @@ AppendOnlyBlockDirectory_Init_forInsert(
 
 	init_internal(blockDirectory);
 
+	init_zonemaps(blockDirectory);
+
 	ereportif(Debug_appendonly_print_blockdirectory, LOG,
 			  (errmsg("Append-only block directory init for insert: "
 					  "(segno, numColumnGroups, isAOCol, lastSequence)="
@@ -540,6 +604,8 @@ AppendOnlyBlockDirectory_Init_writeCols(
 	init_internal_proj(blockDirectory, NULL, false);
 
 	init_internal(blockDirectory);
+
+	init_zonemaps(blockDirectory);
 }
 
 static bool
@@ -1249,7 +1315,27 @@ AppendOnlyBlockDirectory_InsertEntry(AppendOnlyBlockDirectory *blockDirectory,
 									 int64 rowCount)
 {
 	return insert_new_entry(blockDirectory, columnGroupNo, firstRowNum,
-							fileOffset, rowCount);
+							fileOffset, rowCount, NULL, 0);
+}
+
+/*
+ * AppendOnlyBlockDirectory_InsertEntryWithZoneMap
+ *
+ * Like AppendOnlyBlockDirectory_InsertEntry(), but also record the synopses
+ * of the block's values, for the columns that have one. They are only kept
+ * if the block directory has zone maps.
+ */
+bool
+AppendOnlyBlockDirectory_InsertEntryWithZoneMap(AppendOnlyBlockDirectory *blockDirectory,
+												int columnGroupNo,
+												int64 firstRowNum,
+												int64 fileOffset,
+												int64 rowCount,
+												const AOZoneMapEntry *synopses,
+												int nsynopses)
+{
+	return insert_new_entry(blockDirectory, columnGroupNo, firstRowNum,
+							fileOffset, rowCount, synopses, nsynopses);
 }
 
 /*
@@ -1314,7 +1400,9 @@ insert_new_entry(AppendOnlyBlockDirectory *blockDirectory,
 				 int columnGroupNo,
 				 int64 firstRowNum,
 				 int64 fileOffset,
-				 int64 rowCount)
+				 int64 rowCount,
+				 const AOZoneMapEntry *synopses,
+				 int nsynopses)
 {
 	MinipageEntry *entry = NULL;
 	MinipagePerColumnGroup *minipageInfo;
@@ -1350,6 +1438,19 @@ insert_new_entry(AppendOnlyBlockDirectory *blockDirectory,
 	entry->fileOffset = fileOffset;
 	entry->rowCount = rowCount;
 
+	if (minipageInfo->zonemap != NULL)
+	{
+		AOZoneMap  *zonemap = minipageInfo->zonemap;
+		AOZoneMapEntry *synopsis =
+			&zonemap->entry[minipageInfo->numMinipageEntries * zonemap->nAtts];
+
+		/* Entries without a synopsis, e.g. placeholders, never skip a block */
+		MemSet(synopsis, 0, zonemap->nAtts * sizeof(AOZoneMapEntry));
+		if (synopses != NULL)
+			memcpy(synopsis, synopses,
+				   Min(nsynopses, (int) zonemap->nAtts) * sizeof(AOZoneMapEntry));
+	}
+
 	minipageInfo->numMinipageEntries++;
 
 	ereportif(Debug_appendonly_print_blockdirectory, LOG,
@@ -1507,9 +1608,49 @@ extract_minipage(AppendOnlyBlockDirectory *blockDirectory,
 					  values[Anum_pg_aoblkdir_minipage - 1],
 					  nulls[Anum_pg_aoblkdir_minipage - 1]);
 
+	if (minipageInfo->zonemap != NULL)
+		copy_out_zonemap(minipageInfo,
+						 values[Anum_pg_aoblkdir_zonemap - 1],
+						 nulls[Anum_pg_aoblkdir_zonemap - 1]);
+
 	ItemPointerCopy(&tuple->t_self, &minipageInfo->tupleTid);
 }
 
+/*
+ * copy_out_zonemap
+ *
+ * Copy out the synopses of the minipage that was just copied out. They are
+ * all left invalid if the row has none, or they don't match the layout we
+ * write.
+ */
+static void
+copy_out_zonemap(MinipagePerColumnGroup *minipageInfo,
+				 Datum zonemap_value,
+				 bool zonemap_isnull)
+{
+	AOZoneMap  *zonemap = minipageInfo->zonemap;
+
+	MemSet(zonemap->entry, 0,
+		   AOZoneMapSize(minipageInfo->numMinipageEntries, zonemap->nAtts) -
+		   offsetof(AOZoneMap, entry));
+
+	if (!zonemap_isnull)
+	{
+		struct varlena *value = (struct varlena *) DatumGetPointer(zonemap_value);
+		AOZoneMap  *detoast_value = (AOZoneMap *) pg_detoast_datum(value);
+
+		if (detoast_value->version == AOZONEMAP_VERSION &&
+			detoast_value->nAtts == zonemap->nAtts &&
+			detoast_value->nEntry == minipageInfo->numMinipageEntries)
+			memcpy(zonemap->entry, detoast_value->entry,
+				   AOZoneMapSize(detoast_value->nEntry, detoast_value->nAtts) -
+				   offsetof(AOZoneMap, entry));
+
+		if ((struct varlena *) detoast_value != value)
+			pfree(detoast_value);
+	}
+}
+
 /*
  * load_last_minipage
  *
@@ -1697,6 +1838,35 @@ write_minipage(AppendOnlyBlockDirectory *blockDirectory,
 		PointerGetDatum(minipageInfo->minipage);
 	nulls[Anum_pg_aoblkdir_minipage - 1] = false;
 
+	if (blockDirectory->hasZoneMaps)
+	{
+		AOZoneMap  *zonemap = minipageInfo->zonemap;
+		bool		hasSynopsis = false;
+
+		/* Don't bother storing the zone map if no entry has a synopsis */
+		if (zonemap != NULL)
+		{
+			uint32		nsynopses = minipageInfo->numMinipageEntries * zonemap->nAtts;
+
+			for (uint32 i = 0; i < nsynopses && !hasSynopsis; i++)
+				hasSynopsis = (zonemap->entry[i].flags & AOZONEMAP_VALID) != 0;
+		}
+
+		if (hasSynopsis)
+		{
+			SET_VARSIZE(zonemap,
+						AOZoneMapSize(minipageInfo->numMinipageEntries, zonemap->nAtts));
+			zonemap->nEntry = minipageInfo->numMinipageEntries;
+			values[Anum_pg_aoblkdir_zonemap - 1] = PointerGetDatum(zonemap);
+			nulls[Anum_pg_aoblkdir_zonemap - 1] = false;
+		}
+		else
+		{
+			values[Anum_pg_aoblkdir_zonemap - 1] = (Datum) 0;
+			nulls[Anum_pg_aoblkdir_zonemap - 1] = true;
+		}
+	}
+
 	tuple = heaptuple_form_to(heapTupleDesc,
 							  values,
 							  nulls,
@@ -1747,6 +1917,11 @@ clear_minipage(MinipagePerColumnGroup *minipagePerColumnGroup)
 {
 	MemSet(minipagePerColumnGroup->minipage->entry, 0,
 		   minipagePerColumnGroup->numMinipageEntries * sizeof(MinipageEntry));
+	if (minipagePerColumnGroup->zonemap != NULL)
+		MemSet(minipagePerColumnGroup->zonemap->entry, 0,
+			   AOZoneMapSize(minipagePerColumnGroup->numMinipageEntries,
+							 minipagePerColumnGroup->zonemap->nAtts) -
+			   offsetof(AOZoneMap, entry));
 	minipagePerColumnGroup->numMinipageEntries = 0;
 	ItemPointerSetInvalid(&minipagePerColumnGroup->tupleTid);
 	minipagePerColumnGroup->cached_entry_no = InvalidEntryNum;
@@ -1811,7 +1986,7 @@ AppendOnlyBlockDirectory_InsertPlaceholder(AppendOnlyBlockDirectory *blockDirect
 
 	/* insert placeholder entry with a max row count */
 	insert_new_entry(blockDirectory, columnGroupNo, firstRowNum, fileOffset,
-					 AOTupleId_MaxRowNum);
+					 AOTupleId_MaxRowNum, NULL, 0);
 	/* insert placeholder row containing placeholder entry */
 	write_minipage(blockDirectory, columnGroupNo, minipagePerColumnGroup);
 	/*
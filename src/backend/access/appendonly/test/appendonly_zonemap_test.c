@@ -0,0 +1,164 @@
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include "cmockery.h"
+
+#include "postgres.h"
+#include "utils/memutils.h"
+
+#include "../appendonly_zonemap.c"
+
+static AOZoneMapKey
+make_key(AttrNumber attnum, StrategyNumber strategy, int64 value)
+{
+	AOZoneMapKey key;
+
+	key.attnum = attnum;
+	key.strategy = strategy;
+	key.isnull = false;
+	key.value = value;
+
+	return key;
+}
+
+static void
+test__AOZoneMapEntry_AddDatum(void **state)
+{
+	AOZoneMapEntry entry;
+
+	AOZoneMapEntry_Init(&entry, 2);
+	assert_int_equal(entry.flags, AOZONEMAP_VALID);
+
+	AOZoneMapEntry_AddDatum(&entry, (Datum) 0, true, sizeof(int32));
+	assert_int_equal(entry.nullCount, 1);
+	assert_false(entry.flags & AOZONEMAP_HASVALUES);
+
+	AOZoneMapEntry_AddDatum(&entry, Int32GetDatum(-5), false, sizeof(int32));
+	AOZoneMapEntry_AddDatum(&entry, Int32GetDatum(42), false, sizeof(int32));
+	AOZoneMapEntry_AddDatum(&entry, Int32GetDatum(7), false, sizeof(int32));
+	assert_true(entry.flags & AOZONEMAP_HASVALUES);
+	assert_true(entry.minValue == -5);
+	assert_true(entry.maxValue == 42);
+	assert_int_equal(entry.nullCount, 1);
+
+	AOZoneMapEntry_Init(&entry, 1);
+	AOZoneMapEntry_AddDatum(&entry, Int64GetDatum(INT64CONST(5000000000)), false, sizeof(int64));
+	AOZoneMapEntry_AddDatum(&entry, Int64GetDatum(INT64CONST(-5000000000)), false, sizeof(int64));
+	assert_true(entry.minValue == INT64CONST(-5000000000));
+	assert_true(entry.maxValue == INT64CONST(5000000000));
+}
+
+static void
+test__AOZoneMapEntry_Excludes(void **state)
+{
+	AOZoneMapEntry entry;
+	AOZoneMapKey key;
+
+	/* a block with values in [10, 20] */
+	AOZoneMapEntry_Init(&entry, 1);
+	AOZoneMapEntry_AddValue(&entry, 10);
+	AOZoneMapEntry_AddValue(&entry, 20);
+
+	key = make_key(1, BTLessStrategyNumber, 10);
+	assert_true(AOZoneMapEntry_Excludes(&entry, &key));
+	key = make_key(1, BTLessStrategyNumber, 11);
+	assert_false(AOZoneMapEntry_Excludes(&entry, &key));
+
+	key = make_key(1, BTLessEqualStrategyNumber, 9);
+	assert_true(AOZoneMapEntry_Excludes(&entry, &key));
+	key = make_key(1, BTLessEqualStrategyNumber, 10);
+	assert_false(AOZoneMapEntry_Excludes(&entry, &key));
+
+	key = make_key(1, BTEqualStrategyNumber, 9);
+	assert_true(AOZoneMapEntry_Excludes(&entry, &key));
+	key = make_key(1, BTEqualStrategyNumber, 15);
+	assert_false(AOZoneMapEntry_Excludes(&entry, &key));
+	key = make_key(1, BTEqualStrategyNumber, 21);
+	assert_true(AOZoneMapEntry_Excludes(&entry, &key));
+
+	key = make_key(1, BTGreaterEqualStrategyNumber, 21);
+	assert_true(AOZoneMapEntry_Excludes(&entry, &key));
+	key = make_key(1, BTGreaterEqualStrategyNumber, 20);
+	assert_false(AOZoneMapEntry_Excludes(&entry, &key));
+
+	key = make_key(1, BTGreaterStrategyNumber, 20);
+	assert_true(AOZoneMapEntry_Excludes(&entry, &key));
+	key = make_key(1, BTGreaterStrategyNumber, 19);
+	assert_false(AOZoneMapEntry_Excludes(&entry, &key));
+
+	/* synopses of another column, or invalid ones, never exclude */
+	key = make_key(2, BTEqualStrategyNumber, 9);
+	assert_false(AOZoneMapEntry_Excludes(&entry, &key));
+	MemSet(&entry, 0, sizeof(entry));
+	key = make_key(1, BTEqualStrategyNumber, 9);
+	assert_false(AOZoneMapEntry_Excludes(&entry, &key));
+
+	/* IS NULL and IS NOT NULL */
+	AOZoneMapEntry_Init(&entry, 1);
+	AOZoneMapEntry_AddValue(&entry, 10);
+	key = make_key(1, InvalidStrategy, 0);
+	key.isnull = true;
+	assert_true(AOZoneMapEntry_Excludes(&entry, &key));
+	key.isnull = false;
+	assert_false(AOZoneMapEntry_Excludes(&entry, &key));
+
+	/* a block of NULLs has no match for a comparison */
+	AOZoneMapEntry_Init(&entry, 1);
+	AOZoneMapEntry_AddNull(&entry);
+	key.isnull = true;
+	assert_false(AOZoneMapEntry_Excludes(&entry, &key));
+	key.isnull = false;
+	assert_true(AOZoneMapEntry_Excludes(&entry, &key));
+	key = make_key(1, BTGreaterStrategyNumber, 0);
+	assert_true(AOZoneMapEntry_Excludes(&entry, &key));
+}
+
+static void
+test__AOZoneMapScan_SkipTo(void **state)
+{
+	AOZoneMapScanData zms;
+	AOZoneMapKeyRanges keyRanges[2];
+
+	MemSet(&zms, 0, sizeof(zms));
+	MemSet(keyRanges, 0, sizeof(keyRanges));
+	zms.nkeys = 2;
+	zms.keyRanges = keyRanges;
+
+	/* key 0 excludes rows [101, 301) and [501, 601), key 1 [301, 401) */
+	add_excluded_range(&keyRanges[0], 101, 100);
+	add_excluded_range(&keyRanges[0], 201, 100);
+	add_excluded_range(&keyRanges[0], 501, 100);
+	add_excluded_range(&keyRanges[1], 301, 100);
+	assert_int_equal(keyRanges[0].nranges, 2);
+	assert_true(keyRanges[0].ranges[0].endRowNum == 301);
+
+	assert_true(AOZoneMapScan_SkipTo(&zms, 1) == 1);
+	assert_true(AOZoneMapScan_NextExcluded(&zms, 1) == 101);
+	assert_true(AOZoneMapScan_SkipTo(&zms, 100) == 100);
+
+	/* the ranges of both keys chain up to row 401 */
+	assert_true(AOZoneMapScan_SkipTo(&zms, 150) == 401);
+	assert_true(AOZoneMapScan_NextExcluded(&zms, 401) == 501);
+
+	assert_true(AOZoneMapScan_SkipTo(&zms, 550) == 601);
+	assert_true(AOZoneMapScan_NextExcluded(&zms, 601) == PG_INT64_MAX);
+
+	pfree(keyRanges[0].ranges);
+	pfree(keyRanges[1].ranges);
+}
+
+int
+main(int argc, char *argv[])
+{
+	cmockery_parse_arguments(argc, argv);
+
+	const		UnitTest tests[] = {
+		unit_test(test__AOZoneMapEntry_AddDatum),
+		unit_test(test__AOZoneMapEntry_Excludes),
+		unit_test(test__AOZoneMapScan_SkipTo)
+	};
+
+	MemoryContextInit();
+
+	return run_tests(tests);
+}
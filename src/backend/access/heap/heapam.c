@@ -1233,6 +1233,7 @@ heap_beginscan(Relation relation, Snapshot snapshot,
 	scan->rs_base.rs_nkeys = nkeys;
 	scan->rs_base.rs_flags = flags;
 	scan->rs_base.rs_parallel = parallel_scan;
+	scan->rs_base.rs_nblocks_skipped = 0;
 	scan->rs_strategy = NULL;	/* set in initscan */
 
 	/*
@@ -0,0 +1,791 @@
+/*-------------------------------------------------------------------------
+ *
+ * cdbappendonlydecompress.c
+ *	  Decompress Append-Only Storage Blocks ahead of the scan, with helper
+ *	  threads.
+ *
+ * With a strong compression level, decompressing the blocks is most of the
+ * CPU time of an AO or AOCS scan.  When gp_appendonly_decompress_workers is
+ * set, each read session that uses zlib or zstd compression looks at the
+ * blocks that follow the one being scanned, and hands the compressed ones to
+ * a pool of helper threads.  When the scan gets to such a block,
+ * AppendOnlyStorageRead_Content() copies out the already decompressed
+ * content instead of decompressing it itself.
+ *
+ * The blocks are taken from what the scan's BufferedRead already read in its
+ * current large read, so decompressing ahead adds no I/O.  The read session
+ * does everything that can raise an error: it parses and verifies the block
+ * headers and checksums, the same way AppendOnlyStorageRead_ReadNextBlock()
+ * does, and copies the compressed content of the verified blocks into a slot.
+ * The helper threads only call the compression library on the slot's
+ * buffers.  Anything unexpected just stops the decompress-ahead, and the scan
+ * then hits the same problem, and reports it, when it reads the block
+ * itself.  The blocks beyond the current large read are looked at once the
+ * scan has read them.
+ *
+ * The slots are allocated in the memory context of the read session, so
+ * they are accounted for like any other memory of the query, and the total
+ * for the backend is capped by gp_appendonly_decompress_ahead_mem.  A reset
+ * callback on that context makes sure no helper thread still works on a
+ * slot when the memory goes away, on error for example.
+ *
+ * The pool of helper threads is created on first use and lives as long as
+ * the backend.  It is shared by all the read sessions of the backend, e.g.
+ * by the columns of an AOCS scan.
+ *
+ * Portions Copyright (c) 2012-Present VMware, Inc. or its affiliates.
+ *
+ *
+ * IDENTIFICATION
+ *	    src/backend/cdb/cdbappendonlydecompress.c
+ *
+ *-------------------------------------------------------------------------
+ */
+#include "postgres.h"
+
+#include <limits.h>
+#include <pthread.h>
+#include <signal.h>
+#ifdef HAVE_LIBZ
+#include <zlib.h>
+#endif
+#ifdef USE_ZSTD
+#include <zstd.h>
+#endif
+
+#include "cdb/cdbappendonlydecompress.h"
+#include "cdb/cdbappendonlystorage.h"
+#include "cdb/cdbappendonlystorageformat.h"
+#include "cdb/cdbappendonlystorageread.h"
+#include "lib/ilist.h"
+#include "utils/guc.h"
+#include "utils/memutils.h"
+
+int			gp_appendonly_decompress_workers = 0;
+int			gp_appendonly_decompress_ahead_mem = 16384;
+
+/* The largest number of helper threads */
+#define MAX_DECOMPRESS_WORKERS 32
+
+typedef enum DecompressAlgorithm
+{
+	DECOMPRESS_ZLIB,
+	DECOMPRESS_ZSTD
+} DecompressAlgorithm;
+
+typedef enum DecompressSlotState
+{
+	DECOMPRESS_SLOT_FREE,
+	DECOMPRESS_SLOT_QUEUED,		/* waiting for a helper thread */
+	DECOMPRESS_SLOT_RUNNING,	/* being decompressed */
+	DECOMPRESS_SLOT_DONE,
+	DECOMPRESS_SLOT_FAILED
+} DecompressSlotState;
+
+/* What DecompressAheadNextBlock() found at the next position */
+typedef enum DecompressAheadLook
+{
+	DECOMPRESS_AHEAD_BLOCK,		/* a block, now looked at */
+	DECOMPRESS_AHEAD_NOT_READ,	/* nothing until the scan reads further */
+	DECOMPRESS_AHEAD_END		/* nothing more to look at */
+} DecompressAheadLook;
+
+/*
+ * One block to decompress.  The state, and the link in the job queue, are
+ * protected by decompressPoolMutex.  The rest belongs to the helper thread
+ * while the slot is running, and to the read session otherwise.
+ */
+typedef struct DecompressSlot
+{
+	dlist_node	node;
+	DecompressSlotState state;
+	DecompressAlgorithm algorithm;
+
+	int64		headerOffsetInFile;
+	int32		compressedLen;
+	int32		uncompressedLen;
+
+	uint8	   *compressed;
+	uint8	   *uncompressed;
+} DecompressSlot;
+
+typedef struct AppendOnlyDecompressAhead
+{
+	AppendOnlyStorageRead *storageRead;
+	DecompressAlgorithm algorithm;
+
+	/*
+	 * Ring of slots, in the order of the blocks in the file.  The oldest is
+	 * at head.
+	 */
+	DecompressSlot *slots;
+	int			nslots;
+	int			head;
+	int			count;
+
+	int64		nextPosition;	/* position of the next block to look at */
+	int64		limitPosition;	/* don't look at blocks from here on */
+	bool		exhausted;		/* no more blocks to look at */
+
+	Size		memoryLen;		/* charged to decompressAheadMemUsed */
+	bool		released;
+	MemoryContextCallback resetCallback;
+} AppendOnlyDecompressAhead;
+
+/*
+ * The pool of helper threads.
+ */
+static pthread_mutex_t decompressPoolMutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t decompressJobAvailable = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t decompressJobDone = PTHREAD_COND_INITIALIZER;
+static dlist_head decompressJobs = DLIST_STATIC_INIT(decompressJobs);
+static int	decompressPoolThreads = 0;
+static bool decompressPoolFailed = false;
+
+/* Memory of the slots of all the read sessions of this backend */
+static Size decompressAheadMemUsed = 0;
+
+static int	DecompressPoolStart(void);
+static void *DecompressPoolWorkerMain(void *arg);
+static bool DecompressSlotDecompress(DecompressSlot *slot, void *zstdContext);
+static void DecompressAheadFill(AppendOnlyDecompressAhead *decompressAhead);
+static DecompressAheadLook DecompressAheadNextBlock(AppendOnlyDecompressAhead *decompressAhead,
+													DecompressSlot *slot, bool *isCompressed);
+static void DecompressAheadDrain(AppendOnlyDecompressAhead *decompressAhead);
+static void DecompressAheadRelease(AppendOnlyDecompressAhead *decompressAhead);
+static void DecompressAheadResetCallback(void *arg);
+
+/*
+ * Start helper threads, up to gp_appendonly_decompress_workers of them.
+ * Returns the number of helper threads running.
+ */
+static int
+DecompressPoolStart(void)
+{
+	int			nthreads;
+
+	nthreads = Min(gp_appendonly_decompress_workers, MAX_DECOMPRESS_WORKERS);
+
+	while (!decompressPoolFailed && decompressPoolThreads < nthreads)
+	{
+		pthread_attr_t t_atts;
+		pthread_t	thread;
+		sigset_t	sigs;
+		sigset_t	old_sigs;
+		int			pthread_err;
+
+		/*
+		 * The helper threads never handle signals, so block them all while
+		 * the thread is created; it inherits our signal mask.
+		 */
+		sigfillset(&sigs);
+		pthread_sigmask(SIG_BLOCK, &sigs, &old_sigs);
+
+		pthread_attr_init(&t_atts);
+		pthread_attr_setstacksize(&t_atts, Max(PTHREAD_STACK_MIN, (256 * 1024)));
+		pthread_attr_setdetachstate(&t_atts, PTHREAD_CREATE_DETACHED);
+		pthread_err = pthread_create(&thread, &t_atts, DecompressPoolWorkerMain, NULL);
+		pthread_attr_destroy(&t_atts);
+
+		pthread_sigmask(SIG_SETMASK, &old_sigs, NULL);
+
+		if (pthread_err != 0)
+		{
+			/* Make do with what we have, and don't try again */
+			elog(LOG, "could not create append-only decompress thread: error code %d",
+				 pthread_err);
+			decompressPoolFailed = true;
+			break;
+		}
+
+		decompressPoolThreads++;
+	}
+
+	return decompressPoolThreads;
+}
+
+/*
+ * Main loop of a helper thread.
+ *
+ * This runs outside of the backend's error handling, so it must not palloc,
+ * elog, or call anything that might.
+ */
+static void *
+DecompressPoolWorkerMain(void *arg)
+{
+	void	   *zstdContext = NULL;
+
+#ifdef USE_ZSTD
+	zstdContext = ZSTD_createDCtx();
+#endif
+
+	pthread_mutex_lock(&decompressPoolMutex);
+	for (;;)
+	{
+		DecompressSlot *slot;
+		bool		ok;
+
+		while (dlist_is_empty(&decompressJobs))
+			pthread_cond_wait(&decompressJobAvailable, &decompressPoolMutex);
+
+		slot = dlist_container(DecompressSlot, node,
+							   dlist_pop_head_node(&decompressJobs));
+		slot->state = DECOMPRESS_SLOT_RUNNING;
+		pthread_mutex_unlock(&decompressPoolMutex);
+
+		ok = DecompressSlotDecompress(slot, zstdContext);
+
+		pthread_mutex_lock(&decompressPoolMutex);
+		slot->state = ok ? DECOMPRESS_SLOT_DONE : DECOMPRESS_SLOT_FAILED;
+		pthread_cond_broadcast(&decompressJobDone);
+	}
+
+	return NULL;
+}
+
+/*
+ * Decompress the content of a slot, with the compression library itself
+ * rather than the pg_compression functions, which are not thread-safe.
+ */
+static bool
+DecompressSlotDecompress(DecompressSlot *slot, void *zstdContext)
+{
+	switch (slot->algorithm)
+	{
+		case DECOMPRESS_ZLIB:
+#ifdef HAVE_LIBZ
+			{
+				uLongf		destLen = slot->uncompressedLen;
+
+				if (uncompress(slot->uncompressed, &destLen,
+							   slot->compressed, slot->compressedLen) != Z_OK)
+					return false;
+				return destLen == (uLongf) slot->uncompressedLen;
+			}
+#endif
+			break;
+
+		case DECOMPRESS_ZSTD:
+#ifdef USE_ZSTD
+			{
+				size_t		destLen;
+
+				if (zstdContext == NULL)
+					return false;
+				destLen = ZSTD_decompressDCtx((ZSTD_DCtx *) zstdContext,
+											  slot->uncompressed, slot->uncompressedLen,
+											  slot->compressed, slot->compressedLen);
+				if (ZSTD_isError(destLen))
+					return false;
+				return destLen == (size_t) slot->uncompressedLen;
+			}
+#endif
+			break;
+	}
+
+	return false;
+}
+
+/*
+ * Set up decompress-ahead for a read session.
+ *
+ * Returns NULL when decompress-ahead is disabled, when the compression type
+ * is not supported, or when there is no memory left in the budget of
+ * gp_appendonly_decompress_ahead_mem.
+ */
+AppendOnlyDecompressAhead *
+AppendOnlyDecompressAhead_Create(AppendOnlyStorageRead *storageRead)
+{
+	AppendOnlyDecompressAhead *decompressAhead;
+	DecompressAlgorithm algorithm;
+	char	   *compressType = storageRead->storageAttributes.compressType;
+	Size		budget;
+	Size		slotLen;
+	int			nslots;
+	int			i;
+
+	if (gp_appendonly_decompress_workers <= 0)
+		return NULL;
+
+	if (!storageRead->storageAttributes.compress || compressType == NULL)
+		return NULL;
+
+#ifdef HAVE_LIBZ
+	if (pg_strcasecmp(compressType, "zlib") == 0)
+		algorithm = DECOMPRESS_ZLIB;
+	else
+#endif
+#ifdef USE_ZSTD
+	if (pg_strcasecmp(compressType, "zstd") == 0)
+		algorithm = DECOMPRESS_ZSTD;
+	else
+#endif
+		return NULL;
+
+	/*
+	 * Two slots per helper thread keep them all busy while the scan consumes
+	 * the blocks they are done with, as long as the budget allows.
+	 */
+	budget = (Size) gp_appendonly_decompress_ahead_mem * 1024;
+	slotLen = 2 * (Size) storageRead->maxBufferLen;
+	nslots = 2 * Min(gp_appendonly_decompress_workers, MAX_DECOMPRESS_WORKERS);
+	if (decompressAheadMemUsed + nslots * slotLen > budget)
+	{
+		if (decompressAheadMemUsed >= budget)
+			return NULL;
+		nslots = (budget - decompressAheadMemUsed) / slotLen;
+	}
+	if (nslots < 2)
+		return NULL;
+
+	if (DecompressPoolStart() == 0)
+		return NULL;
+
+	decompressAhead = MemoryContextAllocZero(storageRead->memoryContext,
+											 sizeof(AppendOnlyDecompressAhead));
+	decompressAhead->storageRead = storageRead;
+	decompressAhead->algorithm = algorithm;
+	decompressAhead->slots = MemoryContextAllocZero(storageRead->memoryContext,
+													nslots * sizeof(DecompressSlot));
+	for (i = 0; i < nslots; i++)
+	{
+		DecompressSlot *slot = &decompressAhead->slots[i];
+
+		slot->state = DECOMPRESS_SLOT_FREE;
+		slot->algorithm = algorithm;
+		slot->compressed = MemoryContextAlloc(storageRead->memoryContext,
+											  storageRead->maxBufferLen);
+		slot->uncompressed = MemoryContextAlloc(storageRead->memoryContext,
+												storageRead->maxBufferLen);
+	}
+	decompressAhead->nslots = nslots;
+
+	/* Nothing to look at until a segment file is opened */
+	decompressAhead->exhausted = true;
+
+	decompressAhead->memoryLen = nslots * slotLen;
+	decompressAheadMemUsed += decompressAhead->memoryLen;
+
+	decompressAhead->resetCallback.func = DecompressAheadResetCallback;
+	decompressAhead->resetCallback.arg = decompressAhead;
+	MemoryContextRegisterResetCallback(storageRead->memoryContext,
+									   &decompressAhead->resetCallback);
+
+	return decompressAhead;
+}
+
+/*
+ * Forget the blocks decompressed so far, and start over at beginFileOffset
+ * in the current segment file.  Blocks at or after afterFileOffset are not
+ * decompressed ahead.
+ */
+void
+AppendOnlyDecompressAhead_Reset(AppendOnlyDecompressAhead *decompressAhead,
+								int64 beginFileOffset,
+								int64 afterFileOffset)
+{
+	if (decompressAhead->released)
+		return;
+
+	DecompressAheadDrain(decompressAhead);
+
+	decompressAhead->nextPosition = beginFileOffset;
+	decompressAhead->limitPosition = afterFileOffset;
+	decompressAhead->exhausted = (beginFileOffset >= afterFileOffset);
+}
+
+/*
+ * Copy out the decompressed content of the block at headerOffsetInFile.
+ *
+ * Returns false when the block was not decompressed ahead, in which case the
+ * caller decompresses it itself.
+ */
+bool
+AppendOnlyDecompressAhead_GetContent(AppendOnlyDecompressAhead *decompressAhead,
+									 int64 headerOffsetInFile,
+									 int32 overallBlockLen,
+									 int32 compressedLen,
+									 uint8 *contentOut,
+									 int32 contentOutLen)
+{
+	bool		found = false;
+	bool		matched = false;
+
+	if (decompressAhead->released)
+		return false;
+
+	/*
+	 * Release the slots of the blocks that the scan skipped, up to the one
+	 * it asks for.
+	 */
+	while (decompressAhead->count > 0 && !matched)
+	{
+		DecompressSlot *slot = &decompressAhead->slots[decompressAhead->head];
+		bool		done = false;
+
+		if (slot->headerOffsetInFile > headerOffsetInFile)
+			break;
+		matched = (slot->headerOffsetInFile == headerOffsetInFile);
+
+		pthread_mutex_lock(&decompressPoolMutex);
+		if (slot->state == DECOMPRESS_SLOT_QUEUED)
+		{
+			/*
+			 * No helper thread got to it yet.  Rather than wait, let the
+			 * caller decompress it.
+			 */
+			dlist_delete(&slot->node);
+		}
+		else
+		{
+			while (slot->state == DECOMPRESS_SLOT_RUNNING)
+				pthread_cond_wait(&decompressJobDone, &decompressPoolMutex);
+			done = (slot->state == DECOMPRESS_SLOT_DONE);
+		}
+		slot->state = DECOMPRESS_SLOT_FREE;
+		pthread_mutex_unlock(&decompressPoolMutex);
+
+		if (matched && done &&
+			slot->compressedLen == compressedLen &&
+			slot->uncompressedLen == contentOutLen)
+		{
+			memcpy(contentOut, slot->uncompressed, contentOutLen);
+			found = true;
+		}
+
+		decompressAhead->head = (decompressAhead->head + 1) % decompressAhead->nslots;
+		decompressAhead->count--;
+	}
+
+	/*
+	 * If we weren't looking at this block, the scan moved somewhere else.
+	 * Carry on from the block after this one.
+	 */
+	if (!matched)
+		AppendOnlyDecompressAhead_Reset(decompressAhead,
+										headerOffsetInFile + overallBlockLen,
+										decompressAhead->limitPosition);
+
+	DecompressAheadFill(decompressAhead);
+
+	return found;
+}
+
+/*
+ * Finish with decompress-ahead, and release its memory.
+ */
+void
+AppendOnlyDecompressAhead_Finish(AppendOnlyDecompressAhead *decompressAhead)
+{
+	int			i;
+
+	if (decompressAhead->released)
+		return;
+
+	DecompressAheadRelease(decompressAhead);
+
+	for (i = 0; i < decompressAhead->nslots; i++)
+	{
+		pfree(decompressAhead->slots[i].compressed);
+		pfree(decompressAhead->slots[i].uncompressed);
+	}
+	pfree(decompressAhead->slots);
+	decompressAhead->slots = NULL;
+	decompressAhead->nslots = 0;
+
+	/*
+	 * The struct itself stays around until its memory context goes away, as
+	 * the reset callback still points to it.
+	 */
+}
+
+/*
+ * Queue the compressed blocks that follow, until all the slots are in use.
+ */
+static void
+DecompressAheadFill(AppendOnlyDecompressAhead *decompressAhead)
+{
+	bool		queued = false;
+
+	while (!decompressAhead->exhausted &&
+		   decompressAhead->count < decompressAhead->nslots)
+	{
+		int			tail;
+		DecompressSlot *slot;
+		bool		isCompressed;
+		DecompressAheadLook look;
+
+		tail = (decompressAhead->head + decompressAhead->count) % decompressAhead->nslots;
+		slot = &decompressAhead->slots[tail];
+		Assert(slot->state == DECOMPRESS_SLOT_FREE);
+
+		look = DecompressAheadNextBlock(decompressAhead, slot, &isCompressed);
+		if (look == DECOMPRESS_AHEAD_NOT_READ)
+			break;
+		if (look == DECOMPRESS_AHEAD_END)
+		{
+			decompressAhead->exhausted = true;
+			break;
+		}
+
+		/* The scan decompresses nothing in the other blocks */
+		if (!isCompressed)
+			continue;
+
+		pthread_mutex_lock(&decompressPoolMutex);
+		slot->state = DECOMPRESS_SLOT_QUEUED;
+		dlist_push_tail(&decompressJobs, &slot->node);
+		pthread_mutex_unlock(&decompressPoolMutex);
+
+		decompressAhead->count++;
+		queued = true;
+	}
+
+	if (queued)
+	{
+		pthread_mutex_lock(&decompressPoolMutex);
+		pthread_cond_broadcast(&decompressJobAvailable);
+		pthread_mutex_unlock(&decompressPoolMutex);
+	}
+}
+
+/*
+ * Look at the block at nextPosition, the same way
+ * AppendOnlyStorageRead_ReadNextBlock() does, and advance past it.  When it
+ * is a compressed block, copy its compressed content into the slot.
+ *
+ * Only the blocks that are all in the BufferedRead's current large read are
+ * looked at, and only once their header and block checksums are verified.
+ *
+ * Returns DECOMPRESS_AHEAD_NOT_READ when the block is not in the current
+ * large read, and DECOMPRESS_AHEAD_END at the end of the range, or when
+ * anything about the block is unexpected.
+ */
+static DecompressAheadLook
+DecompressAheadNextBlock(AppendOnlyDecompressAhead *decompressAhead,
+						 DecompressSlot *slot, bool *isCompressed)
+{
+	AppendOnlyStorageRead *storageRead = decompressAhead->storageRead;
+	BufferedRead *bufferedRead = &storageRead->bufferedRead;
+	bool		usingChecksums = storageRead->storageAttributes.checksum;
+	int64		position = decompressAhead->nextPosition;
+	uint8	   *header;
+	int64		fileRemainderLen;
+	int32		blockLimitLen;
+	AoHeaderKind headerKind;
+	int32		actualHeaderLen;
+	int32		overallBlockLen = 0;
+	int32		contentOffset = 0;
+	int32		uncompressedLen = 0;
+	int32		compressedLen = 0;
+	int			executorBlockKind;
+	bool		hasFirstRowNum;
+	int64		firstRowNum;
+	int			rowCount;
+	AOHeaderCheckError checkError;
+	pg_crc32	storedChecksum;
+	pg_crc32	computedChecksum;
+	int			i;
+
+	*isCompressed = false;
+
+	if (position + storageRead->minimumHeaderLen > decompressAhead->limitPosition)
+		return DECOMPRESS_AHEAD_END;
+	header = BufferedReadPeek(bufferedRead, position, storageRead->minimumHeaderLen);
+	if (header == NULL)
+		return DECOMPRESS_AHEAD_NOT_READ;
+
+	/* Skip zero padding, like AppendOnlyStorageRead_PositionToNextBlock() */
+	for (i = 0; i < storageRead->minimumHeaderLen; i++)
+	{
+		if (header[i] != 0)
+			break;
+	}
+	if (i >= storageRead->minimumHeaderLen)
+	{
+		position += storageRead->minimumHeaderLen;
+		if (position + storageRead->minimumHeaderLen > decompressAhead->limitPosition)
+			return DECOMPRESS_AHEAD_END;
+		header = BufferedReadPeek(bufferedRead, position, storageRead->minimumHeaderLen);
+		if (header == NULL)
+			return DECOMPRESS_AHEAD_NOT_READ;
+	}
+
+	fileRemainderLen = bufferedRead->fileLen - position;
+	if (storageRead->maxBufferLen > fileRemainderLen)
+		blockLimitLen = (int32) fileRemainderLen;
+	else
+		blockLimitLen = storageRead->maxBufferLen;
+
+	if (usingChecksums && gp_appendonly_verify_block_checksums &&
+		!AppendOnlyStorageFormat_VerifyHeaderChecksum(header,
+													  &storedChecksum,
+													  &computedChecksum))
+		return DECOMPRESS_AHEAD_END;
+
+	checkError = AppendOnlyStorageFormat_GetHeaderInfo(header,
+													   usingChecksums,
+													   &headerKind,
+													   &actualHeaderLen);
+	if (checkError != AOHeaderCheckOk)
+		return DECOMPRESS_AHEAD_END;
+
+	header = BufferedReadPeek(bufferedRead, position, actualHeaderLen);
+	if (header == NULL)
+		return DECOMPRESS_AHEAD_NOT_READ;
+
+	switch (headerKind)
+	{
+		case AoHeaderKind_SmallContent:
+			checkError = AppendOnlyStorageFormat_GetSmallContentHeaderInfo(header,
+																		   actualHeaderLen,
+																		   usingChecksums,
+																		   blockLimitLen,
+																		   &overallBlockLen,
+																		   &contentOffset,
+																		   &uncompressedLen,
+																		   &executorBlockKind,
+																		   &hasFirstRowNum,
+																		   storageRead->formatVersion,
+																		   &firstRowNum,
+																		   &rowCount,
+																		   isCompressed,
+																		   &compressedLen);
+			break;
+
+		case AoHeaderKind_LargeContent:
+			/* Only a header; the fragments follow as small content blocks */
+			checkError = AppendOnlyStorageFormat_GetLargeContentHeaderInfo(header,
+																		   actualHeaderLen,
+																		   usingChecksums,
+																		   &uncompressedLen,
+																		   &executorBlockKind,
+																		   &hasFirstRowNum,
+																		   &firstRowNum,
+																		   &rowCount);
+			overallBlockLen = actualHeaderLen;
+			break;
+
+		case AoHeaderKind_NonBulkDenseContent:
+			checkError = AppendOnlyStorageFormat_GetNonBulkDenseContentHeaderInfo(header,
+																				  actualHeaderLen,
+																				  usingChecksums,
+																				  blockLimitLen,
+																				  &overallBlockLen,
+																				  &contentOffset,
+																				  &uncompressedLen,
+																				  &executorBlockKind,
+																				  &hasFirstRowNum,
+																				  storageRead->formatVersion,
+																				  &firstRowNum,
+																				  &rowCount);
+			break;
+
+		case AoHeaderKind_BulkDenseContent:
+			checkError = AppendOnlyStorageFormat_GetBulkDenseContentHeaderInfo(header,
+																			   actualHeaderLen,
+																			   usingChecksums,
+																			   blockLimitLen,
+																			   &overallBlockLen,
+																			   &contentOffset,
+																			   &uncompressedLen,
+																			   &executorBlockKind,
+																			   &hasFirstRowNum,
+																			   storageRead->formatVersion,
+																			   &firstRowNum,
+																			   &rowCount,
+																			   isCompressed,
+																			   &compressedLen);
+			break;
+
+		default:
+			return DECOMPRESS_AHEAD_END;
+	}
+	if (checkError != AOHeaderCheckOk || overallBlockLen <= 0 ||
+		position + overallBlockLen > decompressAhead->limitPosition)
+		return DECOMPRESS_AHEAD_END;
+
+	if (*isCompressed)
+	{
+		if (compressedLen <= 0 || compressedLen > storageRead->maxBufferLen ||
+			uncompressedLen <= 0 || uncompressedLen > storageRead->maxBufferLen ||
+			contentOffset + compressedLen > overallBlockLen)
+			return DECOMPRESS_AHEAD_END;
+
+		/* The whole block, to verify its checksum */
+		header = BufferedReadPeek(bufferedRead, position, overallBlockLen);
+		if (header == NULL)
+			return DECOMPRESS_AHEAD_NOT_READ;
+
+		if (usingChecksums && gp_appendonly_verify_block_checksums &&
+			!AppendOnlyStorageFormat_VerifyBlockChecksum(header,
+														 overallBlockLen,
+														 &storedChecksum,
+														 &computedChecksum))
+			return DECOMPRESS_AHEAD_END;
+
+		memcpy(slot->compressed, &header[contentOffset], compressedLen);
+		slot->headerOffsetInFile = position;
+		slot->compressedLen = compressedLen;
+		slot->uncompressedLen = uncompressedLen;
+	}
+
+	decompressAhead->nextPosition = position + overallBlockLen;
+
+	return DECOMPRESS_AHEAD_BLOCK;
+}
+
+/*
+ * Wait for the helper threads to be done with the slots, and free them all.
+ */
+static void
+DecompressAheadDrain(AppendOnlyDecompressAhead *decompressAhead)
+{
+	int			i;
+
+	pthread_mutex_lock(&decompressPoolMutex);
+	for (i = 0; i < decompressAhead->count; i++)
+	{
+		DecompressSlot *slot;
+
+		slot = &decompressAhead->slots[(decompressAhead->head + i) % decompressAhead->nslots];
+		if (slot->state == DECOMPRESS_SLOT_QUEUED)
+			dlist_delete(&slot->node);
+		while (slot->state == DECOMPRESS_SLOT_RUNNING)
+			pthread_cond_wait(&decompressJobDone, &decompressPoolMutex);
+		slot->state = DECOMPRESS_SLOT_FREE;
+	}
+	pthread_mutex_unlock(&decompressPoolMutex);
+
+	decompressAhead->head = 0;
+	decompressAhead->count = 0;
+	decompressAhead->exhausted = true;
+}
+
+/*
+ * Stop decompressing ahead, and give the memory of the slots back to the
+ * budget.
+ */
+static void
+DecompressAheadRelease(AppendOnlyDecompressAhead *decompressAhead)
+{
+	DecompressAheadDrain(decompressAhead);
+
+	Assert(decompressAheadMemUsed >= decompressAhead->memoryLen);
+	decompressAheadMemUsed -= decompressAhead->memoryLen;
+	decompressAhead->memoryLen = 0;
+	decompressAhead->released = true;
+}
+
+/*
+ * The memory context of the read session is going away.  Make sure that no
+ * helper thread still uses a slot.
+ */
+static void
+DecompressAheadResetCallback(void *arg)
+{
+	AppendOnlyDecompressAhead *decompressAhead = (AppendOnlyDecompressAhead *) arg;
+
+	if (!decompressAhead->released)
+		DecompressAheadRelease(decompressAhead);
+}
@@ -22,6 +22,7 @@
 #include <unistd.h>
 
 #include "catalog/pg_compression.h"
+#include "cdb/cdbappendonlydecompress.h"
 #include "cdb/cdbappendonlystorage.h"
 #include "cdb/cdbappendonlystoragelayer.h"
 #include "cdb/cdbappendonlystorageformat.h"
@@ -130,6 +131,8 @@ AppendOnlyStorageRead_Init(AppendOnlyStorageRead *storageRead,
 	storageRead->file = -1;
 	storageRead->formatVersion = -1;
 
+	storageRead->decompressAhead = AppendOnlyDecompressAhead_Create(storageRead);
+
 	MemoryContextSwitchTo(oldMemoryContext);
 
 	storageRead->isActive = true;
@@ -176,6 +179,12 @@ AppendOnlyStorageRead_FinishSession(AppendOnlyStorageRead *storageRead)
 	 * UNDONE: This expects the MemoryContext to be what was used for the
 	 * 'memory' in ~Init
 	 */
+	if (storageRead->decompressAhead != NULL)
+	{
+		AppendOnlyDecompressAhead_Finish(storageRead->decompressAhead);
+		storageRead->decompressAhead = NULL;
+	}
+
 	BufferedReadFinish(&storageRead->bufferedRead);
 
 	if (storageRead->relationName != NULL)
@@ -290,6 +299,10 @@ AppendOnlyStorageRead_FinishOpenFile(AppendOnlyStorageRead *storageRead,
 						storageRead->file,
 						storageRead->segmentFileName,
 						logicalEof);
+
+	if (storageRead->decompressAhead != NULL)
+		AppendOnlyDecompressAhead_Reset(storageRead->decompressAhead,
+										0, logicalEof);
 }
 
 /*
@@ -399,6 +412,11 @@ AppendOnlyStorageRead_SetTemporaryRange(AppendOnlyStorageRead *storageRead,
 	BufferedReadSetTemporaryRange(&storageRead->bufferedRead,
 								  beginFileOffset,
 								  afterFileOffset);
+
+	if (storageRead->decompressAhead != NULL)
+		AppendOnlyDecompressAhead_Reset(storageRead->decompressAhead,
+										beginFileOffset,
+										afterFileOffset);
 }
 
 /*
@@ -420,6 +438,11 @@ AppendOnlyStorageRead_SetTemporaryStart(AppendOnlyStorageRead *storageRead,
 
 	/* This ensures that we don't limit the scan to afterFileOffset */
 	storageRead->bufferedRead.haveTemporaryLimitInEffect = false;
+
+	if (storageRead->decompressAhead != NULL)
+		AppendOnlyDecompressAhead_Reset(storageRead->decompressAhead,
+										beginFileOffset,
+										storageRead->logicalEof);
 }
 
 /*
@@ -436,6 +459,10 @@ AppendOnlyStorageRead_CloseFile(AppendOnlyStorageRead *storageRead)
 	if (storageRead->file == -1)
 		return;
 
+	/* Stop reading ahead in this file */
+	if (storageRead->decompressAhead != NULL)
+		AppendOnlyDecompressAhead_Reset(storageRead->decompressAhead, 0, 0);
+
 	FileClose(storageRead->file);
 
 	storageRead->file = -1;
@@ -698,6 +725,7 @@ AppendOnlyStorageRead_ReadNextBlock(AppendOnlyStorageRead *storageRead)
 /*	storageRead->current.isLarge = false; */
 /*	storageRead->current.isCompressed = false; */
 /*	storageRead->current.compressedLen = 0; */
+/*	storageRead->current.blockBuffer = NULL; */
 
 	elogif(Debug_appendonly_print_datumstream, LOG,
 		   "before AppendOnlyStorageRead_PositionToNextBlock, storageRead->current.headerOffsetInFile is" INT64_FORMAT "storageRead->current.overallBlockLen is %d",
@@ -1027,6 +1055,9 @@ AppendOnlyStorageRead_OverallBlockLen(AppendOnlyStorageRead *storageRead)
  *
  * Header to current block was read and verified by
  * AppendOnlyStorageRead_ReadNextBlock.
+ *
+ * This may be called more than once for the same block, e.g. when a block
+ * that was copied as it is stored is also decompressed.
  */
 static void
 AppendOnlyStorageRead_InternalGetBuffer(AppendOnlyStorageRead *storageRead,
@@ -1043,6 +1074,13 @@ AppendOnlyStorageRead_InternalGetBuffer(AppendOnlyStorageRead *storageRead,
 		   storageRead->current.headerKind == AoHeaderKind_NonBulkDenseContent ||
 		   storageRead->current.headerKind == AoHeaderKind_BulkDenseContent);
 
+	if (storageRead->current.blockBuffer != NULL)
+	{
+		*header = storageRead->current.blockBuffer;
+		*content = &((*header)[storageRead->current.contentOffset]);
+		return;
+	}
+
 	/*
 	 * Grow the buffer to the full block length to avoid any unnecessary
 	 * copying by BufferedRead.
@@ -1085,6 +1123,7 @@ AppendOnlyStorageRead_InternalGetBuffer(AppendOnlyStorageRead *storageRead,
 					 errcontext_appendonly_read_storage_block(storageRead)));
 	}
 
+	storageRead->current.blockBuffer = *header;
 	*content = &((*header)[storageRead->current.contentOffset]);
 }
 
@@ -1122,6 +1161,43 @@ AppendOnlyStorageRead_GetBuffer(AppendOnlyStorageRead *storageRead)
 	return content;
 }
 
+/*
+ * Get a pointer to the *small* content as it is stored in the block,
+ * compressed or not.
+ *
+ * Used to copy a block to another segment file without decompressing and
+ * compressing its content again (see AppendOnlyStorageWrite_RawContent).
+ *
+ * rawContentLen	- byte length of the content as stored.
+ */
+uint8 *
+AppendOnlyStorageRead_GetRawContent(AppendOnlyStorageRead *storageRead,
+									int32 *rawContentLen)
+{
+	uint8	   *header;
+	uint8	   *content;
+
+	Assert(storageRead != NULL);
+	Assert(storageRead->isActive);
+
+	/*
+	 * Verify next block is a "small" block.
+	 */
+	Assert(storageRead->current.headerKind == AoHeaderKind_SmallContent);
+	Assert(!storageRead->current.isLarge);
+
+	AppendOnlyStorageRead_InternalGetBuffer(storageRead,
+											&header,
+											&content);
+
+	if (storageRead->current.isCompressed)
+		*rawContentLen = storageRead->current.compressedLen;
+	else
+		*rawContentLen = storageRead->current.uncompressedLen;
+
+	return content;
+}
+
 /*
  * Copy the large and/or decompressed content out.
  *
@@ -1304,13 +1380,24 @@ AppendOnlyStorageRead_Content(AppendOnlyStorageRead *storageRead,
 
 			decompressor = cfns[COMPRESSION_DECOMPRESS];
 
-			gp_decompress(content,    /* Compressed data in block. */
-						  storageRead->current.compressedLen,
-						  contentOut,
-						  storageRead->current.uncompressedLen,
-						  decompressor,
-						  storageRead->compressionState,
-						  storageRead->bufferCount);
+			/*
+			 * Take the content from the helper threads if they decompressed
+			 * this block already.
+			 */
+			if (storageRead->decompressAhead == NULL ||
+				!AppendOnlyDecompressAhead_GetContent(storageRead->decompressAhead,
+													  storageRead->current.headerOffsetInFile,
+													  storageRead->current.overallBlockLen,
+													  storageRead->current.compressedLen,
+													  contentOut,
+													  storageRead->current.uncompressedLen))
+				gp_decompress(content,    /* Compressed data in block. */
+							  storageRead->current.compressedLen,
+							  contentOut,
+							  storageRead->current.uncompressedLen,
+							  decompressor,
+							  storageRead->compressionState,
+							  storageRead->bufferCount);
 
 			if (Debug_appendonly_print_scan)
 				elog(LOG,
@@ -1372,6 +1372,138 @@ AppendOnlyStorageWrite_CancelLastBuffer(
 	storageWrite->isFirstRowNumSet = false;
 }
 
+/*
+ * Write a "small" content block with content that is already in its stored
+ * form, compressed or not, e.g. the content of a block of another segment
+ * file of the same table.  The content is written with a new header, that
+ * has the first row number given to ~_SetFirstRowNum, but it is not
+ * decompressed and compressed again.
+ *
+ * Returns false, without writing anything, when the content doesn't fit in a
+ * block.  The caller then has to write the rows again.
+ *
+ * content			- Content as stored.
+ * uncompressedContent - the content once decompressed, which the written
+ *					  block is verified against when
+ *					  gp_appendonly_verify_write_block is on; NULL otherwise.
+ * uncompressedLen	- byte length of the content once decompressed.
+ * compressedLen	- byte length of the compressed content, or 0 when the
+ *					  content is not compressed.
+ * executorBlockKind - a value defined externally by the executor that
+ *					   describes in content stored in the Append-Only Storage
+ *					   Block.
+ * rowCount			- number of rows stored in the content.
+ */
+bool
+AppendOnlyStorageWrite_RawContent(AppendOnlyStorageWrite *storageWrite,
+								  uint8 *content,
+								  uint8 *uncompressedContent,
+								  int32 uncompressedLen,
+								  int32 compressedLen,
+								  int executorBlockKind,
+								  int rowCount)
+{
+	int64		headerOffsetInFile;
+	int32		completeHeaderLen;
+	int32		dataLen;
+	int32		dataRoundedUpLen;
+	uint8	   *header;
+	uint8	   *dataBuffer;
+
+	Assert(storageWrite != NULL);
+	Assert(storageWrite->isActive);
+	Assert(!AppendOnlyStorageWrite_IsBufferAllocated(storageWrite));
+
+	if (compressedLen > 0 && !storageWrite->storageAttributes.compress)
+		return false;
+
+	completeHeaderLen =
+		AppendOnlyStorageWrite_CompleteHeaderLen(storageWrite,
+												 AoHeaderKind_SmallContent);
+
+	dataLen = (compressedLen > 0) ? compressedLen : uncompressedLen;
+	dataRoundedUpLen = AOStorage_RoundUp(dataLen, storageWrite->formatVersion);
+
+	/* The same limits as for content given to ~_FinishBuffer */
+	if (uncompressedLen > storageWrite->maxBufferLen - completeHeaderLen ||
+		dataRoundedUpLen > storageWrite->maxBufferLen - completeHeaderLen)
+		return false;
+
+	headerOffsetInFile = BufferedAppendCurrentBufferPosition(&storageWrite->bufferedAppend);
+
+	header = BufferedAppendGetMaxBuffer(&storageWrite->bufferedAppend);
+	if (header == NULL)
+		ereport(ERROR,
+				(errcode(ERRCODE_INTERNAL_ERROR),
+				 errmsg("We do not expect files to be have a maximum length"),
+				 errcontext_appendonly_write_storage_block(storageWrite)));
+
+	dataBuffer = &header[completeHeaderLen];
+	memcpy(dataBuffer, content, dataLen);
+	AOStorage_ZeroPad(dataBuffer, dataLen, dataRoundedUpLen);
+
+	/* Make the header and compute the checksum if necessary. */
+	AppendOnlyStorageFormat_MakeSmallContentHeader
+		(header,
+		 storageWrite->storageAttributes.checksum,
+		 storageWrite->isFirstRowNumSet,
+		 storageWrite->formatVersion,
+		 storageWrite->firstRowNum,
+		 executorBlockKind,
+		 rowCount,
+		 uncompressedLen,
+		 compressedLen);
+
+	if (Debug_appendonly_print_storage_headers)
+	{
+		AppendOnlyStorageWrite_LogBlockHeader(storageWrite,
+											  headerOffsetInFile,
+											  header);
+	}
+
+	/*
+	 * Just before finishing the AO Storage buffer, let's verify it like the
+	 * blocks we compress ourselves: a compressed block must decompress to
+	 * the same bits as the block it was copied from.
+	 */
+	if (gp_appendonly_verify_write_block)
+	{
+		Assert(uncompressedContent != NULL);
+		AppendOnlyStorageWrite_VerifyWriteBlock(storageWrite,
+												headerOffsetInFile,
+												completeHeaderLen + dataRoundedUpLen,
+												uncompressedContent,
+												uncompressedLen,
+												executorBlockKind,
+												rowCount,
+												compressedLen);
+	}
+
+	BufferedAppendFinishBuffer(&storageWrite->bufferedAppend,
+							   completeHeaderLen + dataRoundedUpLen,
+							   (completeHeaderLen +
+								AOStorage_RoundUp(uncompressedLen, storageWrite->formatVersion) /* non-compressed size */ ),
+							   storageWrite->needsWAL);
+
+	elogif(Debug_appendonly_print_insert, LOG,
+		   "Append-only insert copied block for table '%s' stored %s "
+		   "(segment file '%s', header offset in file " INT64_FORMAT ", "
+		   "source length = %d, result length %d item count %d, block count "
+		   INT64_FORMAT ")",
+		   storageWrite->relationName,
+		   (compressedLen > 0) ? "compressed" : "uncompressed",
+		   storageWrite->segmentFileName,
+		   headerOffsetInFile,
+		   uncompressedLen,
+		   dataLen,
+		   rowCount,
+		   storageWrite->bufferCount);
+
+	storageWrite->isFirstRowNumSet = false;
+
+	return true;
+}
+
 /*----------------------------------------------------------------
  * Writing "Large" Content
  *----------------------------------------------------------------
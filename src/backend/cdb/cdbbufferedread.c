@@ -23,6 +23,8 @@
 #include "utils/faultinjector.h"
 #include "utils/guc.h"
 
+static void BufferedReadPrefetch(
+					 BufferedRead *bufferedRead);
 static void BufferedReadIo(
 			   BufferedRead *bufferedRead);
 static uint8 *BufferedReadUseBeforeBuffer(
@@ -106,6 +108,12 @@ BufferedReadInit(
 	/* start reading from beginning of file */
 	bufferedRead->fileOff = 0;
 
+	/*
+	 * Read-ahead support.
+	 */
+	bufferedRead->prefetchStart = 0;
+	bufferedRead->prefetchPosition = 0;
+
 	/*
 	 * Temporary limit support for random reading.
 	 */
@@ -145,6 +153,9 @@ BufferedReadSetFile(
 	bufferedRead->temporaryLimitFileLen = 0;
 	bufferedRead->fileOff =0;
 
+	bufferedRead->prefetchStart = 0;
+	bufferedRead->prefetchPosition = 0;
+
 	if (fileLen > 0)
 	{
 		/*
@@ -158,6 +169,76 @@ BufferedReadSetFile(
 	}
 }
 
+/*
+ * Issue read-ahead for the large reads that follow the one about to be done.
+ *
+ * Decompressing the blocks of a large read takes about as long as reading
+ * it, so rather than alternating between the two we ask the kernel to start
+ * reading the next gp_appendonly_read_ahead_depth large reads in the
+ * background with FilePrefetch(), and keep that many in flight as the scan
+ * moves forward.  The synchronous FileRead() of a prefetched range then
+ * usually finds the data in the OS cache.
+ *
+ * Only the part of the file within the current read limit is prefetched, so
+ * the small temporary ranges of index and bitmap fetches don't read ahead of
+ * what they need.  Without USE_PREFETCH, this only counts the large reads.
+ */
+static void
+BufferedReadPrefetch(
+					 BufferedRead *bufferedRead)
+{
+	int64		readEnd;
+
+	readEnd = bufferedRead->largeReadPosition + bufferedRead->largeReadLen;
+
+	pgBufferUsage.ao_reads++;
+
+	if (bufferedRead->largeReadPosition >= bufferedRead->prefetchStart &&
+		readEnd <= bufferedRead->prefetchPosition)
+		pgBufferUsage.ao_reads_prefetched++;
+	else
+	{
+		/* first read of the file, or we moved out of the prefetched range */
+		bufferedRead->prefetchStart = bufferedRead->largeReadPosition;
+		bufferedRead->prefetchPosition = readEnd;
+	}
+
+#ifdef USE_PREFETCH
+	if (gp_appendonly_read_ahead_depth > 0)
+	{
+		int64		inEffectFileLen;
+		int64		prefetchEnd;
+
+		if (bufferedRead->haveTemporaryLimitInEffect)
+			inEffectFileLen = bufferedRead->temporaryLimitFileLen;
+		else
+			inEffectFileLen = bufferedRead->fileLen;
+
+		prefetchEnd = readEnd +
+			(int64) gp_appendonly_read_ahead_depth * bufferedRead->maxLargeReadLen;
+		if (prefetchEnd > inEffectFileLen)
+			prefetchEnd = inEffectFileLen;
+
+		while (bufferedRead->prefetchPosition < prefetchEnd)
+		{
+			int32		prefetchLen;
+
+			if (prefetchEnd - bufferedRead->prefetchPosition > bufferedRead->maxLargeReadLen)
+				prefetchLen = bufferedRead->maxLargeReadLen;
+			else
+				prefetchLen = (int32) (prefetchEnd - bufferedRead->prefetchPosition);
+
+			(void) FilePrefetch(bufferedRead->file,
+								bufferedRead->prefetchPosition,
+								prefetchLen,
+								WAIT_EVENT_DATA_FILE_PREFETCH);
+
+			bufferedRead->prefetchPosition += prefetchLen;
+		}
+	}
+#endif
+}
+
 /*
  * Perform a large read i/o.
  */
@@ -173,6 +254,8 @@ BufferedReadIo(
 	Assert(bufferedRead->largeReadLen > 0);
 	largeReadMemory = bufferedRead->largeReadMemory;
 
+	BufferedReadPrefetch(bufferedRead);
+
 	offset = 0;
 	while (largeReadLen > 0)
 	{
@@ -434,14 +517,14 @@ BufferedReadSetTemporaryRange(
 			bufferedRead->largeReadLen = (int32) remainingFileLen;
 
 		bufferedRead->largeReadPosition = beginFileOffset;
-
-		if (bufferedRead->largeReadLen > 0)
-			BufferedReadIo(bufferedRead);
 	}
 
+	/* set before reading, read-ahead must not go past the range either */
 	bufferedRead->haveTemporaryLimitInEffect = true;
 	bufferedRead->temporaryLimitFileLen = afterFileOffset;
 
+	if (newReadNeeded && bufferedRead->largeReadLen > 0)
+		BufferedReadIo(bufferedRead);
 }
 
 /*
@@ -650,6 +733,30 @@ BufferedReadCurrentPosition(
 	return bufferedRead->largeReadPosition + bufferedRead->bufferOffset;
 }
 
+/*
+ * Return the address of the len bytes at position in the current file, if
+ * they are all in the current large read, or NULL otherwise.
+ *
+ * This neither reads anything nor moves the current buffer; it only lets the
+ * caller look at what was already read beyond it.
+ */
+uint8 *
+BufferedReadPeek(
+				 BufferedRead *bufferedRead,
+				 int64 position,
+				 int32 len)
+{
+	Assert(bufferedRead != NULL);
+	Assert(bufferedRead->file >= 0);
+	Assert(len > 0);
+
+	if (position < bufferedRead->largeReadPosition ||
+		position + len > bufferedRead->largeReadPosition + bufferedRead->largeReadLen)
+		return NULL;
+
+	return &bufferedRead->largeReadMemory[position - bufferedRead->largeReadPosition];
+}
+
 /*
  * Flushes the current file for append.  Caller is responsible for closing
  * the file afterwards.
@@ -670,6 +777,9 @@ BufferedReadCompleteFile(
 
 	bufferedRead->largeReadPosition = 0;
 	bufferedRead->largeReadLen = 0;
+
+	bufferedRead->prefetchStart = 0;
+	bufferedRead->prefetchPosition = 0;
 }
 
 
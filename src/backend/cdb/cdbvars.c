@@ -220,6 +220,14 @@ bool		gp_interconnect_full_crc = false;	/* sanity check UDP data. */
 
 bool		gp_interconnect_log_stats = false;	/* emit stats at log-level */
 
+int			gp_interconnect_udp_batch_size = 16;
+
+bool		gp_interconnect_udp_gso = false;
+
+bool		gp_interconnect_compression = false;
+
+int			gp_motion_batch_size = 0;
+
 bool		gp_interconnect_cache_future_packets = true;
 
 int			Gp_postmaster_address_family_type = POSTMASTER_ADDRESS_FAMILY_TYPE_AUTO;
@@ -289,6 +297,9 @@ int			gp_segworker_relative_priority = PRIO_MAX;
 /* Max size of dispatched plans; 0 if no limit */
 int			gp_max_plan_size = 0;
 
+/* Number of dispatched plans each QE keeps for reuse; 0 disables */
+int			gp_dispatch_plan_cache_size = 16;
+
 /* Disable setting of tuple hints while reading */
 bool		gp_disable_tuple_hints = false;
 
@@ -140,6 +140,9 @@ cdbconn_doConnectStart(SegmentDatabaseDescriptor *segdbDesc,
 	char		keepalivesIntervalStr[MAX_INT_STRING_LEN];
 	int			nkeywords = 0;
 
+	/* The new QE process starts with an empty dispatch plan cache */
+	MemSet(segdbDesc->cachedPlans, 0, sizeof(segdbDesc->cachedPlans));
+
 	keywords[nkeywords] = "gpqeid";
 	values[nkeywords] = gpqeid;
 	nkeywords++;
@@ -331,6 +331,15 @@ cdbdisp_makeDispatcherState(bool isExtendedQuery)
 	handle->dispatcherState->largestGangSize = 0;
 	handle->dispatcherState->rootGangSize = 0;
 	handle->dispatcherState->destroyIdleReaderGang = false;
+	handle->dispatcherState->planCacheSlot = -1;
+	MemSet(handle->dispatcherState->planDigest, 0, PG_SHA256_DIGEST_LENGTH);
+	handle->dispatcherState->planLen = 0;
+	handle->dispatcherState->cachedPlanQueryText = NULL;
+	handle->dispatcherState->cachedPlanQueryTextLen = 0;
+	handle->dispatcherState->buildCachedPlanQueryText = NULL;
+	handle->dispatcherState->buildCachedPlanQueryTextArg = NULL;
+	handle->dispatcherState->connectWaitCallback = NULL;
+	handle->dispatcherState->connectWaitArg = NULL;
 
 	return handle->dispatcherState;
 }
@@ -354,6 +363,51 @@ cdbdisp_makeDispatchParams(CdbDispatcherState *ds,
 	MemoryContextSwitchTo(oldContext);
 }
 
+/*
+ * Register the plan that the QEs are to keep in their dispatch plan cache.
+ *
+ * cdbdisp_dispatchToGang() sends the QEs that already hold the plan a variant
+ * of the query text without the plan tree. Most of the time no QE holds it,
+ * so that variant is only built, by 'buildQueryText', once one does.
+ */
+void
+cdbdisp_setCachedPlan(CdbDispatcherState *ds,
+					  int planCacheSlot,
+					  const uint8 *planDigest,
+					  int planLen,
+					  char *(*buildQueryText) (void *arg, int *len),
+					  void *buildQueryTextArg)
+{
+	Assert(planCacheSlot >= 0 && planCacheSlot < MAX_CACHED_DISPATCH_PLANS);
+	Assert(planLen > 0);
+
+	ds->planCacheSlot = planCacheSlot;
+	memcpy(ds->planDigest, planDigest, PG_SHA256_DIGEST_LENGTH);
+	ds->planLen = planLen;
+	ds->cachedPlanQueryText = NULL;
+	ds->cachedPlanQueryTextLen = 0;
+	ds->buildCachedPlanQueryText = buildQueryText;
+	ds->buildCachedPlanQueryTextArg = buildQueryTextArg;
+}
+
+/*
+ * Get the variant of the query text for QEs that already hold the plan,
+ * building it the first time.
+ */
+char *
+cdbdisp_getCachedPlanQueryText(CdbDispatcherState *ds, int *queryTextLen)
+{
+	Assert(ds->planCacheSlot >= 0);
+
+	if (ds->cachedPlanQueryText == NULL)
+		ds->cachedPlanQueryText =
+			ds->buildCachedPlanQueryText(ds->buildCachedPlanQueryTextArg,
+										 &ds->cachedPlanQueryTextLen);
+
+	*queryTextLen = ds->cachedPlanQueryTextLen;
+	return ds->cachedPlanQueryText;
+}
+
 /*
  * Free memory in CdbDispatcherState
  *
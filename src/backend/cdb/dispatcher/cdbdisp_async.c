@@ -329,7 +329,32 @@ cdbdisp_dispatchToGang_async(struct CdbDispatcherState *ds,
 		}
 		pParms->dispatchResultPtrArray[pParms->dispatchCount++] = qeResult;
 
-		dispatchCommand(qeResult, pParms->query_text, pParms->query_text_len);
+		/*
+		 * If the QE already holds the plan in its dispatch plan cache, send
+		 * only the digest of the plan. Otherwise send the whole plan, which
+		 * the QE will keep in the cache slot for the next time.
+		 */
+		if (ds->planCacheSlot >= 0 &&
+			segdbDesc->cachedPlans[ds->planCacheSlot].len == ds->planLen &&
+			memcmp(segdbDesc->cachedPlans[ds->planCacheSlot].digest,
+				   ds->planDigest, PG_SHA256_DIGEST_LENGTH) == 0)
+		{
+			char	   *cachedPlanQueryText;
+			int			cachedPlanQueryTextLen;
+
+			cachedPlanQueryText = cdbdisp_getCachedPlanQueryText(ds, &cachedPlanQueryTextLen);
+			dispatchCommand(qeResult, cachedPlanQueryText, cachedPlanQueryTextLen);
+		}
+		else
+		{
+			dispatchCommand(qeResult, pParms->query_text, pParms->query_text_len);
+			if (ds->planCacheSlot >= 0)
+			{
+				memcpy(segdbDesc->cachedPlans[ds->planCacheSlot].digest,
+					   ds->planDigest, PG_SHA256_DIGEST_LENGTH);
+				segdbDesc->cachedPlans[ds->planCacheSlot].len = ds->planLen;
+			}
+		}
 	}
 }
 
@@ -27,6 +27,7 @@
 #include "cdb/cdbsrlz.h"
 #include "cdb/tupleremap.h"
 #include "catalog/namespace.h" /* for GetTempNamespaceState() */
+#include "common/sha2.h"
 #include "nodes/execnodes.h"
 #include "pgstat.h"
 #include "tcop/tcopprot.h"
@@ -98,17 +99,43 @@ typedef struct DispatchCommandQueryParms
 	 */
 	char	   *serializedDtxContextInfo;
 	int			serializedDtxContextInfolen;
+
+	/*
+	 * SHA-256 digest of the serialized plan tree, and the slot of the QEs'
+	 * dispatch plan cache that holds it, if planCached. The QEs only reuse a
+	 * cached plan if both its digest and its length, serializedPlantreelen,
+	 * match.
+	 */
+	bool		planCached;
+	uint8		planDigest[PG_SHA256_DIGEST_LENGTH];
+	int			planCacheSlot;
 } DispatchCommandQueryParms;
 
+/*
+ * Argument of cdbdisp_serializePlan(), which may run while new gangs are
+ * being connected.
+ */
+typedef struct SerializePlanArg
+{
+	struct QueryDesc *queryDesc;
+	DispatchCommandQueryParms *pQueryParms;
+	MemoryContext memoryContext;
+} SerializePlanArg;
+
 static int fillSliceVector(SliceTable *sliceTable,
 				int sliceIndex,
 				SliceVec *sliceVector,
 				int len);
 
 static char *buildGpQueryString(DispatchCommandQueryParms *pQueryParms,
+				   bool planCached,
 				   int *finalLen);
+static char *buildCachedPlanGpQueryString(void *arg, int *finalLen);
 
-static DispatchCommandQueryParms *cdbdisp_buildPlanQueryParms(struct QueryDesc *queryDesc, bool planRequiresTxn);
+static void cdbdisp_serializePlan(void *arg);
+static void cdbdisp_buildPlanQueryParms(struct QueryDesc *queryDesc,
+										DispatchCommandQueryParms *pQueryParms,
+										bool planRequiresTxn);
 static DispatchCommandQueryParms *cdbdisp_buildUtilityQueryParms(struct Node *stmt, int flags, List *oid_assignments);
 static DispatchCommandQueryParms *cdbdisp_buildCommandQueryParms(const char *strCommand, int flags);
 
@@ -311,7 +338,7 @@ CdbDispatchSetCommand(const char *strCommand, bool cancelOnError)
 
 	ds = cdbdisp_makeDispatcherState(false);
 
-	queryText = buildGpQueryString(pQueryParms, &queryTextLength);
+	queryText = buildGpQueryString(pQueryParms, false, &queryTextLength);
 
 	primaryGang = AllocateGang(ds, GANGTYPE_PRIMARY_WRITER, cdbcomponent_getCdbComponentsList());
 	if (gp_print_create_gang_time)
@@ -487,7 +514,7 @@ cdbdisp_dispatchCommandInternal(DispatchCommandQueryParms *pQueryParms,
 	 */
 	ds->destroyIdleReaderGang = true;
 
-	queryText = buildGpQueryString(pQueryParms, &queryTextLength);
+	queryText = buildGpQueryString(pQueryParms, false, &queryTextLength);
 
 	/*
 	 * Allocate a primary QE for every available segDB in the system.
@@ -622,26 +649,31 @@ cdbdisp_buildUtilityQueryParms(struct Node *stmt,
 	return pQueryParms;
 }
 
-static DispatchCommandQueryParms *
-cdbdisp_buildPlanQueryParms(struct QueryDesc *queryDesc,
-							bool planRequiresTxn)
+/*
+ * Serialize the plan tree of a sliced plan into the DispatchCommandQueryParms.
+ *
+ * Unlike the QueryDispatchDesc, the plan tree doesn't depend on the gangs
+ * allocated for the slices, so cdbdisp_dispatchX() lets this run while the
+ * connections of new gangs are being established, see cdbgang_connectWait().
+ */
+static void
+cdbdisp_serializePlan(void *arg)
 {
-	char	   *splan,
-			   *sddesc;
-
+	SerializePlanArg *spArg = (SerializePlanArg *) arg;
+	DispatchCommandQueryParms *pQueryParms = spArg->pQueryParms;
+	MemoryContext oldContext;
+	char	   *splan;
 	int			splan_len,
-				splan_len_uncompressed,
-				sddesc_len;
-	Oid			save_userid;
+				splan_len_uncompressed;
 
-	DispatchCommandQueryParms *pQueryParms = (DispatchCommandQueryParms *) palloc0(sizeof(*pQueryParms));
+	oldContext = MemoryContextSwitchTo(spArg->memoryContext);
 
 	/*
 	 * serialized plan tree. Note that we're called for a single slice tree
 	 * (corresponding to an initPlan or the main plan), so the parameters are
 	 * fixed and we can include them in the prefix.
 	 */
-	splan = serializeNode((Node *) queryDesc->plannedstmt, &splan_len, &splan_len_uncompressed);
+	splan = serializeNode((Node *) spArg->queryDesc->plannedstmt, &splan_len, &splan_len_uncompressed);
 
 	uint64		plan_size_in_kb = ((uint64) splan_len_uncompressed) / (uint64) 1024;
 
@@ -660,12 +692,50 @@ cdbdisp_buildPlanQueryParms(struct QueryDesc *queryDesc,
 
 	Assert(splan != NULL && splan_len > 0 && splan_len_uncompressed > 0);
 
+	pQueryParms->serializedPlantree = splan;
+	pQueryParms->serializedPlantreelen = splan_len;
+
+	/*
+	 * Repeated executions of a statement usually produce the very same plan
+	 * tree; the parameter values travel in the QueryDispatchDesc. QEs keep
+	 * the plans they have seen in their dispatch plan cache, so that the
+	 * next time we only need to send the digest of the plan, see
+	 * cdbdisp_dispatchToGang(). The QE executes whatever plan it holds under
+	 * that digest, so it has to be collision resistant. A plan goes to the
+	 * cache slot picked by its digest, replacing whatever was there.
+	 */
+	if (gp_dispatch_plan_cache_size > 0)
+	{
+		pg_sha256_ctx sha256ctx;
+		uint32		slotHash;
+
+		pg_sha256_init(&sha256ctx);
+		pg_sha256_update(&sha256ctx, (const uint8 *) splan, splan_len);
+		pg_sha256_final(&sha256ctx, pQueryParms->planDigest);
+
+		memcpy(&slotHash, pQueryParms->planDigest, sizeof(slotHash));
+		pQueryParms->planCacheSlot = slotHash % gp_dispatch_plan_cache_size;
+		pQueryParms->planCached = true;
+	}
+
+	MemoryContextSwitchTo(oldContext);
+}
+
+static void
+cdbdisp_buildPlanQueryParms(struct QueryDesc *queryDesc,
+							DispatchCommandQueryParms *pQueryParms,
+							bool planRequiresTxn)
+{
+	char	   *sddesc;
+	int			sddesc_len;
+	Oid			save_userid;
+
+	Assert(pQueryParms->serializedPlantree != NULL);
+
 	GetUserIdAndSecContext(&save_userid, &queryDesc->ddesc->secContext);
 	sddesc = serializeNode((Node *) queryDesc->ddesc, &sddesc_len, NULL /* uncompressed_size */ );
 
 	pQueryParms->strCommand = queryDesc->sourceText;
-	pQueryParms->serializedPlantree = splan;
-	pQueryParms->serializedPlantreelen = splan_len;
 	pQueryParms->serializedQueryDispatchDesc = sddesc;
 	pQueryParms->serializedQueryDispatchDesclen = sddesc_len;
 
@@ -681,8 +751,6 @@ cdbdisp_buildPlanQueryParms(struct QueryDesc *queryDesc,
 								  queryDesc->extended_query,
 								  mppTxnOptions(planRequiresTxn),
 								  "cdbdisp_buildPlanQueryParms");
-
-	return pQueryParms;
 }
 
 /*
@@ -851,16 +919,25 @@ fillSliceVector(SliceTable *sliceTbl, int rootIdx,
 
 /*
  * Build a query string to be dispatched to QE.
+ *
+ * If the plan is to be kept in the QEs' dispatch plan cache, the query
+ * string carries the cache slot, and the digest and length of the plan. With
+ * 'planCached', the plan tree itself is left out, for the QEs that already
+ * hold it.
  */
 static char *
 buildGpQueryString(DispatchCommandQueryParms *pQueryParms,
+				   bool planCached,
 				   int *finalLen)
 {
 	const char *command = pQueryParms->strCommand;
 	int			command_len;
 	int			is_hs_dispatch = IS_HOT_STANDBY_QD() ? 1 : 0;
 	const char *plantree = pQueryParms->serializedPlantree;
-	int			plantree_len = pQueryParms->serializedPlantreelen;
+	int			plantree_len = planCached ? 0 : pQueryParms->serializedPlantreelen;
+	int			plan_cache_slot = pQueryParms->planCached ? pQueryParms->planCacheSlot : -1;
+	const uint8 *plan_digest = pQueryParms->planDigest;
+	int			plan_len = pQueryParms->planCached ? pQueryParms->serializedPlantreelen : 0;
 	const char *sddesc = pQueryParms->serializedQueryDispatchDesc;
 	int			sddesc_len = pQueryParms->serializedQueryDispatchDesclen;
 	const char *dtxContextInfo = pQueryParms->serializedDtxContextInfo;
@@ -918,6 +995,9 @@ buildGpQueryString(DispatchCommandQueryParms *pQueryParms,
 		sizeof(plantree_len) +
 		sizeof(sddesc_len) +
 		sizeof(dtxContextInfo_len) +
+		sizeof(plan_cache_slot) +
+		PG_SHA256_DIGEST_LENGTH /* plan_digest */ +
+		sizeof(plan_len) +
 		dtxContextInfo_len +
 		command_len +
 		plantree_len +
@@ -989,6 +1069,17 @@ buildGpQueryString(DispatchCommandQueryParms *pQueryParms,
 	memcpy(pos, &tmp, sizeof(tmp));
 	pos += sizeof(tmp);
 
+	tmp = htonl(plan_cache_slot);
+	memcpy(pos, &tmp, sizeof(plan_cache_slot));
+	pos += sizeof(plan_cache_slot);
+
+	memcpy(pos, plan_digest, PG_SHA256_DIGEST_LENGTH);
+	pos += PG_SHA256_DIGEST_LENGTH;
+
+	tmp = htonl(plan_len);
+	memcpy(pos, &tmp, sizeof(plan_len));
+	pos += sizeof(plan_len);
+
 	if (dtxContextInfo_len > 0)
 	{
 		memcpy(pos, dtxContextInfo, dtxContextInfo_len);
@@ -1053,6 +1144,17 @@ buildGpQueryString(DispatchCommandQueryParms *pQueryParms,
 	return shared_query;
 }
 
+/*
+ * Build the query string for QEs that already hold the plan in their
+ * dispatch plan cache. cdbdisp_getCachedPlanQueryText() calls this the first
+ * time such a QE is found.
+ */
+static char *
+buildCachedPlanGpQueryString(void *arg, int *finalLen)
+{
+	return buildGpQueryString((DispatchCommandQueryParms *) arg, true, finalLen);
+}
+
 /*
  * This function is used for dispatching sliced plans
  */
@@ -1074,6 +1176,7 @@ cdbdisp_dispatchX(QueryDesc* queryDesc,
 	CdbDispatcherState *ds;
 	ErrorData *qeError = NULL;
 	DispatchCommandQueryParms *pQueryParms;
+	SerializePlanArg spArg;
 
 	if (log_dispatch_stats)
 		ResetUsage();
@@ -1086,6 +1189,18 @@ cdbdisp_dispatchX(QueryDesc* queryDesc,
 
 	ds = cdbdisp_makeDispatcherState(queryDesc->extended_query);
 
+	pQueryParms = (DispatchCommandQueryParms *) palloc0(sizeof(*pQueryParms));
+
+	/*
+	 * If new gangs need to be created, serialize the plan tree while their
+	 * connections are being established.
+	 */
+	spArg.queryDesc = queryDesc;
+	spArg.pQueryParms = pQueryParms;
+	spArg.memoryContext = CurrentMemoryContext;
+	ds->connectWaitCallback = cdbdisp_serializePlan;
+	ds->connectWaitArg = &spArg;
+
 	/*
 	 * Since we intend to execute the plan, inventory the slice tree,
 	 * allocate gangs, and associate them with slices.
@@ -1097,6 +1212,14 @@ cdbdisp_dispatchX(QueryDesc* queryDesc,
 	 */
 	AssignGangs(ds, queryDesc);
 
+	/* All gangs were reused from the idle pool, serialize the plan tree now */
+	if (ds->connectWaitCallback != NULL)
+	{
+		ds->connectWaitCallback = NULL;
+		cdbdisp_serializePlan(&spArg);
+	}
+	ds->connectWaitArg = NULL;
+
 	/*
 	 * Traverse the slice tree in sliceTbl rooted at rootIdx and build a
 	 * vector of slice indexes specifying the order of [potential] dispatch.
@@ -1107,8 +1230,8 @@ cdbdisp_dispatchX(QueryDesc* queryDesc,
 	/* Each slice table has a unique-id. */
 	sliceTbl->ic_instance_id = ++gp_interconnect_id;
 
-	pQueryParms = cdbdisp_buildPlanQueryParms(queryDesc, planRequiresTxn);
-	queryText = buildGpQueryString(pQueryParms, &queryTextLength);
+	cdbdisp_buildPlanQueryParms(queryDesc, pQueryParms, planRequiresTxn);
+	queryText = buildGpQueryString(pQueryParms, false, &queryTextLength);
 
 	/*
 	 * Allocate result array with enough slots for QEs of primary gangs.
@@ -1116,6 +1239,13 @@ cdbdisp_dispatchX(QueryDesc* queryDesc,
 	cdbdisp_makeDispatchResults(ds, nTotalSlices, cancelOnError);
 	cdbdisp_makeDispatchParams(ds, nTotalSlices, queryText, queryTextLength);
 
+	if (pQueryParms->planCached)
+		cdbdisp_setCachedPlan(ds, pQueryParms->planCacheSlot,
+							  pQueryParms->planDigest,
+							  pQueryParms->serializedPlantreelen,
+							  buildCachedPlanGpQueryString,
+							  pQueryParms);
+
 	cdb_total_plans++;
 	cdb_total_slices += nSlices;
 	if (nSlices > cdb_max_slices)
@@ -1350,7 +1480,7 @@ CdbDispatchCopyStart(struct CdbCopy *cdbCopy, Node *stmt, int flags)
 	 */
 	ds = cdbdisp_makeDispatcherState(false);
 
-	queryText = buildGpQueryString(pQueryParms, &queryTextLength);
+	queryText = buildGpQueryString(pQueryParms, false, &queryTextLength);
 
 	/*
 	 * Allocate a primary QE for every available segDB in the system.
@@ -254,6 +254,15 @@ cdbdisp_seterrcode(int errcode, /* ERRCODE_xxx or 0 */
 		dispatchResult->errcode = errcode;
 	}
 
+	/*
+	 * The QE might have failed before it stored the plan we sent it, so
+	 * forget what we know about its dispatch plan cache. It gets the full
+	 * plan again next time.
+	 */
+	if (dispatchResult->segdbDesc)
+		MemSet(dispatchResult->segdbDesc->cachedPlans, 0,
+			   sizeof(dispatchResult->segdbDesc->cachedPlans));
+
 	if (!meleeResults)
 		return;
 
@@ -75,6 +75,9 @@ Gang      *CurrentGangCreating = NULL;
 
 CreateGangFunc pCreateGangFunc = cdbgang_createGang_async;
 
+/* The dispatcher state AllocateGang() is creating a gang for */
+static CdbDispatcherState *AllocatingDispatcherState = NULL;
+
 static bool NeedResetSession = false;
 static Oid	OldTempNamespace = InvalidOid;
 static Oid	OldTempToastNamespace = InvalidOid;
@@ -132,7 +135,13 @@ AllocateGang(CdbDispatcherState *ds, GangType type, List *segments)
 	else
 		segmentType = SEGMENTTYPE_ANY;
 
+	/*
+	 * Set it even if there is no work to do while connecting, lest an
+	 * earlier allocation that errored out left it behind.
+	 */
+	AllocatingDispatcherState = ds;
 	newGang = cdbgang_createGang(segments, segmentType);
+	AllocatingDispatcherState = NULL;
 	newGang->allocated = true;
 	newGang->type = type;
 
@@ -161,6 +170,28 @@ AllocateGang(CdbDispatcherState *ds, GangType type, List *segments)
 	return newGang;
 }
 
+/*
+ * Called by the gang creation once it has started to connect to the QEs,
+ * to run the connect wait callback of the dispatcher state the gang is for,
+ * if any. This lets the dispatcher get some work done, e.g. serialize the
+ * plan, instead of idly waiting for the QEs to start up.
+ */
+void
+cdbgang_connectWait(void)
+{
+	CdbDispatcherState *ds = AllocatingDispatcherState;
+	void		(*callback) (void *arg);
+
+	if (ds == NULL || ds->connectWaitCallback == NULL)
+		return;
+
+	/* clear it first, it is to be called only once */
+	callback = ds->connectWaitCallback;
+	ds->connectWaitCallback = NULL;
+
+	callback(ds->connectWaitArg);
+}
+
 /*
  * Check the segment failure reason by comparing connection error message.
  */
@@ -182,6 +182,12 @@ create_gang_retry:
 			pollingStatus[i] = PGRES_POLLING_WRITING;
 		}
 
+		/*
+		 * The QEs take a while to start up. Let the dispatcher do its own
+		 * work meanwhile, before it gets to wait for them.
+		 */
+		cdbgang_connectWait();
+
 		/*
 		 * Ok, we've now launched all the connection attempts. Start the
 		 * timeout clock (= get the start timestamp), and poll until they're
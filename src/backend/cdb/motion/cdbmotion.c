@@ -26,6 +26,7 @@
 #include "cdb/ml_ipc.h"
 #include "cdb/tupleremap.h"
 #include "cdb/tupser.h"
+#include "executor/tuptable.h"
 #include "utils/memutils.h"
 #include "utils/typcache.h"
 
@@ -70,11 +71,27 @@ static void processIncomingChunks(MotionLayerState *mlStates,
 
 static inline void reconstructTuple(MotionNodeEntry *pMNEntry, ChunkSorterEntry *pCSEntry, TupleRemapper *remapper);
 
+static SerTupBatch *getSendBatch(MotionLayerState *mlStates,
+								 ChunkTransportState *transportStates,
+								 MotionNodeEntry *pMNEntry,
+								 int16 motNodeID,
+								 int16 targetRoute);
+static SendReturnCode sendBatch(MotionLayerState *mlStates,
+								ChunkTransportState *transportStates,
+								MotionNodeEntry *pMNEntry,
+								int16 motNodeID,
+								int16 targetRoute,
+								SerTupBatch *batch);
+static void flushSendBatches(MotionLayerState *mlStates,
+							 ChunkTransportState *transportStates,
+							 MotionNodeEntry *pMNEntry,
+							 int16 motNodeID);
+
 /* Stats-function declarations. */
 static void statSendTuple(MotionLayerState *mlStates, MotionNodeEntry *pMNEntry, TupleChunkList tcList);
 static void statSendEOS(MotionLayerState *mlStates, MotionNodeEntry *pMNEntry);
 static void statChunksProcessed(MotionLayerState *mlStates, MotionNodeEntry *pMNEntry, int chunksProcessed, int chunkBytes, int tupleBytes);
-static void statNewTupleArrived(MotionNodeEntry *pMNEntry, ChunkSorterEntry *pCSEntry);
+static void statNewTupleArrived(MotionNodeEntry *pMNEntry, ChunkSorterEntry *pCSEntry, int ntuples);
 static void statRecvTuple(MotionNodeEntry *pMNEntry, ChunkSorterEntry *pCSEntry);
 static bool ShouldSendRecordCache(MotionConn *conn, SerTupInfo *pSerInfo);
 static void UpdateSentRecordCache(MotionConn *conn);
@@ -108,7 +125,7 @@ reconstructTuple(MotionNodeEntry *pMNEntry, ChunkSorterEntry *pCSEntry, TupleRem
 	htfifo_addtuple(pCSEntry->ready_tuples, tup);
 
 	/* Stats */
-	statNewTupleArrived(pMNEntry, pCSEntry);
+	statNewTupleArrived(pMNEntry, pCSEntry, 1);
 }
 
 /*
@@ -273,6 +290,8 @@ UpdateMotionLayerNode(MotionLayerState *mlStates, int16 motNodeID, bool preserve
 	pEntry->preserve_order = preserveOrder;
 	pEntry->tuple_desc = CreateTupleDescCopy(tupDesc);
 	InitSerTupInfo(pEntry->tuple_desc, &pEntry->ser_tup_info);
+	pEntry->send_batches = NULL;
+	pEntry->num_send_batches = 0;
 
 	if (!preserveOrder)
 	{
@@ -353,6 +372,14 @@ SendStopMessage(MotionLayerState *mlStates,
 		transportStates->doSendStopMessage(transportStates, motNodeID);
 }
 
+uint64
+GetMotionBytesSaved(MotionLayerState *mlStates, int16 motNodeID)
+{
+	MotionNodeEntry *pEntry = getMotionNodeEntry(mlStates, motNodeID);
+
+	return pEntry->stat_bytes_saved_recvd;
+}
+
 void
 CheckAndSendRecordCache(MotionLayerState *mlStates,
 						ChunkTransportState *transportStates,
@@ -460,6 +487,19 @@ SendTuple(MotionLayerState *mlStates,
 	 */
 	pMNEntry = getMotionNodeEntry(mlStates, motNodeID);
 
+	if (pMNEntry->ser_tup_info.batch_rows > 0)
+	{
+		SerTupBatch *batch = getSendBatch(mlStates, transportStates, pMNEntry,
+										  motNodeID, targetRoute);
+
+		/* Send the batch once it is full */
+		if (!AddTupleToBatch(slot, &pMNEntry->ser_tup_info, batch))
+			return SEND_COMPLETE;
+
+		return sendBatch(mlStates, transportStates, pMNEntry, motNodeID,
+						 targetRoute, batch);
+	}
+
 #ifdef AMS_VERBOSE_LOGGING
 	elog(DEBUG5, "Serializing HeapTuple for sending.");
 #endif
@@ -521,6 +561,119 @@ SendTuple(MotionLayerState *mlStates,
 	return rc;
 }
 
+/*
+ * Get the batch of tuples being filled for targetRoute, when the motion node
+ * sends its tuples in the batch format.
+ */
+static SerTupBatch *
+getSendBatch(MotionLayerState *mlStates,
+			 ChunkTransportState *transportStates,
+			 MotionNodeEntry *pMNEntry,
+			 int16 motNodeID,
+			 int16 targetRoute)
+{
+	MemoryContext oldCtxt;
+	int			i;
+
+	if (pMNEntry->send_batches == NULL)
+	{
+		ChunkTransportStateEntry *pEntry = NULL;
+
+		getChunkTransportState(transportStates, motNodeID, &pEntry);
+
+		pMNEntry->num_send_batches = pEntry->numConns + 1;
+		pMNEntry->send_batches = (SerTupBatch **)
+			MemoryContextAllocZero(mlStates->motion_layer_mctx,
+								   pMNEntry->num_send_batches * sizeof(SerTupBatch *));
+	}
+
+	if (targetRoute == BROADCAST_SEGIDX)
+		i = pMNEntry->num_send_batches - 1;
+	else if (targetRoute >= 0 && targetRoute < pMNEntry->num_send_batches - 1)
+		i = targetRoute;
+	else
+		elog(ERROR, "invalid target route %d for motion node %d",
+			 targetRoute, motNodeID);
+
+	if (pMNEntry->send_batches[i] == NULL)
+	{
+		oldCtxt = MemoryContextSwitchTo(mlStates->motion_layer_mctx);
+		pMNEntry->send_batches[i] = CreateSerTupBatch(&pMNEntry->ser_tup_info);
+		MemoryContextSwitchTo(oldCtxt);
+	}
+
+	return pMNEntry->send_batches[i];
+}
+
+/*
+ * Send the tuples of a batch to targetRoute, as one chunk.
+ */
+static SendReturnCode
+sendBatch(MotionLayerState *mlStates,
+		  ChunkTransportState *transportStates,
+		  MotionNodeEntry *pMNEntry,
+		  int16 motNodeID,
+		  int16 targetRoute,
+		  SerTupBatch *batch)
+{
+	TupleChunkListData tcList;
+	MemoryContext oldCtxt;
+	SendReturnCode rc;
+	int			ntuples = batch->nrows;
+
+	oldCtxt = MemoryContextSwitchTo(mlStates->motion_layer_mctx);
+
+	SerializeBatchIntoChunks(&pMNEntry->ser_tup_info, batch, &tcList);
+
+	MemoryContextSwitchTo(oldCtxt);
+
+	if (!SendTupleChunkToAMS(mlStates, transportStates, motNodeID, targetRoute, tcList.p_first))
+	{
+		pMNEntry->stopped = true;
+		rc = STOP_SENDING;
+	}
+	else
+	{
+		/* update stats; statSendTuple() counts the batch as one tuple */
+		statSendTuple(mlStates, pMNEntry, &tcList);
+		pMNEntry->stat_total_sends += ntuples - 1;
+
+		rc = SEND_COMPLETE;
+	}
+
+	clearTCList(&pMNEntry->ser_tup_info.chunkCache, &tcList);
+
+	return rc;
+}
+
+/*
+ * Send the tuples that are still waiting in batches.
+ */
+static void
+flushSendBatches(MotionLayerState *mlStates,
+				 ChunkTransportState *transportStates,
+				 MotionNodeEntry *pMNEntry,
+				 int16 motNodeID)
+{
+	int			i;
+
+	for (i = 0; i < pMNEntry->num_send_batches && !pMNEntry->stopped; i++)
+	{
+		SerTupBatch *batch = pMNEntry->send_batches[i];
+		int16		targetRoute;
+
+		if (batch == NULL || batch->nrows == 0)
+			continue;
+
+		if (i == pMNEntry->num_send_batches - 1)
+			targetRoute = BROADCAST_SEGIDX;
+		else
+			targetRoute = i;
+
+		sendBatch(mlStates, transportStates, pMNEntry, motNodeID, targetRoute, batch);
+	}
+}
+
 /*
  * Sends a token to all peer Motion Nodes, indicating that this motion
  * node has no more tuples to send out.
@@ -539,6 +692,10 @@ SendEndOfStream(MotionLayerState *mlStates,
 	 */
 	pMNEntry = getMotionNodeEntry(mlStates, motNodeID);
 
+	/* The tuples held back in batches go ahead of end-of-stream. */
+	if (pMNEntry->send_batches != NULL)
+		flushSendBatches(mlStates, transportStates, pMNEntry, motNodeID);
+
 	transportStates->SendEos(transportStates, motNodeID, s_eos_chunk_data);
 
 	/*
@@ -555,18 +712,19 @@ SendEndOfStream(MotionLayerState *mlStates,
  * Receive one tuple from a sender. An unordered receiver will call this with
  * srcRoute == ANY_ROUTE.
  *
- * The tuple is stored in *slot.
+ * The tuple is stored in *slot, which is returned, or NULL at end-of-stream.
  */
-MinimalTuple
+TupleTableSlot *
 RecvTupleFrom(MotionLayerState *mlStates,
 			  ChunkTransportState *transportStates,
 			  int16 motNodeID,
-			  int16 srcRoute)
+			  int16 srcRoute,
+			  TupleTableSlot *slot)
 {
 	MotionNodeEntry *pMNEntry;
 	ChunkSorterEntry *pCSEntry;
 	htup_fifo	ReadyList;
-	MinimalTuple tuple = NULL;
+	bool		found = false;
 
 #ifdef AMS_VERBOSE_LOGGING
 	elog(DEBUG5, "RecvTupleFrom( motNodeID = %d, srcRoute = %d )", motNodeID, srcRoute);
@@ -595,10 +753,26 @@ RecvTupleFrom(MotionLayerState *mlStates,
 
 	for (;;)
 	{
+		MinimalTuple tuple;
+		TupleBatch	batch;
+
 		/* Get the next tuple from the FIFO, if one is available. */
 		tuple = htfifo_gettuple(ReadyList);
 		if (tuple)
+		{
+			ExecStoreMinimalTuple(tuple, slot, true /* shouldFree */ );
+			found = true;
 			break;
+		}
+
+		/* Or the next one of a batch. */
+		batch = htfifo_getbatch(ReadyList);
+		if (batch)
+		{
+			TupleBatchNextTuple(batch, slot);
+			found = true;
+			break;
+		}
 
 		/*
 		 * We need to get more chunks before we have a full tuple to return. Loop
@@ -618,11 +792,13 @@ RecvTupleFrom(MotionLayerState *mlStates,
 		processIncomingChunks(mlStates, transportStates, pMNEntry, motNodeID, srcRoute);
 	}
 
+	if (!found)
+		return NULL;
+
 	/* Stats */
-	if (tuple)
-		statRecvTuple(pMNEntry, pCSEntry);
+	statRecvTuple(pMNEntry, pCSEntry);
 
-	return tuple;
+	return slot;
 }
 
 
@@ -671,6 +847,10 @@ processIncomingChunks(MotionLayerState *mlStates,
 	getChunkTransportState(transportStates, motNodeID, &pEntry);
 	conn = pEntry->conns + srcRoute;
 
+	/* Bytes that arrived compressed */
+	pMNEntry->stat_bytes_saved_recvd += conn->stat_bytes_saved;
+	conn->stat_bytes_saved = 0;
+
 	numChunks = 0;
 	chunkBytes = 0;
 	tupleBytes = 0;
@@ -837,6 +1017,17 @@ EndMotionLayerNode(MotionLayerState *mlStates, int16 motNodeID, bool flushCommLa
 		}
 	}
 
+	if (pMNEntry->send_batches != NULL)
+	{
+		for (i = 0; i < pMNEntry->num_send_batches; i++)
+		{
+			if (pMNEntry->send_batches[i] != NULL)
+				pfree(pMNEntry->send_batches[i]);
+		}
+		pfree(pMNEntry->send_batches);
+		pMNEntry->send_batches = NULL;
+	}
+
 	CleanupSerTupInfo(&pMNEntry->ser_tup_info);
 	FreeTupleDesc(pMNEntry->tuple_desc);
 	if (!pMNEntry->preserve_order)
@@ -1088,6 +1279,32 @@ addChunkToSorter(ChunkTransportState *transportStates,
 
 			break;
 
+		case TC_BATCH:
+			/* There shouldn't be any partial tuple data in the list! */
+			if (chunkSorterEntry->chunk_list.num_chunks != 0)
+			{
+				ereport(ERROR,
+						(errcode(ERRCODE_GP_INTERCONNECTION_ERROR),
+						 errmsg("received TC_BATCH chunk from [src=%d,mn=%d] after partial tuple data",
+								srcRoute, motNodeID)));
+			}
+
+			/*
+			 * The tuples are handed out one by one, as they are asked for,
+			 * from a copy of the chunk.
+			 */
+			{
+				TupleBatch	batch;
+
+				batch = CvtChunkToBatch(tcItem, &pMNEntry->ser_tup_info);
+				pfree(tcItem);
+
+				htfifo_addbatch(chunkSorterEntry->ready_tuples, batch);
+
+				statNewTupleArrived(pMNEntry, chunkSorterEntry, batch->nrows);
+			}
+			break;
+
 		case TC_END_OF_STREAM:
 #ifdef AMS_VERBOSE_LOGGING
 			elog(LOG, "Got end-of-stream. motnode %d route %d", motNodeID, srcRoute);
@@ -1202,7 +1419,7 @@ statChunksProcessed(MotionLayerState *mlStates, MotionNodeEntry *pMNEntry, int c
 }
 
 static void
-statNewTupleArrived(MotionNodeEntry *pMNEntry, ChunkSorterEntry *pCSEntry)
+statNewTupleArrived(MotionNodeEntry *pMNEntry, ChunkSorterEntry *pCSEntry, int ntuples)
 {
 	uint32		tupsAvail;
 
@@ -1216,7 +1433,7 @@ statNewTupleArrived(MotionNodeEntry *pMNEntry, ChunkSorterEntry *pCSEntry)
 	 * Also, if the motion node is order-preserving, we track a per-sender
 	 * high-watermark as well.
 	 */
-	tupsAvail = ++(pMNEntry->stat_tuples_available);
+	tupsAvail = (pMNEntry->stat_tuples_available += ntuples);
 	if (pMNEntry->stat_tuples_available_hwm < tupsAvail)
 	{
 		/* New high-watermark! */
@@ -18,6 +18,7 @@
 #include "access/heapam.h"
 #include "utils/memutils.h"
 #include "cdb/htupfifo.h"
+#include "cdb/tupser.h"
 
 static void htfifo_cleanup(htup_fifo htf);
 
@@ -36,6 +37,8 @@ htfifo_create(void)
 
 	htf->freelist = NULL;
 
+	htf->batches = NIL;
+
 	return htf;
 }
 
@@ -65,6 +68,9 @@ htfifo_cleanup(htup_fifo htf)
 
 	htf->p_first = NULL;
 	htf->p_last = NULL;
+
+	list_free_deep(htf->batches);
+	htf->batches = NIL;
 }
 
 /*
@@ -174,3 +180,41 @@ htfifo_gettuple(htup_fifo htf)
 
 	return tup;
 }
+
+/*
+ * Append a batch of tuples to the FIFO.
+ *
+ * The batches are kept apart from the tuples: a sender sends either one or
+ * the other, so there is no order between them to maintain.
+ */
+void
+htfifo_addbatch(htup_fifo htf, TupleBatch batch)
+{
+	AssertArg(htf != NULL);
+	AssertArg(batch != NULL && batch->nrows > 0);
+
+	htf->batches = lappend(htf->batches, batch);
+}
+
+/*
+ * Retrieve the first batch of the FIFO with tuples left in it, freeing the
+ * batches that have been consumed.  If there is none, NULL is returned.
+ */
+TupleBatch
+htfifo_getbatch(htup_fifo htf)
+{
+	AssertArg(htf != NULL);
+
+	while (htf->batches != NIL)
+	{
+		TupleBatch	batch = (TupleBatch) linitial(htf->batches);
+
+		if (batch->next < batch->nrows)
+			return batch;
+
+		htf->batches = list_delete_first(htf->batches);
+		pfree(batch);
+	}
+
+	return NULL;
+}
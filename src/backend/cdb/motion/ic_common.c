@@ -31,10 +31,25 @@
 #include <sys/time.h>
 #include <netinet/in.h>
 
+#ifdef USE_ZSTD
+#include <zstd.h>
+#endif
+
 /*
   #define AMS_VERBOSE_LOGGING
 */
 
+/*
+ * Packets with less tuple data than this are not worth compressing.
+ */
+#define IC_COMPRESS_MIN_BYTES		256
+
+/*
+ * Number of packets of a connection sent uncompressed after one that zstd
+ * did not shrink by at least 1/8th.
+ */
+#define IC_COMPRESS_BACKOFF_PACKETS	16
+
 /*=========================================================================
  * STRUCTS
  */
@@ -70,6 +85,8 @@ static void cleanup_interconnect_handle(interconnect_handle_t *h);
 static interconnect_handle_t *allocate_interconnect_handle(void);
 static void destroy_interconnect_handle(interconnect_handle_t *h);
 static interconnect_handle_t *find_interconnect_handle(ChunkTransportState *icContext);
+static uint8 *decompressChunks(MotionConn *conn, uint8 *chunk, int chunkSize,
+							   int *dataSize);
 
 static void
 logChunkParseDetails(MotionConn *conn, uint32 ic_instance_id)
@@ -96,6 +113,8 @@ RecvTupleChunk(MotionConn *conn, ChunkTransportState *transportStates)
 	TupleChunkListItem lastTcItem = NULL;
 	uint32		tcSize;
 	int			bytesProcessed = 0;
+	uint8	   *data;
+	int			dataSize;
 
 	if (Gp_interconnect_type == INTERCONNECT_TYPE_TCP ||
 		Gp_interconnect_type == INTERCONNECT_TYPE_PROXY)
@@ -117,9 +136,24 @@ RecvTupleChunk(MotionConn *conn, ChunkTransportState *transportStates)
 		 conn->recvBytes, conn->msgSize, conn->pBuff, conn->msgPos);
 #endif
 
-	while (bytesProcessed != conn->msgSize)
+	data = conn->msgPos;
+	dataSize = conn->msgSize;
+
+	/*
+	 * A compressed packet carries a single TC_COMPRESSED chunk: form the
+	 * TupleChunks out of what it expands to.
+	 */
+	if (dataSize - bytesProcessed >= TUPLE_CHUNK_HEADER_SIZE &&
+		*(uint16 *) (data + bytesProcessed + 2) == TC_COMPRESSED)
 	{
-		if (conn->msgSize - bytesProcessed < TUPLE_CHUNK_HEADER_SIZE)
+		data = decompressChunks(conn, data + bytesProcessed,
+								dataSize - bytesProcessed, &dataSize);
+		bytesProcessed = 0;
+	}
+
+	while (bytesProcessed != dataSize)
+	{
+		if (dataSize - bytesProcessed < TUPLE_CHUNK_HEADER_SIZE)
 		{
 			logChunkParseDetails(conn, transportStates->sliceTable->ic_instance_id);
 
@@ -127,10 +161,10 @@ RecvTupleChunk(MotionConn *conn, ChunkTransportState *transportStates)
 					(errcode(ERRCODE_GP_INTERCONNECTION_ERROR),
 					 errmsg("interconnect error parsing message: insufficient data received"),
 					 errdetail("conn->msgSize %d bytesProcessed %d < chunk-header %d",
-							   conn->msgSize, bytesProcessed, TUPLE_CHUNK_HEADER_SIZE)));
+							   dataSize, bytesProcessed, TUPLE_CHUNK_HEADER_SIZE)));
 		}
 
-		tcSize = TUPLE_CHUNK_HEADER_SIZE + (*(uint16 *) (conn->msgPos + bytesProcessed));
+		tcSize = TUPLE_CHUNK_HEADER_SIZE + (*(uint16 *) (data + bytesProcessed));
 
 		/* sanity check */
 		if (tcSize > Gp_max_packet_size)
@@ -157,7 +191,7 @@ RecvTupleChunk(MotionConn *conn, ChunkTransportState *transportStates)
 					 errdetail("tcSize %d > max %d header %d processed %d/%d from %p",
 							   tcSize, Gp_max_packet_size,
 							   TUPLE_CHUNK_HEADER_SIZE, bytesProcessed,
-							   conn->msgSize, conn->msgPos)));
+							   dataSize, data)));
 		}
 
 
@@ -168,7 +202,7 @@ RecvTupleChunk(MotionConn *conn, ChunkTransportState *transportStates)
 		if (Gp_interconnect_type == INTERCONNECT_TYPE_TCP ||
 			Gp_interconnect_type == INTERCONNECT_TYPE_PROXY)
 		{
-			if (tcSize >= conn->msgSize)
+			if (bytesProcessed + tcSize > dataSize)
 			{
 				/*
 				 * see MPP-720: it is possible that our message got messed up
@@ -181,11 +215,11 @@ RecvTupleChunk(MotionConn *conn, ChunkTransportState *transportStates)
 				ereport(ERROR,
 						(errcode(ERRCODE_GP_INTERCONNECTION_ERROR),
 						 errmsg("interconnect error parsing message"),
-						 errdetail("tcSize %d >= conn->msgSize %d",
-								   tcSize, conn->msgSize)));
+						 errdetail("tcSize %d at %d > conn->msgSize %d",
+								   tcSize, bytesProcessed, dataSize)));
 			}
 		}
-		Assert(tcSize < conn->msgSize);
+		Assert(bytesProcessed + tcSize <= dataSize);
 
 		/*
 		 * We store the data inplace, and handle any necessary copying later
@@ -195,7 +229,7 @@ RecvTupleChunk(MotionConn *conn, ChunkTransportState *transportStates)
 
 		tcItem->p_next = NULL;
 		tcItem->chunk_length = tcSize;
-		tcItem->inplace = (char *) (conn->msgPos + bytesProcessed);
+		tcItem->inplace = (char *) (data + bytesProcessed);
 
 		bytesProcessed += tcSize;
 
@@ -225,6 +259,133 @@ RecvTupleChunk(MotionConn *conn, ChunkTransportState *transportStates)
 	return firstTcItem;
 }
 
+/*
+ * Expand the TC_COMPRESSED chunk of a packet received on conn.
+ *
+ * Returns the tuple chunks it held, and their total size in *dataSize.  They
+ * are in a buffer that is reused for the next compressed packet, like the
+ * "inplace" chunks of an uncompressed packet that point into the receive
+ * buffer: the motion layer processes or copies all the chunks of a packet
+ * before it asks for the next one.
+ */
+static uint8 *
+decompressChunks(MotionConn *conn, uint8 *chunk, int chunkSize, int *dataSize)
+{
+#ifdef USE_ZSTD
+	static ZSTD_DCtx *cxt = NULL;	/* ZSTD decompression context */
+	static uint8 *buf = NULL;
+	uint16		compressedSize;
+	size_t		rawSize;
+
+	memcpy(&compressedSize, chunk, sizeof(uint16));
+	if (TUPLE_CHUNK_HEADER_SIZE + compressedSize != chunkSize)
+		ereport(ERROR,
+				(errcode(ERRCODE_GP_INTERCONNECTION_ERROR),
+				 errmsg("interconnect error parsing compressed message"),
+				 errdetail("compressed chunk of %d bytes in %d bytes of packet data from seg%d at %s",
+						   compressedSize, chunkSize,
+						   conn->remoteContentId, conn->remoteHostAndPort)));
+
+	if (!cxt)
+	{
+		cxt = ZSTD_createDCtx();
+		if (!cxt)
+			elog(ERROR, "out of memory");
+	}
+
+	/* a packet never expands beyond the size of an uncompressed one */
+	if (!buf)
+		buf = MemoryContextAlloc(TopMemoryContext, Gp_max_packet_size);
+
+	rawSize = ZSTD_decompressDCtx(cxt, buf, Gp_max_packet_size,
+								  chunk + TUPLE_CHUNK_HEADER_SIZE, compressedSize);
+	if (ZSTD_isError(rawSize))
+		ereport(ERROR,
+				(errcode(ERRCODE_GP_INTERCONNECTION_ERROR),
+				 errmsg("interconnect error decompressing message: %s",
+						ZSTD_getErrorName(rawSize)),
+				 errdetail("from seg%d at %s",
+						   conn->remoteContentId, conn->remoteHostAndPort)));
+
+	if (rawSize > chunkSize)
+		conn->stat_bytes_saved += rawSize - chunkSize;
+
+	*dataSize = (int) rawSize;
+	return buf;
+#else
+	ereport(ERROR,
+			(errcode(ERRCODE_GP_INTERCONNECTION_ERROR),
+			 errmsg("interconnect error: received a compressed message, but this build does not support zstd"),
+			 errdetail("from seg%d at %s",
+					   conn->remoteContentId, conn->remoteHostAndPort)));
+	return NULL;				/* keep compiler quiet */
+#endif
+}
+
+/*
+ * Compress the tuple chunks of the packet about to be sent on conn, i.e. the
+ * bytes of conn->pBuff from headerSize to conn->msgSize, into a single
+ * TC_COMPRESSED chunk, if gp_interconnect_compression is on.
+ *
+ * Every packet is compressed on its own, so that the receiver can expand it
+ * however the transport delivers it.  Packets that zstd does not shrink by
+ * at least 1/8th are sent as they are, and the next few packets of the
+ * connection are not even tried.
+ */
+void
+CompressTupleChunks(MotionConn *conn, int headerSize)
+{
+#ifdef USE_ZSTD
+	static ZSTD_CCtx *cxt = NULL;	/* ZSTD compression context */
+	static char *buf = NULL;
+	static size_t bufSize = 0;
+	int			rawSize = conn->msgSize - headerSize;
+	size_t		compressedSize;
+
+	if (!gp_interconnect_compression ||
+		conn->tupleCount == 0 ||
+		rawSize < IC_COMPRESS_MIN_BYTES)
+		return;
+
+	if (conn->compressSkip > 0)
+	{
+		conn->compressSkip--;
+		return;
+	}
+
+	if (!cxt)
+	{
+		cxt = ZSTD_createCCtx();
+		if (!cxt)
+			elog(ERROR, "out of memory");
+	}
+
+	if (!buf)
+	{
+		bufSize = ZSTD_compressBound(Gp_max_packet_size);
+		buf = MemoryContextAlloc(TopMemoryContext, bufSize);
+	}
+
+	compressedSize = ZSTD_compressCCtx(cxt, buf, bufSize,
+									   conn->pBuff + headerSize, rawSize,
+									   1);
+	if (ZSTD_isError(compressedSize))
+		elog(ERROR, "interconnect compression failed: %s uncompressed len %d",
+			 ZSTD_getErrorName(compressedSize), rawSize);
+
+	if (TUPLE_CHUNK_HEADER_SIZE + compressedSize > rawSize - rawSize / 8)
+	{
+		conn->compressSkip = IC_COMPRESS_BACKOFF_PACKETS;
+		return;
+	}
+
+	SetChunkDataSize(conn->pBuff + headerSize, compressedSize);
+	SetChunkType(conn->pBuff + headerSize, TC_COMPRESSED);
+	memcpy(conn->pBuff + headerSize + TUPLE_CHUNK_HEADER_SIZE, buf, compressedSize);
+	conn->msgSize = headerSize + TUPLE_CHUNK_HEADER_SIZE + compressedSize;
+#endif
+}
+
 /*=========================================================================
  * VISIBLE FUNCTIONS
  */
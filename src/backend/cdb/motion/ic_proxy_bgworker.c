@@ -45,11 +45,14 @@ ICProxyShmemSize(void)
 {
 	Size		size = 0;
 	size = add_size(size, sizeof(*ic_proxy_peer_listener_failed));
+	size = add_size(size, mul_size(IC_PROXY_MAX_PEER_STATS,
+								   sizeof(ICProxyPeerStats)));
 	return size;
 }
 
 /*
- * initialize ICProxy's SHM structure: only one flag variable
+ * initialize ICProxy's SHM structure: the listener failure flag, and the
+ * peer statistics
  */
 void
 ICProxyShmemInit(void)
@@ -60,4 +63,33 @@ ICProxyShmemInit(void)
 													&found);
 	if (!found)
 		pg_atomic_init_u32(ic_proxy_peer_listener_failed, 0);
+
+	ic_proxy_peer_stats = ShmemInitStruct("IC_PROXY Peer Statistics",
+										  mul_size(IC_PROXY_MAX_PEER_STATS,
+												   sizeof(ICProxyPeerStats)),
+										  &found);
+	if (!found)
+	{
+		int			i;
+
+		for (i = 0; i < IC_PROXY_MAX_PEER_STATS; i++)
+		{
+			ICProxyPeerStats *stats = &ic_proxy_peer_stats[i];
+
+			pg_atomic_init_u32(&stats->dbid, 0);
+			stats->content = IC_PROXY_INVALID_CONTENT;
+			pg_atomic_init_u32(&stats->connected, 0);
+			pg_atomic_init_u64(&stats->sentBytes, 0);
+			pg_atomic_init_u64(&stats->sentPackets, 0);
+			pg_atomic_init_u64(&stats->writes, 0);
+			pg_atomic_init_u64(&stats->recvBytes, 0);
+			pg_atomic_init_u64(&stats->recvPackets, 0);
+			pg_atomic_init_u64(&stats->queuedPackets, 0);
+			pg_atomic_init_u64(&stats->writeQueueBytes, 0);
+			pg_atomic_init_u64(&stats->sendRate, 0);
+			pg_atomic_init_u64(&stats->recvRate, 0);
+			stats->lastSentBytes = 0;
+			stats->lastRecvBytes = 0;
+		}
+	}
 }
\ No newline at end of file
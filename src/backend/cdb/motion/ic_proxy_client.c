@@ -459,17 +459,21 @@ ic_proxy_client_blessed_lookup(uv_loop_t *loop, const ICProxyKey *key)
 
 /*
  * Pass a c2p packet to the router.
+ *
+ * The packet is the obuf's buffer, instead of copying it we hand it over to
+ * the router by taking a reference, the obuf continues with a new buffer.
  */
 static void
 ic_proxy_client_route_c2p_data(void *opaque, const void *data, uint16 size)
 {
-	const ICProxyPkt *pkt = data;
+	ICProxyPkt *pkt = (ICProxyPkt *) data;
 	ICProxyClient *client = opaque;
 
 	Assert(ic_proxy_pkt_is_from_client(pkt, &client->key));
 	Assert(ic_proxy_pkt_is_live(pkt, &client->key));
 
-	ic_proxy_router_route(client->pipe.loop, ic_proxy_pkt_dup(pkt), NULL, NULL);
+	ic_proxy_pkt_cache_ref(pkt);
+	ic_proxy_router_route(client->pipe.loop, pkt, NULL, NULL);
 }
 
 /*
@@ -19,6 +19,11 @@
  *
  * Other formats can be supported by providing custom methods.
  *
+ * The data passed to the callbacks is only borrowed, it is overwritten or
+ * recycled after the callback returns.  A callback can keep it, without
+ * copying, by taking a reference with ic_proxy_pkt_cache_ref(), the i/o bufs
+ * then switch to a new buffer instead of reusing the shared one.
+ *
  *
  * Copyright (c) 2020-Present VMware, Inc. or its affiliates.
  *
@@ -91,6 +96,23 @@ ic_proxy_ibuf_empty(const ICProxyIBuf *ibuf)
 	return ibuf->len == 0;
 }
 
+/*
+ * Stop using the ibuf's buffer if the callback has kept a reference on it.
+ *
+ * The buffer is only needed again for an incomplete packet, it is allocated
+ * on demand at that time.
+ */
+static inline void
+ic_proxy_ibuf_release_shared_buffer(ICProxyIBuf *ibuf)
+{
+	/* the callback might also have reinitialized the ibuf */
+	if (ibuf->buf && ic_proxy_pkt_cache_is_shared(ibuf->buf))
+	{
+		ic_proxy_pkt_cache_free(ibuf->buf);
+		ibuf->buf = NULL;
+	}
+}
+
 /*
  * Push data to the ibuf.
  *
@@ -101,12 +123,10 @@ ic_proxy_ibuf_empty(const ICProxyIBuf *ibuf)
  * If "size" is 0 then a force flush is triggered, the "callback" is called
  * with the incomplete packet.
  *
- * TODO: libuv supports sending an array of buffers, so it is technically
- * possible to prevent the memory copying in this function, we only need to let
- * the get_packet_size() method supports parsing the packet size from an array
- * of buffers.  However the callback function also needs to support
- * non-continues packet, an easy way is to only copying the header into
- * continues memory.
+ * Complete packets are passed to the "callback" as pointers into "data",
+ * only a packet that spans several pushes is copied into the ibuf's buffer.
+ * If "data" is a packet cache buffer the "callback" can keep the packet,
+ * without copying, by taking a reference on it.
  */
 void
 ic_proxy_ibuf_push(ICProxyIBuf *ibuf,
@@ -117,15 +137,16 @@ ic_proxy_ibuf_push(ICProxyIBuf *ibuf,
 	uint16		packet_size;
 	uint16		delta;
 
-	if (unlikely(ibuf->buf == NULL))
-		ibuf->buf = ic_proxy_pkt_cache_alloc(NULL);
-
 	/* a force-flush */
 	if (unlikely(size == 0))
 	{
+		if (unlikely(ibuf->buf == NULL))
+			ibuf->buf = ic_proxy_pkt_cache_alloc(NULL);
+
 		/* TODO: do we need to flush if ibuf->len is 0? */
 		callback(opaque, ibuf->buf, ibuf->len);
 		ibuf->len = 0;
+		ic_proxy_ibuf_release_shared_buffer(ibuf);
 		return;
 	}
 
@@ -169,6 +190,7 @@ ic_proxy_ibuf_push(ICProxyIBuf *ibuf,
 
 			callback(opaque, ibuf->buf, packet_size);
 			ibuf->len = 0;
+			ic_proxy_ibuf_release_shared_buffer(ibuf);
 		}
 	}
 
@@ -192,6 +214,9 @@ ic_proxy_ibuf_push(ICProxyIBuf *ibuf,
 	if (size > 0)
 	{
 		/* got a incomplete pkt */
+		if (unlikely(ibuf->buf == NULL))
+			ibuf->buf = ic_proxy_pkt_cache_alloc(NULL);
+
 		memcpy(ibuf->buf, data, size);
 		ibuf->len = size;
 	}
@@ -352,7 +377,20 @@ ic_proxy_obuf_push(ICProxyOBuf *obuf,
 			obuf->set_packet_size(obuf->buf, obuf->len);
 			callback(opaque, obuf->buf, obuf->len);
 
-			/* we will reuse the header */
+			/*
+			 * The callback might have kept the packet, in such a case we
+			 * continue with a new buffer, otherwise the buffer is reused.
+			 * Either way we will reuse the header.
+			 */
+			if (ic_proxy_pkt_cache_is_shared(obuf->buf))
+			{
+				char	   *buf = ic_proxy_pkt_cache_alloc(NULL);
+
+				memcpy(buf, obuf->buf, obuf->header_size);
+				ic_proxy_pkt_cache_free(obuf->buf);
+				obuf->buf = buf;
+			}
+
 			obuf->len = obuf->header_size;
 		}
 	}
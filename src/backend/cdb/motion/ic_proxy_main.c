@@ -42,6 +42,8 @@ static bool			ic_proxy_peer_listening;
 static bool			ic_proxy_peer_relistening;
 /* flag (in SHM) for incidaing if peer listener bind/listen failed */
 pg_atomic_uint32 	*ic_proxy_peer_listener_failed;
+/* peer statistics (in SHM) */
+ICProxyPeerStats	*ic_proxy_peer_stats;
 
 static uv_pipe_t	ic_proxy_client_listener;
 static bool			ic_proxy_client_listening;
@@ -472,7 +474,7 @@ ic_proxy_server_drop_legacy_peers(uv_loop_t *loop)
  * Timer handler.
  *
  * This is used to maintain the proxy-proxy network, as well as the client and
- * peer listeners.
+ * peer listeners, and to sample the peer statistics.
  */
 static void
 ic_proxy_server_on_timer(uv_timer_t *timer)
@@ -480,6 +482,8 @@ ic_proxy_server_on_timer(uv_timer_t *timer)
 	ic_proxy_server_peer_listener_init(timer->loop);
 	ic_proxy_server_ensure_peers(timer->loop);
 	ic_proxy_server_client_listener_init(timer->loop);
+
+	ic_proxy_peer_table_update_stats(uv_now(timer->loop));
 }
 
 /*
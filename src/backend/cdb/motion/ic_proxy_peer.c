@@ -32,7 +32,15 @@
  *
  * Incoming packets, the one received from a remote peer, is never cached in
  * the peer, they are routed to the target clients, or their placeholders,
- * immediately.
+ * immediately.  They are routed without copying, as references into the
+ * buffer they are received in.
+ *
+ * Outgoing packets are written one write at a time, the ones routed while a
+ * write is in progress are queued, and are written together with a single
+ * scatter/gather write once it is done.
+ *
+ * The statistics of the peers are kept in SHM, so they can be reported by the
+ * gp_toolkit.gp_interconnect_proxy_peer_stats view.
  *
  *
  * Copyright (c) 2020-Present VMware, Inc. or its affiliates.
@@ -57,6 +65,9 @@
  */
 static ICProxyPeer *ic_proxy_peers[65536];
 
+/* when the rates in the peer statistics were updated, in ms */
+static uint64 ic_proxy_peer_stats_updated_at;
+
 
 static void ic_proxy_peer_shutdown(ICProxyPeer *peer);
 static void ic_proxy_peer_handle_out_cache(ICProxyPeer *peer);
@@ -66,6 +77,87 @@ static void ic_proxy_peer_send_message(ICProxyPeer *peer,
 									   ICProxyMessageType mtype,
 									   const ICProxyKey *key,
 									   ic_proxy_sent_cb callback);
+static void ic_proxy_peer_flush(ICProxyPeer *peer);
+
+
+/*
+ * Increase a counter of the peer statistics.
+ *
+ * Only the proxy bgworker updates the statistics, so no atomic add is needed,
+ * the atomic read & write only ensure that the readers never see a torn
+ * value.
+ */
+static inline void
+ic_proxy_peer_stats_add(pg_atomic_uint64 *counter, uint64 delta)
+{
+	pg_atomic_write_u64(counter, pg_atomic_read_u64(counter) + delta);
+}
+
+/*
+ * Find the statistics slot of a peer, a free slot is taken if there is none.
+ *
+ * Return NULL if all the slots are in use.
+ */
+static ICProxyPeerStats *
+ic_proxy_peer_stats_lookup(int16 content, uint16 dbid)
+{
+	ICProxyPeerStats *freeslot = NULL;
+	int			i;
+
+	for (i = 0; i < IC_PROXY_MAX_PEER_STATS; i++)
+	{
+		ICProxyPeerStats *stats = &ic_proxy_peer_stats[i];
+		uint32		slotdbid = pg_atomic_read_u32(&stats->dbid);
+
+		if (slotdbid == dbid)
+			return stats;
+		else if (slotdbid == 0 && !freeslot)
+			freeslot = stats;
+	}
+
+	if (freeslot)
+	{
+		freeslot->content = content;
+		pg_write_barrier();
+		pg_atomic_write_u32(&freeslot->dbid, dbid);
+	}
+	else
+		elogif(gp_log_interconnect >= GPVARS_VERBOSITY_VERBOSE, LOG,
+			   "ic-proxy: peer[seg%hd,dbid%hu]: no free slot for the statistics",
+					 content, dbid);
+
+	return freeslot;
+}
+
+/*
+ * Reset the peer statistics, this is done when the proxy bgworker launches.
+ */
+static void
+ic_proxy_peer_stats_reset(void)
+{
+	int			i;
+
+	for (i = 0; i < IC_PROXY_MAX_PEER_STATS; i++)
+	{
+		ICProxyPeerStats *stats = &ic_proxy_peer_stats[i];
+
+		pg_atomic_write_u32(&stats->dbid, 0);
+		pg_atomic_write_u32(&stats->connected, 0);
+		pg_atomic_write_u64(&stats->sentBytes, 0);
+		pg_atomic_write_u64(&stats->sentPackets, 0);
+		pg_atomic_write_u64(&stats->writes, 0);
+		pg_atomic_write_u64(&stats->recvBytes, 0);
+		pg_atomic_write_u64(&stats->recvPackets, 0);
+		pg_atomic_write_u64(&stats->queuedPackets, 0);
+		pg_atomic_write_u64(&stats->writeQueueBytes, 0);
+		pg_atomic_write_u64(&stats->sendRate, 0);
+		pg_atomic_write_u64(&stats->recvRate, 0);
+		stats->lastSentBytes = 0;
+		stats->lastRecvBytes = 0;
+	}
+
+	ic_proxy_peer_stats_updated_at = 0;
+}
 
 
 /*
@@ -96,6 +188,8 @@ void
 ic_proxy_peer_table_init(void)
 {
 	memset(ic_proxy_peers, 0, sizeof(ic_proxy_peers));
+
+	ic_proxy_peer_stats_reset();
 }
 
 void
@@ -108,6 +202,59 @@ ic_proxy_peer_table_uninit(void)
 	 */
 }
 
+/*
+ * Sample the queues and calculate the rates of the peer statistics.
+ *
+ * This is called by the per second timer, now is the loop time in ms.
+ */
+void
+ic_proxy_peer_table_update_stats(uint64 now)
+{
+	uint64		elapsed = now - ic_proxy_peer_stats_updated_at;
+	int			i;
+
+	for (i = 0; i < IC_PROXY_MAX_PEER_STATS; i++)
+	{
+		ICProxyPeerStats *stats = &ic_proxy_peer_stats[i];
+		uint32		dbid = pg_atomic_read_u32(&stats->dbid);
+		ICProxyPeer *peer;
+		uint64		sentBytes;
+		uint64		recvBytes;
+
+		if (dbid == 0)
+			continue;
+
+		peer = ic_proxy_peers[dbid];
+		if (peer)
+		{
+			pg_atomic_write_u32(&stats->connected,
+								(peer->state & IC_PROXY_PEER_STATE_READY_FOR_DATA) &&
+								!(peer->state & IC_PROXY_PEER_STATE_SHUTTING));
+			pg_atomic_write_u64(&stats->queuedPackets,
+								list_length(peer->reqs) +
+								list_length(peer->outq));
+			pg_atomic_write_u64(&stats->writeQueueBytes,
+								peer->tcp.write_queue_size);
+		}
+
+		sentBytes = pg_atomic_read_u64(&stats->sentBytes);
+		recvBytes = pg_atomic_read_u64(&stats->recvBytes);
+
+		if (elapsed > 0 && ic_proxy_peer_stats_updated_at > 0)
+		{
+			pg_atomic_write_u64(&stats->sendRate,
+								(sentBytes - stats->lastSentBytes) * 1000 / elapsed);
+			pg_atomic_write_u64(&stats->recvRate,
+								(recvBytes - stats->lastRecvBytes) * 1000 / elapsed);
+		}
+
+		stats->lastSentBytes = sentBytes;
+		stats->lastRecvBytes = recvBytes;
+	}
+
+	ic_proxy_peer_stats_updated_at = now;
+}
+
 /*
  * Update the peer name from the state bits.
  *
@@ -244,6 +391,9 @@ ic_proxy_peer_register(ICProxyPeer *peer)
 
 	ic_proxy_peers[peer->dbid] = peer;
 
+	if (!peer->stats)
+		peer->stats = ic_proxy_peer_stats_lookup(peer->content, peer->dbid);
+
 	elogif(gp_log_interconnect >= GPVARS_VERBOSITY_VERBOSE, LOG,
 		   "ic-proxy: %s: registered", peer->name);
 }
@@ -309,7 +459,12 @@ ic_proxy_peer_on_data_pkt(void *opaque, const void *data, uint16 size)
 		return;
 	}
 
-	ic_proxy_router_route(peer->tcp.loop, ic_proxy_pkt_dup(pkt), NULL, NULL);
+	if (peer->stats)
+		ic_proxy_peer_stats_add(&peer->stats->recvPackets, 1);
+
+	/* route the packet without copying, it is still in the receive buffer */
+	ic_proxy_pkt_cache_ref(pkt);
+	ic_proxy_router_route(peer->tcp.loop, (ICProxyPkt *) pkt, NULL, NULL);
 }
 
 /*
@@ -345,6 +500,13 @@ ic_proxy_peer_on_data(uv_stream_t *stream, ssize_t nread, const uv_buf_t *buf)
 		return;
 	}
 
+	if (peer->stats)
+		ic_proxy_peer_stats_add(&peer->stats->recvBytes, nread);
+
+	/*
+	 * The complete packets are routed as references into the buffer, it is
+	 * only recycled when all of them are sent out.
+	 */
 	ic_proxy_ibuf_push(&peer->ibuf, buf->base, nread,
 					   ic_proxy_peer_on_data_pkt, peer);
 	ic_proxy_pkt_cache_free(buf->base);
@@ -363,6 +525,9 @@ ic_proxy_peer_new(uv_loop_t *loop, int16 content, uint16 dbid)
 	peer->dbid = dbid;
 	peer->state = 0;
 	peer->reqs = NIL;
+	peer->outq = NIL;
+	peer->writing = false;
+	peer->stats = NULL;
 
 	ic_proxy_ibuf_init_p2p(&peer->ibuf);
 
@@ -389,17 +554,22 @@ ic_proxy_peer_free(ICProxyPeer *peer)
 	elogif(gp_log_interconnect >= GPVARS_VERBOSITY_DEBUG, DEBUG5,
 		   "ic-proxy: %s: freeing", peer->name);
 
+	Assert(!peer->writing);
+
+	peer->reqs = list_concat(peer->outq, peer->reqs);
+	peer->outq = NIL;
+
 	foreach(cell, peer->reqs)
 	{
-		ICProxyPkt *pkt = lfirst(cell);
+		ICProxyDelay *delay = lfirst(cell);
 
 		elog(WARNING, "ic-proxy: %s: unhandled outgoing %s, dropping it",
-					 peer->name, ic_proxy_pkt_to_str(pkt));
+					 peer->name, ic_proxy_pkt_to_str(delay->pkt));
 
-		ic_proxy_pkt_cache_free(pkt);
+		ic_proxy_pkt_cache_free(delay->pkt);
 	}
 
-	list_free(peer->reqs);
+	peer->reqs = ic_proxy_list_free_deep(peer->reqs);
 
 	ic_proxy_ibuf_uninit(&peer->ibuf);
 	ic_proxy_free(peer);
@@ -429,6 +599,14 @@ ic_proxy_peer_on_close(uv_handle_t *handle)
 	/* it's unlikely that the ibuf is non-empty, but clear it for sure */
 	ic_proxy_ibuf_clear(&peer->ibuf);
 
+	/*
+	 * The pending writes are all canceled now, the packets that were not
+	 * written yet are kept, they will be sent on the next connection.
+	 */
+	Assert(!peer->writing);
+	peer->reqs = list_concat(peer->outq, peer->reqs);
+	peer->outq = NIL;
+
 	ic_proxy_peer_unregister(peer);
 }
 
@@ -907,7 +1085,82 @@ ic_proxy_peer_route_data(ICProxyPeer *peer, ICProxyPkt *pkt,
 		return;
 	}
 
-	ic_proxy_router_write((uv_stream_t *) &peer->tcp, pkt, 0, callback, opaque);
+	peer->outq = lappend(peer->outq,
+						 ic_proxy_peer_build_delay(peer, pkt, callback, opaque));
+
+	/*
+	 * If a write is in progress the packet is sent after it, together with
+	 * the others queued meanwhile.
+	 */
+	if (!peer->writing)
+		ic_proxy_peer_flush(peer);
+}
+
+/*
+ * The queued packets are written.
+ */
+static void
+ic_proxy_peer_on_written(void *opaque, int npkts, uint64 nbytes, int status)
+{
+	ICProxyPeer *peer = opaque;
+
+	peer->writing = false;
+
+	if (status < 0)
+	{
+		/*
+		 * The peer is closing, or will be shut down on the read error, the
+		 * remaining packets will be sent on the next connection.
+		 */
+		elogif(gp_log_interconnect >= GPVARS_VERBOSITY_DEBUG, DEBUG3,
+			   "ic-proxy: %s: failed to send %d pkts: %s",
+					 peer->name, npkts, uv_strerror(status));
+		return;
+	}
+
+	if (peer->stats)
+	{
+		ic_proxy_peer_stats_add(&peer->stats->sentPackets, npkts);
+		ic_proxy_peer_stats_add(&peer->stats->sentBytes, nbytes);
+	}
+
+	ic_proxy_peer_flush(peer);
+}
+
+/*
+ * Write all the queued packets with a single scatter/gather write.
+ *
+ * Only one write is in progress at a time, the packets routed meanwhile are
+ * queued, so the more the load is, the more packets are written at once.
+ */
+static void
+ic_proxy_peer_flush(ICProxyPeer *peer)
+{
+	List	   *delays;
+
+	Assert(!peer->writing);
+
+	if (peer->outq == NIL)
+		return;
+
+	/* no more writes once shutting down, the packets are kept till closed */
+	if (peer->state & (IC_PROXY_PEER_STATE_SHUTTING |
+					   IC_PROXY_PEER_STATE_CLOSING))
+		return;
+
+	delays = peer->outq;
+	peer->outq = NIL;
+
+	elogif(gp_log_interconnect >= GPVARS_VERBOSITY_DEBUG, DEBUG5,
+		   "ic-proxy: %s: writing %d pkts",
+				 peer->name, list_length(delays));
+
+	if (peer->stats)
+		ic_proxy_peer_stats_add(&peer->stats->writes, 1);
+
+	peer->writing = true;
+	ic_proxy_router_writev((uv_stream_t *) &peer->tcp, delays,
+						   ic_proxy_peer_on_written, peer);
 }
 
 /*
@@ -7,13 +7,22 @@
  * Libuv needs us to allocate the packet buffer, and it does not reuse the
  * buffer, so it is expansive to repeatedly allocating and freeing the packets.
  *
- * To make it more efficient we save all the freed packets in a free list, and
- * reuse them later.
+ * To make it more efficient the packets are carved from large slabs, and the
+ * freed packets are saved in the free lists of their slabs and reused later.
  *
  * All the allocated packets are of the same size, the max possible packet
  * size, discarding the size requested by libuv, so the packet buffer can be
  * safely reused later.
  *
+ * The packets are reference counted, so a packet can be forwarded without
+ * copying it: a libuv read buffer usually contains several p2p packets, each
+ * of them can be routed as a pointer into the read buffer, holding a reference
+ * on it, and the buffer is only recycled when all of them are sent out.  To
+ * support this, any pointer into a packet buffer, not only the beginning of
+ * it, can be passed to ic_proxy_pkt_cache_ref() and ic_proxy_pkt_cache_free().
+ * The slabs are aligned to their size, so the slab and the packet buffer can
+ * be found from such a pointer directly.
+ *
  * TODO:
  * - many libuv requests, such as uv_write(), needs us to allocate the request
  *   buffer, they are not reused, too, we could consider saving them in a
@@ -29,9 +38,12 @@
 #include "ic_proxy.h"
 #include "ic_proxy_pkt_cache.h"
 
+#include "lib/ilist.h"
+
 #include <uv.h>
 
 typedef struct ICProxyPktCache ICProxyPktCache;
+typedef struct ICProxyPktSlab ICProxyPktSlab;
 
 /*
  * A simple free list.
@@ -41,46 +53,181 @@ struct ICProxyPktCache
 	ICProxyPktCache *next;
 };
 
-static struct 
+/*
+ * A slab, it is followed by the packet buffers.
+ */
+struct ICProxyPktSlab
 {
-	ICProxyPktCache *freelist;	/* the free list */
-	uint32		pkt_size;		/* the packet size for all the packets */
+	dlist_node	node;			/* in the partial list if having free pkts */
+
+	ICProxyPktCache *freelist;	/* the free packets of this slab */
 	uint32		n_free;			/* count of packets in the free list */
-	uint32		n_total;		/* count of all the allocated packets */
+
+	uint32		refcount[FLEXIBLE_ARRAY_MEMBER];	/* of every packet */
+};
+
+static struct
+{
+	dlist_head	partial;		/* slabs which have free packets */
+	uint32		pkt_size;		/* the packet size for all the packets */
+	uint32		slab_header_size;	/* offset of the first packet */
+	uint32		pkts_per_slab;	/* count of the packets in a slab */
+	uint32		n_free;			/* count of free packets in all the slabs */
+	uint32		n_total;		/* count of packets in all the slabs */
 } ic_proxy_pkt_cache;
 
+/*
+ * Get the slab of a packet, ptr can point to anywhere inside the packet.
+ */
+static inline ICProxyPktSlab *
+ic_proxy_pkt_cache_get_slab(const void *ptr)
+{
+	return (ICProxyPktSlab *)
+		((uintptr_t) ptr & ~((uintptr_t) IC_PROXY_PKT_CACHE_SLAB_SIZE - 1));
+}
+
+/*
+ * Get the index of a packet in its slab, ptr can point to anywhere inside the
+ * packet.
+ */
+static inline uint32
+ic_proxy_pkt_cache_get_index(ICProxyPktSlab *slab, const void *ptr)
+{
+	uint32		offset = (const char *) ptr - (const char *) slab;
+	uint32		index;
+
+	Assert(offset >= ic_proxy_pkt_cache.slab_header_size);
+
+	index = ((offset - ic_proxy_pkt_cache.slab_header_size) /
+			 ic_proxy_pkt_cache.pkt_size);
+
+	Assert(index < ic_proxy_pkt_cache.pkts_per_slab);
+	return index;
+}
+
+static inline char *
+ic_proxy_pkt_cache_get_pkt(ICProxyPktSlab *slab, uint32 index)
+{
+	return ((char *) slab + ic_proxy_pkt_cache.slab_header_size +
+			index * ic_proxy_pkt_cache.pkt_size);
+}
+
+/*
+ * Allocate a new slab, and put all its packets in its free list.
+ */
+static ICProxyPktSlab *
+ic_proxy_pkt_cache_new_slab(void)
+{
+	ICProxyPktSlab *slab;
+	void	   *ptr;
+	int			i;
+
+	/* palloc() cannot allocate aligned memory */
+	if (posix_memalign(&ptr, IC_PROXY_PKT_CACHE_SLAB_SIZE,
+					   IC_PROXY_PKT_CACHE_SLAB_SIZE) != 0)
+		ereport(ERROR,
+				(errcode(ERRCODE_OUT_OF_MEMORY),
+				 errmsg("ic-proxy: out of memory for the packet cache")));
+
+	slab = ptr;
+	slab->freelist = NULL;
+	slab->n_free = ic_proxy_pkt_cache.pkts_per_slab;
+
+	/* put the packets in the free list in the address order */
+	for (i = ic_proxy_pkt_cache.pkts_per_slab - 1; i >= 0; i--)
+	{
+		ICProxyPktCache *cpkt;
+
+		cpkt = (ICProxyPktCache *) ic_proxy_pkt_cache_get_pkt(slab, i);
+		cpkt->next = slab->freelist;
+		slab->freelist = cpkt;
+		slab->refcount[i] = 0;
+	}
+
+	dlist_push_head(&ic_proxy_pkt_cache.partial, &slab->node);
+	ic_proxy_pkt_cache.n_free += ic_proxy_pkt_cache.pkts_per_slab;
+	ic_proxy_pkt_cache.n_total += ic_proxy_pkt_cache.pkts_per_slab;
+
+	return slab;
+}
+
+/*
+ * Release a slab, all its packets must be free.
+ */
+static void
+ic_proxy_pkt_cache_release_slab(ICProxyPktSlab *slab)
+{
+	Assert(slab->n_free == ic_proxy_pkt_cache.pkts_per_slab);
+
+	dlist_delete(&slab->node);
+	ic_proxy_pkt_cache.n_free -= ic_proxy_pkt_cache.pkts_per_slab;
+	ic_proxy_pkt_cache.n_total -= ic_proxy_pkt_cache.pkts_per_slab;
+
+	free(slab);
+}
+
 /*
  * Initialize the packet cache.
  */
 void
 ic_proxy_pkt_cache_init(uint32 pkt_size)
 {
-	ic_proxy_pkt_cache.freelist = NULL;
+	uint32		header_size;
+	uint32		n;
+
+	pkt_size = MAXALIGN(pkt_size);
+
+	/*
+	 * The refcount array is in the slab header, so we have to figure out the
+	 * count of packets in a slab and the header size at the same time.
+	 */
+	n = ((IC_PROXY_PKT_CACHE_SLAB_SIZE - offsetof(ICProxyPktSlab, refcount)) /
+		 (pkt_size + sizeof(uint32)));
+	for (;;)
+	{
+		header_size = MAXALIGN(offsetof(ICProxyPktSlab, refcount) +
+							   sizeof(uint32) * n);
+		if (header_size + pkt_size * n <= IC_PROXY_PKT_CACHE_SLAB_SIZE)
+			break;
+		n--;
+	}
+
+	Assert(n > 0);
+
+	dlist_init(&ic_proxy_pkt_cache.partial);
 	ic_proxy_pkt_cache.pkt_size = pkt_size;
+	ic_proxy_pkt_cache.slab_header_size = header_size;
+	ic_proxy_pkt_cache.pkts_per_slab = n;
 	ic_proxy_pkt_cache.n_free = 0;
 	ic_proxy_pkt_cache.n_total = 0;
 }
 
 /*
  * Cleanup the packet cache.
+ *
+ * Only the slabs whose packets are all free are released, the packets still
+ * in use are not tracked anyway.
  */
 void
 ic_proxy_pkt_cache_uninit(void)
 {
-	while (ic_proxy_pkt_cache.freelist)
+	dlist_mutable_iter iter;
+
+	dlist_foreach_modify(iter, &ic_proxy_pkt_cache.partial)
 	{
-		ICProxyPktCache *cpkt = ic_proxy_pkt_cache.freelist;
+		ICProxyPktSlab *slab = dlist_container(ICProxyPktSlab, node, iter.cur);
 
-		ic_proxy_pkt_cache.freelist = cpkt->next;
-		ic_proxy_free(cpkt);
+		if (slab->n_free == ic_proxy_pkt_cache.pkts_per_slab)
+			ic_proxy_pkt_cache_release_slab(slab);
 	}
 }
 
 /*
  * Allocate a packet from the cache.
  *
- * If the free list is empty a new packet is allocated and returned, otherwise
- * one is detached from the free list and returned directly.
+ * The packet is taken from the first slab that has free packets, a new slab
+ * is allocated if there is no such one.  The returned packet has a reference
+ * count of 1.
  *
  * If pkt_size is not NULL it is set with the actual packet buffer size.
  *
@@ -89,20 +236,26 @@ ic_proxy_pkt_cache_uninit(void)
 void *
 ic_proxy_pkt_cache_alloc(size_t *pkt_size)
 {
+	ICProxyPktSlab *slab;
 	ICProxyPktCache *cpkt;
 
-	if (ic_proxy_pkt_cache.freelist)
-	{
-		cpkt = ic_proxy_pkt_cache.freelist;
-
-		ic_proxy_pkt_cache.freelist = cpkt->next;
-		ic_proxy_pkt_cache.n_free--;
-	}
+	if (dlist_is_empty(&ic_proxy_pkt_cache.partial))
+		slab = ic_proxy_pkt_cache_new_slab();
 	else
-	{
-		cpkt = ic_proxy_alloc(ic_proxy_pkt_cache.pkt_size);
-		ic_proxy_pkt_cache.n_total++;
-	}
+		slab = dlist_head_element(ICProxyPktSlab, node,
+								  &ic_proxy_pkt_cache.partial);
+
+	cpkt = slab->freelist;
+	slab->freelist = cpkt->next;
+	slab->n_free--;
+	ic_proxy_pkt_cache.n_free--;
+
+	/* a slab is only in the partial list when it has free packets */
+	if (slab->n_free == 0)
+		dlist_delete(&slab->node);
+
+	Assert(slab->refcount[ic_proxy_pkt_cache_get_index(slab, cpkt)] == 0);
+	slab->refcount[ic_proxy_pkt_cache_get_index(slab, cpkt)] = 1;
 
 	if (pkt_size)
 		*pkt_size = ic_proxy_pkt_cache.pkt_size;
@@ -131,36 +284,86 @@ ic_proxy_pkt_cache_alloc_buffer(uv_handle_t *handle, size_t size, uv_buf_t *buf)
 }
 
 /*
- * Return a packet to the free list.
+ * Take one more reference on a packet.
+ *
+ * The ptr can point to anywhere inside the packet buffer, which allows to hold
+ * a packet inside a larger buffer without copying it.  Each reference must be
+ * released with ic_proxy_pkt_cache_free(), also with any pointer inside the
+ * packet buffer.
  */
 void
-ic_proxy_pkt_cache_free(void *pkt)
+ic_proxy_pkt_cache_ref(const void *ptr)
 {
-	ICProxyPktCache *cpkt = pkt;
+	ICProxyPktSlab *slab = ic_proxy_pkt_cache_get_slab(ptr);
+	uint32		index = ic_proxy_pkt_cache_get_index(slab, ptr);
+
+	Assert(slab->refcount[index] > 0);
+	slab->refcount[index]++;
+}
+
+/*
+ * Return true if the packet is referenced more than once.
+ */
+bool
+ic_proxy_pkt_cache_is_shared(const void *ptr)
+{
+	ICProxyPktSlab *slab = ic_proxy_pkt_cache_get_slab(ptr);
+	uint32		index = ic_proxy_pkt_cache_get_index(slab, ptr);
+
+	Assert(slab->refcount[index] > 0);
+	return slab->refcount[index] > 1;
+}
+
+/*
+ * Release a reference on a packet, the ptr can point to anywhere inside it.
+ *
+ * The packet is returned to the free list of its slab when the last reference
+ * is released.
+ */
+void
+ic_proxy_pkt_cache_free(void *ptr)
+{
+	ICProxyPktSlab *slab = ic_proxy_pkt_cache_get_slab(ptr);
+	uint32		index = ic_proxy_pkt_cache_get_index(slab, ptr);
+	ICProxyPktCache *cpkt;
+
+	Assert(slab->refcount[index] > 0);
+	if (--slab->refcount[index] > 0)
+		return;
+
+	cpkt = (ICProxyPktCache *) ic_proxy_pkt_cache_get_pkt(slab, index);
 
 #if 0
 	/* for debug purpose */
 	memset(cpkt, 0, ic_proxy_pkt_cache.pkt_size);
 
-	for (ICProxyPktCache *iter = ic_proxy_pkt_cache.freelist;
-		 iter; iter = iter->next)
+	for (ICProxyPktCache *iter = slab->freelist; iter; iter = iter->next)
 		Assert(iter != cpkt);
 #endif
 
-	/* need to limit the size of the free list */
-	if (ic_proxy_pkt_cache.n_total > IC_PROXY_PKT_CACHE_MAX_SIZE)
+	cpkt->next = slab->freelist;
+	slab->freelist = cpkt;
+	slab->n_free++;
+	ic_proxy_pkt_cache.n_free++;
+
+	if (slab->n_free == 1)
 	{
-		ic_proxy_free(pkt);
-		ic_proxy_pkt_cache.n_total--;
+		/* the slab was full */
+		dlist_push_tail(&ic_proxy_pkt_cache.partial, &slab->node);
 	}
-	else
+	else if (slab->n_free == ic_proxy_pkt_cache.pkts_per_slab &&
+			 ic_proxy_pkt_cache.n_free - slab->n_free >=
+			 ic_proxy_pkt_cache.pkts_per_slab)
 	{
-		cpkt->next = ic_proxy_pkt_cache.freelist;
-		ic_proxy_pkt_cache.freelist = cpkt;
-		ic_proxy_pkt_cache.n_free++;
-
-		elogif(gp_log_interconnect >= GPVARS_VERBOSITY_DEBUG, DEBUG5,
-			   "ic-proxy: pkt-cache: recycled, %d free, %d total",
-					 ic_proxy_pkt_cache.n_free, ic_proxy_pkt_cache.n_total);
+		/*
+		 * Need to limit the size of the cache: the slab is completely free,
+		 * release it if the other slabs have another slab worth of free
+		 * packets, which prevents allocating and releasing a slab repeatedly.
+		 */
+		ic_proxy_pkt_cache_release_slab(slab);
 	}
+
+	elogif(gp_log_interconnect >= GPVARS_VERBOSITY_DEBUG, DEBUG5,
+		   "ic-proxy: pkt-cache: recycled, %d free, %d total",
+				 ic_proxy_pkt_cache.n_free, ic_proxy_pkt_cache.n_total);
 }
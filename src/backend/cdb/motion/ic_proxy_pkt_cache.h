@@ -14,13 +14,16 @@
 
 #include <uv.h>
 
-#define IC_PROXY_PKT_CACHE_MAX_SIZE 20000
+/* packets are allocated in slabs of this size, it must be a power of 2 */
+#define IC_PROXY_PKT_CACHE_SLAB_SIZE (1024 * 1024)
 
 extern void ic_proxy_pkt_cache_init(uint32 pkt_size);
 extern void ic_proxy_pkt_cache_uninit(void);
 extern void *ic_proxy_pkt_cache_alloc(size_t *pkt_size);
 extern void ic_proxy_pkt_cache_alloc_buffer(uv_handle_t *handle,
 											size_t size, uv_buf_t *buf);
-extern void ic_proxy_pkt_cache_free(void *pkt);
+extern void ic_proxy_pkt_cache_ref(const void *ptr);
+extern bool ic_proxy_pkt_cache_is_shared(const void *ptr);
+extern void ic_proxy_pkt_cache_free(void *ptr);
 
 #endif   /* IC_PROXY_PKT_CACHE_H */
@@ -22,6 +22,7 @@
 
 
 typedef struct ICProxyWriteReq ICProxyWriteReq;
+typedef struct ICProxyWriteVReq ICProxyWriteVReq;
 typedef struct ICProxyLoopback ICProxyLoopback;
 
 
@@ -40,6 +41,23 @@ struct ICProxyWriteReq
 	void	   *opaque;			/* the callback data */
 };
 
+/*
+ * A router write request of multiple packets.
+ *
+ * The packets are written with one scatter/gather write, every packet still
+ * gets its own callback.
+ */
+struct ICProxyWriteVReq
+{
+	uv_write_t	req;			/* the libuv write request */
+
+	List	   *delays;			/* List<ICProxyDelay *>, the packets */
+	uint64		nbytes;			/* total size of the packets */
+
+	ic_proxy_written_cb callback;	/* the callback of the whole write */
+	void	   *opaque;			/* the callback data */
+};
+
 /*
  * The loopback packet queue.
  *
@@ -316,3 +334,107 @@ ic_proxy_router_write(uv_stream_t *stream, ICProxyPkt *pkt, int32 offset,
 
 	uv_write(&wreq->req, stream, &wbuf, 1, ic_proxy_router_on_write);
 }
+
+/*
+ * The packets are written.
+ */
+static void
+ic_proxy_router_on_writev(uv_write_t *req, int status)
+{
+	ICProxyWriteVReq *wreq = (ICProxyWriteVReq *) req;
+	ListCell   *cell;
+
+	foreach(cell, wreq->delays)
+	{
+		ICProxyDelay *delay = lfirst(cell);
+		ICProxyPkt *pkt = delay->pkt;
+
+		Assert(ic_proxy_pkt_is_valid(pkt));
+
+		if (status < 0)
+		{
+			elogif(gp_log_interconnect >= GPVARS_VERBOSITY_DEBUG, DEBUG5,
+				   "ic-proxy: router: failed to send %s: %s",
+						 ic_proxy_pkt_to_str(pkt), uv_strerror(status));
+		}
+		else
+		{
+			elogif(gp_log_interconnect >= GPVARS_VERBOSITY_DEBUG, DEBUG5,
+				   "ic-proxy: router: sent %s",
+						 ic_proxy_pkt_to_str(pkt));
+		}
+
+		if (delay->callback)
+			delay->callback(delay->opaque, pkt, status);
+
+		ic_proxy_pkt_cache_free(pkt);
+	}
+
+	if (wreq->callback)
+		wreq->callback(wreq->opaque, list_length(wreq->delays), wreq->nbytes,
+					   status);
+
+	ic_proxy_list_free_deep(wreq->delays);
+	ic_proxy_free(req);
+}
+
+/*
+ * Write a list of packets to a libuv stream with one scatter/gather write.
+ *
+ * This is similar to ic_proxy_router_write(), but it takes a list of delays,
+ * every packet is written from offset 0, and the per-packet callbacks are
+ * recorded in the delays.
+ *
+ * - stream: the target stream, usually a peer;
+ * - delays: List<ICProxyDelay *>, the packets to write, the ownership of both
+ *   the list and the packets is taken;
+ * - callback: the callback function of the whole write, it is called after
+ *   the per-packet callbacks;
+ * - opaque: the callback data;
+ */
+void
+ic_proxy_router_writev(uv_stream_t *stream, List *delays,
+					   ic_proxy_written_cb callback, void *opaque)
+{
+	ICProxyWriteVReq *wreq;
+	uv_buf_t   *wbufs;
+	ListCell   *cell;
+	int			nbufs = 0;
+	int			ret;
+
+	Assert(delays != NIL);
+
+	wreq = ic_proxy_new(ICProxyWriteVReq);
+
+	wreq->delays = delays;
+	wreq->nbytes = 0;
+	wreq->callback = callback;
+	wreq->opaque = opaque;
+
+	wbufs = ic_proxy_alloc(sizeof(*wbufs) * list_length(delays));
+
+	foreach(cell, delays)
+	{
+		ICProxyDelay *delay = lfirst(cell);
+
+		elogif(gp_log_interconnect >= GPVARS_VERBOSITY_DEBUG, DEBUG5,
+			   "ic-proxy: router: sending %s", ic_proxy_pkt_to_str(delay->pkt));
+
+		wbufs[nbufs].base = (char *) delay->pkt;
+		wbufs[nbufs].len = delay->pkt->len;
+		wreq->nbytes += delay->pkt->len;
+		nbufs++;
+	}
+
+	/* libuv takes a copy of the buffer array */
+	ret = uv_write(&wreq->req, stream, wbufs, nbufs, ic_proxy_router_on_writev);
+
+	ic_proxy_free(wbufs);
+
+	/*
+	 * The callback is not triggered if the write fails to start, call it by
+	 * ourselves, so the packets are freed and the caller is informed.
+	 */
+	if (ret < 0)
+		ic_proxy_router_on_writev(&wreq->req, ret);
+}
@@ -20,6 +20,8 @@
 
 typedef void (* ic_proxy_sent_cb) (void *opaque,
 								   const ICProxyPkt *pkt, int status);
+typedef void (* ic_proxy_written_cb) (void *opaque, int npkts, uint64 nbytes,
+									  int status);
 
 
 extern void ic_proxy_router_init(uv_loop_t *loop);
@@ -29,6 +31,8 @@ extern void ic_proxy_router_route(uv_loop_t *loop, ICProxyPkt *pkt,
 extern void ic_proxy_router_write(uv_stream_t *stream,
 								  ICProxyPkt *pkt, int32 offset,
 								  ic_proxy_sent_cb callback, void *opaque);
+extern void ic_proxy_router_writev(uv_stream_t *stream, List *delays,
+								   ic_proxy_written_cb callback, void *opaque);
 
 
 #endif   /* IC_PROXY_ROUTER_H */
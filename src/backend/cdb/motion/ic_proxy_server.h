@@ -16,6 +16,8 @@
 
 #include <uv.h>
 
+#include "cdb/ic_proxy_bgworker.h"
+
 #include "ic_proxy.h"
 #include "ic_proxy_iobuf.h"
 #include "ic_proxy_packet.h"
@@ -65,9 +67,14 @@ struct ICProxyPeer
 
 	List	   *reqs;			/* outgoing queue for data that can't be sent
 								 * immediately */
+	List	   *outq;			/* outgoing queue for data that waits for the
+								 * current write */
+	bool		writing;		/* a write is in progress */
 
 	ICProxyIBuf	ibuf;			/* ibuf detects the packet boundaries */
 
+	ICProxyPeerStats *stats;	/* statistics in SHM, or NULL */
+
 	char		name[128];		/* name of the client, only for logging */
 };
 
@@ -121,6 +128,7 @@ extern void ic_proxy_client_table_shutdown_by_dbid(uint16 dbid);
 
 extern void ic_proxy_peer_table_init(void);
 extern void ic_proxy_peer_table_uninit(void);
+extern void ic_proxy_peer_table_update_stats(uint64 now);
 
 extern ICProxyPeer *ic_proxy_peer_new(uv_loop_t *loop,
 									  int16 content, uint16 dbid);
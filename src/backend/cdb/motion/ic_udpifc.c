@@ -30,6 +30,7 @@
 #include <unistd.h>
 #include <arpa/inet.h>
 #include <netinet/in.h>
+#include <netinet/udp.h>
 
 #include "access/transam.h"
 #include "access/xact.h"
@@ -612,6 +613,9 @@ typedef struct AckSendParam
  * duplicatedPktNum          - duplicate packet number.
  * recvAckNum                - the number of Acks received.
  * statusQueryMsgNum         - the number of status query messages sent.
+ * sndSyscallNum             - the number of system calls sending the packets counted by sndPktNum.
+ * recvSyscallNum            - the number of system calls reading packets in the rx thread.
+ * recvSyscallPktNum         - the number of packets read by those calls.
  *
  */
 typedef struct ICStatistics
@@ -633,6 +637,9 @@ typedef struct ICStatistics
 	int32		duplicatedPktNum;
 	int32		recvAckNum;
 	int32		statusQueryMsgNum;
+	int32		sndSyscallNum;
+	int32		recvSyscallNum;
+	int32		recvSyscallPktNum;
 } ICStatistics;
 
 /* Statistics for UDP interconnect. */
@@ -743,6 +750,8 @@ static void checkQDConnectionAlive(void);
 
 
 static void *rxThreadFunc(void *arg);
+static int receivePackets(icpkthdr **pkts, int npkts, int *lens, struct sockaddr_storage *peers, socklen_t *peerlens);
+static void handleRxPacket(icpkthdr **pktp, int read_count, struct sockaddr_storage *peer, socklen_t peerlen);
 
 static bool handleMismatch(icpkthdr *pkt, struct sockaddr_storage *peer, int peer_len);
 static void handleAckedPacket(MotionConn *ackConn, ICBuffer *buf, uint64 now);
@@ -901,6 +910,10 @@ dumpTransProtoStats()
 	snprintf(tmpbuf, 32, "%d." UINT64_FORMAT "txt", MyProcPid, getCurrentTime());
 	FILE	   *ofile = fopen(tmpbuf, "w+");
 
+	fprintf(ofile, "snd_pkts %d snd_syscalls %d recv_pkts %d recv_syscalls %d\n",
+			ic_statistics.sndPktNum, ic_statistics.sndSyscallNum,
+			ic_statistics.recvSyscallPktNum, ic_statistics.recvSyscallNum);
+
 	pthread_mutex_lock(&trans_proto_stats.lock);
 	while (trans_proto_stats.head)
 	{
@@ -3622,7 +3635,8 @@ TeardownUDPIFCInterconnect_Internal(ChunkTransportState *transportStates,
 		 " freebuf_avg %f "
 		 "mismatch_pkt_num %d disordered_pkt_num %d duplicated_pkt_num %d"
 		 " rtt/dev [" UINT64_FORMAT "/" UINT64_FORMAT ", %f/%f, " UINT64_FORMAT "/" UINT64_FORMAT "] "
-		 " cwnd %f status_query_msg_num %d",
+		 " cwnd %f status_query_msg_num %d"
+		 " snd_pkts_per_syscall %f recv_pkts_per_syscall %f",
 		 ic_control_info.isSender, isReceiver,
 		 Gp_interconnect_snd_queue_depth, Gp_interconnect_queue_depth, Gp_max_packet_size,
 		 UNACK_QUEUE_RING_SLOTS_NUM, TIMER_SPAN, DEFAULT_RTT,
@@ -3635,7 +3649,9 @@ TeardownUDPIFCInterconnect_Internal(ChunkTransportState *transportStates,
 		 (double) ((double) ic_statistics.totalBuffers) / ((double) ic_statistics.bufferCountingTime),
 		 ic_statistics.mismatchNum, ic_statistics.disorderedPktNum, ic_statistics.duplicatedPktNum,
 		 (minRtt == ~((uint64) 0) ? 0 : minRtt), (minDev == ~((uint64) 0) ? 0 : minDev), avgRtt, avgDev, maxRtt, maxDev,
-		 snd_control_info.cwnd, ic_statistics.statusQueryMsgNum);
+		 snd_control_info.cwnd, ic_statistics.statusQueryMsgNum,
+		 (double) ((double) ic_statistics.sndPktNum) / ((double) ic_statistics.sndSyscallNum),
+		 (double) ((double) ic_statistics.recvSyscallPktNum) / ((double) ic_statistics.recvSyscallNum));
 
 	ic_control_info.isSender = false;
 	memset(&ic_statistics, 0, sizeof(ICStatistics));
@@ -4561,6 +4577,8 @@ prepareXmit(MotionConn *conn)
 {
 	Assert(conn != NULL);
 
+	CompressTupleChunks(conn, sizeof(conn->conn_info));
+
 	conn->conn_info.len = conn->msgSize;
 	conn->conn_info.crc = 0;
 
@@ -4690,6 +4708,182 @@ sendOnce(ChunkTransportState *transportStates, ChunkTransportStateEntry *pEntry,
 	return;
 }
 
+/*
+ * udpBatchSize
+ * 		The most packets to send or receive with one system call.
+ */
+static inline int
+udpBatchSize(void)
+{
+#ifdef HAVE_SENDMMSG
+#ifdef USE_ASSERT_CHECKING
+	/* The fault injection hooks are on sendto() and recvfrom() */
+	if (udp_testmode)
+		return 1;
+#endif
+	return gp_interconnect_udp_batch_size;
+#else
+	return 1;
+#endif
+}
+
+#if defined(HAVE_SENDMMSG) && defined(UDP_SEGMENT)
+
+/*
+ * Largest datagram handed to the kernel for segmentation: the maximum UDP
+ * payload over IPv6.
+ */
+#define UDPIC_MAX_GSO_SIZE (0xFFFF - 40 - 8)
+
+/* Set once a send with segmentation offload is rejected */
+static bool udp_gso_unsupported = false;
+
+/*
+ * sendBatchSegmented
+ * 		Send a batch of packets as one datagram that the kernel splits into
+ * 		packets of the size of the first one.
+ *
+ * That needs all the packets but the last one to have the same size, and the
+ * last one to be no larger. Returns false, having sent nothing, if the batch
+ * does not qualify or the kernel refuses it.
+ */
+static bool
+sendBatchSegmented(ChunkTransportStateEntry *pEntry, MotionConn *conn, ICBuffer **bufs, int nbufs)
+{
+	struct msghdr msg;
+	struct iovec iovs[GP_INTERCONNECT_UDP_MAX_BATCH_SIZE];
+	union
+	{
+		char		buf[CMSG_SPACE(sizeof(uint16))];
+		struct cmsghdr align;
+	}			control;
+	struct cmsghdr *cmsg;
+	uint16		segsize = bufs[0]->pkt->len;
+	int			total = 0;
+	int			i;
+	ssize_t		n;
+
+	if (udp_gso_unsupported)
+		return false;
+
+	for (i = 0; i < nbufs; i++)
+	{
+		int32		len = bufs[i]->pkt->len;
+
+		if (len > segsize || (len != segsize && i != nbufs - 1))
+			return false;
+
+		iovs[i].iov_base = bufs[i]->pkt;
+		iovs[i].iov_len = len;
+		total += len;
+	}
+
+	if (total > UDPIC_MAX_GSO_SIZE)
+		return false;
+
+	memset(&msg, 0, sizeof(msg));
+	msg.msg_name = &conn->peer;
+	msg.msg_namelen = conn->peer_len;
+	msg.msg_iov = iovs;
+	msg.msg_iovlen = nbufs;
+	msg.msg_control = control.buf;
+	msg.msg_controllen = sizeof(control.buf);
+
+	cmsg = CMSG_FIRSTHDR(&msg);
+	cmsg->cmsg_level = SOL_UDP;
+	cmsg->cmsg_type = UDP_SEGMENT;
+	cmsg->cmsg_len = CMSG_LEN(sizeof(uint16));
+	memcpy(CMSG_DATA(cmsg), &segsize, sizeof(uint16));
+
+	do
+	{
+		n = sendmsg(pEntry->txfd, &msg, 0);
+		ic_statistics.sndSyscallNum++;
+	} while (n < 0 && errno == EINTR);
+
+	if (n < 0)
+	{
+		/*
+		 * The kernel is too old, the device cannot checksum the segments, or
+		 * the segments would need IP fragmentation.  Don't try again.
+		 */
+		if (errno == EINVAL || errno == EIO || errno == ENOPROTOOPT ||
+			errno == EOPNOTSUPP)
+		{
+			if (DEBUG1 >= log_min_messages)
+				write_log("Interconnect UDP segmentation offload disabled (errno %d)", errno);
+			udp_gso_unsupported = true;
+		}
+		return false;
+	}
+
+	return true;
+}
+#endif							/* HAVE_SENDMMSG && UDP_SEGMENT */
+
+/*
+ * sendBatch
+ * 		Send a batch of packets of a connection with as few system calls as
+ * 		possible.
+ *
+ * A packet that sendmmsg() refuses is sent again on its own by sendOnce(),
+ * which knows which errors to ignore.
+ */
+static void
+sendBatch(ChunkTransportState *transportStates, ChunkTransportStateEntry *pEntry, MotionConn *conn,
+		  ICBuffer **bufs, int nbufs)
+{
+#ifdef HAVE_SENDMMSG
+	struct mmsghdr msgs[GP_INTERCONNECT_UDP_MAX_BATCH_SIZE];
+	struct iovec iovs[GP_INTERCONNECT_UDP_MAX_BATCH_SIZE];
+	int			i;
+
+	if (nbufs > 1)
+	{
+#ifdef UDP_SEGMENT
+		if (gp_interconnect_udp_gso && sendBatchSegmented(pEntry, conn, bufs, nbufs))
+			return;
+#endif
+
+		memset(msgs, 0, sizeof(struct mmsghdr) * nbufs);
+		for (i = 0; i < nbufs; i++)
+		{
+			iovs[i].iov_base = bufs[i]->pkt;
+			iovs[i].iov_len = bufs[i]->pkt->len;
+			msgs[i].msg_hdr.msg_name = &conn->peer;
+			msgs[i].msg_hdr.msg_namelen = conn->peer_len;
+			msgs[i].msg_hdr.msg_iov = &iovs[i];
+			msgs[i].msg_hdr.msg_iovlen = 1;
+		}
+
+		i = 0;
+		while (i < nbufs)
+		{
+			int			n;
+
+			n = sendmmsg(pEntry->txfd, &msgs[i], nbufs - i, 0);
+			ic_statistics.sndSyscallNum++;
+
+			if (n > 0)
+				i += n;
+			else if (n < 0 && errno == EINTR)
+				continue;
+			else
+			{
+				sendOnce(transportStates, pEntry, bufs[i], conn);
+				ic_statistics.sndSyscallNum++;
+				i++;
+			}
+		}
+		return;
+	}
+#endif
+
+	Assert(nbufs == 1);
+	sendOnce(transportStates, pEntry, bufs[0], conn);
+	ic_statistics.sndSyscallNum++;
+}
+
 
 /*
  * handleStopMsgs
@@ -4799,6 +4993,10 @@ handleStopMsgs(ChunkTransportState *transportStates, ChunkTransportStateEntry *p
 static void
 sendBuffers(ChunkTransportState *transportStates, ChunkTransportStateEntry *pEntry, MotionConn *conn)
 {
+	ICBuffer   *batch[GP_INTERCONNECT_UDP_MAX_BATCH_SIZE];
+	int			nbatch = 0;
+	int			maxbatch = udpBatchSize();
+
 	while (conn->capacity > 0 && icBufferListLength(&conn->sndQueue) > 0)
 	{
 		ICBuffer   *buf = NULL;
@@ -4837,9 +5035,9 @@ sendBuffers(ChunkTransportState *transportStates, ChunkTransportStateEntry *pEnt
 		}
 
 		/*
-		 * Note the place of sendOnce here. If we send before appending it to
+		 * Note the place of sendBatch here. If we send before appending it to
 		 * the unack queue and putting it into unack queue ring, and there is
-		 * a network error occurred in the sendOnce function, error message
+		 * a network error occurred in the sendBatch function, error message
 		 * will be output. In the time of error message output, interrupts is
 		 * potentially checked, if there is a pending query cancel, it will
 		 * lead to a dangled buffer (memory leak).
@@ -4848,15 +5046,24 @@ sendBuffers(ChunkTransportState *transportStates, ChunkTransportStateEntry *pEnt
 		updateStats(TPE_DATA_PKT_SEND, conn, buf->pkt);
 #endif
 
-		sendOnce(transportStates, pEntry, buf, conn);
+		batch[nbatch++] = buf;
 		ic_statistics.sndPktNum++;
 
 #ifdef AMS_VERBOSE_LOGGING
 		logPkt("SEND PKT DETAIL", buf->pkt);
 #endif
 
+		if (nbatch == maxbatch)
+		{
+			sendBatch(transportStates, pEntry, conn, batch, nbatch);
+			nbatch = 0;
+		}
+
 		buf->conn->sentSeq = buf->pkt->seq;
 	}
+
+	if (nbatch > 0)
+		sendBatch(transportStates, pEntry, conn, batch, nbatch);
 }
 
 /*
@@ -6192,6 +6399,173 @@ handleDataPacket(MotionConn *conn, icpkthdr *pkt, struct sockaddr_storage *peer,
 	return true;
 }
 
+/*
+ * receivePackets
+ * 		Read up to npkts packets from the listener socket.
+ *
+ * Returns the number of packets read, with their lengths and source
+ * addresses, or -1 with errno set.
+ *
+ * NOTE: Runs in the rx thread; MUST NOT elog.
+ */
+static int
+receivePackets(icpkthdr **pkts, int npkts, int *lens,
+			   struct sockaddr_storage *peers, socklen_t *peerlens)
+{
+#ifdef HAVE_SENDMMSG
+	if (npkts > 1)
+	{
+		struct mmsghdr msgs[GP_INTERCONNECT_UDP_MAX_BATCH_SIZE];
+		struct iovec iovs[GP_INTERCONNECT_UDP_MAX_BATCH_SIZE];
+		int			n;
+		int			i;
+
+		memset(msgs, 0, sizeof(struct mmsghdr) * npkts);
+		for (i = 0; i < npkts; i++)
+		{
+			iovs[i].iov_base = pkts[i];
+			iovs[i].iov_len = Gp_max_packet_size;
+			msgs[i].msg_hdr.msg_name = &peers[i];
+			msgs[i].msg_hdr.msg_namelen = sizeof(peers[i]);
+			msgs[i].msg_hdr.msg_iov = &iovs[i];
+			msgs[i].msg_hdr.msg_iovlen = 1;
+		}
+
+		/* The socket is non-blocking, so this returns what is queued. */
+		n = recvmmsg(UDP_listenerFd, msgs, npkts, MSG_WAITFORONE, NULL);
+
+		for (i = 0; i < n; i++)
+		{
+			lens[i] = msgs[i].msg_len;
+			peerlens[i] = msgs[i].msg_hdr.msg_namelen;
+		}
+
+		return n;
+	}
+#endif
+
+	peerlens[0] = sizeof(peers[0]);
+	lens[0] = recvfrom(UDP_listenerFd, (char *) pkts[0], Gp_max_packet_size, 0,
+					   (struct sockaddr *) &peers[0], &peerlens[0]);
+
+	return lens[0] < 0 ? -1 : 1;
+}
+
+/*
+ * handleRxPacket
+ * 		Handle a packet read by the rx thread.
+ *
+ * *pktp is set to NULL if the packet buffer was handed over to a connection.
+ *
+ * NOTE: Runs in the rx thread; MUST NOT elog.
+ */
+static void
+handleRxPacket(icpkthdr **pktp, int read_count, struct sockaddr_storage *peer, socklen_t peerlen)
+{
+	icpkthdr   *pkt = *pktp;
+	MotionConn *conn = NULL;
+	bool		wakeup_mainthread = false;
+	AckSendParam param;
+
+	if (DEBUG5 >= log_min_messages)
+		write_log("received inbound len %d", read_count);
+
+	if (read_count < sizeof(icpkthdr))
+	{
+		if (DEBUG1 >= log_min_messages)
+			write_log("Interconnect error: short conn receive (%d)", read_count);
+		return;
+	}
+
+	/* length must be >= 0 */
+	if (pkt->len < 0)
+	{
+		if (DEBUG3 >= log_min_messages)
+			write_log("received inbound with negative length");
+		return;
+	}
+
+	if (pkt->len != read_count)
+	{
+		if (DEBUG3 >= log_min_messages)
+			write_log("received inbound packet [%d], short: read %d bytes, pkt->len %d", pkt->seq, read_count, pkt->len);
+		return;
+	}
+
+	/*
+	 * check the CRC of the payload.
+	 */
+	if (gp_interconnect_full_crc)
+	{
+		if (!checkCRC(pkt))
+		{
+			pg_atomic_add_fetch_u32((pg_atomic_uint32 *) &ic_statistics.crcErrors, 1);
+			if (DEBUG2 >= log_min_messages)
+				write_log("received network data error, dropping bad packet, user data unaffected.");
+			return;
+		}
+	}
+
+#ifdef AMS_VERBOSE_LOGGING
+	logPkt("GOT MESSAGE", pkt);
+#endif
+
+	memset(&param, 0, sizeof(AckSendParam));
+
+	/*
+	 * Get the connection for the pkt.
+	 *
+	 * The connection hash table should be locked until finishing the
+	 * processing of the packet to avoid the connection addition/removal from
+	 * the hash table during the mean time.
+	 */
+
+	pthread_mutex_lock(&ic_control_info.lock);
+	conn = findConnByHeader(&ic_control_info.connHtab, pkt);
+
+	if (conn != NULL)
+	{
+		/* Handling a regular packet */
+		if (handleDataPacket(conn, pkt, peer, &peerlen, &param, &wakeup_mainthread))
+			*pktp = NULL;
+		ic_statistics.recvPktNum++;
+	}
+	else
+	{
+		/*
+		 * There may have two kinds of Mismatched packets: a) Past packets
+		 * from previous command after I was torn down b) Future packets from
+		 * current command before my connections are built.
+		 *
+		 * The handling logic is to "Ack the past and Nak the future".
+		 */
+		if ((pkt->flags & UDPIC_FLAGS_RECEIVER_TO_SENDER) == 0)
+		{
+			if (DEBUG1 >= log_min_messages)
+				write_log("mismatched packet received, seq %d, srcpid %d, dstpid %d, icid %d, sid %d", pkt->seq, pkt->srcPid, pkt->dstPid, pkt->icId, pkt->sessionId);
+
+#ifdef AMS_VERBOSE_LOGGING
+			logPkt("Got a Mismatched Packet", pkt);
+#endif
+
+			if (handleMismatch(pkt, peer, peerlen))
+				*pktp = NULL;
+			ic_statistics.mismatchNum++;
+		}
+	}
+	pthread_mutex_unlock(&ic_control_info.lock);
+
+	if (wakeup_mainthread)
+		SetLatch(&ic_control_info.latch);
+
+	/*
+	 * real ack sending is after lock release to decrease the lock holding
+	 * time.
+	 */
+	if (param.msg.len != 0)
+		sendAckWithParam(&param);
+}
+
 /*
  * rxThreadFunc
  * 		Main function of the receive background thread.
@@ -6203,12 +6577,24 @@ handleDataPacket(MotionConn *conn, icpkthdr *pkt, struct sockaddr_storage *peer,
  *		write_log("my brilliant log statement here.");
  *
  * NOTE: In threads, we cannot use palloc/pfree, because it's not thread safe.
+ *
+ * The thread always holds one rx buffer, pkts[0], accounted for by the
+ * initial rx_buffer_pool.maxCount. When there is inbound traffic it borrows
+ * more buffers to read a batch of packets with one system call; these are
+ * counted in maxCount while borrowed, just like the packets cached by
+ * cacheFuturePacket(), and given back after the batch.
  */
 static void *
 rxThreadFunc(void *arg)
 {
-	icpkthdr   *pkt = NULL;
+	icpkthdr   *pkts[GP_INTERCONNECT_UDP_MAX_BATCH_SIZE];
+	int			lens[GP_INTERCONNECT_UDP_MAX_BATCH_SIZE];
+	struct sockaddr_storage peers[GP_INTERCONNECT_UDP_MAX_BATCH_SIZE];
+	socklen_t	peerlens[GP_INTERCONNECT_UDP_MAX_BATCH_SIZE];
 	bool		skip_poll = false;
+	int			i;
+
+	memset(pkts, 0, sizeof(pkts));
 
 	for (;;)
 	{
@@ -6226,13 +6612,13 @@ rxThreadFunc(void *arg)
 		}
 
 		/* Try to get a buffer */
-		if (pkt == NULL)
+		if (pkts[0] == NULL)
 		{
 			pthread_mutex_lock(&ic_control_info.lock);
-			pkt = getRxBuffer(&rx_buffer_pool);
+			pkts[0] = getRxBuffer(&rx_buffer_pool);
 			pthread_mutex_unlock(&ic_control_info.lock);
 
-			if (pkt == NULL)
+			if (pkts[0] == NULL)
 			{
 				setRxThreadError(ENOMEM);
 				continue;
@@ -6282,15 +6668,25 @@ rxThreadFunc(void *arg)
 			/* we've got something interesting to read */
 			/* handle incoming */
 			/* ready to read on our socket */
-			MotionConn *conn = NULL;
-			int			read_count = 0;
+			int			batch_size = udpBatchSize();
+			int			nbufs;
+			int			read_count;
 
-			struct sockaddr_storage peer;
-			socklen_t	peerlen;
+			/* borrow the buffers for the rest of the batch */
+			pthread_mutex_lock(&ic_control_info.lock);
+			for (nbufs = 1; nbufs < batch_size; nbufs++)
+			{
+				rx_buffer_pool.maxCount++;
+				pkts[nbufs] = getRxBuffer(&rx_buffer_pool);
+				if (pkts[nbufs] == NULL)
+				{
+					rx_buffer_pool.maxCount--;
+					break;
+				}
+			}
+			pthread_mutex_unlock(&ic_control_info.lock);
 
-			peerlen = sizeof(peer);
-			read_count = recvfrom(UDP_listenerFd, (char *) pkt, Gp_max_packet_size, 0,
-								  (struct sockaddr *) &peer, &peerlen);
+			read_count = receivePackets(pkts, nbufs, lens, peers, peerlens);
 
 			if (pg_atomic_read_u32(&ic_control_info.shutdown) == 1)
 			{
@@ -6301,17 +6697,11 @@ rxThreadFunc(void *arg)
 				break;
 			}
 
-			if (DEBUG5 >= log_min_messages)
-				write_log("received inbound len %d", read_count);
-
 			if (read_count < 0)
 			{
-				skip_poll = false;
-
-				if (errno == EWOULDBLOCK || errno == EINTR)
-					continue;
+				int			save_errno = errno;
 
-				write_log("Interconnect error: recvfrom (%d)", errno);
+				skip_poll = false;
 
 				/*
 				 * ERROR case: if simply break out the loop here, there will
@@ -6321,127 +6711,62 @@ rxThreadFunc(void *arg)
 				 * Thus, we set an error flag, and let main thread to report
 				 * an error.
 				 */
-				setRxThreadError(errno);
-				continue;
-			}
-
-			if (read_count < sizeof(icpkthdr))
-			{
-				if (DEBUG1 >= log_min_messages)
-					write_log("Interconnect error: short conn receive (%d)", read_count);
-				continue;
-			}
-
-			/*
-			 * when we get a "good" recvfrom() result, we can skip poll()
-			 * until we get a bad one.
-			 */
-			skip_poll = true;
-
-			/* length must be >= 0 */
-			if (pkt->len < 0)
-			{
-				if (DEBUG3 >= log_min_messages)
-					write_log("received inbound with negative length");
-				continue;
-			}
-
-			if (pkt->len != read_count)
-			{
-				if (DEBUG3 >= log_min_messages)
-					write_log("received inbound packet [%d], short: read %d bytes, pkt->len %d", pkt->seq, read_count, pkt->len);
-				continue;
-			}
-
-			/*
-			 * check the CRC of the payload.
-			 */
-			if (gp_interconnect_full_crc)
-			{
-				if (!checkCRC(pkt))
+				if (save_errno != EWOULDBLOCK && save_errno != EINTR)
 				{
-					pg_atomic_add_fetch_u32((pg_atomic_uint32 *) &ic_statistics.crcErrors, 1);
-					if (DEBUG2 >= log_min_messages)
-						write_log("received network data error, dropping bad packet, user data unaffected.");
-					continue;
+					write_log("Interconnect error: recvfrom (%d)", save_errno);
+					setRxThreadError(save_errno);
 				}
 			}
-
-#ifdef AMS_VERBOSE_LOGGING
-			logPkt("GOT MESSAGE", pkt);
-#endif
-
-			bool		wakeup_mainthread = false;
-			AckSendParam param;
-
-			memset(&param, 0, sizeof(AckSendParam));
-
-			/*
-			 * Get the connection for the pkt.
-			 *
-			 * The connection hash table should be locked until finishing the
-			 * processing of the packet to avoid the connection
-			 * addition/removal from the hash table during the mean time.
-			 */
-
-			pthread_mutex_lock(&ic_control_info.lock);
-			conn = findConnByHeader(&ic_control_info.connHtab, pkt);
-
-			if (conn != NULL)
-			{
-				/* Handling a regular packet */
-				if (handleDataPacket(conn, pkt, &peer, &peerlen, &param, &wakeup_mainthread))
-					pkt = NULL;
-				ic_statistics.recvPktNum++;
-			}
 			else
 			{
+				pg_atomic_add_fetch_u32((pg_atomic_uint32 *) &ic_statistics.recvSyscallNum, 1);
+				pg_atomic_add_fetch_u32((pg_atomic_uint32 *) &ic_statistics.recvSyscallPktNum, read_count);
+
 				/*
-				 * There may have two kinds of Mismatched packets: a) Past
-				 * packets from previous command after I was torn down b)
-				 * Future packets from current command before my connections
-				 * are built.
-				 *
-				 * The handling logic is to "Ack the past and Nak the future".
+				 * when we get a "good" recvfrom() result, we can skip poll()
+				 * until we get a bad one.
 				 */
-				if ((pkt->flags & UDPIC_FLAGS_RECEIVER_TO_SENDER) == 0)
-				{
-					if (DEBUG1 >= log_min_messages)
-						write_log("mismatched packet received, seq %d, srcpid %d, dstpid %d, icid %d, sid %d", pkt->seq, pkt->srcPid, pkt->dstPid, pkt->icId, pkt->sessionId);
+				skip_poll = true;
 
-#ifdef AMS_VERBOSE_LOGGING
-					logPkt("Got a Mismatched Packet", pkt);
-#endif
-
-					if (handleMismatch(pkt, &peer, peerlen))
-						pkt = NULL;
-					ic_statistics.mismatchNum++;
-				}
+				for (i = 0; i < read_count; i++)
+					handleRxPacket(&pkts[i], lens[i], &peers[i], peerlens[i]);
 			}
-			pthread_mutex_unlock(&ic_control_info.lock);
-
-			if (wakeup_mainthread)
-				SetLatch(&ic_control_info.latch);
 
 			/*
-			 * real ack sending is after lock release to decrease the lock
-			 * holding time.
+			 * Give back the borrowed buffers, keeping one of those left
+			 * if ours was handed over to a connection.
 			 */
-			if (param.msg.len != 0)
-				sendAckWithParam(&param);
+			pthread_mutex_lock(&ic_control_info.lock);
+			for (i = 1; i < nbufs; i++)
+			{
+				rx_buffer_pool.maxCount--;
+				if (pkts[i] == NULL)
+					continue;
+				if (pkts[0] == NULL)
+					pkts[0] = pkts[i];
+				else
+					putRxBufferToFreeList(&rx_buffer_pool, pkts[i]);
+				pkts[i] = NULL;
+			}
+			pthread_mutex_unlock(&ic_control_info.lock);
 		}
 
 		/* pthread_yield(); */
 	}
 
-	/* Before return, we release the packet. */
-	if (pkt)
+	/* Before return, we release the packets. */
+	pthread_mutex_lock(&ic_control_info.lock);
+	for (i = 0; i < GP_INTERCONNECT_UDP_MAX_BATCH_SIZE; i++)
 	{
-		pthread_mutex_lock(&ic_control_info.lock);
-		freeRxBuffer(&rx_buffer_pool, pkt);
-		pkt = NULL;
-		pthread_mutex_unlock(&ic_control_info.lock);
+		if (pkts[i])
+		{
+			if (i > 0)
+				rx_buffer_pool.maxCount--;
+			freeRxBuffer(&rx_buffer_pool, pkts[i]);
+			pkts[i] = NULL;
+		}
 	}
+	pthread_mutex_unlock(&ic_control_info.lock);
 
 	/* nothing to return */
 	return NULL;
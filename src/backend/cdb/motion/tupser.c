@@ -16,6 +16,7 @@
 #include "postgres.h"
 
 #include "access/htup.h"
+#include "access/htup_details.h"
 #include "access/memtup.h"
 #include "access/tuptoaster.h"
 #include "catalog/pg_type.h"
@@ -23,6 +24,7 @@
 #include "cdb/cdbsrlz.h"
 #include "cdb/tupser.h"
 #include "cdb/cdbvars.h"
+#include "executor/tuptable.h"
 #include "libpq/pqformat.h"
 #include "storage/smgr.h"
 #include "utils/acl.h"
@@ -40,6 +42,7 @@
 #define RECORD_CACHE_MAGIC_TUPLEN	-1
 
 static void addByteStringToChunkList(TupleChunkList tcList, char *data, int datalen, TupleChunkListCache *cache);
+static void InitSerTupBatchInfo(SerTupInfo *pSerInfo);
 
 #define addCharToChunkList(tcList, x, c)							\
 	do															\
@@ -142,6 +145,84 @@ InitSerTupInfo(TupleDesc tupdesc, SerTupInfo *pSerInfo)
 			ReleaseSysCache(typeTuple);
 		}
 	}
+
+	if (gp_motion_batch_size > 0 && !pSerInfo->has_record_types)
+		InitSerTupBatchInfo(pSerInfo);
+}
+
+/*
+ * Is a column of this type stored in the batch format?
+ */
+static bool
+IsBatchAttr(SerAttrInfo *attrInfo)
+{
+	if (!attrInfo->typbyval)
+		return false;
+
+	switch (attrInfo->typlen)
+	{
+		case sizeof(char):
+		case sizeof(int16):
+		case sizeof(int32):
+#if SIZEOF_DATUM == 8
+		case sizeof(int64):
+#endif
+			return true;
+		default:
+			return false;
+	}
+}
+
+/*
+ * Set up the batch format for tuples of pSerInfo's descriptor, if all their
+ * columns are fixed-width pass-by-value types.
+ *
+ * A batch is sent as a single TC_BATCH chunk, so the number of tuples in a
+ * batch is limited by what fits in a chunk.  The chunk holds:
+ *
+ *	  int32		number of tuples
+ *	  bits8[]	bitmap of the columns that have a null bitmap
+ *	  for each column:
+ *		bits8[]	null bitmap, bit set for non-NULL values, if any NULL
+ *		values, packed, with a zero in place of NULLs
+ */
+static void
+InitSerTupBatchInfo(SerTupInfo *pSerInfo)
+{
+	TupleDesc	tupdesc = pSerInfo->tupdesc;
+	int			natts = tupdesc->natts;
+	int			width = 0;
+	int			avail;
+	int			rows;
+	int			off;
+	int			i;
+
+	for (i = 0; i < natts; i++)
+	{
+		if (TupleDescAttr(tupdesc, i)->attisdropped ||
+			!IsBatchAttr(&pSerInfo->myinfo[i]))
+			return;
+		width += pSerInfo->myinfo[i].typlen;
+	}
+
+	/* each row takes width bytes, and one bit in each null bitmap */
+	avail = Gp_max_tuple_chunk_size - TUPLE_CHUNK_HEADER_SIZE -
+		sizeof(int32) - BITMAPLEN(natts) - natts;
+	if (avail <= 0)
+		return;
+	rows = Min(avail * 8 / (width * 8 + natts), gp_motion_batch_size);
+	if (rows < 2)
+		return;
+
+	pSerInfo->batch_valoff = (int *) palloc(natts * sizeof(int));
+	off = 0;
+	for (i = 0; i < natts; i++)
+	{
+		pSerInfo->batch_valoff[i] = off;
+		off += rows * pSerInfo->myinfo[i].typlen;
+	}
+	pSerInfo->batch_size = off;
+	pSerInfo->batch_rows = rows;
 }
 
 
@@ -168,6 +249,11 @@ CleanupSerTupInfo(SerTupInfo *pSerInfo)
 		pfree(pSerInfo->nulls);
 	pSerInfo->nulls = NULL;
 
+	if (pSerInfo->batch_valoff != NULL)
+		pfree(pSerInfo->batch_valoff);
+	pSerInfo->batch_valoff = NULL;
+	pSerInfo->batch_rows = 0;
+
 	pSerInfo->tupdesc = NULL;
 
 	while (pSerInfo->chunkCache.items != NULL)
@@ -682,3 +768,313 @@ CvtChunksToTup(TupleChunkList tcList, SerTupInfo *pSerInfo, TupleRemapper *remap
 
 	return tup;
 }
+
+/*
+ * Store a value of a column in the batch format.  The values are not aligned
+ * within the chunks.
+ */
+static inline void
+storeBatchValue(char *pos, Datum value, int16 typlen)
+{
+	switch (typlen)
+	{
+		case sizeof(char):
+			*pos = DatumGetChar(value);
+			break;
+		case sizeof(int16):
+			{
+				int16		v = DatumGetInt16(value);
+
+				memcpy(pos, &v, sizeof(v));
+			}
+			break;
+		case sizeof(int32):
+			{
+				int32		v = DatumGetInt32(value);
+
+				memcpy(pos, &v, sizeof(v));
+			}
+			break;
+#if SIZEOF_DATUM == 8
+		case sizeof(int64):
+			memcpy(pos, &value, sizeof(value));
+			break;
+#endif
+		default:
+			elog(ERROR, "unsupported byval length: %d", (int) typlen);
+	}
+}
+
+static inline Datum
+fetchBatchValue(const char *pos, int16 typlen)
+{
+	switch (typlen)
+	{
+		case sizeof(char):
+			return CharGetDatum(*pos);
+		case sizeof(int16):
+			{
+				int16		v;
+
+				memcpy(&v, pos, sizeof(v));
+				return Int16GetDatum(v);
+			}
+		case sizeof(int32):
+			{
+				int32		v;
+
+				memcpy(&v, pos, sizeof(v));
+				return Int32GetDatum(v);
+			}
+#if SIZEOF_DATUM == 8
+		case sizeof(int64):
+			{
+				Datum		v;
+
+				memcpy(&v, pos, sizeof(v));
+				return v;
+			}
+#endif
+		default:
+			elog(ERROR, "unsupported byval length: %d", (int) typlen);
+			return (Datum) 0;	/* keep compiler quiet */
+	}
+}
+
+/*
+ * Create an empty batch of tuples to send in the batch format.
+ *
+ * NOTE: allocates in the current memory-context, like InitSerTupInfo().
+ */
+SerTupBatch *
+CreateSerTupBatch(SerTupInfo *pSerInfo)
+{
+	int			natts = pSerInfo->tupdesc->natts;
+	int			bitmaplen = BITMAPLEN(pSerInfo->batch_rows);
+	SerTupBatch *batch;
+	char	   *pos;
+
+	Assert(pSerInfo->batch_rows > 0);
+
+	pos = palloc0(MAXALIGN(sizeof(SerTupBatch)) +
+				  MAXALIGN(natts * sizeof(bool)) +
+				  MAXALIGN(natts * bitmaplen) +
+				  pSerInfo->batch_size);
+
+	batch = (SerTupBatch *) pos;
+	pos += MAXALIGN(sizeof(SerTupBatch));
+	batch->hasnulls = (bool *) pos;
+	pos += MAXALIGN(natts * sizeof(bool));
+	batch->nullbits = (bits8 *) pos;
+	pos += MAXALIGN(natts * bitmaplen);
+	batch->values = pos;
+	batch->nrows = 0;
+
+	return batch;
+}
+
+/*
+ * Append the tuple in slot to a batch.  Returns true if the batch is full,
+ * and should be sent with SerializeBatchIntoChunks().
+ */
+bool
+AddTupleToBatch(TupleTableSlot *slot, SerTupInfo *pSerInfo, SerTupBatch *batch)
+{
+	int			natts = pSerInfo->tupdesc->natts;
+	int			bitmaplen = BITMAPLEN(pSerInfo->batch_rows);
+	int			row = batch->nrows;
+	int			i;
+
+	Assert(row < pSerInfo->batch_rows);
+
+	slot_getallattrs(slot);
+
+	for (i = 0; i < natts; i++)
+	{
+		int16		typlen = pSerInfo->myinfo[i].typlen;
+		char	   *pos = batch->values + pSerInfo->batch_valoff[i] + row * typlen;
+
+		if (slot->tts_isnull[i])
+		{
+			batch->hasnulls[i] = true;
+			memset(pos, 0, typlen);
+		}
+		else
+		{
+			batch->nullbits[i * bitmaplen + (row >> 3)] |= 1 << (row & 0x07);
+			storeBatchValue(pos, slot->tts_values[i], typlen);
+		}
+	}
+
+	return ++batch->nrows == pSerInfo->batch_rows;
+}
+
+/*
+ * Convert the tuples of a batch into a single TC_BATCH chunk, and empty the
+ * batch.
+ */
+void
+SerializeBatchIntoChunks(SerTupInfo *pSerInfo, SerTupBatch *batch, TupleChunkList tcList)
+{
+	int			natts = pSerInfo->tupdesc->natts;
+	int			bitmaplen = BITMAPLEN(pSerInfo->batch_rows);
+	int32		nrows = batch->nrows;
+	TupleChunkListItem tcItem;
+	bits8	   *colbits;
+	char	   *pos;
+	int			dataSize;
+	int			i;
+
+	AssertArg(tcList != NULL);
+	Assert(nrows > 0);
+
+	tcList->p_first = NULL;
+	tcList->p_last = NULL;
+	tcList->num_chunks = 0;
+	tcList->serialized_data_length = 0;
+	tcList->max_chunk_length = Gp_max_tuple_chunk_size;
+
+	tcItem = getChunkFromCache(&pSerInfo->chunkCache);
+	pos = (char *) tcItem->chunk_data + TUPLE_CHUNK_HEADER_SIZE;
+
+	memcpy(pos, &nrows, sizeof(nrows));
+	pos += sizeof(nrows);
+	colbits = (bits8 *) pos;
+	memset(colbits, 0, BITMAPLEN(natts));
+	pos += BITMAPLEN(natts);
+
+	for (i = 0; i < natts; i++)
+	{
+		int			valuesLen = nrows * pSerInfo->myinfo[i].typlen;
+
+		if (batch->hasnulls[i])
+		{
+			colbits[i >> 3] |= 1 << (i & 0x07);
+			memcpy(pos, batch->nullbits + i * bitmaplen, BITMAPLEN(nrows));
+			pos += BITMAPLEN(nrows);
+		}
+		memcpy(pos, batch->values + pSerInfo->batch_valoff[i], valuesLen);
+		pos += valuesLen;
+	}
+
+	dataSize = pos - (char *) tcItem->chunk_data;
+	Assert(dataSize <= Gp_max_tuple_chunk_size);
+
+	SetChunkType(tcItem->chunk_data, TC_BATCH);
+	SetChunkDataSize(tcItem->chunk_data, dataSize - TUPLE_CHUNK_HEADER_SIZE);
+	tcItem->chunk_length = dataSize;
+	appendChunkToTCList(tcList, tcItem);
+	tcList->serialized_data_length = dataSize - TUPLE_CHUNK_HEADER_SIZE;
+
+	/* Start over */
+	batch->nrows = 0;
+	memset(batch->hasnulls, 0, natts * sizeof(bool));
+	memset(batch->nullbits, 0, natts * bitmaplen);
+}
+
+/*
+ * Take in a TC_BATCH chunk.  Its contents are copied, as the chunk may point
+ * into a receive buffer.
+ */
+TupleBatch
+CvtChunkToBatch(TupleChunkListItem tcItem, SerTupInfo *pSerInfo)
+{
+	int			natts = pSerInfo->tupdesc->natts;
+	int			dataSize = tcItem->chunk_length - TUPLE_CHUNK_HEADER_SIZE;
+	TupleBatch	batch;
+	bits8	   *colbits;
+	char	   *pos;
+	char	   *end;
+	int32		nrows;
+	int			i;
+
+	batch = palloc(MAXALIGN(sizeof(TupleBatchData)) +
+				   MAXALIGN(natts * (sizeof(bits8 *) + sizeof(char *))) +
+				   dataSize);
+	batch->nullbits = (bits8 **) ((char *) batch + MAXALIGN(sizeof(TupleBatchData)));
+	batch->values = (char **) (batch->nullbits + natts);
+	pos = (char *) batch + MAXALIGN(sizeof(TupleBatchData)) +
+		MAXALIGN(natts * (sizeof(bits8 *) + sizeof(char *)));
+	end = pos + dataSize;
+
+	memcpy(pos, GetChunkDataPtr(tcItem) + TUPLE_CHUNK_HEADER_SIZE, dataSize);
+
+	if (dataSize < sizeof(nrows) + BITMAPLEN(natts))
+		goto malformed;
+	memcpy(&nrows, pos, sizeof(nrows));
+	pos += sizeof(nrows);
+	if (nrows <= 0 || nrows > dataSize)
+		goto malformed;
+	colbits = (bits8 *) pos;
+	pos += BITMAPLEN(natts);
+
+	for (i = 0; i < natts; i++)
+	{
+		SerAttrInfo *attrInfo = &pSerInfo->myinfo[i];
+
+		if (!IsBatchAttr(attrInfo))
+			goto malformed;
+
+		if (colbits[i >> 3] & (1 << (i & 0x07)))
+		{
+			batch->nullbits[i] = (bits8 *) pos;
+			pos += BITMAPLEN(nrows);
+		}
+		else
+			batch->nullbits[i] = NULL;
+
+		batch->values[i] = pos;
+		pos += nrows * attrInfo->typlen;
+		if (pos > end)
+			goto malformed;
+	}
+	if (pos != end)
+		goto malformed;
+
+	batch->nrows = nrows;
+	batch->next = 0;
+	batch->natts = natts;
+	batch->attrinfo = pSerInfo->myinfo;
+
+	return batch;
+
+malformed:
+	ereport(ERROR,
+			(errcode(ERRCODE_PROTOCOL_VIOLATION),
+			 errmsg("malformed tuple batch of %d bytes", dataSize)));
+	return NULL;				/* keep compiler quiet */
+}
+
+/*
+ * Store the next tuple of a batch in slot, as a virtual tuple.
+ */
+void
+TupleBatchNextTuple(TupleBatch batch, TupleTableSlot *slot)
+{
+	int			row = batch->next++;
+	int			i;
+
+	Assert(row < batch->nrows);
+	Assert(slot->tts_tupleDescriptor->natts == batch->natts);
+
+	ExecClearTuple(slot);
+
+	for (i = 0; i < batch->natts; i++)
+	{
+		if (batch->nullbits[i] && att_isnull(row, batch->nullbits[i]))
+		{
+			slot->tts_values[i] = (Datum) 0;
+			slot->tts_isnull[i] = true;
+		}
+		else
+		{
+			int16		typlen = batch->attrinfo[i].typlen;
+
+			slot->tts_values[i] = fetchBatchValue(batch->values[i] + row * typlen,
+												  typlen);
+			slot->tts_isnull[i] = false;
+		}
+	}
+
+	ExecStoreVirtualTuple(slot);
+}
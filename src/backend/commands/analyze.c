@@ -186,6 +186,10 @@ static int acquire_sample_rows_dispatcher(Relation onerel, bool inh, int elevel,
 										  HeapTuple *rows, int targrows,
 										  double *totalrows, double *totaldeadrows);
 static BlockNumber acquire_index_number_of_blocks(Relation indexrel, Relation tablerel);
+static bool analyze_tracks_ao_changes(Relation onerel, bool inh);
+static int64 acquire_ao_modcount(Relation onerel);
+static bool ao_stats_are_current(Relation onerel, VacAttrStats **vacattrstats,
+								 int attr_cnt, int64 aoModCount, bool fullscan);
 
 static void gp_acquire_correlations_dispatcher(Oid relOid, bool inh, float4 *correlations, bool *correlationsIsNull);
 static int	compare_rows(const void *a, const void *b);
@@ -497,6 +501,8 @@ do_analyze_rel(Relation onerel, VacuumParams *params,
 	Bitmapset **colLargeRowIndexes;
 	double     *colLargeRowLength;
 	bool		sample_needed;
+	bool		track_ao_changes;
+	int64		aoModCount = 0;
 
 	if (inh)
 		ereport(elevel,
@@ -590,6 +596,56 @@ do_analyze_rel(Relation onerel, VacuumParams *params,
 		attr_cnt = tcnt;
 	}
 
+	/*
+	 * GPDB: With gp_analyze_skip_unchanged_ao, remember the modcount of an
+	 * append-optimized partition before we sample it, and keep the statistics
+	 * it already has if it has not been modified since they were computed.
+	 * This is what makes re-analyzing a large partitioned table after loading
+	 * a few new partitions cheap: only those partitions are sampled, and the
+	 * root statistics are merged from the statistics of all the leaves. It
+	 * is all or nothing per partition; a modified partition is sampled again
+	 * as a whole.
+	 */
+	track_ao_changes = analyze_tracks_ao_changes(onerel, inh);
+	if (track_ao_changes)
+	{
+		aoModCount = acquire_ao_modcount(onerel);
+
+		if (ao_stats_are_current(onerel, vacattrstats, attr_cnt, aoModCount,
+								 (params->options & VACOPT_FULLSCAN) != 0))
+		{
+			ereport(elevel,
+					(errmsg("skipping \"%s.%s\" --- not modified since it was last analyzed",
+							get_namespace_name(RelationGetNamespace(onerel)),
+							RelationGetRelationName(onerel))));
+
+			/*
+			 * The partition still counts as analyzed. Its data has not
+			 * changed, so neither has its number of tuples, but update
+			 * pg_class and report the ANALYZE to the stats collector like
+			 * below, so that its changes_since_analyze counter is reset.
+			 */
+			totalrows = Max(onerel->rd_rel->reltuples, 0);
+			vac_update_relstats(onerel,
+								relpages,
+								totalrows,
+								0,
+								onerel->rd_rel->relhasindex,
+								InvalidTransactionId,
+								InvalidMultiXactId,
+								in_outer_xact,
+								false /* isVacuum */);
+			pgstat_report_analyze(onerel, totalrows, 0, (va_cols == NIL));
+
+			AtEOXact_GUC(false, save_nestlevel);
+			SetUserIdAndSecContext(save_userid, save_sec_context);
+			MemoryContextSwitchTo(caller_context);
+			MemoryContextDelete(anl_context);
+			anl_context = NULL;
+			return;
+		}
+	}
+
 	/*
 	 * Open all indexes of the relation, and see if there are any analyzable
 	 * columns in the indexes.  We do not analyze index columns if there was
@@ -891,6 +947,12 @@ do_analyze_rel(Relation onerel, VacuumParams *params,
 					int16 stakind = 0;
 					if(stats->stahll_full != NULL)
 					{
+						if (track_ao_changes)
+						{
+							((GpHLLCounter) (stats->stahll_full))->aoModCount = aoModCount;
+							((GpHLLCounter) (stats->stahll_full))->aoRelfilenode = onerel->rd_node.relNode;
+						}
+
 						hll_length = datumGetSize(PointerGetDatum(stats->stahll_full), false, -1);
 						hll_values[0] = datumCopy(PointerGetDatum(stats->stahll_full), false, hll_length);
 						stakind = STATISTIC_KIND_FULLHLL;
@@ -899,6 +961,11 @@ do_analyze_rel(Relation onerel, VacuumParams *params,
 					{
 						((GpHLLCounter) (stats->stahll))->relPages = relpages;
 						((GpHLLCounter) (stats->stahll))->relTuples = totalrows;
+						if (track_ao_changes)
+						{
+							((GpHLLCounter) (stats->stahll))->aoModCount = aoModCount;
+							((GpHLLCounter) (stats->stahll))->aoRelfilenode = onerel->rd_node.relNode;
+						}
 
 						hll_length = gp_hyperloglog_len((GpHLLCounter)stats->stahll);
 						hll_values[0] = datumCopy(PointerGetDatum(stats->stahll), false, hll_length);
@@ -2110,6 +2177,114 @@ AcquireNumberOfBlocks(Relation onerel)
 	}
 }
 
+/*
+ * Can we tell whether 'onerel' was modified since its statistics were
+ * computed?
+ *
+ * We can for the append-optimized tables whose column statistics include a
+ * HyperLogLog counter, that is the leaf partitions and the tables created
+ * with analyze_hll_non_part_table, because we record the modcount of the table
+ * in the counter.
+ */
+static bool
+analyze_tracks_ao_changes(Relation onerel, bool inh)
+{
+	if (!gp_analyze_skip_unchanged_ao || Gp_role != GP_ROLE_DISPATCH || inh)
+		return false;
+
+	if (onerel->rd_rel->relkind != RELKIND_RELATION ||
+		!RelationStorageIsAO(onerel) ||
+		!onerel->rd_cdbpolicy || GpPolicyIsEntry(onerel->rd_cdbpolicy))
+		return false;
+
+	if (onerel->rd_rel->relispartition)
+		return true;
+
+	return (onerel->rd_options != NULL &&
+			((StdRdOptions *) onerel->rd_options)->analyze_hll_non_part_table);
+}
+
+/*
+ * Compute the sum of the modcounts of all the segment files of an
+ * append-optimized table, on all the segments.
+ *
+ * Every change to the data of the table bumps the modcount of at least one
+ * of its segment files, and the modcounts are never reset as long as the
+ * table keeps its relfilenode, so the sum changes whenever the data does.
+ * This is the same test that analyzedb uses to find the tables to analyze.
+ */
+static int64
+acquire_ao_modcount(Relation onerel)
+{
+	Oid			segrelid;
+	char	   *modcount_sql;
+	int64		modcount;
+
+	GetAppendOnlyEntryAuxOids(onerel, &segrelid, NULL, NULL);
+
+	modcount_sql = psprintf("select pg_catalog.sum(modcount) from %s",
+							quote_qualified_identifier(get_namespace_name(get_rel_namespace(segrelid)),
+													   get_rel_name(segrelid)));
+	modcount = get_size_from_segDBs(modcount_sql);
+	pfree(modcount_sql);
+
+	return modcount;
+}
+
+/*
+ * Are the statistics that 'onerel' has for the columns in 'vacattrstats'
+ * still current?
+ *
+ * They are if the HyperLogLog counter of every column was created when the
+ * table had the same relfilenode and modcount as now.  If 'fullscan' is set,
+ * only counters built by scanning the whole table will do.
+ */
+static bool
+ao_stats_are_current(Relation onerel, VacAttrStats **vacattrstats,
+					 int attr_cnt, int64 aoModCount, bool fullscan)
+{
+	int			i;
+
+	if (attr_cnt == 0)
+		return false;
+
+	for (i = 0; i < attr_cnt; i++)
+	{
+		HeapTuple	statstup;
+		AttStatsSlot hllSlot;
+		bool		current = false;
+
+		statstup = SearchSysCache3(STATRELATTINH,
+								   ObjectIdGetDatum(RelationGetRelid(onerel)),
+								   Int16GetDatum(vacattrstats[i]->attr->attnum),
+								   BoolGetDatum(false));
+		if (!HeapTupleIsValid(statstup))
+			return false;
+
+		if (get_attstatsslot(&hllSlot, statstup, STATISTIC_KIND_FULLHLL,
+							 InvalidOid, ATTSTATSSLOT_VALUES) ||
+			(!fullscan &&
+			 get_attstatsslot(&hllSlot, statstup, STATISTIC_KIND_HLL,
+							  InvalidOid, ATTSTATSSLOT_VALUES)))
+		{
+			/* copy the counter, so that its fields are properly aligned */
+			GpHLLCounter hll = (GpHLLCounter) DatumGetByteaPCopy(hllSlot.values[0]);
+
+			current = (hll->aoRelfilenode == onerel->rd_node.relNode &&
+					   hll->aoModCount == aoModCount);
+
+			pfree(hll);
+			free_attstatsslot(&hllSlot);
+		}
+		ReleaseSysCache(statstup);
+
+		if (!current)
+			return false;
+	}
+
+	return true;
+}
+
 /*
  * Compute index relation's size.
  *
@@ -38,6 +38,7 @@
 #include "executor/execPartition.h"
 #include "executor/executor.h"
 #include "executor/nodeModifyTable.h"
+#include "executor/spi.h"
 #include "executor/tuptable.h"
 #include "foreign/fdwapi.h"
 #include "libpq/libpq.h"
@@ -46,17 +47,22 @@
 #include "miscadmin.h"
 #include "optimizer/optimizer.h"
 #include "nodes/makefuncs.h"
+#include "parser/analyze.h"
 #include "parser/parse_coerce.h"
 #include "parser/parse_collate.h"
 #include "parser/parse_expr.h"
 #include "parser/parse_relation.h"
+#include "parser/scansup.h"
 #include "pgstat.h"
 #include "port/pg_bswap.h"
+#include "port/pg_charscan.h"
 #include "rewrite/rewriteHandler.h"
 #include "storage/fd.h"
 #include "storage/execute_pipe.h"
+#include "storage/proc.h"
 #include "tcop/tcopprot.h"
 #include "tcop/utility.h"
+#include "utils/acl.h"
 #include "utils/builtins.h"
 #include "utils/lsyscache.h"
 #include "utils/memutils.h"
@@ -227,6 +233,13 @@ static uint64 CopyToDispatch(CopyState cstate);
 static uint64 CopyTo(CopyState cstate);
 static uint64 CopyDispatchOnSegment(CopyState cstate, const CopyStmt *stmt);
 static uint64 CopyToQueryOnSegment(CopyState cstate);
+static bool CopyFromCanStage(Relation rel, List *options, Node *whereClause);
+static Relation CopyFromGetStagingTable(Relation rel, List *attnamelist,
+										char **collist);
+static bool CopyFromStagingTableMatches(Relation stagingRel, Relation rel,
+										List *attnums);
+static uint64 CopyFromStagingTable(Relation rel, Relation stagingRel,
+								   const char *collist);
 static bool CopyReadLine(CopyState cstate);
 static bool CopyReadLineText(CopyState cstate);
 static int	CopyReadAttributesText(CopyState cstate, int stop_processing_at_field);
@@ -1224,6 +1237,9 @@ DoCopy(ParseState *pstate, const CopyStmt *stmt,
 
 	if (is_from)
 	{
+		Relation	stagingRel = NULL;
+		char	   *stagingCols = NULL;
+
 		Assert(rel);
 
 		if (stmt->sreh && Gp_role != GP_ROLE_EXECUTE && !rel->rd_cdbpolicy)
@@ -1241,8 +1257,22 @@ DoCopy(ParseState *pstate, const CopyStmt *stmt,
 			PreventCommandIfReadOnly("COPY FROM");
 		PreventCommandIfParallelMode("COPY FROM");
 
-		cstate = BeginCopyFrom(pstate, rel, stmt->filename, stmt->is_program,
-							   NULL, NULL, stmt->attlist, options);
+		/*
+		 * With gp_copy_parse_on_segments, load the data into a randomly
+		 * distributed staging table instead, so that the QD only needs to
+		 * find the line boundaries, and move the rows to the real table
+		 * afterwards.
+		 */
+		if (CopyFromCanStage(rel, options, whereClause))
+			stagingRel = CopyFromGetStagingTable(rel, stmt->attlist,
+												 &stagingCols);
+
+		if (stagingRel)
+			cstate = BeginCopyFrom(pstate, stagingRel, stmt->filename,
+								   stmt->is_program, NULL, NULL, NIL, options);
+		else
+			cstate = BeginCopyFrom(pstate, rel, stmt->filename, stmt->is_program,
+								   NULL, NULL, stmt->attlist, options);
 		cstate->whereClause = whereClause;
 
 		/*
@@ -1300,6 +1330,9 @@ DoCopy(ParseState *pstate, const CopyStmt *stmt,
 		}
 		PG_END_TRY();
 		EndCopyFrom(cstate);
+
+		if (stagingRel)
+			*processed = CopyFromStagingTable(rel, stagingRel, stagingCols);
 	}
 	else
 	{
@@ -1363,6 +1396,334 @@ DoCopy(ParseState *pstate, const CopyStmt *stmt,
 	}
 }
 
+/*
+ * Can a COPY FROM into 'rel' go through a staging table?
+ *
+ * When the table is hash distributed, the QD has to parse each row up to the
+ * last distribution key column, and hash the key, to know where to send the
+ * row.  With gp_copy_parse_on_segments, we instead COPY into a randomly
+ * distributed temporary table, which the QD spreads the lines over without
+ * looking into them.  The segments parse the rows in parallel, and an
+ * INSERT ... SELECT then redistributes them to the right segments.
+ *
+ * That doesn't work for everything COPY can do.  LOG ERRORS would log the
+ * errors for the staging table, and a WHERE clause or FREEZE would apply to
+ * the wrong table.  BINARY rows are parsed in full by the QD anyway, and
+ * ON SEGMENT doesn't go through the QD at all.
+ *
+ * This only checks the COPY itself; CopyFromGetStagingTable() can still
+ * decide to go without a staging table.
+ */
+static bool
+CopyFromCanStage(Relation rel, List *options, Node *whereClause)
+{
+	ListCell   *lc;
+
+	if (!gp_copy_parse_on_segments || Gp_role != GP_ROLE_DISPATCH)
+		return false;
+
+	if (rel->rd_rel->relkind != RELKIND_RELATION &&
+		rel->rd_rel->relkind != RELKIND_PARTITIONED_TABLE)
+		return false;
+	if (!GpPolicyIsHashPartitioned(rel->rd_cdbpolicy))
+		return false;
+
+	if (whereClause)
+		return false;
+
+	foreach(lc, options)
+	{
+		DefElem    *defel = lfirst_node(DefElem, lc);
+
+		if (strcmp(defel->defname, "format") == 0)
+		{
+			if (strcmp(defGetString(defel), "binary") == 0)
+				return false;
+		}
+		else if (strcmp(defel->defname, "freeze") == 0)
+		{
+			if (defGetBoolean(defel))
+				return false;
+		}
+		else if (strcmp(defel->defname, "on_segment") == 0)
+			return false;
+		else if (strcmp(defel->defname, "sreh") == 0)
+		{
+			SingleRowErrorDesc *sreh = (SingleRowErrorDesc *) defel->arg;
+
+			if (IS_LOG_TO_FILE(sreh->log_error_type))
+				return false;
+		}
+	}
+
+	return true;
+}
+
+/*
+ * The staging tables that have been filled in the current transaction, by
+ * OID, and the local transaction ID of that transaction.  Allocated in
+ * TopMemoryContext.
+ */
+static LocalTransactionId stagingTablesUsedLxid = InvalidLocalTransactionId;
+static List *stagingTablesUsed = NIL;
+
+/*
+ * Get the staging table for a COPY FROM into 'rel', with the columns being
+ * copied, opened and empty.  The comma-separated list of the column names is
+ * returned in *collist, for CopyFromStagingTable().  Returns NULL if the COPY
+ * has to go without a staging table.
+ *
+ * Creating and dropping a table for every COPY would mean catalog changes,
+ * and dispatching them, each time.  So the staging table is a temporary
+ * table that is kept for the rest of the session, and reused by the next
+ * COPY FROM into the same table with the same columns.  It is created ON
+ * COMMIT DELETE ROWS, which empties it at commit without touching the
+ * catalogs.  Only a second COPY FROM into the same table within one
+ * transaction has to TRUNCATE it first.
+ */
+static Relation
+CopyFromGetStagingTable(Relation rel, List *attnamelist, char **collist)
+{
+	TupleDesc	tupDesc = RelationGetDescr(rel);
+	List	   *attnums = CopyGetAttnums(tupDesc, rel, attnamelist);
+	char	   *stagingName;
+	Oid			stagingRelid;
+	Relation	stagingRel = NULL;
+	StringInfoData coldefs;
+	StringInfoData colnames;
+	StringInfoData sql;
+	MemoryContext oldcontext;
+	ListCell   *lc;
+
+	initStringInfo(&coldefs);
+	initStringInfo(&colnames);
+	foreach(lc, attnums)
+	{
+		Form_pg_attribute attr = TupleDescAttr(tupDesc, lfirst_int(lc) - 1);
+		const char *attname = quote_identifier(NameStr(attr->attname));
+
+		if (colnames.len > 0)
+		{
+			appendStringInfoString(&coldefs, ", ");
+			appendStringInfoString(&colnames, ", ");
+		}
+		appendStringInfo(&coldefs, "%s %s", attname,
+						 format_type_with_typemod(attr->atttypid, attr->atttypmod));
+		appendStringInfoString(&colnames, attname);
+	}
+	*collist = colnames.data;
+
+	/*
+	 * Named after the OID of the table, so that it doesn't clash with the
+	 * staging table of another table with a similar, or truncated, name.
+	 */
+	stagingName = psprintf("gp_copy_staging_%u", RelationGetRelid(rel));
+
+	/* Forget about the staging tables filled in earlier transactions */
+	if (stagingTablesUsedLxid != MyProc->lxid)
+	{
+		list_free(stagingTablesUsed);
+		stagingTablesUsed = NIL;
+		stagingTablesUsedLxid = MyProc->lxid;
+	}
+
+	initStringInfo(&sql);
+	if (SPI_connect() != SPI_OK_CONNECT)
+		elog(ERROR, "SPI_connect failed");
+
+	/*
+	 * Reuse the staging table we already have, unless the columns being
+	 * copied changed since it was created.
+	 */
+	stagingRelid = RangeVarGetRelid(makeRangeVar("pg_temp", stagingName, -1),
+									RowExclusiveLock, true);
+	if (OidIsValid(stagingRelid))
+	{
+		stagingRel = table_open(stagingRelid, NoLock);
+
+		if (!CopyFromStagingTableMatches(stagingRel, rel, attnums))
+		{
+			table_close(stagingRel, NoLock);
+			stagingRel = NULL;
+
+			appendStringInfo(&sql, "DROP TABLE pg_temp.%s",
+							 quote_identifier(stagingName));
+			if (SPI_execute(sql.data, false, 0) != SPI_OK_UTILITY)
+				elog(ERROR, "could not drop COPY staging table \"%s\"", stagingName);
+			resetStringInfo(&sql);
+		}
+		else if (list_member_oid(stagingTablesUsed, stagingRelid))
+		{
+			/* still holds the rows of an earlier COPY of this transaction */
+			appendStringInfo(&sql, "TRUNCATE pg_temp.%s",
+							 quote_identifier(stagingName));
+			if (SPI_execute(sql.data, false, 0) != SPI_OK_UTILITY)
+				elog(ERROR, "could not truncate COPY staging table \"%s\"", stagingName);
+			resetStringInfo(&sql);
+		}
+	}
+
+	if (stagingRel == NULL)
+	{
+		/* the staging table is a temporary table */
+		if (pg_database_aclcheck(MyDatabaseId, GetUserId(), ACL_CREATE_TEMP) != ACLCHECK_OK)
+		{
+			SPI_finish();
+			return NULL;
+		}
+
+		/*
+		 * No constraints or defaults: the rows are checked, and the missing
+		 * columns filled in, when they are inserted into the real table.
+		 */
+		appendStringInfo(&sql,
+						 "CREATE TEMPORARY TABLE pg_temp.%s (%s) USING heap ON COMMIT DELETE ROWS DISTRIBUTED RANDOMLY",
+						 quote_identifier(stagingName), coldefs.data);
+		if (SPI_execute(sql.data, false, 0) != SPI_OK_UTILITY)
+			elog(ERROR, "could not create COPY staging table \"%s\"", stagingName);
+
+		stagingRel = table_openrv(makeRangeVar("pg_temp", stagingName, -1),
+								  RowExclusiveLock);
+	}
+	SPI_finish();
+
+	oldcontext = MemoryContextSwitchTo(TopMemoryContext);
+	stagingTablesUsed = lappend_oid(stagingTablesUsed,
+									RelationGetRelid(stagingRel));
+	MemoryContextSwitchTo(oldcontext);
+
+	return stagingRel;
+}
+
+/*
+ * Does the existing staging table 'stagingRel' have the columns of 'rel'
+ * listed in 'attnums', in that order, and is it randomly distributed like
+ * CopyFromGetStagingTable() creates it?
+ */
+static bool
+CopyFromStagingTableMatches(Relation stagingRel, Relation rel, List *attnums)
+{
+	TupleDesc	tupDesc = RelationGetDescr(rel);
+	TupleDesc	stagingTupDesc = RelationGetDescr(stagingRel);
+	ListCell   *lc;
+	int			i = 0;
+
+	if (stagingRel->rd_rel->relkind != RELKIND_RELATION ||
+		!GpPolicyIsRandomPartitioned(stagingRel->rd_cdbpolicy))
+		return false;
+
+	if (stagingTupDesc->natts != list_length(attnums))
+		return false;
+
+	foreach(lc, attnums)
+	{
+		Form_pg_attribute attr = TupleDescAttr(tupDesc, lfirst_int(lc) - 1);
+		Form_pg_attribute stagingAttr = TupleDescAttr(stagingTupDesc, i++);
+
+		if (stagingAttr->attisdropped ||
+			strcmp(NameStr(attr->attname), NameStr(stagingAttr->attname)) != 0 ||
+			attr->atttypid != stagingAttr->atttypid ||
+			attr->atttypmod != stagingAttr->atttypmod)
+			return false;
+	}
+
+	return true;
+}
+
+/*
+ * Move the rows loaded into the staging table into the real table.  Returns
+ * the number of rows inserted.  The staging table is kept for the next COPY,
+ * see CopyFromGetStagingTable().
+ *
+ * The rows are moved with an INSERT ... SELECT, planned and run like any
+ * other query, so that the planner redistributes them among the segments.
+ * But COPY doesn't fire rules, so the INSERT is not rewritten.  The defaults
+ * of the columns that are not copied, which the rewriter would fill in, are
+ * added here instead, with build_column_default() like CopyFrom() does.
+ */
+static uint64
+CopyFromStagingTable(Relation rel, Relation stagingRel, const char *collist)
+{
+	char	   *stagingName = pstrdup(quote_identifier(RelationGetRelationName(stagingRel)));
+	TupleDesc	tupDesc = RelationGetDescr(rel);
+	StringInfoData sql;
+	RawStmt    *parsetree;
+	Query	   *query;
+	TargetEntry **tles;
+	List	   *targetList = NIL;
+	ListCell   *lc;
+	PlannedStmt *plan;
+	QueryDesc  *queryDesc;
+	uint64		processed;
+	int			i;
+
+	table_close(stagingRel, NoLock);
+
+	/* Make the rows just copied into the staging table visible */
+	CommandCounterIncrement();
+
+	initStringInfo(&sql);
+	appendStringInfo(&sql, "INSERT INTO %s (%s) SELECT %s FROM pg_temp.%s",
+					 quote_qualified_identifier(get_namespace_name(RelationGetNamespace(rel)),
+												RelationGetRelationName(rel)),
+					 collist, collist, stagingName);
+
+	parsetree = linitial_node(RawStmt, pg_parse_query(sql.data));
+	query = parse_analyze(parsetree, sql.data, NULL, 0, NULL);
+
+	/* Put the target list in attribute order, with the defaults */
+	tles = (TargetEntry **) palloc0(tupDesc->natts * sizeof(TargetEntry *));
+	foreach(lc, query->targetList)
+	{
+		TargetEntry *tle = lfirst_node(TargetEntry, lc);
+
+		tles[tle->resno - 1] = tle;
+	}
+	for (i = 0; i < tupDesc->natts; i++)
+	{
+		Form_pg_attribute att = TupleDescAttr(tupDesc, i);
+
+		if (tles[i] == NULL)
+		{
+			Node	   *defexpr;
+
+			if (att->attisdropped || att->attgenerated)
+				continue;
+
+			defexpr = build_column_default(rel, i + 1);
+			if (defexpr == NULL)
+				continue;
+
+			tles[i] = makeTargetEntry((Expr *) defexpr, i + 1,
+									  pstrdup(NameStr(att->attname)), false);
+		}
+		targetList = lappend(targetList, tles[i]);
+	}
+	query->targetList = targetList;
+
+	plan = pg_plan_query(query, 0, NULL);
+
+	PushCopiedSnapshot(GetActiveSnapshot());
+	UpdateActiveSnapshotCommandId();
+
+	queryDesc = CreateQueryDesc(plan, sql.data,
+								GetActiveSnapshot(), InvalidSnapshot,
+								None_Receiver, NULL, NULL, 0);
+
+	ExecutorStart(queryDesc, 0);
+	ExecutorRun(queryDesc, ForwardScanDirection, 0L, true);
+	ExecutorFinish(queryDesc);
+	ExecutorEnd(queryDesc);
+
+	/* The row count from the segments is only known after ExecutorEnd() */
+	processed = queryDesc->es_processed;
+
+	FreeQueryDesc(queryDesc);
+	PopActiveSnapshot();
+
+	return processed;
+}
+
 /*
  * Process the statement option list for COPY.
  *
@@ -6367,6 +6728,10 @@ CopyReadLineText(CopyState cstate)
 	char		quotec = '\0';
 	char		escapec = '\0';
 
+	/* the bytes that the loop below can't just step over */
+	char		special_chars[4];
+	PgCharScanSet special_set;
+
 	if (cstate->csv_mode)
 	{
 		quotec = cstate->quote[0];
@@ -6378,6 +6743,22 @@ CopyReadLineText(CopyState cstate)
 
 	mblen_str[1] = '\0';
 
+	special_chars[0] = '\n';
+	special_chars[1] = '\r';
+	if (cstate->csv_mode)
+	{
+		special_chars[2] = quotec;
+		special_chars[3] = escapec;
+		pg_charscan_init(&special_set, special_chars, 4,
+						 cstate->encoding_embeds_ascii);
+	}
+	else
+	{
+		special_chars[2] = '\\';
+		pg_charscan_init(&special_set, special_chars, 3,
+						 cstate->encoding_embeds_ascii);
+	}
+
 	/*
 	 * The objective of this loop is to transfer the entire next input line
 	 * into line_buf.  Hence, we only care for detecting newlines (\r and/or
@@ -6443,6 +6824,27 @@ CopyReadLineText(CopyState cstate)
 			need_data = false;
 		}
 
+		/*
+		 * Step over the bytes that can't end the line or change the CSV
+		 * state, many at a time.  In CSV mode, a backslash only matters as
+		 * the first character of a line, which we always look at below.
+		 */
+		if (!first_char_in_line)
+		{
+			const char *special;
+
+			special = pg_charscan_first(copy_raw_buf + raw_buf_ptr,
+										copy_raw_buf + copy_buf_len,
+										&special_set);
+			if (special > copy_raw_buf + raw_buf_ptr)
+			{
+				raw_buf_ptr = special - copy_raw_buf;
+				last_was_esc = false;
+				if (raw_buf_ptr >= copy_buf_len)
+					continue;
+			}
+		}
+
 		/* OK to fetch a character */
 		prev_raw_ptr = raw_buf_ptr;
 		c = copy_raw_buf[raw_buf_ptr++];
@@ -6859,6 +7261,9 @@ CopyReadAttributesText(CopyState cstate, int stop_processing_at_field)
 	char	   *output_ptr;
 	char	   *cur_ptr;
 	char	   *line_end_ptr;
+	char		field_chars[2];
+	int			nfield_chars = 0;
+	PgCharScanSet field_set;
 
 	/*
 	 * We need a special case for zero-column tables: check that the input
@@ -6890,6 +7295,14 @@ CopyReadAttributesText(CopyState cstate, int stop_processing_at_field)
 	cur_ptr = cstate->line_buf.data + cstate->line_buf.cursor;
 	line_end_ptr = cstate->line_buf.data + cstate->line_buf.len;
 
+	/* the bytes that end a run of plain data in a field */
+	if (!delim_off)
+		field_chars[nfield_chars++] = delimc;
+	if (!cstate->escape_off)
+		field_chars[nfield_chars++] = escapec;
+	if (nfield_chars > 0)
+		pg_charscan_init(&field_set, field_chars, nfield_chars, false);
+
 	/* Outer loop iterates over fields */
 	fieldno = 0;
 	for (;;)
@@ -6936,6 +7349,18 @@ CopyReadAttributesText(CopyState cstate, int stop_processing_at_field)
 		{
 			char		c;
 
+			/* Copy the plain data up to the next delimiter or escape */
+			if (nfield_chars > 0)
+			{
+				char	   *special;
+
+				special = (char *) pg_charscan_first(cur_ptr, line_end_ptr,
+													 &field_set);
+				memcpy(output_ptr, cur_ptr, special - cur_ptr);
+				output_ptr += special - cur_ptr;
+				cur_ptr = special;
+			}
+
 			end_ptr = cur_ptr;
 			if (cur_ptr >= line_end_ptr)
 				break;
@@ -7108,6 +7533,10 @@ CopyReadAttributesCSV(CopyState cstate, int stop_processing_at_field)
 	char	   *output_ptr;
 	char	   *cur_ptr;
 	char	   *line_end_ptr;
+	char		unquoted_chars[2];
+	char		quoted_chars[2];
+	PgCharScanSet unquoted_set;
+	PgCharScanSet quoted_set;
 
 	/*
 	 * We need a special case for zero-column tables: check that the input
@@ -7139,6 +7568,14 @@ CopyReadAttributesCSV(CopyState cstate, int stop_processing_at_field)
 	cur_ptr = cstate->line_buf.data + cstate->line_buf.cursor;
 	line_end_ptr = cstate->line_buf.data + cstate->line_buf.len;
 
+	/* the bytes that end a run of plain data, outside and inside quotes */
+	unquoted_chars[0] = quotec;
+	unquoted_chars[1] = delimc;
+	pg_charscan_init(&unquoted_set, unquoted_chars, delim_off ? 1 : 2, false);
+	quoted_chars[0] = quotec;
+	quoted_chars[1] = escapec;
+	pg_charscan_init(&quoted_set, quoted_chars, 2, false);
+
 	/* Outer loop iterates over fields */
 	fieldno = 0;
 	for (;;)
@@ -7184,6 +7621,15 @@ CopyReadAttributesCSV(CopyState cstate, int stop_processing_at_field)
 			/* Not in quote */
 			for (;;)
 			{
+				char	   *special;
+
+				/* Copy the plain data up to the next delimiter or quote */
+				special = (char *) pg_charscan_first(cur_ptr, line_end_ptr,
+													 &unquoted_set);
+				memcpy(output_ptr, cur_ptr, special - cur_ptr);
+				output_ptr += special - cur_ptr;
+				cur_ptr = special;
+
 				end_ptr = cur_ptr;
 				if (cur_ptr >= line_end_ptr)
 					goto endfield;
@@ -7207,6 +7653,15 @@ CopyReadAttributesCSV(CopyState cstate, int stop_processing_at_field)
 			/* In quote */
 			for (;;)
 			{
+				char	   *special;
+
+				/* Copy the plain data up to the next escape or quote */
+				special = (char *) pg_charscan_first(cur_ptr, line_end_ptr,
+													 &quoted_set);
+				memcpy(output_ptr, cur_ptr, special - cur_ptr);
+				output_ptr += special - cur_ptr;
+				cur_ptr = special;
+
 				end_ptr = cur_ptr;
 				if (cur_ptr >= line_end_ptr)
 					ereport(ERROR,
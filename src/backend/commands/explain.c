@@ -25,6 +25,8 @@
 #include "executor/execUtils.h"
 #include "executor/hashjoin.h"
 #include "executor/nodeHash.h"
+#include "executor/nodeMotion.h"
+#include "executor/nodeSeqscan.h"
 #include "foreign/fdwapi.h"
 #include "jit/jit.h"
 #include "nodes/extensible.h"
@@ -131,6 +133,8 @@ static void show_sort_info(SortState *sortstate, ExplainState *es);
 static void show_windowagg_keys(WindowAggState *waggstate, List *ancestors, ExplainState *es);
 static void show_hash_info(HashState *hashstate, ExplainState *es);
 static void show_hashagg_info(AggState *hashstate, ExplainState *es);
+static void show_blocks_skipped(PlanState *planstate, ExplainState *es);
+static void show_motion_bytes_saved(MotionState *motionstate, ExplainState *es);
 static void show_tidbitmap_info(BitmapHeapScanState *planstate,
 								ExplainState *es);
 static void show_instrumentation_count(const char *qlabel, int which,
@@ -2377,6 +2381,12 @@ ExplainNode(PlanState *planstate, List *ancestors,
 			if (plan->qual)
 				show_instrumentation_count("Rows Removed by Filter", 1,
 										   planstate, es);
+			if (IsA(planstate, SeqScanState) &&
+				((SeqScanState *) planstate)->runtimeFilter)
+				show_instrumentation_count("Rows Removed by Runtime Filter", 2,
+										   planstate, es);
+			if (es->analyze)
+				show_blocks_skipped(planstate, es);
 			break;
 		case T_Gather:
 			{
@@ -2664,6 +2674,8 @@ ExplainNode(PlanState *planstate, List *ancestors,
 									 "Hash Module: %d\n",
 									 pMotion->numHashSegments);
 				}
+				if (es->analyze)
+					show_motion_bytes_saved((MotionState *) planstate, es);
 			}
 			break;
 		case T_AssertOp:
@@ -3702,6 +3714,39 @@ show_tidbitmap_info(BitmapHeapScanState *planstate, ExplainState *es)
 	}
 }
 
+/*
+ * Show the number of blocks that a SeqScan skipped using the zone maps of
+ * append-optimized tables.
+ */
+static void
+show_blocks_skipped(PlanState *planstate, ExplainState *es)
+{
+	uint64		blocks_skipped;
+
+	if (IsA(planstate, SeqScanState))
+		blocks_skipped = ((SeqScanState *) planstate)->blocks_skipped;
+	else if (IsA(planstate, DynamicSeqScanState))
+		blocks_skipped = ((DynamicSeqScanState *) planstate)->blocks_skipped;
+	else
+		return;
+
+	if (blocks_skipped > 0)
+		ExplainPropertyInteger("Blocks Skipped by Zone Maps", NULL,
+							   (int64) blocks_skipped, es);
+}
+
+/*
+ * Show the number of bytes that interconnect compression kept off the
+ * network for a Motion, summed over its receivers.
+ */
+static void
+show_motion_bytes_saved(MotionState *motionstate, ExplainState *es)
+{
+	if (motionstate->bytes_saved > 0)
+		ExplainPropertyInteger("Bytes Saved by Compression", "bytes",
+							   (int64) motionstate->bytes_saved, es);
+}
+
 /*
  * If it's EXPLAIN ANALYZE, show instrumentation information for a plan node
  *
@@ -3845,11 +3890,12 @@ show_buffer_usage(ExplainState *es, const BufferUsage *usage)
 								 usage->local_blks_written > 0);
 		bool		has_temp = (usage->temp_blks_read > 0 ||
 								usage->temp_blks_written > 0);
+		bool		has_ao = (usage->ao_reads > 0);
 		bool		has_timing = (!INSTR_TIME_IS_ZERO(usage->blk_read_time) ||
 								  !INSTR_TIME_IS_ZERO(usage->blk_write_time));
 
 		/* Show only positive counter values. */
-		if (has_shared || has_local || has_temp)
+		if (has_shared || has_local || has_temp || has_ao)
 		{
 			appendStringInfoSpaces(es->str, es->indent * 2);
 			appendStringInfoString(es->str, "Buffers:");
@@ -3869,7 +3915,7 @@ show_buffer_usage(ExplainState *es, const BufferUsage *usage)
 				if (usage->shared_blks_written > 0)
 					appendStringInfo(es->str, " written=%ld",
 									 usage->shared_blks_written);
-				if (has_local || has_temp)
+				if (has_local || has_temp || has_ao)
 					appendStringInfoChar(es->str, ',');
 			}
 			if (has_local)
@@ -3887,7 +3933,7 @@ show_buffer_usage(ExplainState *es, const BufferUsage *usage)
 				if (usage->local_blks_written > 0)
 					appendStringInfo(es->str, " written=%ld",
 									 usage->local_blks_written);
-				if (has_temp)
+				if (has_temp || has_ao)
 					appendStringInfoChar(es->str, ',');
 			}
 			if (has_temp)
@@ -3899,6 +3945,17 @@ show_buffer_usage(ExplainState *es, const BufferUsage *usage)
 				if (usage->temp_blks_written > 0)
 					appendStringInfo(es->str, " written=%ld",
 									 usage->temp_blks_written);
+				if (has_ao)
+					appendStringInfoChar(es->str, ',');
+			}
+			if (has_ao)
+			{
+				/* large reads of AO segment files, and read-ahead hits */
+				appendStringInfo(es->str, " ao read=%ld",
+								 usage->ao_reads);
+				if (usage->ao_reads_prefetched > 0)
+					appendStringInfo(es->str, " prefetched=%ld",
+									 usage->ao_reads_prefetched);
 			}
 			appendStringInfoChar(es->str, '\n');
 		}
@@ -3939,6 +3996,13 @@ show_buffer_usage(ExplainState *es, const BufferUsage *usage)
 							   usage->temp_blks_read, es);
 		ExplainPropertyInteger("Temp Written Blocks", NULL,
 							   usage->temp_blks_written, es);
+		if (usage->ao_reads > 0)
+		{
+			ExplainPropertyInteger("AO Reads", NULL,
+								   usage->ao_reads, es);
+			ExplainPropertyInteger("AO Prefetched Reads", NULL,
+								   usage->ao_reads_prefetched, es);
+		}
 		if (track_io_timing)
 		{
 			ExplainPropertyFloat("I/O Read Time", "ms",
@@ -70,6 +70,8 @@ typedef struct CdbExplain_StatInst
 	int			enotes;			/* Offset to end of node's extra text */
 	long		exact_pages;		/* BitmapHeapScan exact_pages */
 	long		lossy_pages;		/* BitmapHeapScan lossy_pages */
+	uint64		blocks_skipped;		/* SeqScan blocks skipped by zone maps */
+	uint64		motion_bytes_saved;	/* Motion bytes saved by compression */
 } CdbExplain_StatInst;
 
 
@@ -894,6 +896,18 @@ cdbexplain_collectStatsFromNode(PlanState *planstate, CdbExplain_SendStatCtx *ct
 		si->exact_pages = bhsState->exact_pages;
 		si->lossy_pages = bhsState->lossy_pages;
 	}
+	if (IsA(planstate, SeqScanState))
+		si->blocks_skipped = ExecSeqScanBlocksSkipped((SeqScanState *) planstate);
+	if (IsA(planstate, DynamicSeqScanState))
+	{
+		DynamicSeqScanState *dssState = (DynamicSeqScanState *) planstate;
+
+		si->blocks_skipped = dssState->blocks_skipped;
+		if (dssState->seqScanState)
+			si->blocks_skipped += ExecSeqScanBlocksSkipped(dssState->seqScanState);
+	}
+	if (IsA(planstate, MotionState))
+		si->motion_bytes_saved = ExecMotionBytesSaved((MotionState *) planstate);
 }								/* cdbexplain_collectStatsFromNode */
 
 
@@ -1034,6 +1048,7 @@ cdbexplain_depositStatsToNode(PlanState *planstate, CdbExplain_RecvStatCtx *ctx)
 	CdbExplain_DepStatAcc blk_read_time;
 	CdbExplain_DepStatAcc blk_write_time;
 
+	uint64		motion_bytes_saved = 0;
 	int			imsgptr;
 	int			nInst;
 
@@ -1122,6 +1137,7 @@ cdbexplain_depositStatsToNode(PlanState *planstate, CdbExplain_RecvStatCtx *ctx)
 		cdbexplain_depStatAcc_upd(&temp_blks_written, rsi->bufusage.temp_blks_written, rsh, rsi, nsi);
 		cdbexplain_depStatAcc_upd(&blk_read_time, INSTR_TIME_GET_DOUBLE(rsi->bufusage.blk_read_time), rsh, rsi, nsi);
 		cdbexplain_depStatAcc_upd(&blk_write_time, INSTR_TIME_GET_DOUBLE(rsi->bufusage.blk_write_time), rsh, rsi, nsi);
+		motion_bytes_saved += rsi->motion_bytes_saved;
 
 		/* Update per-slice accumulators. */
 		cdbexplain_depStatAcc_upd(&peakmemused, rsh->worker.peakmemused, rsh, rsi, nsi);
@@ -1136,6 +1152,10 @@ cdbexplain_depositStatsToNode(PlanState *planstate, CdbExplain_RecvStatCtx *ctx)
 	ns->totalWorkfileCreated = totalWorkfileCreated.agg;
 	ns->totalPartTableScanned = totalPartTableScanned.agg;
 
+	/* Bytes saved by interconnect compression add up across the receivers */
+	if (IsA(planstate, MotionState))
+		((MotionState *) planstate)->bytes_saved = motion_bytes_saved;
+
 	/* Roll up summary over all nodes of slice into RecvStatCtx. */
 	ctx->workmemused_max = Max(ctx->workmemused_max, workmemused.agg.vmax);
 	ctx->workmemwanted_max = Max(ctx->workmemwanted_max, workmemwanted.agg.vmax);
@@ -1174,6 +1194,12 @@ cdbexplain_depositStatsToNode(PlanState *planstate, CdbExplain_RecvStatCtx *ctx)
 			bhsState->exact_pages = ntuples.nsimax->exact_pages;
 			bhsState->lossy_pages = ntuples.nsimax->lossy_pages;
 		}
+
+		/* Likewise for the blocks a SeqScan skipped using zone maps */
+		if (IsA(planstate, SeqScanState))
+			((SeqScanState *) planstate)->blocks_skipped = ntuples.nsimax->blocks_skipped;
+		else if (IsA(planstate, DynamicSeqScanState))
+			((DynamicSeqScanState *) planstate)->blocks_skipped = ntuples.nsimax->blocks_skipped;
 	}
 	/* Save non-zero nloops even when 0 tuple is returned */
 	else if (nloops.agg.vcnt > 0)
@@ -1156,10 +1156,13 @@ DefineRelation(CreateStmt *stmt, char relkind, Oid ownerId,
 	rel = relation_open(relationId, AccessExclusiveLock);
 
 	/*
-	 * If this is an append-only relation, create the auxliary tables necessary
+	 * If this is an append-only relation, create the auxliary tables necessary.
+	 * The zone maps live in the block directory, so create it right away if
+	 * they are enabled.
 	 */
 	if (RelationStorageIsAO(rel))
-		NewRelationCreateAOAuxTables(RelationGetRelid(rel), stmt->buildAoBlkdir);
+		NewRelationCreateAOAuxTables(RelationGetRelid(rel),
+									 stmt->buildAoBlkdir || gp_appendonly_zone_maps);
 
 	/*
 	 * Now add any newly specified column default and generation expressions
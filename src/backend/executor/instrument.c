@@ -255,6 +255,8 @@ BufferUsageAdd(BufferUsage *dst, const BufferUsage *add)
 	dst->temp_blks_written += add->temp_blks_written;
 	INSTR_TIME_ADD(dst->blk_read_time, add->blk_read_time);
 	INSTR_TIME_ADD(dst->blk_write_time, add->blk_write_time);
+	dst->ao_reads += add->ao_reads;
+	dst->ao_reads_prefetched += add->ao_reads_prefetched;
 }
 
 /* dst += add - sub */
@@ -277,6 +279,8 @@ BufferUsageAccumDiff(BufferUsage *dst,
 						  add->blk_read_time, sub->blk_read_time);
 	INSTR_TIME_ACCUM_DIFF(dst->blk_write_time,
 						  add->blk_write_time, sub->blk_write_time);
+	dst->ao_reads += add->ao_reads - sub->ao_reads;
+	dst->ao_reads_prefetched += add->ao_reads_prefetched - sub->ao_reads_prefetched;
 }
 
 /* Calculate number slots from gp_instrument_shmem_size */
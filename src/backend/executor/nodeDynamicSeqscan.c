@@ -236,6 +236,8 @@ CleanupOnePartition(DynamicSeqScanState *scanState)
 
 	if (scanState->seqScanState)
 	{
+		scanState->blocks_skipped +=
+			ExecSeqScanBlocksSkipped(scanState->seqScanState);
 		ExecEndSeqScan(scanState->seqScanState);
 		scanState->seqScanState = NULL;
 		Assert(scanState->ss.ss_currentRelation != NULL);
@@ -37,6 +37,7 @@
 #include "executor/hashjoin.h"
 #include "executor/nodeHash.h"
 #include "executor/nodeHashjoin.h"
+#include "lib/bloomfilter.h"
 #include "miscadmin.h"
 #include "pgstat.h"
 #include "port/atomics.h"
@@ -63,6 +64,8 @@ static void ExecHashSkewTableInsert(HashState *hashState,
 									uint32 hashvalue,
 									int bucketNumber);
 static void ExecHashRemoveNextSkewBucket(HashState *hashState, HashJoinTable hashtable);
+static bloom_filter *ExecHashRuntimeFilterCreate(HashState *node);
+static void ExecHashRuntimeFilterFinish(HashState *node, bloom_filter *bloom);
 
 static void ExecHashTableExplainEnd(PlanState *planstate, struct StringInfoData *buf);
 static void
@@ -160,6 +163,7 @@ MultiExecPrivateHash(HashState *node)
 	TupleTableSlot *slot;
 	ExprContext *econtext;
 	uint32		hashvalue;
+	bloom_filter *bloom = NULL;
 
 	/*
 	 * get state info from node
@@ -173,6 +177,13 @@ MultiExecPrivateHash(HashState *node)
 	hashkeys = node->hashkeys;
 	econtext = node->ps.ps_ExprContext;
 
+	/*
+	 * If the join pushed a runtime filter down to its outer side, fill it
+	 * with the hash values of the rows we insert.
+	 */
+	if (node->runtimeFilter)
+		bloom = ExecHashRuntimeFilterCreate(node);
+
 	SIMPLE_FAULT_INJECTOR("multi_exec_hash_large_vmem");
 
 	/*
@@ -209,6 +220,10 @@ MultiExecPrivateHash(HashState *node)
 				ExecHashTableInsert(node, hashtable, slot, hashvalue);
 			}
 			hashtable->totalTuples += 1;
+
+			if (bloom)
+				bloom_add_element(bloom, (unsigned char *) &hashvalue,
+								  sizeof(hashvalue));
 		}
 
 		if (hashkeys_null)
@@ -225,6 +240,9 @@ MultiExecPrivateHash(HashState *node)
 	/* Now we have set up all the initial batches & primary overflow batches. */
 	hashtable->nbatch_outstart = hashtable->nbatch;
 
+	if (bloom)
+		ExecHashRuntimeFilterFinish(node, bloom);
+
 	/* resize the hash table if needed (NTUP_PER_BUCKET exceeded) */
 	if (hashtable->nbuckets != hashtable->nbuckets_optimal)
 		ExecHashIncreaseNumBuckets(hashtable);
@@ -987,6 +1005,13 @@ ExecHashTableDestroy(HashState *hashState, HashJoinTable hashtable)
 	Assert(hashtable);
 	Assert(!hashtable->eagerlyReleased);
 
+	/* The runtime filter only describes the rows of this hash table */
+	if (hashState->runtimeFilter && hashState->runtimeFilter->bloom)
+	{
+		bloom_free(hashState->runtimeFilter->bloom);
+		hashState->runtimeFilter->bloom = NULL;
+	}
+
 	/*
 	 * Make sure all the temp files are closed.
 	 * GPDB supports rescan of hashjoin, the batch0 can still have temp files.
@@ -2062,6 +2087,103 @@ ExecHashGetHashValue(HashState *hashState, HashJoinTable hashtable,
 	return result;
 }
 
+/*
+ * A filter with most of its bits set lets nearly every row through, which
+ * only costs the scan time.  That happens when the inner side turns out to be
+ * much larger than estimated.
+ */
+#define RUNTIME_FILTER_MAX_BITS_SET 0.75
+
+/*
+ * ExecHashRuntimeFilterCreate
+ *		create an empty Bloom filter for the hash values of the inner rows
+ *
+ * The filter is sized for the estimated number of inner rows, within
+ * work_mem.  It must outlive the hash table's memory, since the scan on
+ * the outer side may still run when the hash table is released.
+ */
+static bloom_filter *
+ExecHashRuntimeFilterCreate(HashState *node)
+{
+	MemoryContext oldcxt;
+	bloom_filter *bloom;
+
+	/* The filter of a previous hash table is gone with it */
+	Assert(node->runtimeFilter->bloom == NULL);
+
+	oldcxt = MemoryContextSwitchTo(node->ps.state->es_query_cxt);
+	bloom = bloom_create((int64) Max(node->ps.plan->plan_rows, 1.0),
+						 work_mem, 0);
+	MemoryContextSwitchTo(oldcxt);
+
+	return bloom;
+}
+
+/*
+ * ExecHashRuntimeFilterFinish
+ *		hand the filter over to the scan, now that it has every inner row
+ */
+static void
+ExecHashRuntimeFilterFinish(HashState *node, bloom_filter *bloom)
+{
+	if (bloom_prop_bits_set(bloom) > RUNTIME_FILTER_MAX_BITS_SET)
+		bloom_free(bloom);
+	else
+		node->runtimeFilter->bloom = bloom;
+}
+
+/*
+ * ExecHashRuntimeFilterRejects
+ *		can the outer row in 'slot' not have a match in the hash table?
+ *
+ * 'slot' holds a row of the relation scanned on the outer side of the join.
+ * Its hash value is computed from the columns that the outer hash keys
+ * refer to, the way ExecHashGetHashValue() computes it from the keys.  A row
+ * with a NULL key is never rejected: the join decides what to do with it.
+ */
+bool
+ExecHashRuntimeFilterRejects(RuntimeFilterState *filter,
+							 ExprContext *econtext,
+							 TupleTableSlot *slot)
+{
+	uint32		hashkey = 0;
+	MemoryContext oldContext;
+	int			i;
+
+	if (filter->bloom == NULL)
+		return false;
+
+	/* Reclaim anything the hash functions leaked for the previous row */
+	ResetExprContext(econtext);
+
+	oldContext = MemoryContextSwitchTo(econtext->ecxt_per_tuple_memory);
+
+	for (i = 0; i < filter->nkeys; i++)
+	{
+		Datum		keyval;
+		bool		isNull;
+
+		/* rotate hashkey left 1 bit at each step */
+		hashkey = (hashkey << 1) | ((hashkey & 0x80000000) ? 1 : 0);
+
+		keyval = slot_getattr(slot, filter->attnums[i], &isNull);
+		if (isNull)
+		{
+			MemoryContextSwitchTo(oldContext);
+			return false;
+		}
+
+		hashkey ^= DatumGetUInt32(FunctionCall1Coll(&filter->hashfunctions[i],
+													filter->collations[i],
+													keyval));
+	}
+
+	MemoryContextSwitchTo(oldContext);
+
+	return bloom_lacks_element(filter->bloom, (unsigned char *) &hashkey,
+							   sizeof(hashkey));
+}
+
 /*
  * ExecHashGetBucketAndBatch
  *		Determine the bucket number and batch number for a hash value
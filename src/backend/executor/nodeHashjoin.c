@@ -116,7 +116,9 @@
 #include "executor/nodeHash.h"
 #include "executor/nodeHashjoin.h"
 #include "miscadmin.h"
+#include "parser/parsetree.h"
 #include "pgstat.h"
+#include "utils/lsyscache.h"
 #include "utils/memutils.h"
 #include "utils/sharedtuplestore.h"
 
@@ -162,6 +164,7 @@ static void ReleaseHashTable(HashJoinState *node);
 static void SpillCurrentBatch(HashJoinState *node);
 static bool ExecHashJoinReloadHashTable(HashJoinState *hjstate);
 static void ExecEagerFreeHashJoin(HashJoinState *node);
+static void ExecHashJoinInitRuntimeFilter(HashJoinState *hjstate);
 
 static inline void SaveWorkFileSetStatsInfo(HashJoinTable hashtable);
 
@@ -933,9 +936,88 @@ ExecInitHashJoin(HashJoin *node, EState *estate, int eflags)
 	hjstate->hj_MatchedOuter = false;
 	hjstate->hj_OuterNotEmpty = false;
 
+	if (node->runtime_filter)
+		ExecHashJoinInitRuntimeFilter(hjstate);
+
 	return hjstate;
 }
 
+/*
+ * ExecHashJoinInitRuntimeFilter
+ *		push a runtime filter down to the SeqScan on our outer side
+ *
+ * The planner marked the join as one that discards the outer rows without a
+ * match.  The Hash node builds a Bloom filter over the hash values of the
+ * inner rows, and the scan drops the rows whose hash value is not in it.  For
+ * the scan to compute the hash values, each outer hash key must be a plain
+ * column of the scanned relation; if one is not, the join runs without the
+ * filter.
+ */
+static void
+ExecHashJoinInitRuntimeFilter(HashJoinState *hjstate)
+{
+	HashJoin   *node = (HashJoin *) hjstate->js.ps.plan;
+	PlanState  *outerState = outerPlanState(hjstate);
+	Scan	   *scan;
+	RuntimeFilterState *filter;
+	int			nkeys = list_length(node->hashkeys);
+	ListCell   *lk;
+	ListCell   *lo;
+	ListCell   *lc;
+	int			i = 0;
+
+	if (!IsA(outerState, SeqScanState) ||
+		outerState->plan->parallel_aware ||
+		node->join.plan.parallel_aware)
+		return;
+	scan = (Scan *) outerState->plan;
+
+	filter = (RuntimeFilterState *) palloc(sizeof(RuntimeFilterState));
+	filter->nkeys = nkeys;
+	filter->attnums = (AttrNumber *) palloc(nkeys * sizeof(AttrNumber));
+	filter->hashfunctions = (FmgrInfo *) palloc(nkeys * sizeof(FmgrInfo));
+	filter->collations = (Oid *) palloc(nkeys * sizeof(Oid));
+	filter->bloom = NULL;
+
+	forthree(lk, node->hashkeys, lo, node->hashoperators, lc, node->hashcollations)
+	{
+		Expr	   *key = (Expr *) lfirst(lk);
+		Oid			hashop = lfirst_oid(lo);
+		TargetEntry *tle;
+		Oid			left_hashfn;
+		Oid			right_hashfn;
+
+		/* The key refers to an entry of the scan's target list ... */
+		if (IsA(key, RelabelType))
+			key = ((RelabelType *) key)->arg;
+		if (!IsA(key, Var) || ((Var *) key)->varno != OUTER_VAR)
+			return;
+		tle = get_tle_by_resno(scan->plan.targetlist, ((Var *) key)->varattno);
+		if (tle == NULL)
+			return;
+
+		/* ... which must be a user column of the scanned relation */
+		key = tle->expr;
+		if (IsA(key, RelabelType))
+			key = ((RelabelType *) key)->arg;
+		if (!IsA(key, Var) ||
+			((Var *) key)->varno != scan->scanrelid ||
+			((Var *) key)->varattno <= 0)
+			return;
+		filter->attnums[i] = ((Var *) key)->varattno;
+
+		if (!get_op_hash_functions(hashop, &left_hashfn, &right_hashfn))
+			elog(ERROR, "could not find hash function for hash operator %u",
+				 hashop);
+		fmgr_info(left_hashfn, &filter->hashfunctions[i]);
+		filter->collations[i] = lfirst_oid(lc);
+		i++;
+	}
+
+	((SeqScanState *) outerState)->runtimeFilter = filter;
+	((HashState *) innerPlanState(hjstate))->runtimeFilter = filter;
+}
+
 /* ----------------------------------------------------------------
  *		ExecEndHashJoin
  *
@@ -304,7 +304,6 @@ execMotionUnsortedReceiver(MotionState *node)
 {
 	/* RECEIVER LOGIC */
 	TupleTableSlot *slot;
-	MinimalTuple tuple;
 	Motion	   *motion = (Motion *) node->ps.plan;
 	EState	   *estate = node->ps.state;
 
@@ -348,11 +347,13 @@ execMotionUnsortedReceiver(MotionState *node)
 			ereport(ERROR, (errmsg("Interconnect is down unexpectedly.")));
 	}
 
-	tuple = RecvTupleFrom(node->ps.state->motionlayer_context,
-						  node->ps.state->interconnect_context,
-						  motion->motionID, ANY_ROUTE);
+	/* receive it straight into our result slot and return this. */
+	slot = RecvTupleFrom(node->ps.state->motionlayer_context,
+						 node->ps.state->interconnect_context,
+						 motion->motionID, ANY_ROUTE,
+						 node->ps.ps_ResultTupleSlot);
 
-	if (!tuple)
+	if (!slot)
 	{
 #ifdef CDB_MOTION_DEBUG
 		if (gp_log_interconnect >= GPVARS_VERBOSITY_DEBUG)
@@ -367,11 +368,6 @@ execMotionUnsortedReceiver(MotionState *node)
 	node->numTuplesFromAMS++;
 	node->numTuplesToParent++;
 
-	/* store it in our result slot and return this. */
-	slot = node->ps.ps_ResultTupleSlot;
-
-	slot = ExecStoreMinimalTuple(tuple, slot, true /* shouldFree */ );
-
 #ifdef CDB_MOTION_DEBUG
 	if (node->numTuplesToParent <= 20)
 	{
@@ -429,7 +425,7 @@ execMotionSortedReceiver(MotionState *node)
 {
 	TupleTableSlot *slot;
 	binaryheap *hp = node->tupleheap;
-	MinimalTuple inputTuple;
+	TupleTableSlot *inputSlot;
 	Motion	   *motion = (Motion *) node->ps.plan;
 	EState	   *estate = node->ps.state;
 
@@ -476,7 +472,6 @@ execMotionSortedReceiver(MotionState *node)
 	 */
 	if (!node->tupleheapReady)
 	{
-		MinimalTuple inputTuple;
 		binaryheap *hp = node->tupleheap;
 		Motion	   *motion = (Motion *) node->ps.plan;
 		int			iSegIdx;
@@ -492,34 +487,37 @@ execMotionSortedReceiver(MotionState *node)
 			if (lfirst(lcProcess) == NULL)
 				continue;			/* skip this one: we are not receiving from it */
 
-			inputTuple = RecvTupleFrom(node->ps.state->motionlayer_context,
-									   node->ps.state->interconnect_context,
-									   motion->motionID, iSegIdx);
-
-			if (!inputTuple)
-				continue;			/* skip this one: received nothing */
-
 			/*
-			 * Make a slot to hold this tuple. We will reuse it to hold any
-			 * future tuples from the same sender. We initialized the result
-			 * tuple slot with the correct type earlier, so make the new slot
-			 * have the same type.
+			 * Make a slot to hold the tuples from this sender. We will reuse
+			 * it to hold any future tuples from the same sender. We
+			 * initialized the result tuple slot with the correct type
+			 * earlier, so make the new slot have the same type.
 			 */
-			oldcxt = MemoryContextSwitchTo(estate->es_query_cxt);
-			node->slots[iSegIdx] = MakeTupleTableSlot(node->ps.ps_ResultTupleSlot->tts_tupleDescriptor,
-													  &TTSOpsMinimalTuple);
-			MemoryContextSwitchTo(oldcxt);
+			if (node->slots[iSegIdx] == NULL)
+			{
+				oldcxt = MemoryContextSwitchTo(estate->es_query_cxt);
+				node->slots[iSegIdx] = MakeTupleTableSlot(node->ps.ps_ResultTupleSlot->tts_tupleDescriptor,
+														  &TTSOpsMinimalTuple);
+				MemoryContextSwitchTo(oldcxt);
+			}
+
+			inputSlot = RecvTupleFrom(node->ps.state->motionlayer_context,
+									  node->ps.state->interconnect_context,
+									  motion->motionID, iSegIdx,
+									  node->slots[iSegIdx]);
+
+			if (!inputSlot)
+				continue;			/* skip this one: received nothing */
 
 			/*
-			 * Store the tuple in the slot, and add it to the heap.
+			 * Add the tuple to the heap.
 			 *
 			 * Use slot_getsomeattrs() to materialize the columns we need for
 			 * the comparisons in the tts_values/isnull arrays. The comparator
 			 * can then peek directly into the arrays, which is cheaper than
 			 * calling slot_getattr() all the time.
 			 */
-			ExecStoreMinimalTuple(inputTuple, node->slots[iSegIdx], true);
-			slot_getsomeattrs(node->slots[iSegIdx], node->lastSortColIdx);
+			slot_getsomeattrs(inputSlot, node->lastSortColIdx);
 			binaryheap_add_unordered(hp, iSegIdx);
 
 			node->numTuplesFromAMS++;
@@ -566,16 +564,16 @@ execMotionSortedReceiver(MotionState *node)
 		Assert(DatumGetInt32(binaryheap_first(hp)) == node->routeIdNext);
 
 		/* Receive the successor of the tuple that we returned last time. */
-		inputTuple = RecvTupleFrom(node->ps.state->motionlayer_context,
-								   node->ps.state->interconnect_context,
-								   motion->motionID,
-								   node->routeIdNext);
+		inputSlot = RecvTupleFrom(node->ps.state->motionlayer_context,
+								  node->ps.state->interconnect_context,
+								  motion->motionID,
+								  node->routeIdNext,
+								  node->slots[node->routeIdNext]);
 
 		/* Substitute it in the pq for its predecessor. */
-		if (inputTuple)
+		if (inputSlot)
 		{
-			ExecStoreMinimalTuple(inputTuple, node->slots[node->routeIdNext], true);
-			slot_getsomeattrs(node->slots[node->routeIdNext], node->lastSortColIdx);
+			slot_getsomeattrs(inputSlot, node->lastSortColIdx);
 			binaryheap_replace_first(hp, Int32GetDatum(node->routeIdNext));
 
 			node->numTuplesFromAMS++;
@@ -1305,3 +1303,23 @@ ExecSquelchMotion(MotionState *node)
 					node->ps.state->interconnect_context,
 					motion->motionID);
 }
+
+/* ----------------------------------------------------------------
+ *		ExecMotionBytesSaved
+ *
+ *		Returns the number of bytes that interconnect compression kept
+ *		off the network for the tuples received by this motion node.
+ * ----------------------------------------------------------------
+ */
+uint64
+ExecMotionBytesSaved(MotionState *node)
+{
+	Motion	   *motion = (Motion *) node->ps.plan;
+
+	if (node->mstype != MOTIONSTATE_RECV ||
+		node->ps.state->motionlayer_context == NULL)
+		return 0;
+
+	return GetMotionBytesSaved(node->ps.state->motionlayer_context,
+							   motion->motionID);
+}
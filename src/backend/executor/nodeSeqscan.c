@@ -30,6 +30,7 @@
 #include "access/relscan.h"
 #include "access/tableam.h"
 #include "executor/execdebug.h"
+#include "executor/nodeHash.h"
 #include "executor/nodeSeqscan.h"
 #include "utils/rel.h"
 #include "nodes/nodeFuncs.h"
@@ -84,10 +85,19 @@ SeqNext(SeqScanState *node)
 	}
 
 	/*
-	 * get the next tuple from the table
+	 * get the next tuple from the table, skipping the ones that the runtime
+	 * filter of a Hash Join above us proves to have no match
 	 */
-	if (table_scan_getnextslot(scandesc, direction, slot))
-		return slot;
+	while (table_scan_getnextslot(scandesc, direction, slot))
+	{
+		if (node->runtimeFilter == NULL ||
+			!ExecHashRuntimeFilterRejects(node->runtimeFilter,
+										  node->ss.ps.ps_ExprContext,
+										  slot))
+			return slot;
+
+		InstrCountFiltered2(node, 1);
+	}
 	return NULL;
 }
 
@@ -229,6 +239,24 @@ ExecEndSeqScan(SeqScanState *node)
 		table_endscan(scanDesc);
 }
 
+/* ----------------------------------------------------------------
+ *		ExecSeqScanBlocksSkipped
+ *
+ *		Returns the number of blocks that the table AM skipped without
+ *		reading them, e.g. using the zone maps of AO tables.
+ * ----------------------------------------------------------------
+ */
+uint64
+ExecSeqScanBlocksSkipped(SeqScanState *node)
+{
+	TableScanDesc scanDesc = node->ss.ss_currentScanDesc;
+
+	if (scanDesc == NULL)
+		return 0;
+
+	return scanDesc->rs_nblocks_skipped;
+}
+
 /* ----------------------------------------------------------------
  *						Join Support
  * ----------------------------------------------------------------
@@ -25,6 +25,8 @@
 
 #include "gpopt/gpdbwrappers.h"
 #include "gpopt/init.h"
+#include "gpopt/mdcache/CMDCache.h"
+#include "gpopt/optimizer/CPlanCache.h"
 #include "naucrates/exception.h"
 #include "naucrates/init.h"
 
@@ -148,6 +150,77 @@ CGPOptimizer::SerializeDXLPlan(Query *query)
 	return nullptr;
 }
 
+//---------------------------------------------------------------------------
+//	@function:
+//		CGPOptimizer::GetCacheStats
+//
+//	@doc:
+//		Fill in counters of the optimizer's caches, return the number of
+//		entries filled in
+//
+//---------------------------------------------------------------------------
+int
+CGPOptimizer::GetCacheStats(OptimizerCacheStats *stats, int max_stats)
+{
+	int nstats = 0;
+
+	if (nstats < max_stats)
+	{
+		OptimizerCacheStats *md_cache_stats = &stats[nstats++];
+
+		md_cache_stats->name = "metadata";
+		md_cache_stats->entries = CMDCache::ULLGetEntries();
+		md_cache_stats->size = CMDCache::ULLGetCacheSize();
+		md_cache_stats->quota = CMDCache::ULLGetCacheQuota();
+		md_cache_stats->hits = CMDCache::ULLGetHits();
+		md_cache_stats->misses = CMDCache::ULLGetMisses();
+		md_cache_stats->evictions = CMDCache::ULLGetCacheEvictionCounter();
+		md_cache_stats->invalidations = CMDCache::ULLGetInvalidations();
+		md_cache_stats->invalidated_entries =
+			CMDCache::ULLGetInvalidatedEntries();
+		md_cache_stats->retained_entries = CMDCache::ULLGetRetainedEntries();
+	}
+
+	if (nstats < max_stats)
+	{
+		OptimizerCacheStats *plan_cache_stats = &stats[nstats++];
+
+		plan_cache_stats->name = "plan";
+		plan_cache_stats->entries = CPlanCache::ULLGetEntries();
+		plan_cache_stats->size = CPlanCache::ULLGetCacheSize();
+		plan_cache_stats->quota = CPlanCache::ULLGetCacheQuota();
+		plan_cache_stats->hits = CPlanCache::ULLGetHits();
+		plan_cache_stats->misses = CPlanCache::ULLGetMisses();
+		plan_cache_stats->evictions = CPlanCache::ULLGetCacheEvictionCounter();
+		plan_cache_stats->invalidations = CPlanCache::ULLGetInvalidations();
+		plan_cache_stats->invalidated_entries =
+			CPlanCache::ULLGetInvalidatedEntries();
+		plan_cache_stats->retained_entries = 0;
+	}
+
+	if (nstats < max_stats && OrcaMDCacheEnabled())
+	{
+		OptimizerCacheStats *shared_md_cache_stats = &stats[nstats++];
+		OrcaMDCacheStats shared_stats;
+
+		OrcaMDCacheGetStats(&shared_stats);
+
+		shared_md_cache_stats->name = "shared metadata";
+		shared_md_cache_stats->entries = shared_stats.entries;
+		shared_md_cache_stats->size = shared_stats.size;
+		shared_md_cache_stats->quota = shared_stats.quota;
+		shared_md_cache_stats->hits = shared_stats.hits;
+		shared_md_cache_stats->misses = shared_stats.misses;
+		shared_md_cache_stats->evictions = shared_stats.evictions;
+		shared_md_cache_stats->invalidations = shared_stats.invalidations;
+		shared_md_cache_stats->invalidated_entries =
+			shared_stats.invalidated_entries;
+		shared_md_cache_stats->retained_entries = 0;
+	}
+
+	return nstats;
+}
+
 //---------------------------------------------------------------------------
 //	@function:
 //		InitGPOPT()
@@ -219,6 +292,22 @@ SerializeDXLPlan(Query *query)
 }
 }
 
+//---------------------------------------------------------------------------
+//	@function:
+//		GetOptimizerCacheStats
+//
+//	@doc:
+//		Expose counters of the optimizer's caches to C files
+//
+//---------------------------------------------------------------------------
+extern "C" {
+int
+GetOptimizerCacheStats(OptimizerCacheStats *stats, int max_stats)
+{
+	return CGPOptimizer::GetCacheStats(stats, max_stats);
+}
+}
+
 //---------------------------------------------------------------------------
 //	@function:
 //		InitGPOPT()
@@ -36,6 +36,7 @@ extern "C" {
 #include "access/amapi.h"
 #include "access/external.h"
 #include "access/genam.h"
+#include "catalog/partition.h"
 #include "catalog/pg_inherits.h"
 #include "foreign/fdwapi.h"
 #include "nodes/nodeFuncs.h"
@@ -522,6 +523,17 @@ gpdb::ExtractNodesExpression(Node *node, int node_tag,
 	return NIL;
 }
 
+bool
+gpdb::HashJoinRuntimeFilterEligible(HashJoin *join)
+{
+	GP_WRAP_START;
+	{
+		return hashjoin_runtime_filter_eligible(join);
+	}
+	GP_WRAP_END;
+	return false;
+}
+
 void
 gpdb::FreeAttrStatsSlot(AttStatsSlot *sslot)
 {
@@ -2289,11 +2301,16 @@ gpdb::InjectFaultInOptTasks(const char *fault_name)
  * We register a callback to a cache on all the catalog tables that contain
  * information that's contained in the ORCA metadata cache.
 
- * There is no fine-grained mechanism in the metadata cache for invalidating
- * individual entries ATM, so we just blow the whole cache whenever anything
- * changes. The callback simply increments a counter. Whenever we start
- * planning a query, we check the counter to see if it has changed since the
- * last planned query, and reset the whole cache if it has.
+ * The callbacks increment a counter, and remember what was invalidated: the
+ * OIDs of relations from relcache invalidations, and the cache id and hash
+ * value of syscache invalidations on catalogs keyed by a single OID. Whenever
+ * we start planning a query, we check the counter to see if it has changed
+ * since the last planned query. If it has, the metadata cache drops only the
+ * objects that match the remembered invalidations (see
+ * MDCacheRelIsInvalidated() and MDCacheOidIsInvalidated()). Invalidations
+ * that can't be attributed to individual objects, like a flush of all
+ * caches, changes to pg_cast or pg_amop, or more invalidations than we have
+ * room for, still reset the whole cache.
  *
  * To make sure we've covered all catalog tables that contain information
  * that's stored in the metadata cache, there are "catalog tables: xxx"
@@ -2302,21 +2319,115 @@ gpdb::InjectFaultInOptTasks(const char *fault_name)
  * anything fetched via the wrapper functions in this file can end up in the
  * metadata cache and hence need to have an invalidation callback registered.
  */
+#define MDCACHE_MAX_INVALIDATIONS 256
+
+typedef struct MDCacheInvalidations
+{
+	/* the whole cache must be reset */
+	bool		reset;
+
+	/* pg_statistic was changed */
+	bool		stats;
+
+	/* relations from relcache invalidations */
+	int			nrels;
+	Oid			rels[MDCACHE_MAX_INVALIDATIONS];
+
+	/* syscache invalidations on catalogs keyed by a single OID */
+	int			nsyscache;
+	int			cacheids[MDCACHE_MAX_INVALIDATIONS];
+	uint32		hashvalues[MDCACHE_MAX_INVALIDATIONS];
+} MDCacheInvalidations;
+
 static bool mdcache_invalidation_counter_registered = false;
 static int64 mdcache_invalidation_counter = 0;
 static int64 last_mdcache_invalidation_counter = 0;
 
+/* invalidations received since the last planned query */
+static MDCacheInvalidations pending_mdcache_invalidations;
+
+/* invalidations to apply to the metadata cache for the current query */
+static MDCacheInvalidations current_mdcache_invalidations;
+
+/* syscaches keyed by a single OID, which is also the OID of an ORCA mdid */
+static const int mdcache_oid_caches[] = {
+	AGGFNOID,	/* pg_aggregate */
+	CONSTROID,	/* pg_constraint */
+	OPEROID,	/* pg_operator */
+	PROCOID,	/* pg_proc */
+	TYPEOID,	/* pg_type */
+};
+
+static void
+add_mdcache_rel_invalidation(MDCacheInvalidations *invals, Oid relid)
+{
+	for (int i = 0; i < invals->nrels; i++)
+	{
+		if (invals->rels[i] == relid)
+			return;
+	}
+
+	if (invals->nrels >= MDCACHE_MAX_INVALIDATIONS)
+	{
+		invals->reset = true;
+		return;
+	}
+
+	invals->rels[invals->nrels++] = relid;
+}
+
 static void
 mdsyscache_invalidation_counter_callback(Datum arg, int cacheid,
 										 uint32 hashvalue)
 {
+	MDCacheInvalidations *invals = &pending_mdcache_invalidations;
+
 	mdcache_invalidation_counter++;
+
+	/* a zero hash value means that the whole syscache was flushed */
+	if (hashvalue == 0)
+	{
+		invals->reset = true;
+		return;
+	}
+
+	if (cacheid == STATRELATTINH)
+	{
+		invals->stats = true;
+		return;
+	}
+
+	for (unsigned int i = 0; i < lengthof(mdcache_oid_caches); i++)
+	{
+		if (mdcache_oid_caches[i] != cacheid)
+			continue;
+
+		if (invals->nsyscache >= MDCACHE_MAX_INVALIDATIONS)
+		{
+			invals->reset = true;
+			return;
+		}
+
+		invals->cacheids[invals->nsyscache] = cacheid;
+		invals->hashvalues[invals->nsyscache] = hashvalue;
+		invals->nsyscache++;
+		return;
+	}
+
+	/* pg_amop, pg_cast, pg_opfamily: can't map those to cached objects */
+	invals->reset = true;
 }
 
 static void
 mdrelcache_invalidation_counter_callback(Datum arg, Oid relid)
 {
 	mdcache_invalidation_counter++;
+
+	/* InvalidOid means that all relcache entries were invalidated */
+	if (!OidIsValid(relid))
+		pending_mdcache_invalidations.reset = true;
+	else
+		add_mdcache_rel_invalidation(&pending_mdcache_invalidations, relid);
 }
 
 static void
@@ -2385,6 +2496,10 @@ register_mdcache_invalidation_callbacks(void)
 }
 
 // Has there been any catalog changes since last call?
+//
+// The invalidations received since the last call become the ones reported by
+// MDCacheNeedsFullReset(), MDCacheRelIsInvalidated(), MDCacheOidIsInvalidated()
+// and MDCacheStatsAreInvalidated() until the next call.
 bool
 gpdb::MDCacheNeedsReset(void)
 {
@@ -2397,11 +2512,44 @@ gpdb::MDCacheNeedsReset(void)
 		}
 		if (last_mdcache_invalidation_counter == mdcache_invalidation_counter)
 		{
+			memset(&current_mdcache_invalidations, 0,
+				   sizeof(current_mdcache_invalidations));
 			return false;
 		}
 		else
 		{
-			last_mdcache_invalidation_counter = mdcache_invalidation_counter;
+			MDCacheInvalidations *invals = &current_mdcache_invalidations;
+			int64 counter = mdcache_invalidation_counter;
+
+			memcpy(invals, &pending_mdcache_invalidations, sizeof(*invals));
+
+			/*
+			 * Statistics of a partitioned table are derived from its
+			 * partitions (see CdbEstimatePartitionedNumTuples()), so a
+			 * change to a partition also invalidates its ancestors.
+			 */
+			int nrels = invals->nrels;
+			for (int i = 0; i < nrels && !invals->reset; i++)
+			{
+				ListCell *lc;
+
+				foreach (lc, get_partition_ancestors(invals->rels[i]))
+				{
+					add_mdcache_rel_invalidation(invals, lfirst_oid(lc));
+				}
+			}
+
+			/*
+			 * Looking up the ancestors may have processed more invalidation
+			 * messages. Keep them, and everything before them, for the next
+			 * query in that case.
+			 */
+			last_mdcache_invalidation_counter = counter;
+			if (counter == mdcache_invalidation_counter)
+			{
+				memset(&pending_mdcache_invalidations, 0,
+					   sizeof(pending_mdcache_invalidations));
+			}
 			return true;
 		}
 	}
@@ -2410,6 +2558,130 @@ gpdb::MDCacheNeedsReset(void)
 	return true;
 }
 
+// Must the whole metadata cache be reset, because some of the catalog
+// changes can't be attributed to individual objects?
+bool
+gpdb::MDCacheNeedsFullReset(void)
+{
+	return current_mdcache_invalidations.reset;
+}
+
+// Was the relation with the given OID invalidated?
+bool
+gpdb::MDCacheRelIsInvalidated(Oid relid)
+{
+	const MDCacheInvalidations *invals = &current_mdcache_invalidations;
+
+	for (int i = 0; i < invals->nrels; i++)
+	{
+		if (invals->rels[i] == relid)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+// Was the type, function, operator, aggregate or constraint with the given
+// OID invalidated? Since syscache invalidations only carry a hash value of
+// the key, this may also return true for an unaffected object.
+bool
+gpdb::MDCacheOidIsInvalidated(Oid oid)
+{
+	const MDCacheInvalidations *invals = &current_mdcache_invalidations;
+
+	if (invals->nsyscache == 0)
+	{
+		return false;
+	}
+
+	GP_WRAP_START;
+	{
+		for (unsigned int i = 0; i < lengthof(mdcache_oid_caches); i++)
+		{
+			int cacheid = mdcache_oid_caches[i];
+			bool computed = false;
+			uint32 hashvalue = 0;
+
+			for (int j = 0; j < invals->nsyscache; j++)
+			{
+				if (invals->cacheids[j] != cacheid)
+				{
+					continue;
+				}
+
+				if (!computed)
+				{
+					hashvalue =
+						GetSysCacheHashValue1(cacheid, ObjectIdGetDatum(oid));
+					computed = true;
+				}
+
+				if (invals->hashvalues[j] == hashvalue)
+				{
+					return true;
+				}
+			}
+		}
+		return false;
+	}
+	GP_WRAP_END;
+
+	return true;
+}
+
+// Were any types, functions, operators, aggregates or constraints invalidated?
+bool
+gpdb::MDCacheHasInvalidatedOids(void)
+{
+	return current_mdcache_invalidations.nsyscache > 0;
+}
+
+// Was pg_statistic changed?
+bool
+gpdb::MDCacheStatsAreInvalidated(void)
+{
+	return current_mdcache_invalidations.stats;
+}
+
+bool
+gpdb::SharedMDCacheEnabled(void)
+{
+	return OrcaMDCacheEnabled();
+}
+
+uint64
+gpdb::SharedMDCacheGetEpoch(void)
+{
+	return OrcaMDCacheGetEpoch();
+}
+
+char *
+gpdb::SharedMDCacheLookup(const char *key, Oid relid, OrcaMDCacheKind kind,
+						  Size *len)
+{
+	GP_WRAP_START;
+	{
+		return OrcaMDCacheLookup(key, relid, kind, len);
+	}
+	GP_WRAP_END;
+	return nullptr;
+}
+
+void
+gpdb::SharedMDCacheInsert(const char *key, Oid relid, OrcaMDCacheKind kind,
+						  const char *data, Size len, uint64 epoch)
+{
+	GP_WRAP_START;
+	{
+		/* catalog tables: pg_class */
+		OrcaMDCacheInsert(key, relid, kind, data, len, epoch);
+		return;
+	}
+	GP_WRAP_END;
+}
+
 // returns true if a query cancel is requested in GPDB
 bool
 gpdb::IsAbortRequested(void)
@@ -17,11 +17,18 @@
 extern "C" {
 #include "postgres.h"
 }
+#include "gpos/common/CAutoP.h"
+#include "gpos/common/CAutoRg.h"
+
+#include "gpopt/gpdbwrappers.h"
 #include "gpopt/mdcache/CMDAccessor.h"
 #include "gpopt/relcache/CMDProviderRelcache.h"
 #include "gpopt/translate/CTranslatorRelcacheToDXL.h"
 #include "naucrates/dxl/CDXLUtils.h"
 #include "naucrates/exception.h"
+#include "naucrates/md/CMDIdColStats.h"
+#include "naucrates/md/CMDIdGPDB.h"
+#include "naucrates/md/CMDIdRelStats.h"
 
 using namespace gpos;
 using namespace gpdxl;
@@ -40,11 +47,102 @@ IMDCacheObject *
 CMDProviderRelcache::GetMDObj(CMemoryPool *mp, CMDAccessor *md_accessor,
 							  IMDId *mdid, IMDCacheObject::Emdtype mdtype) const
 {
+	CHAR key[ORCA_MDCACHE_KEYLEN];
+	OrcaMDCacheKind kind;
+	OID relid;
+
+	if (!gpdb::SharedMDCacheEnabled() ||
+		!GetSharedCacheKey(mdid, key, &kind, &relid))
+	{
+		IMDCacheObject *md_obj = CTranslatorRelcacheToDXL::RetrieveObject(
+			mp, md_accessor, mdid, mdtype);
+		GPOS_ASSERT(nullptr != md_obj);
+
+		return md_obj;
+	}
+
+	// parse the object if another backend has translated it already
+	Size len = 0;
+	CHAR *data = gpdb::SharedMDCacheLookup(key, relid, kind, &len);
+	if (nullptr != data)
+	{
+		CAutoP<CWStringDynamic> dxl_str(
+			CDXLUtils::CreateDynamicStringFromCharArray(mp, data));
+		gpdb::GPDBFree(data);
+
+		IMDCacheObject *md_obj = CDXLUtils::ParseDXLToIMDIdCacheObj(
+			mp, dxl_str.Value(), nullptr /* XSD path */);
+		GPOS_ASSERT(nullptr != md_obj);
+
+		return md_obj;
+	}
+
+	// the epoch must be taken before we start reading the catalogs, so that
+	// invalidations arriving during the translation make the object stale
+	uint64 epoch = gpdb::SharedMDCacheGetEpoch();
+
 	IMDCacheObject *md_obj =
 		CTranslatorRelcacheToDXL::RetrieveObject(mp, md_accessor, mdid, mdtype);
 	GPOS_ASSERT(nullptr != md_obj);
 
+	CAutoP<CWStringDynamic> dxl_str(CDXLUtils::SerializeMDObj(
+		mp, md_obj, true /*serialize_document_header_footer*/,
+		false /*indentation*/));
+	CAutoRg<CHAR> dxl_char(CDXLUtils::CreateMultiByteCharStringFromWCString(
+		mp, dxl_str->GetBuffer()));
+
+	gpdb::SharedMDCacheInsert(key, relid, kind, dxl_char.Rgt(),
+							  clib::Strlen(dxl_char.Rgt()) + 1, epoch);
+
 	return md_obj;
 }
 
+// compute the key of a metadata object in the metadata cache shared by all
+// backends, and the relation it belongs to; returns false for objects that
+// are not shared
+BOOL
+CMDProviderRelcache::GetSharedCacheKey(IMDId *mdid, CHAR *key,
+									   OrcaMDCacheKind *kind, OID *relid)
+{
+	switch (mdid->MdidType())
+	{
+		case IMDId::EmdidRel:
+			*kind = ORCA_MDCACHE_RELATION;
+			*relid = CMDIdGPDB::CastMdid(mdid)->Oid();
+			break;
+
+		case IMDId::EmdidRelStats:
+			*kind = ORCA_MDCACHE_RELSTATS;
+			*relid = CMDIdGPDB::CastMdid(
+						 CMDIdRelStats::CastMdid(mdid)->GetRelMdId())
+						 ->Oid();
+			break;
+
+		case IMDId::EmdidColStats:
+			*kind = ORCA_MDCACHE_COLSTATS;
+			*relid = CMDIdGPDB::CastMdid(
+						 CMDIdColStats::CastMdid(mdid)->GetRelMdId())
+						 ->Oid();
+			break;
+
+		default:
+			return false;
+	}
+
+	// metadata ids are plain ASCII
+	const WCHAR *wsz = mdid->GetBuffer();
+	ULONG length = GPOS_WSZ_LENGTH(wsz);
+	if (length >= ORCA_MDCACHE_KEYLEN)
+	{
+		return false;
+	}
+
+	for (ULONG ul = 0; ul <= length; ul++)
+	{
+		key[ul] = (CHAR) wsz[ul];
+	}
+
+	return true;
+}
+
 // EOF
@@ -1619,6 +1619,10 @@ CTranslatorDXLToPlStmt::TranslateDXLHashJoin(
 	plan->righttree = right_plan;
 	SetParamIds(plan);
 
+	// let the Hash node build a runtime filter for the scan on the outer
+	// side; the inner side is always built first (prefetch_inner)
+	hashjoin->runtime_filter = gpdb::HashJoinRuntimeFilterEligible(hashjoin);
+
 	// cleanup
 	translation_context_arr_with_siblings->Release();
 	child_contexts->Release();
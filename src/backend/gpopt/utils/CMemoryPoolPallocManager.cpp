@@ -30,8 +30,16 @@ CMemoryPoolPallocManager::CMemoryPoolPallocManager(CMemoryPool *internal,
 }
 
 // create new memory pool
+//
+// The kind is ignored. An AllocSet context already bump-allocates small
+// chunks from blocks of growing size, keeps freed chunks in free lists per
+// power-of-two size class, and releases all blocks at once when deleted,
+// which is what CMemoryPoolSlab does for the malloc based managers. Objects
+// of CMemoryPoolSlab also could not be freed here: the static DeleteImpl of
+// this manager hands every pointer to pfree(). Inside the server, slab pools
+// are therefore palloc based like all others.
 CMemoryPool *
-CMemoryPoolPallocManager::NewMemoryPool()
+CMemoryPoolPallocManager::NewMemoryPool(EMemoryPoolKind)
 {
 	return GPOS_NEW(GetInternalMemoryPool()) CMemoryPoolPalloc();
 }
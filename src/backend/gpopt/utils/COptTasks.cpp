@@ -46,8 +46,10 @@ extern "C" {
 #include "gpopt/mdcache/CAutoMDAccessor.h"
 #include "gpopt/mdcache/CMDCache.h"
 #include "gpopt/minidump/CMinidumperUtils.h"
+#include "gpopt/minidump/CSerializableOptimizerConfig.h"
 #include "gpopt/optimizer/COptimizer.h"
 #include "gpopt/optimizer/COptimizerConfig.h"
+#include "gpopt/optimizer/CPlanCache.h"
 #include "gpopt/relcache/CMDProviderRelcache.h"
 #include "gpopt/translate/CContextDXLToPlStmt.h"
 #include "gpopt/translate/CTranslatorDXLToExpr.h"
@@ -67,6 +69,7 @@ extern "C" {
 #include "naucrates/exception.h"
 #include "naucrates/init.h"
 #include "naucrates/md/CMDIdCast.h"
+#include "naucrates/md/CMDIdColStats.h"
 #include "naucrates/md/CMDIdRelStats.h"
 #include "naucrates/md/CMDIdScCmp.h"
 #include "naucrates/md/CSystemId.h"
@@ -873,17 +876,47 @@ COptTasks::OptimizeTask(void *ptr)
 		CMDCache::Init();
 		CMDCache::SetCacheQuota(optimizer_mdcache_size * 1024L);
 	}
-	else if (reset_mdcache)
+	else if (reset_mdcache && gpdb::MDCacheNeedsFullReset())
 	{
 		CMDCache::Reset();
 		CMDCache::SetCacheQuota(optimizer_mdcache_size * 1024L);
 	}
-	else if (CMDCache::ULLGetCacheQuota() !=
-			 (ULLONG) optimizer_mdcache_size * 1024L)
+	else
 	{
-		CMDCache::SetCacheQuota(optimizer_mdcache_size * 1024L);
+		// drop only the objects affected by the catalog changes
+		if (reset_mdcache)
+		{
+			(void) CMDCache::Invalidate(IsMDCacheObjectInvalidated,
+										nullptr /*context*/);
+		}
+
+		if (CMDCache::ULLGetCacheQuota() !=
+			(ULLONG) optimizer_mdcache_size * 1024L)
+		{
+			CMDCache::SetCacheQuota(optimizer_mdcache_size * 1024L);
+		}
 	}
 
+	// cached plans were derived from the cached metadata, so the plan cache
+	// is purged together with the metadata cache
+	if (!CPlanCache::FInitialized())
+	{
+		if (optimizer_plan_caching)
+		{
+			CPlanCache::Init();
+			CPlanCache::SetCacheQuota(optimizer_plan_cache_size * 1024L);
+		}
+	}
+	else if (reset_mdcache)
+	{
+		CPlanCache::Reset();
+		CPlanCache::SetCacheQuota(optimizer_plan_cache_size * 1024L);
+	}
+	else if (CPlanCache::ULLGetCacheQuota() !=
+			 (ULLONG) optimizer_plan_cache_size * 1024L)
+	{
+		CPlanCache::SetCacheQuota(optimizer_plan_cache_size * 1024L);
+	}
 
 	// load search strategy
 	CSearchStageArray *search_strategy_arr =
@@ -893,6 +926,7 @@ COptTasks::OptimizeTask(void *ptr)
 	CBitSet *enabled_trace_flags = nullptr;
 	CBitSet *disabled_trace_flags = nullptr;
 	CDXLNode *plan_dxl = nullptr;
+	CWStringDynamic *plan_cache_key = nullptr;
 
 	IMdIdArray *col_stats = nullptr;
 	MdidHashSet *rel_stats = nullptr;
@@ -953,10 +987,50 @@ COptTasks::OptimizeTask(void *ptr)
 			CAutoTraceFlag atf2(EopttraceUseLegacyOpfamilies,
 								use_legacy_opfamilies);
 
-			plan_dxl = COptimizer::PdxlnOptimize(
-				mp, &mda, query_dxl, query_output_dxlnode_array,
-				cte_dxlnode_array, expr_evaluator, num_segments, gp_session_id,
-				gp_command_count, search_strategy_arr, optimizer_config);
+			CHAR *cached_plan_dxl = nullptr;
+			if (optimizer_plan_caching &&
+				IsPlanCacheable(opt_ctxt->m_query, search_strategy_arr))
+			{
+				plan_cache_key = SerializePlanCacheKey(
+					mp, query_dxl, query_output_dxlnode_array,
+					cte_dxlnode_array, optimizer_config, num_segments,
+					num_segments_for_costing);
+				cached_plan_dxl = CPlanCache::SzLookup(mp, plan_cache_key);
+			}
+
+			if (nullptr != cached_plan_dxl)
+			{
+				ULLONG plan_id = 0;
+				ULLONG plan_space_size = 0;
+				plan_dxl = CDXLUtils::GetPlanDXLNode(
+					mp, cached_plan_dxl, nullptr /*xsd_file_path*/, &plan_id,
+					&plan_space_size);
+				GPOS_DELETE_ARRAY(cached_plan_dxl);
+			}
+			else
+			{
+				plan_dxl = COptimizer::PdxlnOptimize(
+					mp, &mda, query_dxl, query_output_dxlnode_array,
+					cte_dxlnode_array, expr_evaluator, num_segments,
+					gp_session_id, gp_command_count, search_strategy_arr,
+					optimizer_config);
+
+				if (nullptr != plan_cache_key)
+				{
+					CWStringDynamic plan_str(mp);
+					COstreamString oss(&plan_str);
+					CDXLUtils::SerializePlan(
+						mp, oss, plan_dxl,
+						optimizer_config->GetEnumeratorCfg()->GetPlanId(),
+						optimizer_config->GetEnumeratorCfg()->GetPlanSpaceSize(),
+						true /*serialize_header_footer*/, false /*indentation*/);
+					CHAR *plan_str_mb =
+						CDXLUtils::CreateMultiByteCharStringFromWCString(
+							mp, plan_str.GetBuffer());
+					CPlanCache::Insert(plan_cache_key, plan_str_mb);
+					GPOS_DELETE_ARRAY(plan_str_mb);
+				}
+			}
 
 			if (opt_ctxt->m_should_serialize_plan_dxl)
 			{
@@ -1003,6 +1077,7 @@ COptTasks::OptimizeTask(void *ptr)
 	GPOS_CATCH_EX(ex)
 	{
 		ResetTraceflags(enabled_trace_flags, disabled_trace_flags);
+		GPOS_DELETE(plan_cache_key);
 		CRefCount::SafeRelease(rel_stats);
 		CRefCount::SafeRelease(col_stats);
 		CRefCount::SafeRelease(enabled_trace_flags);
@@ -1010,6 +1085,7 @@ COptTasks::OptimizeTask(void *ptr)
 		CRefCount::SafeRelease(trace_flags);
 		CRefCount::SafeRelease(plan_dxl);
 		CMDCache::Shutdown();
+		CPlanCache::Shutdown();
 
 		IErrorContext *errctxt = CTask::Self()->GetErrCtxt();
 
@@ -1023,6 +1099,7 @@ COptTasks::OptimizeTask(void *ptr)
 
 	// cleanup
 	ResetTraceflags(enabled_trace_flags, disabled_trace_flags);
+	GPOS_DELETE(plan_cache_key);
 	CRefCount::SafeRelease(enabled_trace_flags);
 	CRefCount::SafeRelease(disabled_trace_flags);
 	CRefCount::SafeRelease(trace_flags);
@@ -1035,6 +1112,137 @@ COptTasks::OptimizeTask(void *ptr)
 }
 
 
+//---------------------------------------------------------------------------
+//	@function:
+//		COptTasks::IsMDCacheObjectInvalidated
+//
+//	@doc:
+//		Map the metadata id of a cached object to the catalog invalidations
+//		received since the last planned query. Relations, indexes and their
+//		statistics are matched against relcache invalidations; types,
+//		functions, operators, aggregates and check constraints against
+//		syscache invalidations. Objects that can't be mapped to a single OID
+//		are dropped on any change to the catalogs they are derived from.
+//
+//---------------------------------------------------------------------------
+BOOL
+COptTasks::IsMDCacheObjectInvalidated(const IMDId *mdid,
+									  void *  // context
+)
+{
+	switch (mdid->MdidType())
+	{
+		case IMDId::EmdidRel:
+		case IMDId::EmdidInd:
+		case IMDId::EmdidExtStatsInfo:
+		{
+			OID oid = CMDIdGPDB::CastMdid(mdid)->Oid();
+			return gpdb::MDCacheRelIsInvalidated(oid) ||
+				   (IMDId::EmdidExtStatsInfo == mdid->MdidType() &&
+					gpdb::MDCacheStatsAreInvalidated());
+		}
+
+		case IMDId::EmdidGeneral:
+		{
+			OID oid = CMDIdGPDB::CastMdid(mdid)->Oid();
+			return gpdb::MDCacheOidIsInvalidated(oid) ||
+				   gpdb::MDCacheRelIsInvalidated(oid);
+		}
+
+		case IMDId::EmdidCheckConstraint:
+		{
+			OID oid = CMDIdGPDB::CastMdid(mdid)->Oid();
+			return gpdb::MDCacheOidIsInvalidated(oid);
+		}
+
+		case IMDId::EmdidRelStats:
+		{
+			const IMDId *rel_mdid =
+				CMDIdRelStats::CastMdid(mdid)->GetRelMdId();
+			return gpdb::MDCacheRelIsInvalidated(
+				CMDIdGPDB::CastMdid(rel_mdid)->Oid());
+		}
+
+		case IMDId::EmdidColStats:
+		{
+			const IMDId *rel_mdid =
+				CMDIdColStats::CastMdid(mdid)->GetRelMdId();
+			return gpdb::MDCacheStatsAreInvalidated() ||
+				   gpdb::MDCacheRelIsInvalidated(
+					   CMDIdGPDB::CastMdid(rel_mdid)->Oid());
+		}
+
+		case IMDId::EmdidCastFunc:
+		case IMDId::EmdidScCmp:
+			// derived from pg_cast, pg_operator and pg_proc entries
+			return gpdb::MDCacheHasInvalidatedOids();
+
+		default:
+			// extended statistics are keyed by the statistics object rather
+			// than by the relation they belong to; drop them, and anything
+			// else we can't map, on any catalog change
+			return true;
+	}
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		COptTasks::IsPlanCacheable
+//
+//	@doc:
+//		Check whether the plan of the given query may be served from the
+//		plan cache. Only plain SELECT statements qualify: the query DXL of
+//		DML and utility-wrapped statements (CTAS, COPY, REFRESH) does not
+//		capture everything their plans depend on.
+//
+//---------------------------------------------------------------------------
+BOOL
+COptTasks::IsPlanCacheable(const Query *query,
+						   const CSearchStageArray *search_strategy_arr)
+{
+	return CMD_SELECT == query->commandType &&
+		   PARENTSTMTTYPE_NONE == query->parentStmtType &&
+		   nullptr == search_strategy_arr;
+}
+
+
+//---------------------------------------------------------------------------
+//	@function:
+//		COptTasks::SerializePlanCacheKey
+//
+//	@doc:
+//		Serialize everything besides metadata that the optimizer output
+//		depends on: the query, the optimizer configuration including the
+//		current trace flags, and the segment counts. This is the same input
+//		a minidump records to reproduce a plan.
+//
+//---------------------------------------------------------------------------
+CWStringDynamic *
+COptTasks::SerializePlanCacheKey(CMemoryPool *mp, const CDXLNode *query_dxl,
+								 const CDXLNodeArray *query_output_dxlnode_array,
+								 const CDXLNodeArray *cte_dxlnode_array,
+								 const COptimizerConfig *optimizer_config,
+								 ULONG num_segments,
+								 ULONG num_segments_for_costing)
+{
+	CWStringDynamic *key = GPOS_NEW(mp) CWStringDynamic(mp);
+	COstreamString oss(key);
+
+	CDXLUtils::SerializeQuery(mp, oss, query_dxl, query_output_dxlnode_array,
+							  cte_dxlnode_array,
+							  false /*serialize_header_footer*/,
+							  false /*indentation*/);
+
+	CSerializableOptimizerConfig serializable_config(mp, optimizer_config);
+	serializable_config.Serialize(oss);
+
+	key->AppendFormat(GPOS_WSZ_LIT("<segments %d %d>"), num_segments,
+					  num_segments_for_costing);
+
+	return key;
+}
+
+
 //---------------------------------------------------------------------------
 //	@function:
 //		COptTasks::PrintMissingStatsWarning
@@ -37,6 +37,10 @@ using namespace gpmd;
 //---------------------------------------------------------------------------
 class CMDCache
 {
+public:
+	// type definition of a predicate selecting metadata objects to invalidate
+	using InvalidateFuncPtr = BOOL (*)(const IMDId *, void *);
+
 private:
 	// pointer to the underlying cache
 	static CMDAccessor::MDCache *m_pcache;
@@ -44,6 +48,39 @@ private:
 	// the maximum size of the cache
 	static ULLONG m_ullCacheQuota;
 
+	// number of lookups that found an object in the cache
+	static ULLONG m_ullHits;
+
+	// number of lookups that had to fetch an object from the provider
+	static ULLONG m_ullMisses;
+
+	// evictions from cache instances that have been destroyed
+	static ULLONG m_ullEvictions;
+
+	// number of times the whole cache was purged
+	static ULLONG m_ullResets;
+
+	// number of times selected objects were invalidated
+	static ULLONG m_ullInvalidations;
+
+	// number of objects dropped by resets and invalidations
+	static ULLONG m_ullInvalidatedEntries;
+
+	// number of objects that survived an invalidation, i.e. that did not
+	// need to be reloaded, compared to purging the whole cache
+	static ULLONG m_ullRetainedEntries;
+
+	// invalidation predicate on metadata ids together with its context
+	struct SInvalidateContext
+	{
+		InvalidateFuncPtr m_pfInvalidate;
+
+		void *m_context;
+	};
+
+	// adapter from cache keys to metadata ids for invalidation predicates
+	static BOOL FInvalidateKey(CMDKey *const &pmdkey, void *context);
+
 	// private ctor
 	CMDCache() = default;
 
@@ -78,6 +115,72 @@ public:
 	// reset global instance
 	static void Reset();
 
+	// drop the objects whose mdid satisfies the given predicate, keeping
+	// the rest of the cache; returns the number of dropped objects
+	static ULLONG Invalidate(InvalidateFuncPtr pfInvalidate, void *context);
+
+	// count a lookup of the global instance
+	static void
+	RecordLookup(BOOL fFound)
+	{
+		if (fFound)
+		{
+			m_ullHits++;
+		}
+		else
+		{
+			m_ullMisses++;
+		}
+	}
+
+	// number of cached objects
+	static ULLONG ULLGetEntries();
+
+	// total memory held by cached objects
+	static ULLONG ULLGetCacheSize();
+
+	// hit counter
+	static ULLONG
+	ULLGetHits()
+	{
+		return m_ullHits;
+	}
+
+	// miss counter
+	static ULLONG
+	ULLGetMisses()
+	{
+		return m_ullMisses;
+	}
+
+	// number of times the whole cache was purged
+	static ULLONG
+	ULLGetResets()
+	{
+		return m_ullResets;
+	}
+
+	// number of resets and invalidations
+	static ULLONG
+	ULLGetInvalidations()
+	{
+		return m_ullResets + m_ullInvalidations;
+	}
+
+	// number of objects dropped by resets and invalidations
+	static ULLONG
+	ULLGetInvalidatedEntries()
+	{
+		return m_ullInvalidatedEntries;
+	}
+
+	// number of objects kept by invalidations
+	static ULLONG
+	ULLGetRetainedEntries()
+	{
+		return m_ullRetainedEntries;
+	}
+
 	// global accessor
 	static CMDAccessor::MDCache *
 	Pcache()
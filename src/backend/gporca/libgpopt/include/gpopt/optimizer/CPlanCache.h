@@ -0,0 +1,244 @@
+//---------------------------------------------------------------------------
+//	Greenplum Database
+//	Copyright (C) 2024 VMware, Inc. or its affiliates.
+//
+//	@filename:
+//		CPlanCache.h
+//
+//	@doc:
+//		Cache of optimized plans, keyed on the serialized optimizer input
+//---------------------------------------------------------------------------
+#ifndef GPOPT_CPlanCache_H
+#define GPOPT_CPlanCache_H
+
+#include "gpos/base.h"
+#include "gpos/common/CRefCount.h"
+#include "gpos/memory/CCache.h"
+#include "gpos/memory/CCacheAccessor.h"
+#include "gpos/memory/CCacheFactory.h"
+#include "gpos/string/CWStringConst.h"
+
+namespace gpopt
+{
+using namespace gpos;
+
+//---------------------------------------------------------------------------
+//	@class:
+//		CPlanCacheKey
+//
+//	@doc:
+//		Key for plans in the plan cache; wraps the serialized optimizer
+//		input (query DXL, optimizer configuration and trace flags) together
+//		with its precomputed hash value
+//
+//---------------------------------------------------------------------------
+class CPlanCacheKey
+{
+private:
+	// serialized optimizer input
+	const CWStringBase *m_input;
+
+	// hash value of the serialized input
+	ULONG m_hash;
+
+public:
+	// ctor
+	explicit CPlanCacheKey(const CWStringBase *input);
+
+	// dtor
+	~CPlanCacheKey() = default;
+
+	// serialized input accessor
+	const CWStringBase *
+	Input() const
+	{
+		return m_input;
+	}
+
+	// hash function
+	ULONG
+	HashValue() const
+	{
+		return m_hash;
+	}
+
+	// equality function for using plan keys in a cache
+	static BOOL FEqualPlanCacheKey(CPlanCacheKey *const &pvLeft,
+								   CPlanCacheKey *const &pvRight);
+
+	// hash function for using plan keys in a cache
+	static ULONG UlHashPlanCacheKey(CPlanCacheKey *const &pv);
+};
+
+//---------------------------------------------------------------------------
+//	@class:
+//		CCachedPlan
+//
+//	@doc:
+//		A plan stored in the plan cache; owns a copy of the serialized
+//		optimizer input it was produced from and the serialized plan DXL
+//
+//---------------------------------------------------------------------------
+class CCachedPlan : public CRefCount
+{
+private:
+	// serialized optimizer input
+	CWStringConst *m_input;
+
+	// key pointing to the serialized input
+	CPlanCacheKey *m_key;
+
+	// serialized plan DXL document
+	CHAR *m_plan_dxl;
+
+public:
+	CCachedPlan(const CCachedPlan &) = delete;
+
+	// ctor
+	CCachedPlan(CMemoryPool *mp, const CWStringBase *input,
+				const CHAR *plan_dxl);
+
+	// dtor
+	~CCachedPlan() override;
+
+	// key accessor
+	CPlanCacheKey *
+	Key() const
+	{
+		return m_key;
+	}
+
+	// plan accessor
+	const CHAR *
+	PlanDXL() const
+	{
+		return m_plan_dxl;
+	}
+};
+
+//---------------------------------------------------------------------------
+//	@class:
+//		CPlanCache
+//
+//	@doc:
+//		A wrapper for a generic cache holding optimized plans, analogous to
+//		CMDCache. Plans are stored as serialized DXL documents so that they
+//		do not reference any query-lifetime memory.
+//
+//		The cache does not track which metadata objects a plan depends on;
+//		it must be reset whenever the metadata cache is reset.
+//
+//---------------------------------------------------------------------------
+class CPlanCache
+{
+public:
+	// type definition of the underlying cache
+	using PlanCache = CCache<CCachedPlan *, CPlanCacheKey *>;
+
+	// type definition of a cache accessor
+	using PlanCacheAccessor = CCacheAccessor<CCachedPlan *, CPlanCacheKey *>;
+
+private:
+	// pointer to the underlying cache
+	static PlanCache *m_pcache;
+
+	// the maximum size of the cache
+	static ULLONG m_ullCacheQuota;
+
+	// number of lookups that found a plan
+	static ULLONG m_ullHits;
+
+	// number of lookups that did not find a plan
+	static ULLONG m_ullMisses;
+
+	// evictions from cache instances that have been destroyed
+	static ULLONG m_ullEvictions;
+
+	// number of times the cache was reset
+	static ULLONG m_ullInvalidations;
+
+	// number of plans dropped by resets
+	static ULLONG m_ullInvalidatedEntries;
+
+	// private ctor
+	CPlanCache() = default;
+
+	// private dtor
+	~CPlanCache() = default;
+
+public:
+	CPlanCache(const CPlanCache &) = delete;
+
+	// initialize underlying cache
+	static void Init();
+
+	// has cache been initialized?
+	static BOOL
+	FInitialized()
+	{
+		return (nullptr != m_pcache);
+	}
+
+	// destroy global instance
+	static void Shutdown();
+
+	// drop all cached plans and count an invalidation
+	static void Reset();
+
+	// set the maximum size of the cache
+	static void SetCacheQuota(ULLONG ullCacheQuota);
+
+	// get the maximum size of the cache
+	static ULLONG ULLGetCacheQuota();
+
+	// look up the plan for the given optimizer input; returns a copy of
+	// the serialized plan allocated in the given memory pool, or null
+	static CHAR *SzLookup(CMemoryPool *mp, const CWStringBase *input);
+
+	// store the plan produced for the given optimizer input
+	static void Insert(const CWStringBase *input, const CHAR *plan_dxl);
+
+	// number of cached plans
+	static ULLONG ULLGetEntries();
+
+	// total memory held by cached plans
+	static ULLONG ULLGetCacheSize();
+
+	// hit counter
+	static ULLONG
+	ULLGetHits()
+	{
+		return m_ullHits;
+	}
+
+	// miss counter
+	static ULLONG
+	ULLGetMisses()
+	{
+		return m_ullMisses;
+	}
+
+	// get the number of times we evicted entries from this cache
+	static ULLONG ULLGetCacheEvictionCounter();
+
+	// get the number of times the cache was invalidated
+	static ULLONG
+	ULLGetInvalidations()
+	{
+		return m_ullInvalidations;
+	}
+
+	// get the number of plans dropped by resets
+	static ULLONG
+	ULLGetInvalidatedEntries()
+	{
+		return m_ullInvalidatedEntries;
+	}
+
+};	// class CPlanCache
+
+}  // namespace gpopt
+
+#endif	// !GPOPT_CPlanCache_H
+
+// EOF
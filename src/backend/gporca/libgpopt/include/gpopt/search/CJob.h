@@ -305,6 +305,9 @@ public:
 	// link for job queueing
 	SLink m_linkQueue;
 
+	// link for scheduler's list of runnable jobs
+	SLink m_linkWaiting;
+
 };	// class CJob
 
 }  // namespace gpopt
@@ -13,7 +13,6 @@
 
 #include "gpos/base.h"
 #include "gpos/common/CSyncList.h"
-#include "gpos/common/CSyncPool.h"
 
 #include "gpopt/search/CJob.h"
 
@@ -69,32 +68,9 @@ public:
 	};
 
 private:
-	// job wrapper; used for inserting job to waiting list (lock-free)
-	struct SJobLink
-	{
-		// link id, set by sync set
-		ULONG m_id;
-
-		// pointer to job
-		CJob *m_pj;
-
-		// slink for list of waiting jobs
-		SLink m_link;
-
-		// initialize link
-		void
-		Init(CJob *pj)
-		{
-			m_pj = pj;
-			m_link.m_prev = m_link.m_next = nullptr;
-		}
-	};
-
-	// list of jobs waiting to execute
-	CSyncList<SJobLink> m_listjlWaiting;
-
-	// pool of job link objects
-	CSyncPool<SJobLink> m_spjl;
+	// list of jobs waiting to execute; jobs are linked intrusively
+	// through CJob::m_linkWaiting, so scheduling does not allocate
+	CSyncList<CJob> m_listjWaiting;
 
 	// current job counters
 	ULONG_PTR m_ulpTotal;
@@ -157,10 +133,9 @@ private:
 
 public:
 	// ctor
-	CScheduler(CMemoryPool *mp, ULONG ulJobs
+	CScheduler(
 #ifdef GPOS_DEBUG
-			   ,
-			   BOOL fTrackingJobs = true
+		BOOL fTrackingJobs = true
 #endif	// GPOS_DEBUG
 	);
 
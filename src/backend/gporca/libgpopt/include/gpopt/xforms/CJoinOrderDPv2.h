@@ -323,16 +323,23 @@ private:
 		CDouble m_cardinality;
 		CDouble m_lowest_expr_cost;
 
+		// atoms that share an inner join predicate with one of our atoms;
+		// a group that contains none of them can only be joined with a
+		// cross product
+		CBitSet *m_neighbors;
+
 		SGroupInfo(CMemoryPool *mp, CBitSet *atoms)
 			: m_atoms(atoms), m_cardinality(-1.0), m_lowest_expr_cost(-1.0)
 		{
 			m_best_expr_info_array = GPOS_NEW(mp) SExpressionInfoArray(mp);
+			m_neighbors = GPOS_NEW(mp) CBitSet(mp);
 		}
 
 		~SGroupInfo() override
 		{
 			m_atoms->Release();
 			m_best_expr_info_array->Release();
+			m_neighbors->Release();
 		}
 
 		BOOL
@@ -428,6 +435,9 @@ private:
 	// for each non-inner join (entry in m_on_pred_conjuncts), the required atoms on the left
 	CBitSetArray *m_non_inner_join_dependencies;
 
+	// for each atom, the atoms it shares an inner join predicate with
+	CBitSetArray *m_atom_neighbors;
+
 	// top K expressions at the top level
 	CKHeap<SExpressionInfoArray, SExpressionInfo> *m_top_k_expressions;
 
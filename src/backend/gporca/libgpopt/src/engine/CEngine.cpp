@@ -1683,7 +1683,7 @@ CEngine::Optimize()
 		std::min((ULONG) GPOPT_JOBS_CAP,
 				 (ULONG)(m_pmemo->UlpGroups() * GPOPT_JOBS_PER_GROUP));
 	CJobFactory jf(m_mp, ulJobs);
-	CScheduler sched(m_mp, ulJobs);
+	CScheduler sched;
 
 	CSchedulerContext sc;
 	sc.Init(m_mp, &jf, &sched, this);
@@ -24,6 +24,7 @@
 #include "gpopt/base/COptCtxt.h"
 #include "gpopt/exception.h"
 #include "gpopt/mdcache/CMDAccessorUtils.h"
+#include "gpopt/mdcache/CMDCache.h"
 #include "naucrates/dxl/CDXLUtils.h"
 #include "naucrates/exception.h"
 #include "naucrates/md/CMDIdCast.h"
@@ -509,6 +510,10 @@ CMDAccessor::GetImdObj(IMDId *mdid, IMDCacheObject::Emdtype mdtype)
 		a_pmdcacc = GPOS_NEW(m_mp) CacheAccessorMD(m_pcache);
 		a_pmdcacc->Lookup(&mdkey);
 		IMDCacheObject *pmdobjNew = a_pmdcacc->Val();
+		if (m_pcache == CMDCache::Pcache())
+		{
+			CMDCache::RecordLookup(nullptr != pmdobjNew);
+		}
 		if (nullptr == pmdobjNew)
 		{
 			// object not found in MD cache: retrieve it from MD provider
@@ -24,6 +24,21 @@ CMDAccessor::MDCache *CMDCache::m_pcache = nullptr;
 // maximum size of the cache
 ULLONG CMDCache::m_ullCacheQuota = UNLIMITED_CACHE_QUOTA;
 
+// counters, kept across resets of the cache
+ULLONG CMDCache::m_ullHits = 0;
+
+ULLONG CMDCache::m_ullMisses = 0;
+
+ULLONG CMDCache::m_ullEvictions = 0;
+
+ULLONG CMDCache::m_ullResets = 0;
+
+ULLONG CMDCache::m_ullInvalidations = 0;
+
+ULLONG CMDCache::m_ullInvalidatedEntries = 0;
+
+ULLONG CMDCache::m_ullRetainedEntries = 0;
+
 //---------------------------------------------------------------------------
 //	@function:
 //		CMDCache::Init
@@ -54,6 +69,11 @@ CMDCache::Init()
 void
 CMDCache::Shutdown()
 {
+	if (nullptr != m_pcache)
+	{
+		m_ullEvictions += m_pcache->GetEvictionCounter();
+	}
+
 	GPOS_DELETE(m_pcache);
 	m_pcache = nullptr;
 }
@@ -103,10 +123,12 @@ CMDCache::ULLGetCacheQuota()
 ULLONG
 CMDCache::ULLGetCacheEvictionCounter()
 {
-	// make sure that we already initialized our underlying CCache
-	GPOS_ASSERT(nullptr != m_pcache);
+	if (nullptr == m_pcache)
+	{
+		return m_ullEvictions;
+	}
 
-	return m_pcache->GetEvictionCounter();
+	return m_ullEvictions + m_pcache->GetEvictionCounter();
 }
 
 //---------------------------------------------------------------------------
@@ -120,8 +142,97 @@ CMDCache::ULLGetCacheEvictionCounter()
 void
 CMDCache::Reset()
 {
+	if (nullptr != m_pcache)
+	{
+		m_ullInvalidatedEntries += m_pcache->Size();
+	}
+	m_ullResets++;
+
 	Shutdown();
 	Init();
 }
 
+//---------------------------------------------------------------------------
+//	@function:
+//		CMDCache::FInvalidateKey
+//
+//	@doc:
+//		Apply an invalidation predicate on metadata ids to a cache key
+//
+//---------------------------------------------------------------------------
+BOOL
+CMDCache::FInvalidateKey(CMDKey *const &pmdkey, void *context)
+{
+	GPOS_ASSERT(nullptr != pmdkey);
+
+	SInvalidateContext *invalidate = static_cast<SInvalidateContext *>(context);
+
+	return invalidate->m_pfInvalidate(pmdkey->MDId(), invalidate->m_context);
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CMDCache::Invalidate
+//
+//	@doc:
+//		Drop the objects whose mdid satisfies the given predicate. Unlike
+//		Reset(), the objects that are not affected by a catalog change stay
+//		in the cache and don't need to be fetched from the provider again.
+//
+//---------------------------------------------------------------------------
+ULLONG
+CMDCache::Invalidate(InvalidateFuncPtr pfInvalidate, void *context)
+{
+	GPOS_ASSERT(nullptr != m_pcache && "Metadata cache was not created");
+	GPOS_ASSERT(nullptr != pfInvalidate);
+
+	SInvalidateContext invalidate = {pfInvalidate, context};
+	ULLONG ullInvalidated =
+		m_pcache->InvalidateEntries(FInvalidateKey, &invalidate);
+
+	m_ullInvalidations++;
+	m_ullInvalidatedEntries += ullInvalidated;
+	m_ullRetainedEntries += m_pcache->Size();
+
+	return ullInvalidated;
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CMDCache::ULLGetEntries
+//
+//	@doc:
+//		Number of cached objects
+//
+//---------------------------------------------------------------------------
+ULLONG
+CMDCache::ULLGetEntries()
+{
+	if (nullptr == m_pcache)
+	{
+		return 0;
+	}
+
+	return m_pcache->Size();
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CMDCache::ULLGetCacheSize
+//
+//	@doc:
+//		Total memory held by cached objects
+//
+//---------------------------------------------------------------------------
+ULLONG
+CMDCache::ULLGetCacheSize()
+{
+	if (nullptr == m_pcache)
+	{
+		return 0;
+	}
+
+	return m_pcache->TotalAllocatedSize();
+}
+
 // EOF
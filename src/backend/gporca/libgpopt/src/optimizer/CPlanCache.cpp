@@ -0,0 +1,261 @@
+//---------------------------------------------------------------------------
+//	Greenplum Database
+//	Copyright (C) 2024 VMware, Inc. or its affiliates.
+//
+//	@filename:
+//		CPlanCache.cpp
+//
+//	@doc:
+//		Implementation of the cache of optimized plans
+//---------------------------------------------------------------------------
+
+#include "gpopt/optimizer/CPlanCache.h"
+
+#include "gpos/common/clibwrapper.h"
+
+using namespace gpos;
+using namespace gpopt;
+
+CPlanCache::PlanCache *CPlanCache::m_pcache = nullptr;
+
+ULLONG CPlanCache::m_ullCacheQuota = UNLIMITED_CACHE_QUOTA;
+
+ULLONG CPlanCache::m_ullHits = 0;
+
+ULLONG CPlanCache::m_ullMisses = 0;
+
+ULLONG CPlanCache::m_ullEvictions = 0;
+
+ULLONG CPlanCache::m_ullInvalidations = 0;
+
+ULLONG CPlanCache::m_ullInvalidatedEntries = 0;
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CPlanCacheKey::CPlanCacheKey
+//
+//	@doc:
+//		Constructs a plan cache key
+//
+//---------------------------------------------------------------------------
+CPlanCacheKey::CPlanCacheKey(const CWStringBase *input)
+	: m_input(input),
+	  m_hash(gpos::HashByteArray((const BYTE *) input->GetBuffer(),
+								 input->Length() * GPOS_SIZEOF(WCHAR)))
+{
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CPlanCacheKey::FEqualPlanCacheKey
+//
+//	@doc:
+//		Equality function for using plan keys in a cache
+//
+//---------------------------------------------------------------------------
+BOOL
+CPlanCacheKey::FEqualPlanCacheKey(CPlanCacheKey *const &pvLeft,
+								  CPlanCacheKey *const &pvRight)
+{
+	if (nullptr == pvLeft && nullptr == pvRight)
+	{
+		return true;
+	}
+
+	if (nullptr == pvLeft || nullptr == pvRight)
+	{
+		return false;
+	}
+
+	return pvLeft->HashValue() == pvRight->HashValue() &&
+		   pvLeft->Input()->Equals(pvRight->Input());
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CPlanCacheKey::UlHashPlanCacheKey
+//
+//	@doc:
+//		Hash function for using plan keys in a cache
+//
+//---------------------------------------------------------------------------
+ULONG
+CPlanCacheKey::UlHashPlanCacheKey(CPlanCacheKey *const &pv)
+{
+	return pv->HashValue();
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CCachedPlan::CCachedPlan
+//
+//	@doc:
+//		Ctor; copies the input and the plan into the given memory pool
+//
+//---------------------------------------------------------------------------
+CCachedPlan::CCachedPlan(CMemoryPool *mp, const CWStringBase *input,
+						 const CHAR *plan_dxl)
+	: m_input(nullptr), m_key(nullptr), m_plan_dxl(nullptr)
+{
+	GPOS_ASSERT(nullptr != input);
+	GPOS_ASSERT(nullptr != plan_dxl);
+
+	m_input = GPOS_NEW(mp) CWStringConst(mp, input->GetBuffer());
+	m_key = GPOS_NEW(mp) CPlanCacheKey(m_input);
+
+	const ULONG length = clib::Strlen(plan_dxl);
+	m_plan_dxl = GPOS_NEW_ARRAY(mp, CHAR, length + 1);
+	clib::Strncpy(m_plan_dxl, plan_dxl, length + 1);
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CCachedPlan::~CCachedPlan
+//
+//	@doc:
+//		Dtor
+//
+//---------------------------------------------------------------------------
+CCachedPlan::~CCachedPlan()
+{
+	GPOS_DELETE_ARRAY(m_plan_dxl);
+	GPOS_DELETE(m_key);
+	GPOS_DELETE(m_input);
+}
+
+void
+CPlanCache::Init()
+{
+	GPOS_ASSERT(nullptr == m_pcache && "Plan cache was already created");
+
+	m_pcache = CCacheFactory::CreateCache<CCachedPlan *, CPlanCacheKey *>(
+		true /*fUnique*/, m_ullCacheQuota, CPlanCacheKey::UlHashPlanCacheKey,
+		CPlanCacheKey::FEqualPlanCacheKey);
+}
+
+void
+CPlanCache::Shutdown()
+{
+	if (nullptr != m_pcache)
+	{
+		m_ullEvictions += m_pcache->GetEvictionCounter();
+	}
+
+	GPOS_DELETE(m_pcache);
+	m_pcache = nullptr;
+}
+
+void
+CPlanCache::Reset()
+{
+	if (nullptr != m_pcache)
+	{
+		m_ullInvalidatedEntries += m_pcache->Size();
+	}
+
+	Shutdown();
+	Init();
+
+	m_ullInvalidations++;
+}
+
+void
+CPlanCache::SetCacheQuota(ULLONG ullCacheQuota)
+{
+	GPOS_ASSERT(nullptr != m_pcache && "Plan cache was not created");
+	m_ullCacheQuota = ullCacheQuota;
+	m_pcache->SetCacheQuota(ullCacheQuota);
+}
+
+ULLONG
+CPlanCache::ULLGetCacheQuota()
+{
+	GPOS_ASSERT_IMP(nullptr != m_pcache,
+					m_pcache->GetCacheQuota() == m_ullCacheQuota);
+	return m_ullCacheQuota;
+}
+
+CHAR *
+CPlanCache::SzLookup(CMemoryPool *mp, const CWStringBase *input)
+{
+	GPOS_ASSERT(nullptr != m_pcache && "Plan cache was not created");
+
+	CPlanCacheKey key(input);
+	PlanCacheAccessor acc(m_pcache);
+	acc.Lookup(&key);
+
+	CCachedPlan *cached_plan = acc.Val();
+	if (nullptr == cached_plan)
+	{
+		m_ullMisses++;
+		return nullptr;
+	}
+
+	m_ullHits++;
+
+	// copy the plan out, the entry may be evicted once the accessor is gone
+	const CHAR *plan_dxl = cached_plan->PlanDXL();
+	const ULONG length = clib::Strlen(plan_dxl);
+	CHAR *result = GPOS_NEW_ARRAY(mp, CHAR, length + 1);
+	clib::Strncpy(result, plan_dxl, length + 1);
+
+	// release the reference handed out by the lookup
+	cached_plan->Release();
+
+	return result;
+}
+
+void
+CPlanCache::Insert(const CWStringBase *input, const CHAR *plan_dxl)
+{
+	GPOS_ASSERT(nullptr != m_pcache && "Plan cache was not created");
+
+	PlanCacheAccessor acc(m_pcache);
+
+	// the cached plan lives in the accessor's memory pool, which is handed
+	// over to the cache on successful insertion
+	CMemoryPool *mp = acc.Pmp();
+	CCachedPlan *cached_plan = GPOS_NEW(mp) CCachedPlan(mp, input, plan_dxl);
+
+	// if an identical entry exists already, insertion fails and the new
+	// plan is destroyed together with the accessor's memory pool
+	(void) acc.Insert(cached_plan->Key(), cached_plan);
+
+	// release our reference, the cache entry keeps the plan alive
+	cached_plan->Release();
+}
+
+ULLONG
+CPlanCache::ULLGetEntries()
+{
+	if (nullptr == m_pcache)
+	{
+		return 0;
+	}
+
+	return m_pcache->Size();
+}
+
+ULLONG
+CPlanCache::ULLGetCacheSize()
+{
+	if (nullptr == m_pcache)
+	{
+		return 0;
+	}
+
+	return m_pcache->TotalAllocatedSize();
+}
+
+ULLONG
+CPlanCache::ULLGetCacheEvictionCounter()
+{
+	if (nullptr == m_pcache)
+	{
+		return m_ullEvictions;
+	}
+
+	return m_ullEvictions + m_pcache->GetEvictionCounter();
+}
+
+// EOF
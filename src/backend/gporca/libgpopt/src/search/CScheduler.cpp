@@ -29,14 +29,12 @@ using namespace gpopt;
 //		Ctor
 //
 //---------------------------------------------------------------------------
-CScheduler::CScheduler(CMemoryPool *mp, ULONG ulJobs
+CScheduler::CScheduler(
 #ifdef GPOS_DEBUG
-					   ,
-					   BOOL fTrackingJobs
+	BOOL fTrackingJobs
 #endif	// GPOS_DEBUG
-					   )
-	: m_spjl(mp, ulJobs),
-	  m_ulpTotal(0),
+	)
+	: m_ulpTotal(0),
 	  m_ulpRunning(0),
 	  m_ulpQueued(0),
 	  m_ulpStatsQueued(0),
@@ -50,11 +48,8 @@ CScheduler::CScheduler(CMemoryPool *mp, ULONG ulJobs
 	  m_fTrackingJobs(fTrackingJobs)
 #endif	// GPOS_DEBUG
 {
-	// initialize pool of job links
-	m_spjl.Init(GPOS_OFFSET(SJobLink, m_id));
-
 	// initialize list of waiting new jobs
-	m_listjlWaiting.Init(GPOS_OFFSET(SJobLink, m_link));
+	m_listjWaiting.Init(GPOS_OFFSET(CJob, m_linkWaiting));
 
 #ifdef GPOS_DEBUG
 	// initialize list of running jobs
@@ -233,16 +228,6 @@ CScheduler::Schedule(CJob *pj)
 {
 	GPOS_ASSERT(nullptr != pj);
 
-	// get job link
-	SJobLink *pjl = m_spjl.PtRetrieve();
-
-	// throw OOM if no link can be retrieved
-	if (nullptr == pjl)
-	{
-		GPOS_OOM_CHECK(nullptr);
-	}
-	pjl->Init(pj);
-
 #ifdef GPOS_DEBUG
 	if (FTrackingJobs())
 	{
@@ -254,7 +239,7 @@ CScheduler::Schedule(CJob *pj)
 #endif	// GPOS_DEBUG
 
 	// add to waiting list
-	m_listjlWaiting.Push(pjl);
+	m_listjWaiting.Push(pj);
 
 	// increment number of queued jobs
 	m_ulpQueued++;
@@ -389,14 +374,10 @@ CJob *
 CScheduler::PjRetrieve()
 {
 	// retrieve runnable job from lists of waiting jobs
-	SJobLink *pjl = m_listjlWaiting.Pop();
-	CJob *pj = nullptr;
+	CJob *pj = m_listjWaiting.Pop();
 
-	if (nullptr != pjl)
+	if (nullptr != pj)
 	{
-		pj = pjl->m_pj;
-
-		GPOS_ASSERT(nullptr != pj);
 		GPOS_ASSERT(0 == pj->UlpRefs());
 
 		// decrement number of queued jobs
@@ -405,9 +386,6 @@ CScheduler::PjRetrieve()
 		// update statistics
 		m_ulpStatsDequeued++;
 
-		// recycle job link
-		m_spjl.Recycle(pjl);
-
 #ifdef GPOS_DEBUG
 		// add job to running list
 		if (FTrackingJobs())
@@ -598,11 +576,11 @@ CScheduler::OsPrintActiveJobs(IOstream &os)
 
 	os << std::endl << "List of waiting jobs: " << std::endl;
 
-	SJobLink *pjl = m_listjlWaiting.PtFirst();
-	while (nullptr != pjl)
+	pj = m_listjWaiting.PtFirst();
+	while (nullptr != pj)
 	{
-		pjl->m_pj->OsPrint(os);
-		pjl = m_listjlWaiting.Next(pjl);
+		pj->OsPrint(os);
+		pj = m_listjWaiting.Next(pj);
 	}
 
 	os << std::endl << "List of suspended jobs: " << std::endl;
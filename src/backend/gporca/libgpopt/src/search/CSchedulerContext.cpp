@@ -76,7 +76,11 @@ CSchedulerContext::Init(CMemoryPool *pmpGlobal, CJobFactory *pjf,
 
 	GPOS_ASSERT(!FInit() && "Scheduling context is already initialized");
 
-	m_pmpLocal = CMemoryPoolManager::CreateMemoryPool();
+	// scratch memory of the search jobs: many small, short-lived objects
+	// that are all released together with the scheduling context; inside
+	// the server this is a palloc based pool like all others
+	m_pmpLocal =
+		CMemoryPoolManager::CreateMemoryPool(CMemoryPoolManager::EmpkSlab);
 
 	m_pmpGlobal = pmpGlobal;
 	m_pjf = pjf;
@@ -73,6 +73,7 @@ CJoinOrderDPv2::CJoinOrderDPv2(CMemoryPool *mp,
 	  m_on_pred_conjuncts(onPredConjuncts),
 	  m_child_pred_indexes(childPredIndexes),
 	  m_non_inner_join_dependencies(nullptr),
+	  m_atom_neighbors(nullptr),
 	  m_cross_prod_penalty(GPOPT_DPV2_CROSS_JOIN_DEFAULT_PENALTY),
 	  m_outer_refs(outerRefs)
 {
@@ -135,6 +136,29 @@ CJoinOrderDPv2::CJoinOrderDPv2(CMemoryPool *mp,
 			}
 		}
 	}
+
+	// compute the neighbors of each atom in the join graph, this lets us
+	// recognize cross products without looking at the individual edges
+	m_atom_neighbors = GPOS_NEW(mp) CBitSetArray(mp, m_ulComps);
+	for (ULONG ul = 0; ul < m_ulComps; ul++)
+	{
+		m_atom_neighbors->Append(GPOS_NEW(mp) CBitSet(mp));
+	}
+
+	for (ULONG en = 0; en < m_ulEdges; en++)
+	{
+		SEdge *pedge = m_rgpedge[en];
+
+		if (0 == pedge->m_loj_num)
+		{
+			CBitSetIter bsi(*pedge->m_pbs);
+			while (bsi.Advance())
+			{
+				(*m_atom_neighbors)[bsi.Bit()]->Union(pedge->m_pbs);
+			}
+		}
+	}
+
 	PopulateExpressionToEdgeMapIfNeeded();
 }
 
@@ -153,6 +177,7 @@ CJoinOrderDPv2::~CJoinOrderDPv2()
 	// we can save time in optimized build by skipping all de-allocations here,
 	// we still have all de-allocations enabled in debug-build to detect any possible leaks
 	CRefCount::SafeRelease(m_non_inner_join_dependencies);
+	m_atom_neighbors->Release();
 	CRefCount::SafeRelease(m_child_pred_indexes);
 	m_bitset_to_group_info_map->Release();
 	CRefCount::SafeRelease(m_expression_to_edge_map);
@@ -346,10 +371,15 @@ CJoinOrderDPv2::GetJoinExpr(const SGroupAndExpression &left_child_expr,
 
 	if (!isLOJ)
 	{
-		// inner join, compute the predicate from the join graph
+		// inner join, compute the predicate from the join graph, unless no
+		// edge connects the two groups and this is a cross product
 		GPOS_ASSERT(nullptr == scalar_expr);
-		scalar_expr = PexprBuildInnerJoinPred(left_group_info->m_atoms,
-											  right_group_info->m_atoms);
+		if (!left_group_info->m_neighbors->IsDisjoint(
+				right_group_info->m_atoms))
+		{
+			scalar_expr = PexprBuildInnerJoinPred(left_group_info->m_atoms,
+												  right_group_info->m_atoms);
+		}
 	}
 	else
 	{
@@ -1298,6 +1328,12 @@ CJoinOrderDPv2::LookupOrCreateGroupInfo(SLevelInfo *levelInfo, CBitSet *atoms,
 	{
 		// this is a group we haven't seen yet, create a new group info and derive stats, if needed
 		group_info = GPOS_NEW(m_mp) SGroupInfo(m_mp, atoms);
+
+		CBitSetIter bsi(*atoms);
+		while (bsi.Advance())
+		{
+			group_info->m_neighbors->Union((*m_atom_neighbors)[bsi.Bit()]);
+		}
 		if (!stats_expr_info->m_properties.Satisfies(EJoinOrderStats))
 		{
 			SExpressionProperties stats_props(EJoinOrderStats);
@@ -6,18 +6,16 @@
 //		CBitSet.h
 //
 //	@doc:
-//		Implementation of bitset as linked list of bitvectors
+//		Implementation of bitset as a dense array of words
 //---------------------------------------------------------------------------
 #ifndef GPOS_CBitSet_H
 #define GPOS_CBitSet_H
 
 #include "gpos/base.h"
-#include "gpos/common/CBitVector.h"
 #include "gpos/common/CDynamicPtrArray.h"
 #include "gpos/common/CList.h"
 #include "gpos/common/DbgPrintMixin.h"
 
-
 namespace gpos
 {
 //---------------------------------------------------------------------------
@@ -25,7 +23,14 @@ namespace gpos
 //		CBitSet
 //
 //	@doc:
-//		Linked list of CBitSetLink's
+//		Bit set stored as one contiguous array of 64-bit words that covers
+//		the range of set bits; the range grows as bits are added and is
+//		never shrunk. Bulk operations (union, intersection, subset tests,
+//		counting) are word-at-a-time loops over the overlapping part of
+//		two sets.
+//
+//		The vector size given at construction is the granularity, in bits,
+//		at which the range is extended; it is rounded up to whole words.
 //
 //---------------------------------------------------------------------------
 class CBitSet : public CRefCount, public DbgPrintMixin<CBitSet>
@@ -34,61 +39,23 @@ class CBitSet : public CRefCount, public DbgPrintMixin<CBitSet>
 	friend class CBitSetIter;
 
 protected:
-	//---------------------------------------------------------------------------
-	//	@class:
-	//		CBitSetLink
-	//
-	//	@doc:
-	//		bit vector + offset + link
-	//
-	//---------------------------------------------------------------------------
-	class CBitSetLink
-	{
-	private:
-		// offset
-		ULONG m_offset;
-
-		// bitvector
-		CBitVector *m_vec;
-
-	public:
-		CBitSetLink(const CBitSetLink &) = delete;
-
-		// ctor
-		explicit CBitSetLink(CMemoryPool *, ULONG offset, ULONG vector_size);
-
-		explicit CBitSetLink(CMemoryPool *, const CBitSetLink &);
-
-		// dtor
-		~CBitSetLink();
-
-		// accessor
-		ULONG
-		GetOffset() const
-		{
-			return m_offset;
-		}
+	// pool to allocate words from
+	CMemoryPool *m_mp;
 
-		// accessor
-		CBitVector *
-		GetVec() const
-		{
-			return m_vec;
-		}
+	// granularity of the word range, in bits
+	ULONG m_vector_size;
 
-		// list link
-		SLink m_link;
+	// granularity of the word range, in words
+	ULONG m_chunk_words;
 
-	};	// class CBitSetLink
+	// words covering the range of the set; null if the range is empty
+	ULLONG *m_words;
 
-	// list of bit set links
-	CList<CBitSetLink> m_bsllist;
+	// index of the first word in the range
+	ULONG m_first_word;
 
-	// pool to allocate links from
-	CMemoryPool *m_mp;
-
-	// size of individual bitvectors
-	ULONG m_vector_size;
+	// number of words in the range
+	ULONG m_num_words;
 
 	// number of elements
 	ULONG m_size;
@@ -96,18 +63,53 @@ protected:
 	// private copy ctor
 	CBitSet(const CBitSet &);
 
-	// find link with offset less or equal to given value
-	CBitSetLink *FindLinkByOffset(ULONG, CBitSetLink * = nullptr) const;
+	// index of the word past the range
+	ULONG
+	EndWord() const
+	{
+		return m_first_word + m_num_words;
+	}
+
+	// range of words of the set that contain set bits
+	void TrimmedRange(ULONG *first_word, ULONG *end_word) const;
+
+	// extend the range of words to include the given range
+	void Extend(ULONG first_word, ULONG end_word);
+
+	// find next set bit at or after the given position
+	BOOL GetNextSetBit(ULONG start_pos, ULONG &next_pos) const;
 
 	// reset set
 	void Clear();
 
-	// compute target offset
-	ULONG ComputeOffset(ULONG) const;
-
 	// re-compute size of set
 	void RecomputeSize();
 
+	// word kernels
+
+	// number of bits set
+	static ULONG CountBits(const ULLONG *words, ULONG num_words);
+
+	// are all words zero
+	static BOOL AreZero(const ULLONG *words, ULONG num_words);
+
+	// dst |= src
+	static void Or(ULLONG *dst, const ULLONG *src, ULONG num_words);
+
+	// dst &= src
+	static void And(ULLONG *dst, const ULLONG *src, ULONG num_words);
+
+	// dst &= ~src
+	static void AndNot(ULLONG *dst, const ULLONG *src, ULONG num_words);
+
+	// is (sub & ~super) zero
+	static BOOL IsSubset(const ULLONG *sub, const ULLONG *super,
+						 ULONG num_words);
+
+	// is (left & right) zero
+	static BOOL AreDisjoint(const ULLONG *left, const ULLONG *right,
+							ULONG num_words);
+
 public:
 	// ctor
 	CBitSet(CMemoryPool *mp, ULONG vector_size = 256);
@@ -61,7 +61,9 @@ public:
 	CAutoMemoryPool(const CAutoMemoryPool &) = delete;
 
 	// ctor
-	CAutoMemoryPool(ELeakCheck leak_check_type = ElcExc);
+	CAutoMemoryPool(ELeakCheck leak_check_type = ElcExc,
+					CMemoryPoolManager::EMemoryPoolKind kind =
+						CMemoryPoolManager::EmpkGeneral);
 
 	// FIXME: should mark this noexcept in non-assert builds
 	// dtor
@@ -77,6 +77,9 @@ public:
 	using HashFuncPtr = ULONG (*)(const K &);
 	using EqualFuncPtr = BOOL (*)(const K &, const K &);
 
+	// type definition of a predicate selecting keys to invalidate
+	using InvalidateFuncPtr = BOOL (*)(const K &, void *);
+
 private:
 	using CCacheHashTableEntry = CCacheEntry<T, K>;
 
@@ -252,6 +255,7 @@ private:
 				// remove entry from hash table
 				acc.Remove(entry);
 				deleted = true;
+				m_cache_size -= entry->Pmp()->TotalAllocatedSize();
 			}
 		}
 
@@ -507,6 +511,59 @@ public:
 		}
 	}
 
+	// Remove all entries whose key satisfies the given predicate. Entries
+	// that are still held by an accessor are marked for deletion and are
+	// removed when the last accessor releases them. Returns the number of
+	// invalidated entries.
+	ULLONG
+	InvalidateEntries(InvalidateFuncPtr pfInvalidate, void *context)
+	{
+		GPOS_ASSERT(nullptr != pfInvalidate);
+
+		ULLONG num_invalidated = 0;
+		CCacheHashtableIter iter(m_hash_table);
+		BOOL advanced = false;
+
+		while (advanced || iter.Advance())
+		{
+			advanced = false;
+			CCacheHashTableEntry *entry = nullptr;
+			BOOL deleted = false;
+			// Scope for CCacheHashtableIterAccessor
+			{
+				CCacheHashtableIterAccessor acc(iter);
+
+				if (nullptr != (entry = acc.Value()) &&
+					!entry->IsMarkedForDeletion() &&
+					pfInvalidate(entry->Key(), context))
+				{
+					num_invalidated++;
+
+					if (EXPECTED_REF_COUNT_FOR_DELETE == entry->RefCount())
+					{
+						// remove advances iterator automatically
+						acc.Remove(entry);
+						deleted = true;
+						advanced = true;
+						m_cache_size -= entry->Pmp()->TotalAllocatedSize();
+					}
+					else
+					{
+						entry->MarkForDeletion();
+					}
+				}
+			}
+
+			if (deleted)
+			{
+				GPOS_ASSERT(nullptr != entry);
+				DestroyCacheEntry(entry);
+			}
+		}
+
+		return num_invalidated;
+	}
+
 	// return eviction factor (what percentage of cache size to evict)
 	float
 	GetEvictionFactor()
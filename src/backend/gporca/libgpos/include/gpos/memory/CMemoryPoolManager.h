@@ -59,8 +59,24 @@ private:
 	// global instance
 	static CMemoryPoolManager *m_memory_pool_mgr;
 
-	// create new pool of given type
-	virtual CMemoryPool *NewMemoryPool();
+public:
+	// kinds of memory pools that can be requested from the manager
+	enum EMemoryPoolKind
+	{
+		// general purpose pool, with statistics and leak checking
+		EmpkGeneral = 0,
+
+		// pool for many small objects that are released together; managers
+		// that don't support it, such as the palloc based one used inside
+		// the server, create their usual pools instead
+		EmpkSlab,
+
+		EmpkSentinel
+	};
+
+private:
+	// create new pool of given kind
+	virtual CMemoryPool *NewMemoryPool(EMemoryPoolKind kind);
 
 	// clean-up memory pools
 	static void Cleanup();
@@ -116,7 +132,7 @@ public:
 	CMemoryPoolManager(const CMemoryPoolManager &) = delete;
 
 	// create new memory pool
-	static CMemoryPool *CreateMemoryPool();
+	static CMemoryPool *CreateMemoryPool(EMemoryPoolKind kind = EmpkGeneral);
 
 	// release memory pool
 	static void Destroy(CMemoryPool *);
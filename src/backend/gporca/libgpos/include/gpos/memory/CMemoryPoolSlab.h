@@ -0,0 +1,162 @@
+//---------------------------------------------------------------------------
+//	Greenplum Database
+//	Copyright (C) 2024 VMware, Inc. or its affiliates.
+//
+//	@filename:
+//		CMemoryPoolSlab.h
+//
+//	@doc:
+//		Memory pool that carves small allocations out of large chunks,
+//		keeping freed ones in per-size-class free lists, and releases
+//		all its memory at once when it is destroyed
+//---------------------------------------------------------------------------
+#ifndef GPOS_CMemoryPoolSlab_H
+#define GPOS_CMemoryPoolSlab_H
+
+#include "gpos/assert.h"
+#include "gpos/common/CList.h"
+#include "gpos/memory/CMemoryPool.h"
+#include "gpos/memory/CMemoryPoolTracker.h"
+#include "gpos/types.h"
+
+// smallest and largest slab object, including the allocation tag
+#define GPOS_MEM_SLAB_MIN_OBJECT_SIZE (32)
+#define GPOS_MEM_SLAB_MAX_OBJECT_SIZE (1024)
+
+// size classes grow in steps of 16 bytes up to this size, then 64 bytes
+#define GPOS_MEM_SLAB_SMALL_OBJECT_SIZE (256)
+
+#define GPOS_MEM_SLAB_SIZE_CLASSES                                           \
+	((GPOS_MEM_SLAB_SMALL_OBJECT_SIZE - GPOS_MEM_SLAB_MIN_OBJECT_SIZE) / 16 + \
+	 (GPOS_MEM_SLAB_MAX_OBJECT_SIZE - GPOS_MEM_SLAB_SMALL_OBJECT_SIZE) / 64 + 1)
+
+// size of the first chunk; chunks double in size up to the maximum
+#define GPOS_MEM_SLAB_MIN_CHUNK_SIZE (8 * 1024)
+#define GPOS_MEM_SLAB_MAX_CHUNK_SIZE (1024 * 1024)
+
+namespace gpos
+{
+//---------------------------------------------------------------------------
+//	@class:
+//		CMemoryPoolSlab
+//
+//	@doc:
+//		Memory pool for the many small objects created while optimizing a
+//		query. Allocations up to GPOS_MEM_SLAB_MAX_OBJECT_SIZE are rounded up
+//		to a size class and bump-allocated from chunks obtained from malloc();
+//		freed objects are kept in a free list per size class for reuse.
+//		Larger allocations are passed on to malloc().
+//
+//		Unlike CMemoryPoolTracker, the pool keeps no per-allocation list, no
+//		statistics and no debugging information beyond the allocation type,
+//		so it doesn't support leak checking. Tearing the pool down frees its
+//		chunks, independent of the number of objects allocated from them.
+//
+//---------------------------------------------------------------------------
+class CMemoryPoolSlab : public CMemoryPool
+{
+private:
+	using SAllocTag = CMemoryPoolTracker::SAllocTag;
+
+	// header of a chunk that slab objects are carved from
+	struct SChunk
+	{
+		// next chunk of the pool
+		SChunk *m_next;
+	};
+
+	// header of an allocation too large for a slab
+	struct SLargeAllocHeader
+	{
+		// link for allocation list
+		SLink m_link;
+
+		// total allocation size (including headers)
+		ULONG m_alloc_size;
+
+		// pool and size, must be last
+		SAllocTag m_tag;
+	};
+
+	// a freed slab object; overlays the user data
+	struct SFreeObject
+	{
+		// next free object of the same size class
+		SFreeObject *m_next;
+	};
+
+	// size class marker of allocations too large for a slab
+	static const ULONG LargeAlloc = GPOS_MEM_SLAB_SIZE_CLASSES;
+
+	// free lists, one per size class
+	SFreeObject *m_free_lists[GPOS_MEM_SLAB_SIZE_CLASSES];
+
+	// chunks allocated so far, most recent first
+	SChunk *m_chunks{nullptr};
+
+	// unused part of the most recent chunk
+	BYTE *m_bump_pos{nullptr};
+	BYTE *m_bump_end{nullptr};
+
+	// size of the next chunk
+	ULONG m_next_chunk_size{GPOS_MEM_SLAB_MIN_CHUNK_SIZE};
+
+	// list of live large allocations
+	CList<SLargeAllocHeader> m_large_allocs;
+
+	// memory obtained from malloc()
+	ULLONG m_total_size{0};
+
+	// size class of an object of the given size, including the tag
+	static ULONG SizeClass(ULONG object_size);
+
+	// object size of the given size class
+	static ULONG ObjectSize(ULONG size_class);
+
+	// allocate a new chunk, large enough for an object of the given size
+	void AddChunk(ULONG object_size);
+
+	// allocate a slab object of the given size class
+	SAllocTag *PtagNewObject(ULONG size_class);
+
+	// allocate a large object of the given size, including the tag
+	SAllocTag *PtagNewLargeAlloc(ULONG object_size);
+
+	// release a slab object
+	void FreeObject(void *ptr, ULONG size_class);
+
+	// release a large object
+	void FreeLargeAlloc(SLargeAllocHeader *header);
+
+protected:
+	// dtor
+	~CMemoryPoolSlab() override;
+
+public:
+	CMemoryPoolSlab(CMemoryPoolSlab &) = delete;
+
+	// ctor
+	CMemoryPoolSlab();
+
+	// prepare the memory pool to be deleted
+	void TearDown() override;
+
+	// allocate memory
+	void *NewImpl(const ULONG bytes, const CHAR *file, const ULONG line,
+				  CMemoryPool::EAllocationType eat) override;
+
+	// free memory allocation
+	static void DeleteImpl(void *ptr, EAllocationType eat);
+
+	// return total allocated size
+	ULLONG
+	TotalAllocatedSize() const override
+	{
+		return m_total_size;
+	}
+};
+}  // namespace gpos
+
+#endif	// !GPOS_CMemoryPoolSlab_H
+
+// EOF
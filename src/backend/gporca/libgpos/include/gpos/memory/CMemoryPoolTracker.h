@@ -31,20 +31,33 @@ namespace gpos
 // memory pool with statistics and debugging support
 class CMemoryPoolTracker : public CMemoryPool
 {
-private:
-	// Defines memory block header layout for all allocations;
-	// does not include the pointer to the pool;
-	struct SAllocHeader
+public:
+	// Trailing part of the header of all allocations made by pools of the
+	// default memory pool manager (CMemoryPoolTracker and CMemoryPoolSlab);
+	// immediately precedes the user data so that the manager can find the
+	// pool that has to free an allocation
+	struct SAllocTag
 	{
 		// pointer to pool
-		CMemoryPoolTracker *m_mp;
-
-		// total allocation size (including headers)
-		ULONG m_alloc_size;
+		CMemoryPool *m_mp;
 
 		// user requested size
 		ULONG m_user_size;
 
+		// size class for slab allocations, TrackerAlloc for tracker ones
+		ULONG m_size_class;
+	};
+
+	// size class marker of allocations made by a tracker pool
+	static const ULONG TrackerAlloc = gpos::ulong_max;
+
+private:
+	// Defines memory block header layout for all allocations
+	struct SAllocHeader
+	{
+		// total allocation size (including headers)
+		ULONG m_alloc_size;
+
 		// sequence number
 		ULLONG m_serial;
 
@@ -61,6 +74,9 @@ private:
 
 		// link for allocation list
 		SLink m_link;
+
+		// pool and size, must be last
+		SAllocTag m_tag;
 	};
 
 	// statistics
@@ -101,6 +117,13 @@ public:
 	// get user requested size of allocation
 	static ULONG UserSizeOfAlloc(const void *ptr);
 
+	// get the tag of an allocation
+	static const SAllocTag *
+	PtagOfAlloc(const void *ptr)
+	{
+		return static_cast<const SAllocTag *>(ptr) - 1;
+	}
+
 	// return total allocated size
 	ULLONG
 	TotalAllocatedSize() const override
@@ -31,7 +31,10 @@ public:
 	static GPOS_RESULT EresUnittest_Basics();
 	static GPOS_RESULT EresUnittest_Removal();
 	static GPOS_RESULT EresUnittest_SetOps();
+	static GPOS_RESULT EresUnittest_Iterator();
+	static GPOS_RESULT EresUnittest_Random();
 	static GPOS_RESULT EresUnittest_Performance();
+	static GPOS_RESULT EresUnittest_JoinOrderPerformance();
 
 };	// class CBitSetTest
 }  // namespace gpos
@@ -83,6 +83,9 @@ private:
 	// tests if cache eviction works for a single cache size
 	static void TestEvictionForOneCacheSize(ULLONG ullCacheQuota);
 
+	// invalidation predicate selecting even keys
+	static BOOL FInvalidateEvenKeys(ULONG *const &pvKey, void *context);
+
 
 	// An object with a deep structure
 	class CDeepObject : public CRefCount
@@ -157,6 +160,7 @@ public:
 	static GPOS_RESULT EresUnittest_DeepObject();
 	static GPOS_RESULT EresUnittest_Iteration();
 	static GPOS_RESULT EresUnittest_IterativeDeletion();
+	static GPOS_RESULT EresUnittest_Invalidation();
 
 
 };	// class CCacheTest
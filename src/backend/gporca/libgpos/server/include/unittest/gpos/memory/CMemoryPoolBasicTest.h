@@ -31,6 +31,9 @@ private:
 
 	static GPOS_RESULT EresNewDelete();
 	static GPOS_RESULT EresThrowingCtor();
+	static GPOS_RESULT EresSlabNewDelete();
+	static GPOS_RESULT EresSlabThrowingCtor();
+	static void AllocFreeMix(CMemoryPool *mp, ULONG num_allocs);
 #ifdef GPOS_DEBUG
 	static GPOS_RESULT EresLeak();
 	static GPOS_RESULT EresLeakByException();
@@ -46,6 +49,7 @@ public:
 #endif	// GPOS_DEBUG
 	static GPOS_RESULT EresUnittest_TestTracker();
 	static GPOS_RESULT EresUnittest_TestSlab();
+	static GPOS_RESULT EresUnittest_Benchmark();
 
 };	// class CMemoryPoolBasicTest
 }  // namespace gpos
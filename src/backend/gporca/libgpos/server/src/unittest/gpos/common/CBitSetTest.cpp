@@ -12,7 +12,10 @@
 #include "unittest/gpos/common/CBitSetTest.h"
 
 #include "gpos/base.h"
+#include "gpos/common/CAutoTimer.h"
 #include "gpos/common/CBitSet.h"
+#include "gpos/common/CBitSetIter.h"
+#include "gpos/common/CRandom.h"
 #include "gpos/io/COstreamString.h"
 #include "gpos/memory/CAutoMemoryPool.h"
 #include "gpos/string/CWStringDynamic.h"
@@ -35,7 +38,10 @@ CBitSetTest::EresUnittest()
 		GPOS_UNITTEST_FUNC(CBitSetTest::EresUnittest_Basics),
 		GPOS_UNITTEST_FUNC(CBitSetTest::EresUnittest_Removal),
 		GPOS_UNITTEST_FUNC(CBitSetTest::EresUnittest_SetOps),
-		GPOS_UNITTEST_FUNC(CBitSetTest::EresUnittest_Performance)};
+		GPOS_UNITTEST_FUNC(CBitSetTest::EresUnittest_Iterator),
+		GPOS_UNITTEST_FUNC(CBitSetTest::EresUnittest_Random),
+		GPOS_UNITTEST_FUNC(CBitSetTest::EresUnittest_Performance),
+		GPOS_UNITTEST_FUNC(CBitSetTest::EresUnittest_JoinOrderPerformance)};
 
 	return CUnittest::EresExecute(rgut, GPOS_ARRAY_SIZE(rgut));
 }
@@ -221,6 +227,170 @@ CBitSetTest::EresUnittest_SetOps()
 }
 
 
+//---------------------------------------------------------------------------
+//	@function:
+//		CBitSetTest::EresUnittest_Iterator
+//
+//	@doc:
+//		Iterate over sets with bits far apart and at word boundaries
+//
+//---------------------------------------------------------------------------
+GPOS_RESULT
+CBitSetTest::EresUnittest_Iterator()
+{
+	// create memory pool
+	CAutoMemoryPool amp;
+	CMemoryPool *mp = amp.Pmp();
+
+	const ULONG rgulBits[] = {0, 1, 63, 64, 65, 127, 128, 999, 1000, 4095, 70000};
+
+	// vector sizes below, at and above a word, and not a multiple of a word
+	const ULONG rgulVectorSizes[] = {1, 37, 64, 256, 1024};
+
+	for (ULONG ulSize = 0; ulSize < GPOS_ARRAY_SIZE(rgulVectorSizes); ulSize++)
+	{
+		CBitSet *pbs = GPOS_NEW(mp) CBitSet(mp, rgulVectorSizes[ulSize]);
+
+		// insert in descending order to grow the set at the front
+		for (ULONG ul = GPOS_ARRAY_SIZE(rgulBits); ul > 0; ul--)
+		{
+			GPOS_UNITTEST_ASSERT(!pbs->ExchangeSet(rgulBits[ul - 1]));
+		}
+		GPOS_UNITTEST_ASSERT(GPOS_ARRAY_SIZE(rgulBits) == pbs->Size());
+
+		ULONG ul = 0;
+		CBitSetIter bsi(*pbs);
+		while (bsi.Advance())
+		{
+			GPOS_UNITTEST_ASSERT(ul < GPOS_ARRAY_SIZE(rgulBits));
+			GPOS_UNITTEST_ASSERT(rgulBits[ul] == bsi.Bit());
+			ul++;
+		}
+		GPOS_UNITTEST_ASSERT(GPOS_ARRAY_SIZE(rgulBits) == ul);
+
+		// a copy is equal, has the same hash value and iterates the same way
+		CBitSet *pbsCopy = GPOS_NEW(mp) CBitSet(mp, *pbs);
+		GPOS_UNITTEST_ASSERT(pbsCopy->Equals(pbs));
+		GPOS_UNITTEST_ASSERT(pbsCopy->HashValue() == pbs->HashValue());
+
+		// clearing the largest bit leaves an equal set with a different extent
+		(void) pbs->ExchangeSet(100000);
+		(void) pbs->ExchangeClear(100000);
+		GPOS_UNITTEST_ASSERT(pbsCopy->Equals(pbs) && pbs->Equals(pbsCopy));
+		GPOS_UNITTEST_ASSERT(pbsCopy->HashValue() == pbs->HashValue());
+		GPOS_UNITTEST_ASSERT(pbs->ContainsAll(pbsCopy) &&
+							 pbsCopy->ContainsAll(pbs));
+
+		pbsCopy->Release();
+		pbs->Release();
+	}
+
+	return GPOS_OK;
+}
+
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CBitSetTest::EresUnittest_Random
+//
+//	@doc:
+//		Compare set operations on random sets against a plain bool array
+//
+//---------------------------------------------------------------------------
+GPOS_RESULT
+CBitSetTest::EresUnittest_Random()
+{
+	// create memory pool
+	CAutoMemoryPool amp;
+	CMemoryPool *mp = amp.Pmp();
+
+	const ULONG ulBits = 600;
+	const ULONG ulRounds = 200;
+	CRandom rand(1);
+
+	for (ULONG ulRound = 0; ulRound < ulRounds; ulRound++)
+	{
+		BOOL rgf1[ulBits];
+		BOOL rgf2[ulBits];
+		CBitSet *pbs1 = GPOS_NEW(mp) CBitSet(mp, 128);
+		CBitSet *pbs2 = GPOS_NEW(mp) CBitSet(mp, 128);
+
+		// sets are dense or sparse, and cover all or a part of the range
+		ULONG ulDensity = 1 + rand.Next() % 32;
+		ULONG ulStart = rand.Next() % ulBits;
+		for (ULONG ul = 0; ul < ulBits; ul++)
+		{
+			rgf1[ul] = (0 == rand.Next() % ulDensity);
+			rgf2[ul] = (ul >= ulStart && 0 == rand.Next() % ulDensity);
+			if (rgf1[ul])
+			{
+				(void) pbs1->ExchangeSet(ul);
+			}
+			if (rgf2[ul])
+			{
+				(void) pbs2->ExchangeSet(ul);
+			}
+		}
+
+		BOOL fDisjoint = true;
+		BOOL fContainsAll = true;
+		ULONG ulUnion = 0;
+		ULONG ulIntersection = 0;
+		ULONG ulDifference = 0;
+		for (ULONG ul = 0; ul < ulBits; ul++)
+		{
+			fDisjoint = fDisjoint && !(rgf1[ul] && rgf2[ul]);
+			fContainsAll = fContainsAll && (rgf1[ul] || !rgf2[ul]);
+			ulUnion += (rgf1[ul] || rgf2[ul]);
+			ulIntersection += (rgf1[ul] && rgf2[ul]);
+			ulDifference += (rgf1[ul] && !rgf2[ul]);
+		}
+
+		GPOS_UNITTEST_ASSERT(fDisjoint == pbs1->IsDisjoint(pbs2));
+		GPOS_UNITTEST_ASSERT(fContainsAll == pbs1->ContainsAll(pbs2));
+
+		CBitSet *pbsUnion = GPOS_NEW(mp) CBitSet(mp, *pbs1);
+		pbsUnion->Union(pbs2);
+		CBitSet *pbsIntersection = GPOS_NEW(mp) CBitSet(mp, *pbs1);
+		pbsIntersection->Intersection(pbs2);
+		CBitSet *pbsDifference = GPOS_NEW(mp) CBitSet(mp, *pbs1);
+		pbsDifference->Difference(pbs2);
+
+		GPOS_UNITTEST_ASSERT(ulUnion == pbsUnion->Size());
+		GPOS_UNITTEST_ASSERT(ulIntersection == pbsIntersection->Size());
+		GPOS_UNITTEST_ASSERT(ulDifference == pbsDifference->Size());
+
+		for (ULONG ul = 0; ul < ulBits; ul++)
+		{
+			GPOS_UNITTEST_ASSERT(rgf1[ul] == pbs1->Get(ul));
+			GPOS_UNITTEST_ASSERT((rgf1[ul] || rgf2[ul]) == pbsUnion->Get(ul));
+			GPOS_UNITTEST_ASSERT((rgf1[ul] && rgf2[ul]) ==
+								 pbsIntersection->Get(ul));
+			GPOS_UNITTEST_ASSERT((rgf1[ul] && !rgf2[ul]) ==
+								 pbsDifference->Get(ul));
+		}
+
+		GPOS_UNITTEST_ASSERT(pbsUnion->ContainsAll(pbs1) &&
+							 pbsUnion->ContainsAll(pbs2));
+		GPOS_UNITTEST_ASSERT(pbs1->ContainsAll(pbsIntersection));
+		GPOS_UNITTEST_ASSERT(pbsDifference->IsDisjoint(pbs2));
+
+		// (A - B) + (A * B) = A
+		pbsDifference->Union(pbsIntersection);
+		GPOS_UNITTEST_ASSERT(pbsDifference->Equals(pbs1));
+		GPOS_UNITTEST_ASSERT(pbsDifference->HashValue() == pbs1->HashValue());
+
+		pbsDifference->Release();
+		pbsIntersection->Release();
+		pbsUnion->Release();
+		pbs2->Release();
+		pbs1->Release();
+	}
+
+	return GPOS_OK;
+}
+
+
 //---------------------------------------------------------------------------
 //	@function:
 //		CBitSetTest::EresUnittest_Performance
@@ -262,4 +432,105 @@ CBitSetTest::EresUnittest_Performance()
 	return GPOS_OK;
 }
 
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CBitSetTest::EresUnittest_JoinOrderPerformance
+//
+//	@doc:
+//		Simple perf test -- simulates the set operations of join order
+//		enumeration: for all pairs of disjoint subsets of a set of atoms,
+//		union their atoms and the column references of the atoms, and
+//		check the columns of a join predicate against the result
+//
+//---------------------------------------------------------------------------
+GPOS_RESULT
+CBitSetTest::EresUnittest_JoinOrderPerformance()
+{
+	// create memory pool
+	CAutoMemoryPool amp;
+	CMemoryPool *mp = amp.Pmp();
+
+	const ULONG ulAtoms = 10;
+	const ULONG ulColsPerAtom = 12;
+	const ULONG ulSubsets = 1 << ulAtoms;
+
+	// atom subsets and the columns they produce; columns are numbered as
+	// column references are, sparse and mostly increasing
+	CBitSet *rgpbsAtoms[ulSubsets];
+	CBitSet *rgpbsCols[ulSubsets];
+	for (ULONG ulSubset = 0; ulSubset < ulSubsets; ulSubset++)
+	{
+		rgpbsAtoms[ulSubset] = GPOS_NEW(mp) CBitSet(mp);
+		rgpbsCols[ulSubset] = GPOS_NEW(mp) CBitSet(mp, 1024);
+		for (ULONG ulAtom = 0; ulAtom < ulAtoms; ulAtom++)
+		{
+			if (0 == (ulSubset & (1 << ulAtom)))
+			{
+				continue;
+			}
+
+			(void) rgpbsAtoms[ulSubset]->ExchangeSet(ulAtom);
+			for (ULONG ulCol = 0; ulCol < ulColsPerAtom; ulCol++)
+			{
+				(void) rgpbsCols[ulSubset]->ExchangeSet(
+					100 + ulAtom * 97 + ulCol * 3);
+			}
+		}
+	}
+
+	// predicate columns referencing two neighboring atoms
+	CBitSet *pbsPred = GPOS_NEW(mp) CBitSet(mp, 1024);
+	(void) pbsPred->ExchangeSet(100 + 3 * 97);
+	(void) pbsPred->ExchangeSet(100 + 4 * 97 + 3);
+
+	ULONG ulJoins = 0;
+	ULONG ulPreds = 0;
+	{
+		CAutoTimer at("Join order bit set operations", true /*fPrint*/);
+
+		for (ULONG ulLeft = 1; ulLeft < ulSubsets; ulLeft++)
+		{
+			for (ULONG ulRight = 1; ulRight < ulSubsets; ulRight += 3)
+			{
+				if (!rgpbsAtoms[ulLeft]->IsDisjoint(rgpbsAtoms[ulRight]))
+				{
+					continue;
+				}
+
+				CBitSet *pbsJoin = GPOS_NEW(mp) CBitSet(mp, *rgpbsAtoms[ulLeft]);
+				pbsJoin->Union(rgpbsAtoms[ulRight]);
+
+				CBitSet *pbsJoinCols =
+					GPOS_NEW(mp) CBitSet(mp, *rgpbsCols[ulLeft]);
+				pbsJoinCols->Union(rgpbsCols[ulRight]);
+
+				if (pbsJoinCols->ContainsAll(pbsPred) &&
+					!rgpbsCols[ulLeft]->ContainsAll(pbsPred) &&
+					!rgpbsCols[ulRight]->ContainsAll(pbsPred))
+				{
+					ulPreds++;
+				}
+
+				GPOS_ASSERT(pbsJoin->Equals(rgpbsAtoms[ulLeft | ulRight]));
+				ulJoins++;
+
+				pbsJoinCols->Release();
+				pbsJoin->Release();
+			}
+		}
+	}
+
+	GPOS_UNITTEST_ASSERT(0 < ulJoins && 0 < ulPreds);
+
+	pbsPred->Release();
+	for (ULONG ulSubset = 0; ulSubset < ulSubsets; ulSubset++)
+	{
+		rgpbsCols[ulSubset]->Release();
+		rgpbsAtoms[ulSubset]->Release();
+	}
+
+	return GPOS_OK;
+}
+
 // EOF
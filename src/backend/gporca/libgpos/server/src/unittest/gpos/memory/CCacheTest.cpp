@@ -47,7 +47,8 @@ CCacheTest::EresUnittest()
 		GPOS_UNITTEST_FUNC(CCacheTest::EresUnittest_Eviction),
 		GPOS_UNITTEST_FUNC(CCacheTest::EresUnittest_Iteration),
 		GPOS_UNITTEST_FUNC(CCacheTest::EresUnittest_DeepObject),
-		GPOS_UNITTEST_FUNC(CCacheTest::EresUnittest_IterativeDeletion)};
+		GPOS_UNITTEST_FUNC(CCacheTest::EresUnittest_IterativeDeletion),
+		GPOS_UNITTEST_FUNC(CCacheTest::EresUnittest_Invalidation)};
 
 	fUnique = true;
 	GPOS_RESULT eres = CUnittest::EresExecute(rgut, GPOS_ARRAY_SIZE(rgut));
@@ -974,4 +975,89 @@ CCacheTest::EresUnittest_IterativeDeletion()
 	return GPOS_OK;
 }
 
+//---------------------------------------------------------------------------
+//	@function:
+//		CCacheTest::FInvalidateEvenKeys
+//
+//	@doc:
+//		Invalidation predicate selecting even keys
+//
+//---------------------------------------------------------------------------
+BOOL
+CCacheTest::FInvalidateEvenKeys(ULONG *const &pvKey,
+								void *	// context
+)
+{
+	return 0 == *pvKey % 2;
+}
+
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CCacheTest::EresUnittest_Invalidation
+//
+//	@doc:
+//		Invalidate the entries matching a predicate, while one of them is
+//		held by an accessor
+//
+//---------------------------------------------------------------------------
+GPOS_RESULT
+CCacheTest::EresUnittest_Invalidation()
+{
+	CAutoP<CCache<SSimpleObject *, ULONG *> > apcache;
+	apcache = CCacheFactory::CreateCache<SSimpleObject *, ULONG *>(
+		fUnique, UNLIMITED_CACHE_QUOTA, SSimpleObject::UlMyHash,
+		SSimpleObject::FMyEqual);
+
+	CCache<SSimpleObject *, ULONG *> *pcache = apcache.Value();
+
+	for (ULONG i = 0; i < GPOS_CACHE_ELEMENTS; i++)
+	{
+		(void) InsertOneElement(pcache, i);
+	}
+	GPOS_UNITTEST_ASSERT(GPOS_CACHE_ELEMENTS == pcache->Size());
+
+	ULLONG ullCacheSize = pcache->TotalAllocatedSize();
+
+	// scope for an accessor holding an entry that gets invalidated
+	{
+		CSimpleObjectCacheAccessor ca(pcache);
+		ULONG ulkey = 0;
+		ca.Lookup(&ulkey);
+		SSimpleObject *pso = ca.Val();
+		GPOS_UNITTEST_ASSERT(nullptr != pso);
+
+		// release object since there is no customer to release it after lookup and before CCache's cleanup
+		pso->Release();
+
+		ULLONG ullInvalidated GPOS_ASSERTS_ONLY =
+			pcache->InvalidateEntries(FInvalidateEvenKeys, nullptr);
+		GPOS_UNITTEST_ASSERT(GPOS_CACHE_ELEMENTS / 2 == ullInvalidated);
+
+		// the held entry is only marked for deletion
+		GPOS_UNITTEST_ASSERT(GPOS_CACHE_ELEMENTS / 2 + 1 == pcache->Size());
+		GPOS_UNITTEST_ASSERT(0 == pso->m_ulValue);
+	}
+
+	// the held entry is gone with the accessor
+	GPOS_UNITTEST_ASSERT(GPOS_CACHE_ELEMENTS / 2 == pcache->Size());
+	GPOS_UNITTEST_ASSERT(ullCacheSize > pcache->TotalAllocatedSize());
+
+	for (ULONG i = 0; i < GPOS_CACHE_ELEMENTS; i++)
+	{
+		CSimpleObjectCacheAccessor ca(pcache);
+		ca.Lookup(&i);
+		SSimpleObject *pso = ca.Val();
+		GPOS_UNITTEST_ASSERT((0 == i % 2) == (nullptr == pso));
+
+		if (nullptr != pso)
+		{
+			// release object since there is no customer to release it after lookup and before CCache's cleanup
+			pso->Release();
+		}
+	}
+
+	return GPOS_OK;
+}
+
 // EOF
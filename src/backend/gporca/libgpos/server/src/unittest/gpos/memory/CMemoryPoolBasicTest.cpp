@@ -18,6 +18,7 @@
 #include "gpos/error/CException.h"
 #include "gpos/io/COstreamString.h"
 #include "gpos/memory/CAutoMemoryPool.h"
+#include "gpos/memory/CMemoryPoolSlab.h"
 #include "gpos/memory/CMemoryVisitorPrint.h"
 #include "gpos/string/CWStringDynamic.h"
 #include "gpos/task/CAutoTaskProxy.h"
@@ -45,7 +46,9 @@ CMemoryPoolBasicTest::EresUnittest()
 #ifdef GPOS_DEBUG
 		GPOS_UNITTEST_FUNC(CMemoryPoolBasicTest::EresUnittest_Print),
 #endif	// GPOS_DEBUG
-		GPOS_UNITTEST_FUNC(CMemoryPoolBasicTest::EresUnittest_TestTracker)};
+		GPOS_UNITTEST_FUNC(CMemoryPoolBasicTest::EresUnittest_TestTracker),
+		GPOS_UNITTEST_FUNC(CMemoryPoolBasicTest::EresUnittest_TestSlab),
+		GPOS_UNITTEST_FUNC(CMemoryPoolBasicTest::EresUnittest_Benchmark)};
 
 	CAutoTraceFlag atf(EtraceTestMemoryPools, true /*value*/);
 
@@ -97,6 +100,61 @@ CMemoryPoolBasicTest::EresUnittest_TestTracker()
 }
 
 
+//---------------------------------------------------------------------------
+//	@function:
+//		CMemoryPoolBasicTest::EresUnittest_TestSlab
+//
+//	@doc:
+//		Run tests for slab pools
+//
+//---------------------------------------------------------------------------
+GPOS_RESULT
+CMemoryPoolBasicTest::EresUnittest_TestSlab()
+{
+	if (GPOS_OK != EresSlabNewDelete() ||
+		GPOS_OK != EresTestExpectedError(EresSlabThrowingCtor,
+										 CException::ExmiOOM))
+	{
+		return GPOS_FAILED;
+	}
+
+	return GPOS_OK;
+}
+
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CMemoryPoolBasicTest::EresUnittest_Benchmark
+//
+//	@doc:
+//		Compare the time it takes to allocate and free many small objects
+//		in a tracker pool and in a slab pool, including the destruction
+//		of the pool
+//
+//---------------------------------------------------------------------------
+GPOS_RESULT
+CMemoryPoolBasicTest::EresUnittest_Benchmark()
+{
+	const ULONG num_allocs = 100000;
+
+	{
+		CAutoTimer at("Tracker pool benchmark", true /*fPrint*/);
+		CAutoMemoryPool amp(CAutoMemoryPool::ElcNone,
+							CMemoryPoolManager::EmpkGeneral);
+		AllocFreeMix(amp.Pmp(), num_allocs);
+	}
+
+	{
+		CAutoTimer at("Slab pool benchmark", true /*fPrint*/);
+		CAutoMemoryPool amp(CAutoMemoryPool::ElcNone,
+							CMemoryPoolManager::EmpkSlab);
+		AllocFreeMix(amp.Pmp(), num_allocs);
+	}
+
+	return GPOS_OK;
+}
+
+
 //---------------------------------------------------------------------------
 //	@function:
 //		CMemoryPoolBasicTest::EresTestType
@@ -324,6 +382,138 @@ CMemoryPoolBasicTest::EresLeakByException()
 #endif	// GPOS_DEBUG
 
 
+//---------------------------------------------------------------------------
+//	@function:
+//		CMemoryPoolBasicTest::EresSlabNewDelete
+//
+//	@doc:
+//		Allocate objects of all size classes, and larger ones, from a slab
+//		pool; check that freed objects are reused without corrupting the
+//		live ones
+//
+//---------------------------------------------------------------------------
+GPOS_RESULT
+CMemoryPoolBasicTest::EresSlabNewDelete()
+{
+	CAutoTimer at("Slab NewDelete test", true /*fPrint*/);
+	CAutoMemoryPool amp(CAutoMemoryPool::ElcNone, CMemoryPoolManager::EmpkSlab);
+	CMemoryPool *mp = amp.Pmp();
+
+	const ULONG num_arrays = 2 * GPOS_MEM_SLAB_MAX_OBJECT_SIZE;
+	BYTE *rgrgb[num_arrays];
+
+	for (ULONG ul = 0; ul < num_arrays; ul++)
+	{
+		rgrgb[ul] = GPOS_NEW_ARRAY(mp, BYTE, ul);
+		clib::Memset(rgrgb[ul], (BYTE) ul, ul);
+	}
+
+	ULLONG total_size = mp->TotalAllocatedSize();
+	GPOS_RTL_ASSERT(0 < total_size);
+
+	// free every other array, and allocate it again
+	for (ULONG ul = 0; ul < num_arrays; ul += 2)
+	{
+		GPOS_DELETE_ARRAY(rgrgb[ul]);
+	}
+
+	for (ULONG ul = 0; ul < num_arrays; ul += 2)
+	{
+		rgrgb[ul] = GPOS_NEW_ARRAY(mp, BYTE, ul);
+		clib::Memset(rgrgb[ul], (BYTE) ul, ul);
+	}
+
+	// freed slab objects are reused, only large allocations are redone
+	GPOS_RTL_ASSERT(total_size == mp->TotalAllocatedSize());
+
+	for (ULONG ul = 0; ul < num_arrays; ul++)
+	{
+		GPOS_RTL_ASSERT(ul == CMemoryPool::UserSizeOfAlloc(rgrgb[ul]));
+		for (ULONG ulByte = 0; ulByte < ul; ulByte++)
+		{
+			GPOS_RTL_ASSERT((BYTE) ul == rgrgb[ul][ulByte]);
+		}
+	}
+
+	// the arrays in odd positions are released with the pool
+	for (ULONG ul = 0; ul < num_arrays; ul += 2)
+	{
+		GPOS_DELETE_ARRAY(rgrgb[ul]);
+	}
+
+	return GPOS_OK;
+}
+
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CMemoryPoolBasicTest::EresSlabThrowingCtor
+//
+//	@doc:
+//		Exception in constructor of an object allocated from a slab pool
+//
+//---------------------------------------------------------------------------
+GPOS_RESULT
+CMemoryPoolBasicTest::EresSlabThrowingCtor()
+{
+	CAutoTimer at("Slab ThrowingCtor test", true /*fPrint*/);
+
+	CAutoMemoryPool amp(CAutoMemoryPool::ElcExc, CMemoryPoolManager::EmpkSlab);
+	CMemoryPool *mp = amp.Pmp();
+
+	class CMyTestClass
+	{
+	public:
+		CMyTestClass()
+		{
+			GPOS_RAISE(CException::ExmaSystem, CException::ExmiOOM);
+		}
+	};
+
+	GPOS_NEW(mp) CMyTestClass();
+
+	// doesn't reach this line
+	return GPOS_FAILED;
+}
+
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CMemoryPoolBasicTest::AllocFreeMix
+//
+//	@doc:
+//		Allocation pattern of the optimizer: many small objects, about half
+//		of which are freed again before the pool is destroyed
+//
+//---------------------------------------------------------------------------
+void
+CMemoryPoolBasicTest::AllocFreeMix(CMemoryPool *mp, ULONG num_allocs)
+{
+	const ULONG rgulSizes[] = {16, 24, 40, 64, 96, 120, 200};
+	const ULONG window = 64;
+	ULONG *rgrgul[window];
+
+	for (ULONG ul = 0; ul < window; ul++)
+	{
+		rgrgul[ul] = nullptr;
+	}
+
+	for (ULONG ul = 0; ul < num_allocs; ul++)
+	{
+		// every other object in the window is freed when it gets replaced
+		ULONG slot = ul % window;
+		if (0 == (ul & 1) && nullptr != rgrgul[slot])
+		{
+			GPOS_DELETE_ARRAY(rgrgul[slot]);
+		}
+
+		ULONG size = rgulSizes[ul % GPOS_ARRAY_SIZE(rgulSizes)];
+		rgrgul[slot] = GPOS_NEW_ARRAY(mp, ULONG, size / GPOS_SIZEOF(ULONG));
+		rgrgul[slot][0] = ul;
+	}
+}
+
+
 //---------------------------------------------------------------------------
 //	@function:
 //		CMemoryPoolBasicTest::Size
@@ -8,15 +8,17 @@
 //	@doc:
 //		Implementation of bit sets
 //
-//		Underlying assumption: a set contains only a few links of bitvectors
-//		hence, keeping them in a linked list is efficient;
+//		Underlying assumption: the elements of a set are clustered, e.g.
+//		column references of a query, hence, covering them with one dense
+//		array of words is efficient;
 //---------------------------------------------------------------------------
 
 #include "gpos/common/CBitSet.h"
 
 #include "gpos/base.h"
-#include "gpos/common/CAutoRef.h"
 #include "gpos/common/CBitSetIter.h"
+#include "gpos/common/clibwrapper.h"
+#include "gpos/utils.h"
 
 #ifdef GPOS_DEBUG
 #include "gpos/error/CAutoTrace.h"
@@ -24,163 +26,305 @@
 
 using namespace gpos;
 
+#define BYTES_PER_WORD GPOS_SIZEOF(ULLONG)
+#define BITS_PER_WORD (8 * BYTES_PER_WORD)
+
 FORCE_GENERATE_DBGSTR(CBitSet);
 
 //---------------------------------------------------------------------------
 //	@function:
-//		CBitSetLink
+//		CBitSet::CountBits
 //
 //	@doc:
-//		ctor
+//		Count bits in a range of words; compiles to the population count
+//		instruction where the target has one
 //
 //---------------------------------------------------------------------------
-CBitSet::CBitSetLink::CBitSetLink(CMemoryPool *mp, ULONG offset,
-								  ULONG vector_size)
-	: m_offset(offset)
+ULONG
+CBitSet::CountBits(const ULLONG *words, ULONG num_words)
 {
-	m_vec = GPOS_NEW(mp) CBitVector(mp, vector_size);
-}
+	ULONG nbits = 0;
+	for (ULONG i = 0; i < num_words; i++)
+	{
+#ifdef __GNUC__
+		nbits += __builtin_popcountll(words[i]);
+#else
+		ULLONG ull = words[i];
+		for (; ull != 0; nbits++)
+		{
+			ull &= (ull - 1);
+		}
+#endif	// __GNUC__
+	}
 
+	return nbits;
+}
 
 //---------------------------------------------------------------------------
 //	@function:
-//		CBitSetLink
+//		CBitSet::AreZero
 //
 //	@doc:
-//		copy ctor
+//		Determine if all words in a range are zero
+//
+//		The kernels below have no data dependent branches inside the loop
+//		so that the compiler can vectorize them for the target
 //
 //---------------------------------------------------------------------------
-CBitSet::CBitSetLink::CBitSetLink(CMemoryPool *mp, const CBitSetLink &bsl)
-	: m_offset(bsl.m_offset)
+BOOL
+CBitSet::AreZero(const ULLONG *words, ULONG num_words)
 {
-	m_vec = GPOS_NEW(mp) CBitVector(mp, *bsl.GetVec());
-}
+	ULLONG acc = 0;
+	for (ULONG i = 0; i < num_words; i++)
+	{
+		acc |= words[i];
+	}
 
+	return 0 == acc;
+}
 
 //---------------------------------------------------------------------------
 //	@function:
-//		~CBitSetLink
+//		CBitSet::Or
 //
 //	@doc:
-//		ctor
+//		dst |= src
 //
 //---------------------------------------------------------------------------
-CBitSet::CBitSetLink::~CBitSetLink()
+void
+CBitSet::Or(ULLONG *dst, const ULLONG *src, ULONG num_words)
 {
-	GPOS_DELETE(m_vec);
+	for (ULONG i = 0; i < num_words; i++)
+	{
+		dst[i] |= src[i];
+	}
 }
 
-
 //---------------------------------------------------------------------------
 //	@function:
-//		CBitSet::FindLinkByOffset
+//		CBitSet::And
 //
 //	@doc:
-//		Find bit set link for a given offset; if non-existent return previous
-//		link (may be NULL);
-//		By providing a starting link we can implement a number of operations
-//		in one sweep, ie O(N)
+//		dst &= src
 //
 //---------------------------------------------------------------------------
-CBitSet::CBitSetLink *
-CBitSet::FindLinkByOffset(ULONG offset, CBitSetLink *bsl) const
+void
+CBitSet::And(ULLONG *dst, const ULLONG *src, ULONG num_words)
 {
-	CBitSetLink *found = nullptr;
-	CBitSetLink *cursor = bsl;
+	for (ULONG i = 0; i < num_words; i++)
+	{
+		dst[i] &= src[i];
+	}
+}
 
-	if (nullptr == bsl)
+//---------------------------------------------------------------------------
+//	@function:
+//		CBitSet::AndNot
+//
+//	@doc:
+//		dst &= ~src
+//
+//---------------------------------------------------------------------------
+void
+CBitSet::AndNot(ULLONG *dst, const ULLONG *src, ULONG num_words)
+{
+	for (ULONG i = 0; i < num_words; i++)
 	{
-		// if no cursor provided start with first element
-		cursor = m_bsllist.First();
+		dst[i] &= ~src[i];
 	}
-	else
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CBitSet::IsSubset
+//
+//	@doc:
+//		Determine if all bits of sub are set in super
+//
+//---------------------------------------------------------------------------
+BOOL
+CBitSet::IsSubset(const ULLONG *sub, const ULLONG *super, ULONG num_words)
+{
+	ULLONG acc = 0;
+	for (ULONG i = 0; i < num_words; i++)
 	{
-		GPOS_ASSERT(bsl->GetOffset() <= offset && "invalid start cursor");
-		found = bsl;
+		acc |= sub[i] & ~super[i];
 	}
 
-	GPOS_ASSERT_IMP(nullptr != cursor,
-					GPOS_OK == m_bsllist.Find(cursor) && "cursor not in list");
+	return 0 == acc;
+}
 
-	while (true)
+//---------------------------------------------------------------------------
+//	@function:
+//		CBitSet::AreDisjoint
+//
+//	@doc:
+//		Determine if no bit is set in both left and right
+//
+//---------------------------------------------------------------------------
+BOOL
+CBitSet::AreDisjoint(const ULLONG *left, const ULLONG *right,
+					 ULONG num_words)
+{
+	ULLONG acc = 0;
+	for (ULONG i = 0; i < num_words; i++)
 	{
-		// no more links or we've overshot the target
-		if (nullptr == cursor || cursor->GetOffset() > offset)
-		{
-			break;
-		}
-
-		found = cursor;
-		cursor = m_bsllist.Next(cursor);
+		acc |= left[i] & right[i];
 	}
 
-	GPOS_ASSERT_IMP(found, found->GetOffset() <= offset);
-	return found;
+	return 0 == acc;
 }
 
-
 //---------------------------------------------------------------------------
 //	@function:
-//		CBitSet::RecomputeSize
+//		CBitSet::TrimmedRange
 //
 //	@doc:
-//		Compute size of set by adding up sizes of links
+//		Determine the range of words that contain set bits; the range is
+//		empty if the set is
 //
 //---------------------------------------------------------------------------
 void
-CBitSet::RecomputeSize()
+CBitSet::TrimmedRange(ULONG *first_word, ULONG *end_word) const
 {
-	m_size = 0;
-	CBitSetLink *bsl = nullptr;
+	ULONG first = 0;
+	ULONG end = m_num_words;
 
-	for (bsl = m_bsllist.First(); bsl != nullptr; bsl = m_bsllist.Next(bsl))
+	while (first < end && 0 == m_words[first])
 	{
-		m_size += bsl->GetVec()->CountSetBits();
+		first++;
+	}
+
+	while (end > first && 0 == m_words[end - 1])
+	{
+		end--;
 	}
-}
 
+	*first_word = m_first_word + first;
+	*end_word = m_first_word + end;
+}
 
 //---------------------------------------------------------------------------
 //	@function:
-//		CBitSet::Clear
+//		CBitSet::Extend
 //
 //	@doc:
-//		release all links
+//		Extend the range of words to include the given range, rounded to
+//		the granularity of the set
 //
 //---------------------------------------------------------------------------
 void
-CBitSet::Clear()
+CBitSet::Extend(ULONG first_word, ULONG end_word)
 {
-	CBitSetLink *bsl = nullptr;
+	GPOS_ASSERT(first_word < end_word);
+
+	first_word = (first_word / m_chunk_words) * m_chunk_words;
+	end_word = ((end_word + m_chunk_words - 1) / m_chunk_words) * m_chunk_words;
 
-	while (nullptr != (bsl = m_bsllist.First()))
+	if (nullptr != m_words)
 	{
-		CBitSetLink *bsl_to_remove = bsl;
-		bsl = m_bsllist.Next(bsl);
+		if (m_first_word <= first_word && end_word <= EndWord())
+		{
+			return;
+		}
 
-		m_bsllist.Remove(bsl_to_remove);
-		GPOS_DELETE(bsl_to_remove);
+		first_word = std::min(first_word, m_first_word);
+		end_word = std::max(end_word, EndWord());
 	}
 
-	RecomputeSize();
+	ULONG num_words = end_word - first_word;
+	ULLONG *words = GPOS_NEW_ARRAY(m_mp, ULLONG, num_words);
+	clib::Memset(words, 0, num_words * BYTES_PER_WORD);
+
+	if (nullptr != m_words)
+	{
+		clib::Memcpy(words + (m_first_word - first_word), m_words,
+					 m_num_words * BYTES_PER_WORD);
+		GPOS_DELETE_ARRAY(m_words);
+	}
+
+	m_words = words;
+	m_first_word = first_word;
+	m_num_words = num_words;
 }
 
+//---------------------------------------------------------------------------
+//	@function:
+//		CBitSet::GetNextSetBit
+//
+//	@doc:
+//		Determine the next bit set greater or equal than the provided position
+//
+//---------------------------------------------------------------------------
+BOOL
+CBitSet::GetNextSetBit(ULONG start_pos, ULONG &next_pos) const
+{
+	ULONG word = start_pos / BITS_PER_WORD;
+	ULLONG mask = ~((ULLONG) 0) << (start_pos % BITS_PER_WORD);
+
+	if (word < m_first_word)
+	{
+		word = m_first_word;
+		mask = ~((ULLONG) 0);
+	}
+
+	for (; word < EndWord(); word++)
+	{
+		ULLONG ull = m_words[word - m_first_word] & mask;
+		if (0 != ull)
+		{
+			ULONG bit = 0;
+#ifdef __GNUC__
+			bit = __builtin_ctzll(ull);
+#else
+			for (; 0 == (ull & (ULLONG) 1); bit++)
+			{
+				ull >>= 1;
+			}
+#endif	// __GNUC__
+			next_pos = word * BITS_PER_WORD + bit;
+			return true;
+		}
+
+		// the initial offset applies only to the first word
+		mask = ~((ULLONG) 0);
+	}
+
+	return false;
+}
 
 //---------------------------------------------------------------------------
 //	@function:
-//		CBitSet::GetOffset
+//		CBitSet::RecomputeSize
 //
 //	@doc:
-//		Compute offset
+//		Compute size of set by counting the bits of all words
 //
 //---------------------------------------------------------------------------
-ULONG
-CBitSet::ComputeOffset(ULONG ul) const
+void
+CBitSet::RecomputeSize()
 {
-	return (ul / m_vector_size) * m_vector_size;
+	m_size = CountBits(m_words, m_num_words);
 }
 
+//---------------------------------------------------------------------------
+//	@function:
+//		CBitSet::Clear
+//
+//	@doc:
+//		release all words
+//
+//---------------------------------------------------------------------------
+void
+CBitSet::Clear()
+{
+	GPOS_DELETE_ARRAY(m_words);
+	m_words = nullptr;
+	m_first_word = 0;
+	m_num_words = 0;
 
+	RecomputeSize();
+}
 
 //---------------------------------------------------------------------------
 //	@function:
@@ -191,12 +335,17 @@ CBitSet::ComputeOffset(ULONG ul) const
 //
 //---------------------------------------------------------------------------
 CBitSet::CBitSet(CMemoryPool *mp, ULONG vector_size)
-	: m_mp(mp), m_vector_size(vector_size), m_size(0)
+	: m_mp(mp),
+	  m_vector_size(vector_size),
+	  m_chunk_words(std::max(1U, (vector_size + BITS_PER_WORD - 1) /
+									 (ULONG) BITS_PER_WORD)),
+	  m_words(nullptr),
+	  m_first_word(0),
+	  m_num_words(0),
+	  m_size(0)
 {
-	m_bsllist.Init(GPOS_OFFSET(CBitSetLink, m_link));
 }
 
-
 //---------------------------------------------------------------------------
 //	@function:
 //		CBitSet::CBitSet
@@ -206,13 +355,17 @@ CBitSet::CBitSet(CMemoryPool *mp, ULONG vector_size)
 //
 //---------------------------------------------------------------------------
 CBitSet::CBitSet(CMemoryPool *mp, const CBitSet &bs)
-	: m_mp(mp), m_vector_size(bs.m_vector_size), m_size(0)
+	: m_mp(mp),
+	  m_vector_size(bs.m_vector_size),
+	  m_chunk_words(bs.m_chunk_words),
+	  m_words(nullptr),
+	  m_first_word(0),
+	  m_num_words(0),
+	  m_size(0)
 {
-	m_bsllist.Init(GPOS_OFFSET(CBitSetLink, m_link));
 	Union(&bs);
 }
 
-
 //---------------------------------------------------------------------------
 //	@function:
 //		CBitSet::~CBitSet
@@ -226,7 +379,6 @@ CBitSet::~CBitSet()
 	Clear();
 }
 
-
 //---------------------------------------------------------------------------
 //	@function:
 //		CBitSet::Get
@@ -238,52 +390,50 @@ CBitSet::~CBitSet()
 BOOL
 CBitSet::Get(ULONG pos) const
 {
-	ULONG offset = ComputeOffset(pos);
-
-	CBitSetLink *bsl = FindLinkByOffset(offset);
-	if (nullptr != bsl && bsl->GetOffset() == offset)
+	ULONG word = pos / BITS_PER_WORD;
+	if (word < m_first_word || word >= EndWord())
 	{
-		return bsl->GetVec()->Get(pos - offset);
+		return false;
 	}
 
-	return false;
+	ULLONG mask = ((ULLONG) 1) << (pos % BITS_PER_WORD);
+	return 0 != (m_words[word - m_first_word] & mask);
 }
 
-
 //---------------------------------------------------------------------------
 //	@function:
 //		CBitSet::ExchangeSet
 //
 //	@doc:
-//		Set given bit; return previous value; allocate new link if necessary
+//		Set given bit; return previous value; extend range of words if
+//		necessary
 //
 //---------------------------------------------------------------------------
 BOOL
 CBitSet::ExchangeSet(ULONG pos)
 {
-	ULONG offset = ComputeOffset(pos);
-
-	CBitSetLink *bsl = FindLinkByOffset(offset);
-	if (nullptr == bsl || bsl->GetOffset() != offset)
+	ULONG word = pos / BITS_PER_WORD;
+	if (word < m_first_word || word >= EndWord())
 	{
-		CBitSetLink *pbsl_new =
-			GPOS_NEW(m_mp) CBitSetLink(m_mp, offset, m_vector_size);
-		if (nullptr == bsl)
+		if (nullptr != m_words && word >= EndWord())
 		{
-			m_bsllist.Prepend(pbsl_new);
+			// sets are mostly built in ascending order, double the range
+			// to amortize the copying
+			Extend(word, std::max(word + 1, EndWord() + m_num_words));
 		}
 		else
 		{
-			// insert after found link
-			m_bsllist.Append(pbsl_new, bsl);
+			Extend(word, word + 1);
 		}
-
-		bsl = pbsl_new;
 	}
 
-	GPOS_ASSERT(bsl->GetOffset() == offset);
+	GPOS_ASSERT(m_first_word <= word && word < EndWord());
+
+	ULLONG *pull = &m_words[word - m_first_word];
+	ULLONG mask = ((ULLONG) 1) << (pos % BITS_PER_WORD);
+	BOOL bit = (0 != (*pull & mask));
+	*pull |= mask;
 
-	BOOL bit = bsl->GetVec()->ExchangeSet(pos - offset);
 	if (!bit)
 	{
 		m_size++;
@@ -292,7 +442,6 @@ CBitSet::ExchangeSet(ULONG pos)
 	return bit;
 }
 
-
 //---------------------------------------------------------------------------
 //	@function:
 //		CBitSet::ExchangeClear
@@ -304,188 +453,116 @@ CBitSet::ExchangeSet(ULONG pos)
 BOOL
 CBitSet::ExchangeClear(ULONG pos)
 {
-	ULONG offset = ComputeOffset(pos);
-
-	CBitSetLink *bsl = FindLinkByOffset(offset);
-	if (nullptr != bsl && bsl->GetOffset() == offset)
+	ULONG word = pos / BITS_PER_WORD;
+	if (word < m_first_word || word >= EndWord())
 	{
-		BOOL bit = bsl->GetVec()->ExchangeClear(pos - offset);
-
-		// remove empty link
-		if (bsl->GetVec()->IsEmpty())
-		{
-			m_bsllist.Remove(bsl);
-			GPOS_DELETE(bsl);
-		}
+		return false;
+	}
 
-		if (bit)
-		{
-			m_size--;
-		}
+	ULLONG *pull = &m_words[word - m_first_word];
+	ULLONG mask = ((ULLONG) 1) << (pos % BITS_PER_WORD);
+	BOOL bit = (0 != (*pull & mask));
+	*pull &= ~mask;
 
-		return bit;
+	if (bit)
+	{
+		m_size--;
 	}
 
-	return false;
+	return bit;
 }
 
-
 //---------------------------------------------------------------------------
 //	@function:
 //		CBitSet::Union
 //
 //	@doc:
-//		Union with given other set;
-//		(1) determine which links need to be allocated before(!) modifying
-//			the set allocate and copy missing links aside
-//		(2) insert the new links into the list
-//		(3) union all links, old and new, on a per-bitvector basis
-//
-//		For clarity step (2) and (3) are separated;
+//		Union with given other set; extend the range of words to cover the
+//		set bits of the other set first
 //
 //---------------------------------------------------------------------------
 void
 CBitSet::Union(const CBitSet *pbsOther)
 {
-	CBitSetLink *bsl = nullptr;
-	CBitSetLink *bsl_other = nullptr;
-
-	// dynamic array of CBitSetLink
-	using CBitSetLinkArray = CDynamicPtrArray<CBitSetLink, CleanupNULL>;
-
-	CAutoRef<CBitSetLinkArray> a_drgpbsl;
-	a_drgpbsl = GPOS_NEW(m_mp) CBitSetLinkArray(m_mp);
-
-	// iterate through other's links and copy missing links to array
-	for (bsl_other = pbsOther->m_bsllist.First(); bsl_other != nullptr;
-		 bsl_other = pbsOther->m_bsllist.Next(bsl_other))
-	{
-		bsl = FindLinkByOffset(bsl_other->GetOffset(), bsl);
-		if (nullptr == bsl || bsl->GetOffset() != bsl_other->GetOffset())
-		{
-			// need to copy this link
-			CAutoP<CBitSetLink> a_pbsl;
-			a_pbsl = GPOS_NEW(m_mp) CBitSetLink(m_mp, *bsl_other);
-			a_drgpbsl->Append(a_pbsl.Value());
-
-			a_pbsl.Reset();
-		}
-	}
-
-	// insert all new links
-	bsl = nullptr;
-	for (ULONG i = 0; i < a_drgpbsl->Size(); i++)
+	if (0 == pbsOther->Size())
 	{
-		CBitSetLink *pbslInsert = (*a_drgpbsl)[i];
-		bsl = FindLinkByOffset(pbslInsert->GetOffset(), bsl);
-
-		GPOS_ASSERT_IMP(nullptr != bsl,
-						bsl->GetOffset() < pbslInsert->GetOffset());
-		if (nullptr == bsl)
-		{
-			m_bsllist.Prepend(pbslInsert);
-		}
-		else
-		{
-			m_bsllist.Append(pbslInsert, bsl);
-		}
+		return;
 	}
 
-	// iterate through all links and union them up
-	bsl_other = nullptr;
-	bsl = m_bsllist.First();
-	while (nullptr != bsl)
-	{
-		bsl_other = pbsOther->FindLinkByOffset(bsl->GetOffset(), bsl_other);
-		if (nullptr != bsl_other && bsl_other->GetOffset() == bsl->GetOffset())
-		{
-			bsl->GetVec()->Or(bsl_other->GetVec());
-		}
+	ULONG first_word = 0;
+	ULONG end_word = 0;
+	pbsOther->TrimmedRange(&first_word, &end_word);
+	Extend(first_word, end_word);
 
-		bsl = m_bsllist.Next(bsl);
-	}
+	Or(m_words + (first_word - m_first_word),
+	   pbsOther->m_words + (first_word - pbsOther->m_first_word),
+	   end_word - first_word);
 
 	RecomputeSize();
 }
 
-
 //---------------------------------------------------------------------------
 //	@function:
 //		CBitSet::Intersection
 //
 //	@doc:
-//		Iterate through all links and intersect them; release unused links
+//		Intersect the words both sets cover; clear the others
 //
 //---------------------------------------------------------------------------
 void
 CBitSet::Intersection(const CBitSet *pbsOther)
 {
-	if (nullptr == pbsOther)
+	if (nullptr == pbsOther || 0 == m_size)
 	{
 		return;
 	}
 
-	CBitSetLink *bsl_other = nullptr;
-	CBitSetLink *bsl = m_bsllist.First();
+	ULONG first_word = std::max(m_first_word, pbsOther->m_first_word);
+	ULONG end_word = std::min(EndWord(), pbsOther->EndWord());
 
-	while (nullptr != bsl)
+	if (first_word >= end_word)
 	{
-		CBitSetLink *bsl_to_remove = nullptr;
+		clib::Memset(m_words, 0, m_num_words * BYTES_PER_WORD);
+		m_size = 0;
+		return;
+	}
 
-		bsl_other = pbsOther->FindLinkByOffset(bsl->GetOffset(), bsl_other);
-		if (nullptr != bsl_other && bsl_other->GetOffset() == bsl->GetOffset())
-		{
-			bsl->GetVec()->And(bsl_other->GetVec());
-			CBitSetLink *bsl_prev = bsl;
-
-			bsl = m_bsllist.Next(bsl);
-			// If vector is empty after "ANDing", remove the vector, otherwise
-			// we can get into a situation where an empty vector exists
-			// and causes wrong results for equals/contains operations later
-			if (bsl_prev->GetVec()->IsEmpty())
-			{
-				m_bsllist.Remove(bsl_prev);
-				GPOS_DELETE(bsl_prev);
-			}
-		}
-		else
-		{
-			bsl_to_remove = bsl;
-			bsl = m_bsllist.Next(bsl);
+	clib::Memset(m_words, 0, (first_word - m_first_word) * BYTES_PER_WORD);
+	clib::Memset(m_words + (end_word - m_first_word), 0,
+				 (EndWord() - end_word) * BYTES_PER_WORD);
 
-			m_bsllist.Remove(bsl_to_remove);
-			GPOS_DELETE(bsl_to_remove);
-		}
-	}
+	And(m_words + (first_word - m_first_word),
+		pbsOther->m_words + (first_word - pbsOther->m_first_word),
+		end_word - first_word);
 
 	RecomputeSize();
 }
 
-
 //---------------------------------------------------------------------------
 //	@function:
 //		CBitSet::Difference
 //
 //	@doc:
-//		Substract other set from this by iterating through other set and
-//		explicit removal of elements;
+//		Substract other set from the words both sets cover
 //
 //---------------------------------------------------------------------------
 void
 CBitSet::Difference(const CBitSet *pbs)
 {
-	if (IsDisjoint(pbs))
+	ULONG first_word = std::max(m_first_word, pbs->m_first_word);
+	ULONG end_word = std::min(EndWord(), pbs->EndWord());
+
+	if (0 == m_size || first_word >= end_word)
 	{
 		return;
 	}
 
-	CBitSetIter bsiter(*pbs);
-	while (bsiter.Advance())
-	{
-		(void) ExchangeClear(bsiter.Bit());
-	}
-}
+	AndNot(m_words + (first_word - m_first_word),
+		   pbs->m_words + (first_word - pbs->m_first_word),
+		   end_word - first_word);
 
+	RecomputeSize();
+}
 
 //---------------------------------------------------------------------------
 //	@function:
@@ -504,32 +581,32 @@ CBitSet::ContainsAll(const CBitSet *bs) const
 		return false;
 	}
 
-	CBitSetLink *bsl = nullptr;
-	CBitSetLink *bsl_other = nullptr;
-
-	// iterate through other's links and check for subsets
-	for (bsl_other = bs->m_bsllist.First(); bsl_other != nullptr;
-		 bsl_other = bs->m_bsllist.Next(bsl_other))
+	if (0 == bs->Size())
 	{
-		bsl = FindLinkByOffset(bsl_other->GetOffset(), bsl);
+		return true;
+	}
 
-		if (nullptr == bsl || bsl->GetOffset() != bsl_other->GetOffset() ||
-			!bsl->GetVec()->ContainsAll(bsl_other->GetVec()))
-		{
-			return false;
-		}
+	// all set bits of the other set must be within our range
+	ULONG first_word = 0;
+	ULONG end_word = 0;
+	bs->TrimmedRange(&first_word, &end_word);
+	if (first_word < m_first_word || end_word > EndWord())
+	{
+		return false;
 	}
 
-	return true;
+	return IsSubset(bs->m_words + (first_word - bs->m_first_word),
+					m_words + (first_word - m_first_word),
+					end_word - first_word);
 }
 
-
 //---------------------------------------------------------------------------
 //	@function:
 //		CBitSet::Equals
 //
 //	@doc:
-//		Determine if equal
+//		Determine if equal; sets of the same size are equal if one contains
+//		the other
 //
 //---------------------------------------------------------------------------
 BOOL
@@ -547,28 +624,9 @@ CBitSet::Equals(const CBitSet *bs) const
 		return false;
 	}
 
-	CBitSetLink *bsl = m_bsllist.First();
-	CBitSetLink *bsl_other = bs->m_bsllist.First();
-
-	while (nullptr != bsl)
-	{
-		if (nullptr == bsl_other ||
-			bsl->GetOffset() != bsl_other->GetOffset() ||
-			!bsl->GetVec()->Equals(bsl_other->GetVec()))
-		{
-			return false;
-		}
-
-		bsl = m_bsllist.Next(bsl);
-		bsl_other = bs->m_bsllist.Next(bsl_other);
-	}
-
-	// same length implies bsl_other must have reached end as well
-	return bsl_other == nullptr;
+	return ContainsAll(bs);
 }
 
-
-
 //---------------------------------------------------------------------------
 //	@function:
 //		CBitSet::FDisjoint
@@ -580,32 +638,27 @@ CBitSet::Equals(const CBitSet *bs) const
 BOOL
 CBitSet::IsDisjoint(const CBitSet *bs) const
 {
-	CBitSetLink *bsl = nullptr;
-	CBitSetLink *bsl_other = nullptr;
+	ULONG first_word = std::max(m_first_word, bs->m_first_word);
+	ULONG end_word = std::min(EndWord(), bs->EndWord());
 
-	// iterate through other's links an check if disjoint
-	for (bsl_other = bs->m_bsllist.First(); bsl_other != nullptr;
-		 bsl_other = bs->m_bsllist.Next(bsl_other))
+	if (first_word >= end_word)
 	{
-		bsl = FindLinkByOffset(bsl_other->GetOffset(), bsl);
-
-		if (nullptr != bsl && bsl->GetOffset() == bsl_other->GetOffset() &&
-			!bsl->GetVec()->IsDisjoint(bsl_other->GetVec()))
-		{
-			return false;
-		}
+		return true;
 	}
 
-	return true;
+	return AreDisjoint(m_words + (first_word - m_first_word),
+					   bs->m_words + (first_word - bs->m_first_word),
+					   end_word - first_word);
 }
 
-
 //---------------------------------------------------------------------------
 //	@function:
 //		CBitSet::HashValue
 //
 //	@doc:
-//		Compute hash value for set
+//		Compute hash value for set; combines the hash values of all
+//		non-empty chunks of the vector size, so that it does not depend on
+//		the range of words the set happens to cover
 //
 //---------------------------------------------------------------------------
 ULONG
@@ -613,17 +666,19 @@ CBitSet::HashValue() const
 {
 	ULONG ulHash = 0;
 
-	CBitSetLink *bsl = m_bsllist.First();
-	while (nullptr != bsl)
+	for (ULONG i = 0; i < m_num_words; i += m_chunk_words)
 	{
-		ulHash = gpos::CombineHashes(ulHash, bsl->GetVec()->HashValue());
-		bsl = m_bsllist.Next(bsl);
+		if (!AreZero(m_words + i, m_chunk_words))
+		{
+			ulHash = gpos::CombineHashes(
+				ulHash, gpos::HashByteArray((BYTE *) (m_words + i),
+											m_chunk_words * BYTES_PER_WORD));
+		}
 	}
 
 	return ulHash;
 }
 
-
 //---------------------------------------------------------------------------
 //	@function:
 //		CBitSet::OsPrint
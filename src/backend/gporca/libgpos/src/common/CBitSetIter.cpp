@@ -26,7 +26,7 @@ using namespace gpos;
 //
 //---------------------------------------------------------------------------
 CBitSetIter::CBitSetIter(const CBitSet &bs)
-	: m_bs(bs), m_cursor((ULONG) -1), m_bsl(nullptr), m_active(true)
+	: m_bs(bs), m_cursor((ULONG) -1), m_active(true)
 {
 }
 
@@ -44,24 +44,8 @@ CBitSetIter::Advance()
 {
 	GPOS_ASSERT(m_active && "called advance on exhausted iterator");
 
-	if (nullptr == m_bsl)
-	{
-		m_bsl = m_bs.m_bsllist.First();
-	}
+	m_active = m_bs.GetNextSetBit(m_cursor + 1, m_cursor);
 
-	while (nullptr != m_bsl)
-	{
-		if (m_cursor + 1 <= m_bs.m_vector_size &&
-			m_bsl->GetVec()->GetNextSetBit(m_cursor + 1, m_cursor))
-		{
-			break;
-		}
-
-		m_bsl = m_bs.m_bsllist.Next(m_bsl);
-		m_cursor = (ULONG) -1;
-	}
-
-	m_active = (nullptr != m_bsl);
 	return m_active;
 }
 
@@ -77,10 +61,11 @@ CBitSetIter::Advance()
 ULONG
 CBitSetIter::Bit() const
 {
-	GPOS_ASSERT(m_active && nullptr != m_bsl && "iterator uninitialized");
-	GPOS_ASSERT(m_bsl->GetVec()->Get(m_cursor));
+	GPOS_ASSERT(m_active && "iterator uninitialized");
+	GPOS_ASSERT(m_bs.Get(m_cursor));
 
-	return m_bsl->GetOffset() + m_cursor;
+	return m_cursor;
 }
 
+
 // EOF
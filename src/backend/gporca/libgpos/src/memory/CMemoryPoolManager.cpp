@@ -18,6 +18,7 @@
 #include "gpos/common/clibwrapper.h"
 #include "gpos/error/CAutoTrace.h"
 #include "gpos/memory/CMemoryPool.h"
+#include "gpos/memory/CMemoryPoolSlab.h"
 #include "gpos/memory/CMemoryPoolTracker.h"
 #include "gpos/memory/CMemoryVisitorPrint.h"
 #include "gpos/task/CAutoSuspendAbort.h"
@@ -41,6 +42,8 @@ CMemoryPoolManager::CMemoryPoolManager(CMemoryPool *internal,
 	GPOS_ASSERT(nullptr != internal);
 	GPOS_ASSERT(GPOS_OFFSET(CMemoryPool, m_link) ==
 				GPOS_OFFSET(CMemoryPoolTracker, m_link));
+	GPOS_ASSERT(GPOS_OFFSET(CMemoryPool, m_link) ==
+				GPOS_OFFSET(CMemoryPoolSlab, m_link));
 }
 
 // Set up CMemoryPoolManager's internals.
@@ -75,10 +78,11 @@ CMemoryPoolManager::Init()
 
 
 CMemoryPool *
-CMemoryPoolManager::CreateMemoryPool()
+CMemoryPoolManager::CreateMemoryPool(EMemoryPoolKind kind)
 {
 	GPOS_ASSERT(nullptr != m_memory_pool_mgr);
-	CMemoryPool *mp = m_memory_pool_mgr->NewMemoryPool();
+	GPOS_ASSERT(kind < EmpkSentinel);
+	CMemoryPool *mp = m_memory_pool_mgr->NewMemoryPool(kind);
 
 	// accessor scope
 	{
@@ -95,8 +99,13 @@ CMemoryPoolManager::CreateMemoryPool()
 
 // Allocate a new NewMemoryPool
 CMemoryPool *
-CMemoryPoolManager::NewMemoryPool()
+CMemoryPoolManager::NewMemoryPool(EMemoryPoolKind kind)
 {
+	if (EmpkSlab == kind)
+	{
+		return GPOS_NEW(m_internal_memory_pool) CMemoryPoolSlab();
+	}
+
 	return GPOS_NEW(m_internal_memory_pool) CMemoryPoolTracker();
 }
 
@@ -142,11 +151,20 @@ CMemoryPoolManager::TotalAllocatedSize()
 	return total_size;
 }
 
-// free memory allocation
+// free memory allocation; the tag preceding the allocation tells which
+// kind of pool it was made from
 void
 CMemoryPoolManager::DeleteImpl(void *ptr, CMemoryPool::EAllocationType eat)
 {
-	CMemoryPoolTracker::DeleteImpl(ptr, eat);
+	if (CMemoryPoolTracker::TrackerAlloc ==
+		CMemoryPoolTracker::PtagOfAlloc(ptr)->m_size_class)
+	{
+		CMemoryPoolTracker::DeleteImpl(ptr, eat);
+	}
+	else
+	{
+		CMemoryPoolSlab::DeleteImpl(ptr, eat);
+	}
 }
 
 // get user requested size of allocation
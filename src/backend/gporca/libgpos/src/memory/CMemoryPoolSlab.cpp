@@ -0,0 +1,267 @@
+//---------------------------------------------------------------------------
+//	Greenplum Database
+//	Copyright (C) 2024 VMware, Inc. or its affiliates.
+//
+//	@filename:
+//		CMemoryPoolSlab.cpp
+//
+//	@doc:
+//		Implementation of the memory pool that allocates small objects
+//		from size-class slabs
+//
+//---------------------------------------------------------------------------
+
+#include "gpos/memory/CMemoryPoolSlab.h"
+
+#include "gpos/common/clibwrapper.h"
+#include "gpos/utils.h"
+
+using namespace gpos;
+
+#ifdef GPOS_DEBUG
+// in debug builds, the allocation type is stored after the user data
+#define GPOS_MEM_SLAB_GUARD_SIZE (GPOS_SIZEOF(BYTE))
+#else
+#define GPOS_MEM_SLAB_GUARD_SIZE (0)
+#endif	// GPOS_DEBUG
+
+// ctor
+CMemoryPoolSlab::CMemoryPoolSlab() : CMemoryPool()
+{
+	GPOS_ASSERT(GPOS_OFFSET(SLargeAllocHeader, m_tag) + GPOS_SIZEOF(SAllocTag) ==
+				GPOS_SIZEOF(SLargeAllocHeader));
+	GPOS_ASSERT(GPOS_MEM_SLAB_MAX_OBJECT_SIZE ==
+				ObjectSize(GPOS_MEM_SLAB_SIZE_CLASSES - 1));
+
+	for (ULONG ul = 0; ul < GPOS_MEM_SLAB_SIZE_CLASSES; ul++)
+	{
+		m_free_lists[ul] = nullptr;
+	}
+
+	m_large_allocs.Init(GPOS_OFFSET(SLargeAllocHeader, m_link));
+}
+
+// dtor
+CMemoryPoolSlab::~CMemoryPoolSlab()
+{
+	GPOS_ASSERT(nullptr == m_chunks);
+	GPOS_ASSERT(m_large_allocs.IsEmpty());
+}
+
+// size class of an object of the given size, including the tag
+ULONG
+CMemoryPoolSlab::SizeClass(ULONG object_size)
+{
+	GPOS_ASSERT(object_size <= GPOS_MEM_SLAB_MAX_OBJECT_SIZE);
+
+	if (object_size <= GPOS_MEM_SLAB_MIN_OBJECT_SIZE)
+	{
+		return 0;
+	}
+
+	if (object_size <= GPOS_MEM_SLAB_SMALL_OBJECT_SIZE)
+	{
+		return (object_size - GPOS_MEM_SLAB_MIN_OBJECT_SIZE + 15) / 16;
+	}
+
+	return (GPOS_MEM_SLAB_SMALL_OBJECT_SIZE - GPOS_MEM_SLAB_MIN_OBJECT_SIZE) /
+			   16 +
+		   (object_size - GPOS_MEM_SLAB_SMALL_OBJECT_SIZE + 63) / 64;
+}
+
+// object size of the given size class
+ULONG
+CMemoryPoolSlab::ObjectSize(ULONG size_class)
+{
+	GPOS_ASSERT(size_class < GPOS_MEM_SLAB_SIZE_CLASSES);
+
+	const ULONG small_classes =
+		(GPOS_MEM_SLAB_SMALL_OBJECT_SIZE - GPOS_MEM_SLAB_MIN_OBJECT_SIZE) / 16;
+
+	if (size_class <= small_classes)
+	{
+		return GPOS_MEM_SLAB_MIN_OBJECT_SIZE + size_class * 16;
+	}
+
+	return GPOS_MEM_SLAB_SMALL_OBJECT_SIZE + (size_class - small_classes) * 64;
+}
+
+// allocate a new chunk, large enough for an object of the given size; the
+// rest of the current chunk is abandoned
+void
+CMemoryPoolSlab::AddChunk(ULONG object_size GPOS_ASSERTS_ONLY)
+{
+	const ULONG header_size = GPOS_MEM_ALIGNED_STRUCT_SIZE(SChunk);
+	ULONG chunk_size = m_next_chunk_size;
+	GPOS_ASSERT(header_size + object_size <= chunk_size);
+
+	void *ptr = clib::Malloc(chunk_size);
+	GPOS_OOM_CHECK(ptr);
+
+	SChunk *chunk = static_cast<SChunk *>(ptr);
+	chunk->m_next = m_chunks;
+	m_chunks = chunk;
+
+	m_bump_pos = static_cast<BYTE *>(ptr) + header_size;
+	m_bump_end = static_cast<BYTE *>(ptr) + chunk_size;
+	m_total_size += chunk_size;
+
+	if (m_next_chunk_size < GPOS_MEM_SLAB_MAX_CHUNK_SIZE)
+	{
+		m_next_chunk_size *= 2;
+	}
+}
+
+// allocate a slab object of the given size class
+CMemoryPoolSlab::SAllocTag *
+CMemoryPoolSlab::PtagNewObject(ULONG size_class)
+{
+	SFreeObject *free_object = m_free_lists[size_class];
+	if (nullptr != free_object)
+	{
+		m_free_lists[size_class] = free_object->m_next;
+		return reinterpret_cast<SAllocTag *>(free_object) - 1;
+	}
+
+	const ULONG object_size = ObjectSize(size_class);
+	if (m_bump_pos + object_size > m_bump_end)
+	{
+		AddChunk(object_size);
+	}
+
+	SAllocTag *tag = reinterpret_cast<SAllocTag *>(m_bump_pos);
+	m_bump_pos += object_size;
+
+	return tag;
+}
+
+// allocate a large object of the given size, including the tag
+CMemoryPoolSlab::SAllocTag *
+CMemoryPoolSlab::PtagNewLargeAlloc(ULONG object_size)
+{
+	ULONG alloc_size = GPOS_SIZEOF(SLargeAllocHeader) - GPOS_SIZEOF(SAllocTag) +
+					   GPOS_MEM_ALIGNED_SIZE(object_size);
+
+	void *ptr = clib::Malloc(alloc_size);
+	GPOS_OOM_CHECK(ptr);
+
+	SLargeAllocHeader *header = static_cast<SLargeAllocHeader *>(ptr);
+	header->m_alloc_size = alloc_size;
+	m_large_allocs.Prepend(header);
+	m_total_size += alloc_size;
+
+	return &header->m_tag;
+}
+
+// allocate memory
+void *
+CMemoryPoolSlab::NewImpl(const ULONG bytes, const CHAR *, const ULONG,
+						 CMemoryPool::EAllocationType eat GPOS_ASSERTS_ONLY)
+{
+	GPOS_ASSERT(bytes <= GPOS_MEM_ALLOC_MAX);
+
+	const ULONG object_size =
+		GPOS_SIZEOF(SAllocTag) + bytes + GPOS_MEM_SLAB_GUARD_SIZE;
+
+	SAllocTag *tag = nullptr;
+	ULONG size_class = LargeAlloc;
+	if (object_size <= GPOS_MEM_SLAB_MAX_OBJECT_SIZE)
+	{
+		size_class = SizeClass(object_size);
+		tag = PtagNewObject(size_class);
+	}
+	else
+	{
+		tag = PtagNewLargeAlloc(object_size);
+	}
+
+	tag->m_mp = this;
+	tag->m_user_size = bytes;
+	tag->m_size_class = size_class;
+
+	void *ptr_result = tag + 1;
+
+#ifdef GPOS_DEBUG
+	clib::Memset(ptr_result, GPOS_MEM_INIT_PATTERN_CHAR, bytes);
+
+	BYTE *alloc_type = static_cast<BYTE *>(ptr_result) + bytes;
+	*alloc_type = eat;
+#endif	// GPOS_DEBUG
+
+	return ptr_result;
+}
+
+// release a slab object
+void
+CMemoryPoolSlab::FreeObject(void *ptr, ULONG size_class)
+{
+	SFreeObject *free_object = static_cast<SFreeObject *>(ptr);
+	free_object->m_next = m_free_lists[size_class];
+	m_free_lists[size_class] = free_object;
+}
+
+// release a large object
+void
+CMemoryPoolSlab::FreeLargeAlloc(SLargeAllocHeader *header)
+{
+	m_large_allocs.Remove(header);
+	m_total_size -= header->m_alloc_size;
+
+	clib::Free(header);
+}
+
+// free memory allocation
+void
+CMemoryPoolSlab::DeleteImpl(void *ptr, EAllocationType eat GPOS_ASSERTS_ONLY)
+{
+	SAllocTag *tag = static_cast<SAllocTag *>(ptr) - 1;
+	CMemoryPoolSlab *mp = static_cast<CMemoryPoolSlab *>(tag->m_mp);
+	GPOS_ASSERT(nullptr != mp);
+
+#ifdef GPOS_DEBUG
+	// this assert ensures we aren't writing past allocated memory
+	BYTE *alloc_type = static_cast<BYTE *>(ptr) + tag->m_user_size;
+	GPOS_ASSERT(eat == EatUnknown || *alloc_type == eat);
+
+	// mark user memory as unused in debug mode
+	clib::Memset(ptr, GPOS_MEM_FREED_PATTERN_CHAR, tag->m_user_size);
+#endif	// GPOS_DEBUG
+
+	if (LargeAlloc == tag->m_size_class)
+	{
+		mp->FreeLargeAlloc(reinterpret_cast<SLargeAllocHeader *>(tag + 1) - 1);
+	}
+	else
+	{
+		mp->FreeObject(ptr, tag->m_size_class);
+	}
+}
+
+// Prepare the memory pool to be deleted; releases all chunks, no matter
+// how many objects are still allocated from them
+void
+CMemoryPoolSlab::TearDown()
+{
+	while (!m_large_allocs.IsEmpty())
+	{
+		FreeLargeAlloc(m_large_allocs.First());
+	}
+
+	while (nullptr != m_chunks)
+	{
+		SChunk *chunk = m_chunks;
+		m_chunks = chunk->m_next;
+		clib::Free(chunk);
+	}
+
+	for (ULONG ul = 0; ul < GPOS_MEM_SLAB_SIZE_CLASSES; ul++)
+	{
+		m_free_lists[ul] = nullptr;
+	}
+
+	m_bump_pos = nullptr;
+	m_bump_end = nullptr;
+	m_total_size = 0;
+}
+
+// EOF
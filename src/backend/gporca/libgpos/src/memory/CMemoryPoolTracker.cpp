@@ -37,6 +37,9 @@ using namespace gpos;
 // ctor
 CMemoryPoolTracker::CMemoryPoolTracker() : CMemoryPool()
 {
+	GPOS_ASSERT(GPOS_OFFSET(SAllocHeader, m_tag) + GPOS_SIZEOF(SAllocTag) ==
+				GPOS_MEM_ALLOC_HEADER_SIZE);
+
 	m_allocations_list.Init(GPOS_OFFSET(SAllocHeader, m_link));
 }
 
@@ -50,7 +53,7 @@ CMemoryPoolTracker::~CMemoryPoolTracker()
 void
 CMemoryPoolTracker::RecordAllocation(SAllocHeader *header)
 {
-	m_memory_pool_statistics.RecordAllocation(header->m_user_size,
+	m_memory_pool_statistics.RecordAllocation(header->m_tag.m_user_size,
 											  header->m_alloc_size);
 	m_allocations_list.Prepend(header);
 }
@@ -58,7 +61,7 @@ CMemoryPoolTracker::RecordAllocation(SAllocHeader *header)
 void
 CMemoryPoolTracker::RecordFree(SAllocHeader *header)
 {
-	m_memory_pool_statistics.RecordFree(header->m_user_size,
+	m_memory_pool_statistics.RecordFree(header->m_tag.m_user_size,
 										header->m_alloc_size);
 	m_allocations_list.Remove(header);
 }
@@ -83,10 +86,11 @@ CMemoryPoolTracker::NewImpl(const ULONG bytes, const CHAR *file,
 	++m_alloc_sequence;
 
 	header->m_alloc_size = alloc_size;
-	header->m_mp = this;
 	header->m_filename = file;
 	header->m_line = line;
-	header->m_user_size = bytes;
+	header->m_tag.m_mp = this;
+	header->m_tag.m_user_size = bytes;
+	header->m_tag.m_size_class = TrackerAlloc;
 
 	RecordAllocation(header);
 
@@ -111,15 +115,16 @@ CMemoryPoolTracker::DeleteImpl(void *ptr, EAllocationType eat)
 {
 	SAllocHeader *header = static_cast<SAllocHeader *>(ptr) - 1;
 
-	ULONG user_size = header->m_user_size;
+	ULONG user_size = header->m_tag.m_user_size;
 	BYTE *alloc_type = static_cast<BYTE *>(ptr) + user_size;
 
 	// this assert ensures we aren't writing past allocated memory
 	GPOS_RTL_ASSERT(eat == EatUnknown || *alloc_type == eat);
 
 	// update stats and allocation list
-	GPOS_ASSERT(nullptr != header->m_mp);
-	header->m_mp->RecordFree(header);
+	GPOS_ASSERT(nullptr != header->m_tag.m_mp);
+	GPOS_ASSERT(TrackerAlloc == header->m_tag.m_size_class);
+	static_cast<CMemoryPoolTracker *>(header->m_tag.m_mp)->RecordFree(header);
 
 #ifdef GPOS_DEBUG
 	// mark user memory as unused in debug mode
@@ -129,12 +134,12 @@ CMemoryPoolTracker::DeleteImpl(void *ptr, EAllocationType eat)
 	clib::Free(header);
 }
 
-// get user requested size of allocation
+// get user requested size of allocation; also works for allocations of
+// slab pools, which share the trailing part of the header
 ULONG
 CMemoryPoolTracker::UserSizeOfAlloc(const void *ptr)
 {
-	const SAllocHeader *header = static_cast<const SAllocHeader *>(ptr) - 1;
-	return header->m_user_size;
+	return PtagOfAlloc(ptr)->m_user_size;
 }
 
 
@@ -164,8 +169,9 @@ CMemoryPoolTracker::WalkLiveObjects(gpos::IMemoryVisitor *visitor)
 	{
 		void *user = header + 1;
 
-		visitor->Visit(user, header->m_user_size, header, header->m_alloc_size,
-					   header->m_filename, header->m_line, header->m_serial,
+		visitor->Visit(user, header->m_tag.m_user_size, header,
+					   header->m_alloc_size, header->m_filename, header->m_line,
+					   header->m_serial,
 #ifdef GPOS_DEBUG
 					   &header->m_stack_desc
 #else
@@ -15,6 +15,7 @@
 
 #include "gpos/base.h"
 #include "gpos/common/CAutoTimer.h"
+#include "gpos/common/CBitVector.h"
 #include "gpos/common/clibwrapper.h"
 #include "gpos/error/CErrorHandlerStandard.h"
 #include "gpos/memory/CAutoMemoryPool.h"
@@ -83,10 +83,35 @@ public:
 	static CParseHandlerDXL *GetParseHandlerForDXLString(
 		CMemoryPool *, const CHAR *dxl_string, const CHAR *xsd_file_path);
 
-	// same as above but with DXL file name specified instead of the file contents
+	// same as above but with DXL file name specified instead of the file
+	// contents; the file may hold either XML or binary DXL
 	static CParseHandlerDXL *GetParseHandlerForDXLFile(
 		CMemoryPool *, const CHAR *dxl_filename, const CHAR *xsd_file_path);
 
+	// same as above but for a binary DXL document
+	static CParseHandlerDXL *GetParseHandlerForBinaryDXL(CMemoryPool *,
+														 const BYTE *buffer,
+														 ULONG size);
+
+	// read the given file if it holds a binary DXL document; returns null
+	// if it does not
+	static BYTE *ReadBinaryDXLFile(CMemoryPool *, const CHAR *filename,
+								   ULONG *size);
+
+	// convert the given XML DXL document to binary DXL
+	static BYTE *CreateBinaryDXL(CMemoryPool *, const CHAR *dxl_string,
+								 ULONG *size);
+
+	// same as above but with DXL file name specified instead of the file contents
+	static BYTE *CreateBinaryDXLFromFile(CMemoryPool *,
+										 const CHAR *dxl_filename,
+										 ULONG *size);
+
+	// serialize a binary DXL document as XML
+	static void SerializeBinaryDXL(CMemoryPool *, IOstream &os,
+								   const BYTE *buffer, ULONG size,
+								   BOOL indentation);
+
 	// parse a DXL document containing a DXL plan
 	static CDXLNode *GetPlanDXLNode(CMemoryPool *, const CHAR *dxl_string,
 									const CHAR *xsd_file_path, ULLONG *plan_id,
@@ -28,6 +28,7 @@ using namespace gpos;
 // fwd decl
 class CParseHandlerPhysicalOp;
 class CDXLMemoryManager;
+class CDXLBinaryReader;
 
 // stack of parse handlers
 using ParseHandlerStack = CStack<CParseHandlerBase>;
@@ -51,6 +52,9 @@ private:
 	// parser object responsible for parsing the current XML document
 	SAX2XMLReader *m_xml_reader;
 
+	// reader of the current document if it is binary DXL
+	CDXLBinaryReader *m_binary_reader;
+
 	// current parse handler
 	CParseHandlerBase *m_curr_parse_handler;
 
@@ -63,12 +67,16 @@ private:
 	// check for aborts at regular intervals
 	void CheckForAborts();
 
+	// direct the events of the document to the given handler
+	void SetContentHandler(CParseHandlerBase *parse_handler_base);
+
 
 public:
 	CParseHandlerManager(const CParseHandlerManager &) = delete;
 
 	// ctor/dtor
 	CParseHandlerManager(CDXLMemoryManager *, SAX2XMLReader *);
+	CParseHandlerManager(CDXLMemoryManager *, CDXLBinaryReader *);
 	~CParseHandlerManager();
 
 
@@ -0,0 +1,212 @@
+//---------------------------------------------------------------------------
+//	Greenplum Database
+//	Copyright (C) 2024 VMware, Inc. or its affiliates.
+//
+//	@filename:
+//		CDXLBinaryReader.h
+//
+//	@doc:
+//		Streaming reader for the binary encoding of DXL documents
+//---------------------------------------------------------------------------
+
+#ifndef GPDXL_CDXLBinaryReader_H
+#define GPDXL_CDXLBinaryReader_H
+
+#include <xercesc/sax2/Attributes.hpp>
+#include <xercesc/sax2/DefaultHandler.hpp>
+
+#include "gpos/base.h"
+#include "gpos/common/CDynamicPtrArray.h"
+#include "gpos/string/CWStringDynamic.h"
+
+namespace gpdxl
+{
+using namespace gpos;
+
+XERCES_CPP_NAMESPACE_USE
+
+// fwd decl
+class CXMLSerializer;
+
+// magic bytes at the start of a binary DXL document, followed by the version
+#define GPDXL_BINARY_MAGIC "\x89" "DXB"
+#define GPDXL_BINARY_MAGIC_LENGTH (4)
+#define GPDXL_BINARY_VERSION (1)
+
+// attribute values up to this length (in XMLCh code units) are added to the
+// string table when they first appear, and referred to by index afterwards
+#define GPDXL_BINARY_MAX_INTERNED_LENGTH (64)
+
+// events of a binary DXL document
+enum EDXLBinaryEvent
+{
+	EdxlbeEndDocument = 0,
+	EdxlbeStartElement,
+	EdxlbeEndElement,
+
+	EdxlbeSentinel
+};
+
+using XMLChArray = CDynamicPtrArray<XMLCh, CleanupDeleteArray>;
+using ConstXMLChArray = CDynamicPtrArray<const XMLCh, CleanupNULL>;
+
+//---------------------------------------------------------------------------
+//	@class:
+//		CDXLBinaryReader
+//
+//	@doc:
+//		Reads a DXL document encoded by CDXLBinaryWriter.
+//
+//		The binary encoding is a sequence of SAX events: the start of an
+//		element carries the element's names and attributes, the end of an
+//		element carries nothing, as the reader keeps track of the open
+//		elements. All strings are written as a reference into a string table
+//		that is built while reading the document; a string that is not in the
+//		table yet is written inline, and added to the table, unless it is an
+//		attribute value longer than GPDXL_BINARY_MAX_INTERNED_LENGTH. Numbers
+//		are written as unsigned LEB128 varints, and characters as the UTF-8
+//		encoding of each XMLCh code unit.
+//
+//		The reader replays the events into a content handler, in the same way
+//		a Xerces SAX2XMLReader does, so that documents are parsed by the
+//		regular DXL parse handlers. Character data isn't encoded, as the parse
+//		handlers ignore it.
+//
+//---------------------------------------------------------------------------
+class CDXLBinaryReader
+{
+private:
+	//---------------------------------------------------------------------------
+	//	@class:
+	//		CAttributes
+	//
+	//	@doc:
+	//		Attributes of the current element, as passed to startElement
+	//
+	//---------------------------------------------------------------------------
+	class CAttributes : public Attributes
+	{
+	private:
+		// uri, local name, qualified name and value of each attribute
+		ConstXMLChArray *m_uris;
+		ConstXMLChArray *m_local_names;
+		ConstXMLChArray *m_qnames;
+		ConstXMLChArray *m_values;
+
+	public:
+		CAttributes(const CAttributes &) = delete;
+
+		// ctor
+		explicit CAttributes(CMemoryPool *mp);
+
+		// dtor
+		~CAttributes() override;
+
+		// remove all attributes
+		void Clear();
+
+		// add an attribute
+		void Append(const XMLCh *uri, const XMLCh *local_name,
+					const XMLCh *qname, const XMLCh *value);
+
+		// Attributes interface functions
+		XMLSize_t getLength() const override;
+		const XMLCh *getURI(const XMLSize_t index) const override;
+		const XMLCh *getLocalName(const XMLSize_t index) const override;
+		const XMLCh *getQName(const XMLSize_t index) const override;
+		const XMLCh *getType(const XMLSize_t index) const override;
+		const XMLCh *getValue(const XMLSize_t index) const override;
+		bool getIndex(const XMLCh *const uri, const XMLCh *const local_name,
+					  XMLSize_t &index) const override;
+		int getIndex(const XMLCh *const uri,
+					 const XMLCh *const local_name) const override;
+		bool getIndex(const XMLCh *const qname,
+					  XMLSize_t &index) const override;
+		int getIndex(const XMLCh *const qname) const override;
+		const XMLCh *getType(const XMLCh *const uri,
+							 const XMLCh *const local_name) const override;
+		const XMLCh *getType(const XMLCh *const qname) const override;
+		const XMLCh *getValue(const XMLCh *const uri,
+							  const XMLCh *const local_name) const override;
+		const XMLCh *getValue(const XMLCh *const qname) const override;
+	};
+
+	// memory pool
+	CMemoryPool *m_mp;
+
+	// unread part of the document
+	const BYTE *m_pos;
+	const BYTE *m_end;
+
+	// handler receiving the events
+	DefaultHandler *m_content_handler;
+
+	// string table
+	XMLChArray *m_strings;
+
+	// attribute values of the current event that are not in the string table
+	XMLChArray *m_uninterned_strings;
+
+	// uri, local name and qualified name of the open elements
+	ConstXMLChArray *m_open_elements;
+
+	// names of the current element
+	const XMLCh *m_uri;
+	const XMLCh *m_local_name;
+	const XMLCh *m_qname;
+
+	// attributes of the current element
+	CAttributes m_attributes;
+
+	// raise an error for a malformed document
+	static void RaiseFormatError();
+
+	// read a byte
+	BYTE ReadByte();
+
+	// read an unsigned varint
+	ULONG ReadULONG();
+
+	// read a string; names are always added to the string table
+	const XMLCh *ReadString(BOOL is_name);
+
+	// read and check the document header
+	void ReadHeader();
+
+	// create a GPOS string from a Xerces string
+	static CWStringDynamic *CreateString(CMemoryPool *mp,
+										 const XMLCh *xml_str);
+
+	// read the next event
+	EDXLBinaryEvent ReadEvent();
+
+public:
+	CDXLBinaryReader(const CDXLBinaryReader &) = delete;
+
+	// ctor
+	CDXLBinaryReader(CMemoryPool *mp, const BYTE *buffer, ULONG size);
+
+	// dtor
+	~CDXLBinaryReader();
+
+	// is the given buffer a binary DXL document
+	static BOOL IsBinaryDXL(const BYTE *buffer, ULONG size);
+
+	// set the handler receiving the events; may be changed while parsing
+	void
+	SetContentHandler(DefaultHandler *content_handler)
+	{
+		m_content_handler = content_handler;
+	}
+
+	// replay the document into the content handler
+	void Parse();
+
+	// write the document as XML
+	void Serialize(CXMLSerializer *xml_serializer);
+};
+}  // namespace gpdxl
+
+#endif	// !GPDXL_CDXLBinaryReader_H
+
+// EOF
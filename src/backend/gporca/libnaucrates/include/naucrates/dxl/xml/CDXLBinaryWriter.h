@@ -0,0 +1,133 @@
+//---------------------------------------------------------------------------
+//	Greenplum Database
+//	Copyright (C) 2024 VMware, Inc. or its affiliates.
+//
+//	@filename:
+//		CDXLBinaryWriter.h
+//
+//	@doc:
+//		SAX content handler writing the binary encoding of a DXL document
+//---------------------------------------------------------------------------
+
+#ifndef GPDXL_CDXLBinaryWriter_H
+#define GPDXL_CDXLBinaryWriter_H
+
+#include <xercesc/sax2/Attributes.hpp>
+#include <xercesc/sax2/DefaultHandler.hpp>
+
+#include "gpos/base.h"
+#include "gpos/common/CHashMap.h"
+
+#include "naucrates/dxl/xml/CDXLBinaryReader.h"
+
+namespace gpdxl
+{
+using namespace gpos;
+
+XERCES_CPP_NAMESPACE_USE
+
+//---------------------------------------------------------------------------
+//	@class:
+//		CDXLBinaryWriter
+//
+//	@doc:
+//		Encodes the SAX events of a DXL document in the format described in
+//		CDXLBinaryReader. Install it as the content handler of a Xerces
+//		SAX2XMLReader to convert an XML document.
+//
+//---------------------------------------------------------------------------
+class CDXLBinaryWriter : public DefaultHandler
+{
+private:
+	// key of the string table
+	struct SString
+	{
+		// characters, not null-terminated
+		XMLCh *m_chars;
+
+		// number of characters
+		ULONG m_length;
+	};
+
+	// hash function for string table keys
+	static ULONG HashString(const SString *str);
+
+	// equality function for string table keys
+	static BOOL StringEquals(const SString *str1, const SString *str2);
+
+	// release a string table key
+	static void CleanupString(SString *str);
+
+	// map of strings to their index in the string table
+	using StringToIdMap = CHashMap<SString, ULONG, HashString, StringEquals,
+								   CleanupString, CleanupDelete<ULONG>>;
+
+	// memory pool
+	CMemoryPool *m_mp;
+
+	// encoded document
+	BYTE *m_buffer;
+
+	// bytes used and allocated
+	ULONG m_size;
+	ULONG m_capacity;
+
+	// string table
+	StringToIdMap *m_string_ids;
+
+	// make room for the given number of bytes
+	void Reserve(ULONG bytes);
+
+	// write a byte
+	void
+	WriteByte(BYTE byte)
+	{
+		m_buffer[m_size++] = byte;
+	}
+
+	// write an unsigned varint
+	void WriteULONG(ULONG value);
+
+	// write a string; names are always added to the string table
+	void WriteString(const XMLCh *xml_str, BOOL is_name);
+
+public:
+	CDXLBinaryWriter(const CDXLBinaryWriter &) = delete;
+
+	// ctor
+	explicit CDXLBinaryWriter(CMemoryPool *mp);
+
+	// dtor
+	~CDXLBinaryWriter() override;
+
+	// encoded document
+	const BYTE *
+	GetBuffer() const
+	{
+		return m_buffer;
+	}
+
+	// size of the encoded document
+	ULONG
+	Size() const
+	{
+		return m_size;
+	}
+
+	// DefaultHandler interface functions
+	void startElement(const XMLCh *const element_uri,
+					  const XMLCh *const element_local_name,
+					  const XMLCh *const element_qname,
+					  const Attributes &attr) override;
+
+	void endElement(const XMLCh *const element_uri,
+					const XMLCh *const element_local_name,
+					const XMLCh *const element_qname) override;
+
+	void endDocument() override;
+};
+}  // namespace gpdxl
+
+#endif	// !GPDXL_CDXLBinaryWriter_H
+
+// EOF
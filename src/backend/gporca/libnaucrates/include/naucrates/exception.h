@@ -40,6 +40,7 @@ enum ExMinor
 	ExmiDXLUnrecognizedCompOperator,
 	ExmiDXLValidationError,
 	ExmiDXLXercesParseError,
+	ExmiDXLBinaryFormatError,
 	ExmiDXLIncorrectNumberOfChildren,
 	ExmiDXL2PlStmtConversion,
 	ExmiQuery2DXLAttributeNotFound,
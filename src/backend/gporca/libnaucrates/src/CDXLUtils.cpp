@@ -39,6 +39,8 @@
 #include "naucrates/dxl/parser/CParseHandlerFactory.h"
 #include "naucrates/dxl/parser/CParseHandlerManager.h"
 #include "naucrates/dxl/parser/CParseHandlerPlan.h"
+#include "naucrates/dxl/xml/CDXLBinaryReader.h"
+#include "naucrates/dxl/xml/CDXLBinaryWriter.h"
 #include "naucrates/dxl/xml/CDXLMemoryManager.h"
 #include "naucrates/dxl/xml/CXMLSerializer.h"
 #include "naucrates/md/CDXLStatsDerivedRelation.h"
@@ -156,6 +158,15 @@ CDXLUtils::GetParseHandlerForDXLFile(CMemoryPool *mp, const CHAR *dxl_filename,
 {
 	GPOS_ASSERT(nullptr != mp);
 
+	// binary DXL documents are replayed into the parse handlers directly,
+	// without schema validation
+	ULONG binary_size = 0;
+	CAutoRg<BYTE> binary_dxl(ReadBinaryDXLFile(mp, dxl_filename, &binary_size));
+	if (nullptr != binary_dxl.Rgt())
+	{
+		return GetParseHandlerForBinaryDXL(mp, binary_dxl.Rgt(), binary_size);
+	}
+
 	// setup own memory manager
 	CDXLMemoryManager mm(mp);
 	SAX2XMLReader *sax_2_xml_reader = nullptr;
@@ -257,6 +268,195 @@ CDXLUtils::GetParseHandlerForDXLString(CMemoryPool *mp,
 
 
 
+//---------------------------------------------------------------------------
+//	@function:
+//		CDXLUtils::GetParseHandlerForBinaryDXL
+//
+//	@doc:
+//		Parse the given binary DXL document and return the top-level parser
+//
+//---------------------------------------------------------------------------
+CParseHandlerDXL *
+CDXLUtils::GetParseHandlerForBinaryDXL(CMemoryPool *mp, const BYTE *buffer,
+									   ULONG size)
+{
+	GPOS_ASSERT(nullptr != mp);
+	GPOS_ASSERT(nullptr != buffer);
+
+	CDXLMemoryManager mm(mp);
+	CDXLBinaryReader binary_reader(mp, buffer, size);
+
+	CParseHandlerManager parse_handler_mgr(&mm, &binary_reader);
+	CParseHandlerDXL *parse_handler_dxl =
+		CParseHandlerFactory::GetParseHandlerDXL(mp, &parse_handler_mgr);
+	parse_handler_mgr.ActivateParseHandler(parse_handler_dxl);
+
+	GPOS_TRY
+	{
+		binary_reader.Parse();
+	}
+	GPOS_CATCH_EX(ex)
+	{
+		GPOS_DELETE(parse_handler_dxl);
+		GPOS_RETHROW(ex);
+	}
+	GPOS_CATCH_END;
+
+	GPOS_CHECK_ABORT;
+
+	return parse_handler_dxl;
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CDXLUtils::ReadBinaryDXLFile
+//
+//	@doc:
+//		Read the given file in a byte buffer if it holds a binary DXL
+//		document, and return null otherwise. The function allocates memory
+//		from the provided memory pool, and it is the responsibility of the
+//		caller to deallocate it.
+//
+//---------------------------------------------------------------------------
+BYTE *
+CDXLUtils::ReadBinaryDXLFile(CMemoryPool *mp, const CHAR *filename,
+							 ULONG *size)
+{
+	GPOS_ASSERT(nullptr != size);
+
+	// leave reporting missing files to the XML parser
+	if (!ioutils::IsFile(filename))
+	{
+		return nullptr;
+	}
+
+	CFileReader fr;
+	fr.Open(filename);
+
+	const ULONG_PTR file_size = (ULONG_PTR) fr.FileSize();
+	BYTE magic[GPDXL_BINARY_MAGIC_LENGTH];
+	if (GPDXL_BINARY_MAGIC_LENGTH > file_size ||
+		GPDXL_BINARY_MAGIC_LENGTH !=
+			fr.ReadBytesToBuffer(magic, GPDXL_BINARY_MAGIC_LENGTH) ||
+		!CDXLBinaryReader::IsBinaryDXL(magic, GPDXL_BINARY_MAGIC_LENGTH))
+	{
+		fr.Close();
+		return nullptr;
+	}
+
+	CAutoRg<BYTE> read_buffer(GPOS_NEW_ARRAY(mp, BYTE, file_size));
+	(void) clib::Memcpy(read_buffer.Rgt(), magic, GPDXL_BINARY_MAGIC_LENGTH);
+
+	ULONG_PTR read_bytes GPOS_ASSERTS_ONLY = fr.ReadBytesToBuffer(
+		read_buffer.Rgt() + GPDXL_BINARY_MAGIC_LENGTH,
+		file_size - GPDXL_BINARY_MAGIC_LENGTH);
+	fr.Close();
+
+	GPOS_ASSERT(read_bytes == file_size - GPDXL_BINARY_MAGIC_LENGTH);
+
+	*size = (ULONG) file_size;
+	return read_buffer.RgtReset();
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CDXLUtils::CreateBinaryDXL
+//
+//	@doc:
+//		Convert the given XML DXL document to binary DXL. The function
+//		allocates the returned buffer in the provided memory pool, and it is
+//		the responsibility of the caller to release it.
+//
+//---------------------------------------------------------------------------
+BYTE *
+CDXLUtils::CreateBinaryDXL(CMemoryPool *mp, const CHAR *dxl_string,
+						   ULONG *size)
+{
+	GPOS_ASSERT(nullptr != mp);
+	GPOS_ASSERT(nullptr != size);
+
+	CDXLMemoryManager mm(mp);
+	SAX2XMLReader *sax_2_xml_reader = XMLReaderFactory::createXMLReader(&mm);
+
+	CDXLBinaryWriter binary_writer(mp);
+	sax_2_xml_reader->setContentHandler(&binary_writer);
+	sax_2_xml_reader->setErrorHandler(&binary_writer);
+
+	MemBufInputSource input_src_memory_buffer(
+		(const XMLByte *) dxl_string, strlen(dxl_string), "dxl test", false,
+		&mm);
+
+	try
+	{
+		sax_2_xml_reader->parse(input_src_memory_buffer);
+	}
+	catch (const XMLException &)
+	{
+		delete sax_2_xml_reader;
+		GPOS_RAISE(gpdxl::ExmaDXL, gpdxl::ExmiDXLXercesParseError);
+		return nullptr;
+	}
+	catch (const SAXParseException &)
+	{
+		delete sax_2_xml_reader;
+		GPOS_RAISE(gpdxl::ExmaDXL, gpdxl::ExmiDXLXercesParseError);
+		return nullptr;
+	}
+	catch (const SAXException &)
+	{
+		delete sax_2_xml_reader;
+		GPOS_RAISE(gpdxl::ExmaDXL, gpdxl::ExmiDXLXercesParseError);
+		return nullptr;
+	}
+
+	delete sax_2_xml_reader;
+
+	*size = binary_writer.Size();
+	BYTE *buffer = GPOS_NEW_ARRAY(mp, BYTE, *size);
+	(void) clib::Memcpy(buffer, binary_writer.GetBuffer(), *size);
+
+	return buffer;
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CDXLUtils::CreateBinaryDXLFromFile
+//
+//	@doc:
+//		Convert the given XML DXL file to binary DXL. The function allocates
+//		the returned buffer in the provided memory pool, and it is the
+//		responsibility of the caller to release it.
+//
+//---------------------------------------------------------------------------
+BYTE *
+CDXLUtils::CreateBinaryDXLFromFile(CMemoryPool *mp, const CHAR *dxl_filename,
+								   ULONG *size)
+{
+	CAutoRg<CHAR> dxl_string(Read(mp, dxl_filename));
+
+	return CreateBinaryDXL(mp, dxl_string.Rgt(), size);
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CDXLUtils::SerializeBinaryDXL
+//
+//	@doc:
+//		Serialize a binary DXL document as XML
+//
+//---------------------------------------------------------------------------
+void
+CDXLUtils::SerializeBinaryDXL(CMemoryPool *mp, IOstream &os,
+							  const BYTE *buffer, ULONG size,
+							  BOOL indentation)
+{
+	GPOS_ASSERT(nullptr != buffer);
+
+	CXMLSerializer xml_serializer(mp, os, indentation);
+	CDXLBinaryReader binary_reader(mp, buffer, size);
+	binary_reader.Serialize(&xml_serializer);
+}
+
 //---------------------------------------------------------------------------
 //	@function:
 //		CDXLUtils::GetPlanDXLNode
@@ -11,6 +11,7 @@
 
 #include "naucrates/dxl/parser/CParseHandlerManager.h"
 
+#include "naucrates/dxl/xml/CDXLBinaryReader.h"
 #include "naucrates/dxl/xml/CDXLMemoryManager.h"
 
 using namespace gpdxl;
@@ -31,6 +32,27 @@ CParseHandlerManager::CParseHandlerManager(
 	CDXLMemoryManager *dxl_memory_manager, SAX2XMLReader *sax_2_xml_reader)
 	: m_dxl_memory_manager(dxl_memory_manager),
 	  m_xml_reader(sax_2_xml_reader),
+	  m_binary_reader(nullptr),
+	  m_curr_parse_handler(nullptr),
+	  m_iteration_since_last_abortcheck(0)
+{
+	m_parse_handler_stack = GPOS_NEW(dxl_memory_manager->Pmp())
+		ParseHandlerStack(dxl_memory_manager->Pmp());
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CParseHandlerManager::CParseHandlerManager
+//
+//	@doc:
+//		Constructor for parsing a binary DXL document
+//
+//---------------------------------------------------------------------------
+CParseHandlerManager::CParseHandlerManager(
+	CDXLMemoryManager *dxl_memory_manager, CDXLBinaryReader *binary_reader)
+	: m_dxl_memory_manager(dxl_memory_manager),
+	  m_xml_reader(nullptr),
+	  m_binary_reader(binary_reader),
 	  m_curr_parse_handler(nullptr),
 	  m_iteration_since_last_abortcheck(0)
 {
@@ -75,8 +97,7 @@ CParseHandlerManager::ActivateParseHandler(
 	GPOS_ASSERT(nullptr != parse_handler_base);
 
 	m_curr_parse_handler = parse_handler_base;
-	m_xml_reader->setContentHandler(parse_handler_base);
-	m_xml_reader->setErrorHandler(parse_handler_base);
+	SetContentHandler(parse_handler_base);
 }
 
 //---------------------------------------------------------------------------
@@ -103,8 +124,7 @@ CParseHandlerManager::ReplaceHandler(CParseHandlerBase *parse_handler_base,
 	}
 
 	m_curr_parse_handler = parse_handler_base;
-	m_xml_reader->setContentHandler(parse_handler_base);
-	m_xml_reader->setErrorHandler(parse_handler_base);
+	SetContentHandler(parse_handler_base);
 }
 
 
@@ -133,8 +153,7 @@ CParseHandlerManager::DeactivateHandler()
 		m_curr_parse_handler = nullptr;
 	}
 
-	m_xml_reader->setContentHandler(m_curr_parse_handler);
-	m_xml_reader->setErrorHandler(m_curr_parse_handler);
+	SetContentHandler(m_curr_parse_handler);
 }
 
 //---------------------------------------------------------------------------
@@ -151,6 +170,27 @@ CParseHandlerManager::GetCurrentParseHandler()
 	return m_curr_parse_handler;
 }
 
+//---------------------------------------------------------------------------
+//	@function:
+//		CParseHandlerManager::SetContentHandler
+//
+//	@doc:
+//		Install the given handler in the reader of the current document
+//
+//---------------------------------------------------------------------------
+void
+CParseHandlerManager::SetContentHandler(CParseHandlerBase *parse_handler_base)
+{
+	if (nullptr != m_binary_reader)
+	{
+		m_binary_reader->SetContentHandler(parse_handler_base);
+		return;
+	}
+
+	m_xml_reader->setContentHandler(parse_handler_base);
+	m_xml_reader->setErrorHandler(parse_handler_base);
+}
+
 //---------------------------------------------------------------------------
 //	@function:
 //		CParseHandlerManager::CheckForAborts
@@ -0,0 +1,699 @@
+//---------------------------------------------------------------------------
+//	Greenplum Database
+//	Copyright (C) 2024 VMware, Inc. or its affiliates.
+//
+//	@filename:
+//		CDXLBinaryReader.cpp
+//
+//	@doc:
+//		Implementation of the streaming reader for binary DXL documents
+//---------------------------------------------------------------------------
+
+#include "naucrates/dxl/xml/CDXLBinaryReader.h"
+
+#include <xercesc/util/XMLString.hpp>
+#include <xercesc/util/XMLUni.hpp>
+
+#include "gpos/common/CAutoP.h"
+#include "gpos/common/CAutoRef.h"
+#include "gpos/common/CAutoRg.h"
+#include "gpos/common/clibwrapper.h"
+
+#include "naucrates/dxl/xml/CXMLSerializer.h"
+#include "naucrates/exception.h"
+
+using namespace gpdxl;
+
+// maximum length of an encoded varint
+#define GPDXL_BINARY_MAX_VARINT_LENGTH (5)
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CDXLBinaryReader::CAttributes::CAttributes
+//
+//	@doc:
+//		Ctor
+//
+//---------------------------------------------------------------------------
+CDXLBinaryReader::CAttributes::CAttributes(CMemoryPool *mp)
+	: m_uris(GPOS_NEW(mp) ConstXMLChArray(mp)),
+	  m_local_names(GPOS_NEW(mp) ConstXMLChArray(mp)),
+	  m_qnames(GPOS_NEW(mp) ConstXMLChArray(mp)),
+	  m_values(GPOS_NEW(mp) ConstXMLChArray(mp))
+{
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CDXLBinaryReader::CAttributes::~CAttributes
+//
+//	@doc:
+//		Dtor
+//
+//---------------------------------------------------------------------------
+CDXLBinaryReader::CAttributes::~CAttributes()
+{
+	m_uris->Release();
+	m_local_names->Release();
+	m_qnames->Release();
+	m_values->Release();
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CDXLBinaryReader::CAttributes::Clear
+//
+//	@doc:
+//		Remove all attributes
+//
+//---------------------------------------------------------------------------
+void
+CDXLBinaryReader::CAttributes::Clear()
+{
+	m_uris->Clear();
+	m_local_names->Clear();
+	m_qnames->Clear();
+	m_values->Clear();
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CDXLBinaryReader::CAttributes::Append
+//
+//	@doc:
+//		Add an attribute
+//
+//---------------------------------------------------------------------------
+void
+CDXLBinaryReader::CAttributes::Append(const XMLCh *uri,
+									  const XMLCh *local_name,
+									  const XMLCh *qname, const XMLCh *value)
+{
+	m_uris->Append(uri);
+	m_local_names->Append(local_name);
+	m_qnames->Append(qname);
+	m_values->Append(value);
+}
+
+XMLSize_t
+CDXLBinaryReader::CAttributes::getLength() const
+{
+	return m_values->Size();
+}
+
+const XMLCh *
+CDXLBinaryReader::CAttributes::getURI(const XMLSize_t index) const
+{
+	if (index >= m_values->Size())
+	{
+		return nullptr;
+	}
+
+	return (*m_uris)[(ULONG) index];
+}
+
+const XMLCh *
+CDXLBinaryReader::CAttributes::getLocalName(const XMLSize_t index) const
+{
+	if (index >= m_values->Size())
+	{
+		return nullptr;
+	}
+
+	return (*m_local_names)[(ULONG) index];
+}
+
+const XMLCh *
+CDXLBinaryReader::CAttributes::getQName(const XMLSize_t index) const
+{
+	if (index >= m_values->Size())
+	{
+		return nullptr;
+	}
+
+	return (*m_qnames)[(ULONG) index];
+}
+
+const XMLCh *
+CDXLBinaryReader::CAttributes::getType(const XMLSize_t index) const
+{
+	if (index >= m_values->Size())
+	{
+		return nullptr;
+	}
+
+	// attributes are not validated, so they are all of type CDATA
+	return XMLUni::fgCDATAString;
+}
+
+const XMLCh *
+CDXLBinaryReader::CAttributes::getValue(const XMLSize_t index) const
+{
+	if (index >= m_values->Size())
+	{
+		return nullptr;
+	}
+
+	return (*m_values)[(ULONG) index];
+}
+
+bool
+CDXLBinaryReader::CAttributes::getIndex(const XMLCh *const uri,
+										const XMLCh *const local_name,
+										XMLSize_t &index) const
+{
+	const ULONG size = m_values->Size();
+	for (ULONG ul = 0; ul < size; ul++)
+	{
+		if (XMLString::equals((*m_local_names)[ul], local_name) &&
+			XMLString::equals((*m_uris)[ul], uri))
+		{
+			index = ul;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+int
+CDXLBinaryReader::CAttributes::getIndex(const XMLCh *const uri,
+										const XMLCh *const local_name) const
+{
+	XMLSize_t index = 0;
+	if (getIndex(uri, local_name, index))
+	{
+		return (int) index;
+	}
+
+	return -1;
+}
+
+bool
+CDXLBinaryReader::CAttributes::getIndex(const XMLCh *const qname,
+										XMLSize_t &index) const
+{
+	const ULONG size = m_values->Size();
+	for (ULONG ul = 0; ul < size; ul++)
+	{
+		if (XMLString::equals((*m_qnames)[ul], qname))
+		{
+			index = ul;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+int
+CDXLBinaryReader::CAttributes::getIndex(const XMLCh *const qname) const
+{
+	XMLSize_t index = 0;
+	if (getIndex(qname, index))
+	{
+		return (int) index;
+	}
+
+	return -1;
+}
+
+const XMLCh *
+CDXLBinaryReader::CAttributes::getType(const XMLCh *const uri,
+									   const XMLCh *const local_name) const
+{
+	XMLSize_t index = 0;
+	if (getIndex(uri, local_name, index))
+	{
+		return getType(index);
+	}
+
+	return nullptr;
+}
+
+const XMLCh *
+CDXLBinaryReader::CAttributes::getType(const XMLCh *const qname) const
+{
+	XMLSize_t index = 0;
+	if (getIndex(qname, index))
+	{
+		return getType(index);
+	}
+
+	return nullptr;
+}
+
+const XMLCh *
+CDXLBinaryReader::CAttributes::getValue(const XMLCh *const uri,
+										const XMLCh *const local_name) const
+{
+	XMLSize_t index = 0;
+	if (getIndex(uri, local_name, index))
+	{
+		return getValue(index);
+	}
+
+	return nullptr;
+}
+
+const XMLCh *
+CDXLBinaryReader::CAttributes::getValue(const XMLCh *const qname) const
+{
+	XMLSize_t index = 0;
+	if (getIndex(qname, index))
+	{
+		return getValue(index);
+	}
+
+	return nullptr;
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CDXLBinaryReader::CDXLBinaryReader
+//
+//	@doc:
+//		Ctor; the buffer must outlive the reader
+//
+//---------------------------------------------------------------------------
+CDXLBinaryReader::CDXLBinaryReader(CMemoryPool *mp, const BYTE *buffer,
+								   ULONG size)
+	: m_mp(mp),
+	  m_pos(buffer),
+	  m_end(buffer + size),
+	  m_content_handler(nullptr),
+	  m_strings(nullptr),
+	  m_uninterned_strings(nullptr),
+	  m_open_elements(nullptr),
+	  m_uri(nullptr),
+	  m_local_name(nullptr),
+	  m_qname(nullptr),
+	  m_attributes(mp)
+{
+	GPOS_ASSERT(nullptr != buffer);
+
+	m_strings = GPOS_NEW(m_mp) XMLChArray(m_mp, 1024);
+	m_uninterned_strings = GPOS_NEW(m_mp) XMLChArray(m_mp);
+	m_open_elements = GPOS_NEW(m_mp) ConstXMLChArray(m_mp, 96);
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CDXLBinaryReader::~CDXLBinaryReader
+//
+//	@doc:
+//		Dtor
+//
+//---------------------------------------------------------------------------
+CDXLBinaryReader::~CDXLBinaryReader()
+{
+	m_strings->Release();
+	m_uninterned_strings->Release();
+	m_open_elements->Release();
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CDXLBinaryReader::IsBinaryDXL
+//
+//	@doc:
+//		Does the buffer start with the magic bytes of binary DXL
+//
+//---------------------------------------------------------------------------
+BOOL
+CDXLBinaryReader::IsBinaryDXL(const BYTE *buffer, ULONG size)
+{
+	return GPDXL_BINARY_MAGIC_LENGTH <= size &&
+		   0 == clib::Memcmp(buffer, GPDXL_BINARY_MAGIC,
+							 GPDXL_BINARY_MAGIC_LENGTH);
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CDXLBinaryReader::RaiseFormatError
+//
+//	@doc:
+//		Raise an error for a malformed document
+//
+//---------------------------------------------------------------------------
+void
+CDXLBinaryReader::RaiseFormatError()
+{
+	GPOS_RAISE(gpdxl::ExmaDXL, gpdxl::ExmiDXLBinaryFormatError);
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CDXLBinaryReader::ReadByte
+//
+//	@doc:
+//		Read a byte
+//
+//---------------------------------------------------------------------------
+BYTE
+CDXLBinaryReader::ReadByte()
+{
+	if (m_pos == m_end)
+	{
+		RaiseFormatError();
+	}
+
+	return *m_pos++;
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CDXLBinaryReader::ReadULONG
+//
+//	@doc:
+//		Read an unsigned varint
+//
+//---------------------------------------------------------------------------
+ULONG
+CDXLBinaryReader::ReadULONG()
+{
+	ULONG value = 0;
+	for (ULONG ul = 0; ul < GPDXL_BINARY_MAX_VARINT_LENGTH; ul++)
+	{
+		const BYTE byte = ReadByte();
+		value |= ((ULONG)(byte & 0x7F)) << (7 * ul);
+		if (0 == (byte & 0x80))
+		{
+			return value;
+		}
+	}
+
+	RaiseFormatError();
+	return 0;
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CDXLBinaryReader::ReadString
+//
+//	@doc:
+//		Read a string, either from the string table or inline
+//
+//---------------------------------------------------------------------------
+const XMLCh *
+CDXLBinaryReader::ReadString(BOOL is_name)
+{
+	const ULONG ref = ReadULONG();
+	if (0 < ref)
+	{
+		if (ref > m_strings->Size())
+		{
+			RaiseFormatError();
+		}
+
+		return (*m_strings)[ref - 1];
+	}
+
+	// every character takes at least one byte
+	const ULONG length = ReadULONG();
+	if (length > (ULONG)(m_end - m_pos))
+	{
+		RaiseFormatError();
+	}
+
+	XMLCh *xml_str = GPOS_NEW_ARRAY(m_mp, XMLCh, length + 1);
+	if (is_name || length <= GPDXL_BINARY_MAX_INTERNED_LENGTH)
+	{
+		m_strings->Append(xml_str);
+	}
+	else
+	{
+		m_uninterned_strings->Append(xml_str);
+	}
+
+	for (ULONG ul = 0; ul < length; ul++)
+	{
+		const BYTE byte = ReadByte();
+		if (0x80 > byte)
+		{
+			xml_str[ul] = byte;
+		}
+		else if (0xC0 == (byte & 0xE0))
+		{
+			xml_str[ul] = (XMLCh)(((byte & 0x1F) << 6) | (ReadByte() & 0x3F));
+		}
+		else if (0xE0 == (byte & 0xF0))
+		{
+			const BYTE byte2 = ReadByte();
+			const BYTE byte3 = ReadByte();
+			xml_str[ul] = (XMLCh)(((byte & 0x0F) << 12) |
+								  ((byte2 & 0x3F) << 6) | (byte3 & 0x3F));
+		}
+		else
+		{
+			RaiseFormatError();
+		}
+	}
+	xml_str[length] = 0;
+
+	return xml_str;
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CDXLBinaryReader::ReadHeader
+//
+//	@doc:
+//		Read and check the magic bytes and the version of the document
+//
+//---------------------------------------------------------------------------
+void
+CDXLBinaryReader::ReadHeader()
+{
+	if (!IsBinaryDXL(m_pos, (ULONG)(m_end - m_pos)))
+	{
+		RaiseFormatError();
+	}
+	m_pos += GPDXL_BINARY_MAGIC_LENGTH;
+
+	if (GPDXL_BINARY_VERSION != ReadULONG())
+	{
+		RaiseFormatError();
+	}
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CDXLBinaryReader::ReadEvent
+//
+//	@doc:
+//		Read the next event, and set the names and attributes of the element
+//		it belongs to
+//
+//---------------------------------------------------------------------------
+EDXLBinaryEvent
+CDXLBinaryReader::ReadEvent()
+{
+	m_uninterned_strings->Clear();
+
+	const BYTE event = ReadByte();
+	switch (event)
+	{
+		case EdxlbeStartElement:
+		{
+			m_uri = ReadString(true /*is_name*/);
+			m_local_name = ReadString(true /*is_name*/);
+			m_qname = ReadString(true /*is_name*/);
+
+			m_attributes.Clear();
+			const ULONG num_attrs = ReadULONG();
+			for (ULONG ul = 0; ul < num_attrs; ul++)
+			{
+				const XMLCh *uri = ReadString(true /*is_name*/);
+				const XMLCh *local_name = ReadString(true /*is_name*/);
+				const XMLCh *qname = ReadString(true /*is_name*/);
+				const XMLCh *value = ReadString(false /*is_name*/);
+				m_attributes.Append(uri, local_name, qname, value);
+			}
+
+			m_open_elements->Append(m_uri);
+			m_open_elements->Append(m_local_name);
+			m_open_elements->Append(m_qname);
+			break;
+		}
+
+		case EdxlbeEndElement:
+		{
+			if (0 == m_open_elements->Size())
+			{
+				RaiseFormatError();
+			}
+
+			m_qname = m_open_elements->RemoveLast();
+			m_local_name = m_open_elements->RemoveLast();
+			m_uri = m_open_elements->RemoveLast();
+			break;
+		}
+
+		case EdxlbeEndDocument:
+		{
+			if (0 != m_open_elements->Size() || m_pos != m_end)
+			{
+				RaiseFormatError();
+			}
+			break;
+		}
+
+		default:
+			RaiseFormatError();
+	}
+
+	return (EDXLBinaryEvent) event;
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CDXLBinaryReader::Parse
+//
+//	@doc:
+//		Replay the document into the content handler. The content handler
+//		is looked up for every event, as parse handlers replace themselves
+//		while the document is parsed.
+//
+//---------------------------------------------------------------------------
+void
+CDXLBinaryReader::Parse()
+{
+	ReadHeader();
+
+	if (nullptr != m_content_handler)
+	{
+		m_content_handler->startDocument();
+	}
+
+	EDXLBinaryEvent event = EdxlbeSentinel;
+	while (EdxlbeEndDocument != (event = ReadEvent()))
+	{
+		if (nullptr == m_content_handler)
+		{
+			continue;
+		}
+
+		if (EdxlbeStartElement == event)
+		{
+			m_content_handler->startElement(m_uri, m_local_name, m_qname,
+											m_attributes);
+		}
+		else
+		{
+			m_content_handler->endElement(m_uri, m_local_name, m_qname);
+		}
+	}
+
+	if (nullptr != m_content_handler)
+	{
+		m_content_handler->endDocument();
+	}
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CDXLBinaryReader::CreateString
+//
+//	@doc:
+//		Create a GPOS string from a Xerces string, combining surrogate pairs
+//
+//---------------------------------------------------------------------------
+CWStringDynamic *
+CDXLBinaryReader::CreateString(CMemoryPool *mp, const XMLCh *xml_str)
+{
+	const ULONG length = (ULONG) XMLString::stringLen(xml_str);
+	CAutoRg<WCHAR> wstr(GPOS_NEW_ARRAY(mp, WCHAR, length + 1));
+
+	ULONG wlength = 0;
+	for (ULONG ul = 0; ul < length; ul++)
+	{
+		ULONG ch = xml_str[ul];
+		if (0xD800 <= ch && 0xDC00 > ch && ul + 1 < length &&
+			0xDC00 <= xml_str[ul + 1] && 0xE000 > xml_str[ul + 1])
+		{
+			ch = 0x10000 + ((ch - 0xD800) << 10) + (xml_str[++ul] - 0xDC00);
+		}
+		wstr[wlength++] = (WCHAR) ch;
+	}
+	wstr[wlength] = 0;
+
+	return GPOS_NEW(mp) CWStringDynamic(mp, wstr.Rgt());
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CDXLBinaryReader::Serialize
+//
+//	@doc:
+//		Write the document as XML. Namespace declarations are not encoded
+//		in binary DXL; the namespace of the root element is declared on it.
+//
+//---------------------------------------------------------------------------
+void
+CDXLBinaryReader::Serialize(CXMLSerializer *xml_serializer)
+{
+	GPOS_ASSERT(nullptr != xml_serializer);
+
+	ReadHeader();
+
+	using CWStringDynamicArray =
+		CDynamicPtrArray<CWStringDynamic, CleanupDelete>;
+	CAutoRef<CWStringDynamicArray> open_elements(
+		GPOS_NEW(m_mp) CWStringDynamicArray(m_mp));
+
+	xml_serializer->StartDocument();
+
+	EDXLBinaryEvent event = EdxlbeSentinel;
+	while (EdxlbeEndDocument != (event = ReadEvent()))
+	{
+		if (EdxlbeEndElement == event)
+		{
+			CWStringDynamic *elem_str = open_elements->RemoveLast();
+			xml_serializer->CloseElement(nullptr /*pstrNamespace*/, elem_str);
+			GPOS_DELETE(elem_str);
+			continue;
+		}
+
+		const BOOL is_root = (0 == open_elements->Size());
+		CWStringDynamic *elem_str = CreateString(m_mp, m_qname);
+		open_elements->Append(elem_str);
+		xml_serializer->OpenElement(nullptr /*pstrNamespace*/, elem_str);
+
+		if (is_root && 0 != XMLString::stringLen(m_uri))
+		{
+			// add namespace specification xmlns:prefix="uri", where the
+			// prefix is the part of the element's qname before the colon
+			const WCHAR *qname = elem_str->GetBuffer();
+			const WCHAR *colon = qname;
+			while (L'\0' != *colon && L':' != *colon)
+			{
+				colon++;
+			}
+
+			CWStringDynamic ns_attr(m_mp);
+			ns_attr.AppendWideCharArray(
+				CDXLTokens::GetDXLTokenStr(EdxltokenNamespaceAttr)->GetBuffer());
+			if (L':' == *colon)
+			{
+				ns_attr.AppendFormat(GPOS_WSZ_LIT(":%.*ls"),
+									 (INT)(colon - qname), qname);
+			}
+
+			CAutoP<CWStringDynamic> uri(CreateString(m_mp, m_uri));
+			xml_serializer->AddAttribute(&ns_attr, uri.Value());
+		}
+
+		const ULONG num_attrs = (ULONG) m_attributes.getLength();
+		for (ULONG ul = 0; ul < num_attrs; ul++)
+		{
+			CAutoP<CWStringDynamic> attr_str(
+				CreateString(m_mp, m_attributes.getQName(ul)));
+			CAutoP<CWStringDynamic> value_str(
+				CreateString(m_mp, m_attributes.getValue(ul)));
+			xml_serializer->AddAttribute(attr_str.Value(), value_str.Value());
+		}
+	}
+}
+
+// EOF
@@ -0,0 +1,297 @@
+//---------------------------------------------------------------------------
+//	Greenplum Database
+//	Copyright (C) 2024 VMware, Inc. or its affiliates.
+//
+//	@filename:
+//		CDXLBinaryWriter.cpp
+//
+//	@doc:
+//		Implementation of the SAX content handler writing binary DXL
+//---------------------------------------------------------------------------
+
+#include "naucrates/dxl/xml/CDXLBinaryWriter.h"
+
+#include <xercesc/util/XMLString.hpp>
+
+#include "gpos/common/clibwrapper.h"
+#include "gpos/utils.h"
+
+using namespace gpdxl;
+
+// initial size of the output buffer
+#define GPDXL_BINARY_INITIAL_CAPACITY (64 * 1024)
+
+// number of hash chains of the string table
+#define GPDXL_BINARY_STRING_TABLE_CHAINS (16381)
+
+// maximum length of an encoded varint
+#define GPDXL_BINARY_MAX_VARINT_LENGTH (5)
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CDXLBinaryWriter::CDXLBinaryWriter
+//
+//	@doc:
+//		Ctor; writes the document header
+//
+//---------------------------------------------------------------------------
+CDXLBinaryWriter::CDXLBinaryWriter(CMemoryPool *mp)
+	: m_mp(mp),
+	  m_buffer(nullptr),
+	  m_size(0),
+	  m_capacity(GPDXL_BINARY_INITIAL_CAPACITY),
+	  m_string_ids(nullptr)
+{
+	m_buffer = GPOS_NEW_ARRAY(m_mp, BYTE, m_capacity);
+	m_string_ids =
+		GPOS_NEW(m_mp) StringToIdMap(m_mp, GPDXL_BINARY_STRING_TABLE_CHAINS);
+
+	(void) clib::Memcpy(m_buffer, GPDXL_BINARY_MAGIC,
+						GPDXL_BINARY_MAGIC_LENGTH);
+	m_size = GPDXL_BINARY_MAGIC_LENGTH;
+	WriteULONG(GPDXL_BINARY_VERSION);
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CDXLBinaryWriter::~CDXLBinaryWriter
+//
+//	@doc:
+//		Dtor
+//
+//---------------------------------------------------------------------------
+CDXLBinaryWriter::~CDXLBinaryWriter()
+{
+	m_string_ids->Release();
+	GPOS_DELETE_ARRAY(m_buffer);
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CDXLBinaryWriter::HashString
+//
+//	@doc:
+//		Hash function for string table keys
+//
+//---------------------------------------------------------------------------
+ULONG
+CDXLBinaryWriter::HashString(const SString *str)
+{
+	return gpos::HashByteArray(reinterpret_cast<const BYTE *>(str->m_chars),
+							   str->m_length * GPOS_SIZEOF(XMLCh));
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CDXLBinaryWriter::StringEquals
+//
+//	@doc:
+//		Equality function for string table keys
+//
+//---------------------------------------------------------------------------
+BOOL
+CDXLBinaryWriter::StringEquals(const SString *str1, const SString *str2)
+{
+	return str1->m_length == str2->m_length &&
+		   0 == clib::Memcmp(str1->m_chars, str2->m_chars,
+							 str1->m_length * GPOS_SIZEOF(XMLCh));
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CDXLBinaryWriter::CleanupString
+//
+//	@doc:
+//		Release a string table key
+//
+//---------------------------------------------------------------------------
+void
+CDXLBinaryWriter::CleanupString(SString *str)
+{
+	GPOS_DELETE_ARRAY(str->m_chars);
+	GPOS_DELETE(str);
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CDXLBinaryWriter::Reserve
+//
+//	@doc:
+//		Make room for the given number of bytes in the output buffer
+//
+//---------------------------------------------------------------------------
+void
+CDXLBinaryWriter::Reserve(ULONG bytes)
+{
+	if (m_size + bytes <= m_capacity)
+	{
+		return;
+	}
+
+	ULONG capacity = m_capacity;
+	while (capacity < m_size + bytes)
+	{
+		capacity *= 2;
+	}
+
+	BYTE *buffer = GPOS_NEW_ARRAY(m_mp, BYTE, capacity);
+	(void) clib::Memcpy(buffer, m_buffer, m_size);
+	GPOS_DELETE_ARRAY(m_buffer);
+
+	m_buffer = buffer;
+	m_capacity = capacity;
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CDXLBinaryWriter::WriteULONG
+//
+//	@doc:
+//		Write an unsigned varint, seven bits per byte, least significant
+//		bits first
+//
+//---------------------------------------------------------------------------
+void
+CDXLBinaryWriter::WriteULONG(ULONG value)
+{
+	Reserve(GPDXL_BINARY_MAX_VARINT_LENGTH);
+
+	while (0x80 <= value)
+	{
+		WriteByte((BYTE)(value | 0x80));
+		value >>= 7;
+	}
+	WriteByte((BYTE) value);
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CDXLBinaryWriter::WriteString
+//
+//	@doc:
+//		Write a string: either a reference to the string table, or zero
+//		followed by the length and the characters of a new string. Names are
+//		always added to the string table, long attribute values are not.
+//
+//---------------------------------------------------------------------------
+void
+CDXLBinaryWriter::WriteString(const XMLCh *xml_str, BOOL is_name)
+{
+	const ULONG length = (ULONG) XMLString::stringLen(xml_str);
+	const BOOL intern =
+		is_name || length <= GPDXL_BINARY_MAX_INTERNED_LENGTH;
+
+	if (intern)
+	{
+		SString key = {const_cast<XMLCh *>(xml_str), length};
+		const ULONG *id = m_string_ids->Find(&key);
+		if (nullptr != id)
+		{
+			WriteULONG(*id + 1);
+			return;
+		}
+	}
+
+	WriteULONG(0);
+	WriteULONG(length);
+
+	Reserve(length * 3);
+	for (ULONG ul = 0; ul < length; ul++)
+	{
+		const ULONG ch = xml_str[ul];
+		if (0x80 > ch)
+		{
+			WriteByte((BYTE) ch);
+		}
+		else if (0x800 > ch)
+		{
+			WriteByte((BYTE)(0xC0 | (ch >> 6)));
+			WriteByte((BYTE)(0x80 | (ch & 0x3F)));
+		}
+		else
+		{
+			WriteByte((BYTE)(0xE0 | (ch >> 12)));
+			WriteByte((BYTE)(0x80 | ((ch >> 6) & 0x3F)));
+			WriteByte((BYTE)(0x80 | (ch & 0x3F)));
+		}
+	}
+
+	if (intern)
+	{
+		SString *key = GPOS_NEW(m_mp) SString;
+		key->m_chars = GPOS_NEW_ARRAY(m_mp, XMLCh, length + 1);
+		key->m_length = length;
+		(void) clib::Memcpy(key->m_chars, xml_str,
+							(length + 1) * GPOS_SIZEOF(XMLCh));
+
+		BOOL inserted GPOS_ASSERTS_ONLY = m_string_ids->Insert(
+			key, GPOS_NEW(m_mp) ULONG(m_string_ids->Size()));
+		GPOS_ASSERT(inserted);
+	}
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CDXLBinaryWriter::startElement
+//
+//	@doc:
+//		Write the start of an element
+//
+//---------------------------------------------------------------------------
+void
+CDXLBinaryWriter::startElement(const XMLCh *const element_uri,
+							   const XMLCh *const element_local_name,
+							   const XMLCh *const element_qname,
+							   const Attributes &attrs)
+{
+	Reserve(1);
+	WriteByte(EdxlbeStartElement);
+	WriteString(element_uri, true /*is_name*/);
+	WriteString(element_local_name, true /*is_name*/);
+	WriteString(element_qname, true /*is_name*/);
+
+	const ULONG num_attrs = (ULONG) attrs.getLength();
+	WriteULONG(num_attrs);
+	for (ULONG ul = 0; ul < num_attrs; ul++)
+	{
+		WriteString(attrs.getURI(ul), true /*is_name*/);
+		WriteString(attrs.getLocalName(ul), true /*is_name*/);
+		WriteString(attrs.getQName(ul), true /*is_name*/);
+		WriteString(attrs.getValue(ul), false /*is_name*/);
+	}
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CDXLBinaryWriter::endElement
+//
+//	@doc:
+//		Write the end of an element
+//
+//---------------------------------------------------------------------------
+void
+CDXLBinaryWriter::endElement(const XMLCh *const,  // element_uri,
+							 const XMLCh *const,  // element_local_name,
+							 const XMLCh *const	  // element_qname
+)
+{
+	Reserve(1);
+	WriteByte(EdxlbeEndElement);
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CDXLBinaryWriter::endDocument
+//
+//	@doc:
+//		Write the end of the document
+//
+//---------------------------------------------------------------------------
+void
+CDXLBinaryWriter::endDocument()
+{
+	Reserve(1);
+	WriteByte(EdxlbeEndDocument);
+}
+
+// EOF
@@ -0,0 +1,44 @@
+//---------------------------------------------------------------------------
+//	Greenplum Database
+//	Copyright (C) 2024 VMware, Inc. or its affiliates.
+//
+//	@filename:
+//		CDXLBinaryTest.h
+//
+//	@doc:
+//		Tests the binary encoding of DXL documents
+//---------------------------------------------------------------------------
+
+#ifndef GPDXL_CDXLBinaryTest_H
+#define GPDXL_CDXLBinaryTest_H
+
+#include "gpos/base.h"
+
+namespace gpdxl
+{
+using namespace gpos;
+
+//---------------------------------------------------------------------------
+//	@class:
+//		CDXLBinaryTest
+//
+//	@doc:
+//		Static unit tests
+//
+//---------------------------------------------------------------------------
+class CDXLBinaryTest
+{
+public:
+	// unittests
+	static GPOS_RESULT EresUnittest();
+	static GPOS_RESULT EresUnittest_RoundTrip();
+	static GPOS_RESULT EresUnittest_Parse();
+	static GPOS_RESULT EresUnittest_Malformed();
+	static GPOS_RESULT EresUnittest_Benchmark();
+
+};	// class CDXLBinaryTest
+}  // namespace gpdxl
+
+#endif	// !GPDXL_CDXLBinaryTest_H
+
+// EOF
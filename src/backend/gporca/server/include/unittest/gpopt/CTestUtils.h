@@ -118,6 +118,11 @@ public:
 		const CHAR *szOutputFile;
 	};
 
+	// step of a benchmark run by EresUnittest_Benchmark(); returns GPOS_OK
+	// if the step produced the expected output
+	using PfnBenchmarkStep = GPOS_RESULT (*)(CMemoryPool *mp, ULONG ulStep,
+											 void *pvArg);
+
 	//---------------------------------------------------------------------------
 	//	@class:
 	//		CTestUtils
@@ -694,6 +699,14 @@ public:
 		const CHAR **rgszFileNames, ULONG *pulTestCounter, ULONG ulTests,
 		BOOL fMatchPlans, BOOL fTestSpacePruning);
 
+	// time the given steps of a benchmark, failing at the first step that
+	// doesn't produce the expected output
+	static GPOS_RESULT EresUnittest_Benchmark(CMemoryPool *mp,
+											  const CHAR *rgszSteps[],
+											  ULONG ulSteps,
+											  PfnBenchmarkStep pfnStep,
+											  void *pvArg);
+
 	// return the number of segments, default return GPOPT_TEST_SEGMENTS
 	static ULONG UlSegments(COptimizerConfig *optimizer_config);
 
@@ -20,6 +20,8 @@ class CJoinOrderDPTest
 public:
 	// unittests
 	static gpos::GPOS_RESULT EresUnittest();
+	static gpos::GPOS_RESULT EresUnittest_RunTests();
+	static gpos::GPOS_RESULT EresUnittest_Benchmark();
 };	// class CJoinOrderDPTest
 }  // namespace gpopt
 
@@ -10,7 +10,10 @@
 //---------------------------------------------------------------------------
 
 #include "gpos/_api.h"
+#include "gpos/common/CAutoRg.h"
+#include "gpos/common/CBitVector.h"
 #include "gpos/common/CMainArgs.h"
+#include "gpos/io/CFileWriter.h"
 #include "gpos/memory/CAutoMemoryPool.h"
 #include "gpos/test/CUnittest.h"
 #include "gpos/types.h"
@@ -22,11 +25,13 @@
 #include "gpopt/minidump/CMinidumperUtils.h"
 #include "gpopt/optimizer/COptimizerConfig.h"
 #include "gpopt/xforms/CXformFactory.h"
+#include "naucrates/dxl/CDXLUtils.h"
 #include "naucrates/init.h"
 
 // test headers
 
 #include "unittest/base.h"
+#include "unittest/dxl/CDXLBinaryTest.h"
 #include "unittest/dxl/CDXLMemoryManagerTest.h"
 #include "unittest/dxl/CDXLUtilsTest.h"
 #include "unittest/dxl/CParseHandlerCostModelTest.h"
@@ -124,6 +129,7 @@ static gpos::CUnittest rgut[] = {
 	// naucrates
 	GPOS_UNITTEST_STD(CCostTest), GPOS_UNITTEST_STD(CDatumTest),
 	GPOS_UNITTEST_STD(CDXLMemoryManagerTest), GPOS_UNITTEST_STD(CDXLUtilsTest),
+	GPOS_UNITTEST_STD(CDXLBinaryTest),
 	GPOS_UNITTEST_STD(CMDAccessorTest), GPOS_UNITTEST_STD(CMDProviderTest),
 	GPOS_UNITTEST_STD(CMiniDumperDXLTest),
 	GPOS_UNITTEST_STD(CExpressionPreprocessorTest),
@@ -256,6 +262,7 @@ PvExec(void *pv)
 	CHAR ch = '\0';
 
 	CHAR *file_name = nullptr;
+	CHAR *binary_file_name = nullptr;
 	BOOL fMinidump = false;
 	BOOL fUnittest = false;
 	BOOL fPrintDXLPlan = false;
@@ -299,6 +306,10 @@ PvExec(void *pv)
 				fPrintDXLPlan = true;
 				break;
 
+			case 'b':
+				binary_file_name = optarg;
+				break;
+
 			default:
 				// ignore other parameters
 				break;
@@ -317,6 +328,22 @@ PvExec(void *pv)
 		// initialize DXL support
 		InitDXL();
 
+		if (nullptr != binary_file_name)
+		{
+			// convert the dump file to binary DXL instead of running it
+			CAutoMemoryPool amp;
+			ULONG size = 0;
+			CAutoRg<BYTE> binary_dxl(
+				CDXLUtils::CreateBinaryDXLFromFile(amp.Pmp(), file_name, &size));
+
+			CFileWriter fw;
+			fw.Open(binary_file_name, S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH);
+			fw.Write(binary_dxl.Rgt(), size);
+			fw.Close();
+
+			return nullptr;
+		}
+
 		CMDCache::Init();
 
 		CAutoMemoryPool amp;
@@ -404,7 +431,7 @@ main(INT iArgs, const CHAR **rgszArgs)
 	GPOS_ASSERT(iArgs >= 0);
 
 	// setup args for unittest params
-	CMainArgs ma(iArgs, rgszArgs, "uU:d:xT:i:p");
+	CMainArgs ma(iArgs, rgszArgs, "uU:d:xT:i:pb:");
 
 	// initialize unittest framework
 	CUnittest::Init(rgut, GPOS_ARRAY_SIZE(rgut), ConfigureTests, Cleanup);
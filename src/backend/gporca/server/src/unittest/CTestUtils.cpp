@@ -15,6 +15,7 @@
 
 #include "gpos/base.h"
 #include "gpos/common/CAutoP.h"
+#include "gpos/common/CAutoTimer.h"
 #include "gpos/error/CMessage.h"
 #include "gpos/io/COstreamString.h"
 #include "gpos/memory/CAutoMemoryPool.h"
@@ -4240,6 +4241,43 @@ CTestUtils::EresUnittest_RunTestsWithoutAdditionalTraceFlags(
 }
 
 
+//---------------------------------------------------------------------------
+//	@function:
+//		CTestUtils::EresUnittest_Benchmark
+//
+//	@doc:
+//		Run and time the steps of a benchmark. A benchmark is only meaningful
+//		if it measures the intended work, so every step checks its output,
+//		and the first step that fails ends the benchmark. Steps may leave
+//		their output in pvArg, allocated from mp, for the caller to compare
+//
+//---------------------------------------------------------------------------
+GPOS_RESULT
+CTestUtils::EresUnittest_Benchmark(CMemoryPool *mp, const CHAR *rgszSteps[],
+								   ULONG ulSteps, PfnBenchmarkStep pfnStep,
+								   void *pvArg)
+{
+	for (ULONG ul = 0; ul < ulSteps; ul++)
+	{
+		GPOS_RESULT eres = GPOS_FAILED;
+		{
+			CAutoTimer at(rgszSteps[ul], true /*fPrint*/);
+			eres = pfnStep(mp, ul, pvArg);
+		}
+
+		if (GPOS_OK != eres)
+		{
+			CAutoTrace at(mp);
+			at.Os() << "Benchmark step " << rgszSteps[ul]
+					<< " did not produce the expected output";
+			return eres;
+		}
+	}
+
+	return GPOS_OK;
+}
+
+
 // Create Equivalence Class based on the breakpoints
 CColRefSetArray *
 CTestUtils::createEquivalenceClasses(CMemoryPool *mp, CColRefSet *pcrs,
@@ -0,0 +1,326 @@
+//---------------------------------------------------------------------------
+//	Greenplum Database
+//	Copyright (C) 2024 VMware, Inc. or its affiliates.
+//
+//	@filename:
+//		CDXLBinaryTest.cpp
+//
+//	@doc:
+//		Tests the binary encoding of DXL documents
+//---------------------------------------------------------------------------
+
+#include "unittest/dxl/CDXLBinaryTest.h"
+
+#include "gpos/base.h"
+#include "gpos/common/CAutoP.h"
+#include "gpos/common/CAutoRg.h"
+#include "gpos/error/CAutoTrace.h"
+#include "gpos/io/COstreamString.h"
+#include "gpos/io/ioutils.h"
+#include "gpos/memory/CAutoMemoryPool.h"
+#include "gpos/test/CUnittest.h"
+
+#include "naucrates/dxl/CDXLUtils.h"
+#include "naucrates/dxl/parser/CParseHandlerDXL.h"
+#include "naucrates/dxl/xml/CDXLBinaryReader.h"
+#include "naucrates/dxl/xml/CDXLBinaryWriter.h"
+#include "naucrates/exception.h"
+
+#include "unittest/gpopt/CTestUtils.h"
+
+using namespace gpos;
+using namespace gpdxl;
+using namespace gpopt;
+
+static const CHAR *rgszMinidumpFileNames[] = {
+	"../data/dxl/minidump/TVFRandom.mdp",
+	"../data/dxl/minidump/SixWayDPv2.mdp",
+	"../data/dxl/minidump/MotionHazard-NoMaterializeSortUnderResult.mdp",
+};
+
+// document with characters taking two, three and four bytes in UTF-8
+static const CHAR *szNonAsciiDXL =
+	"<?xml version=\"1.0\" encoding=\"UTF-8\"?>"
+	"<dxl:DXLMessage xmlns:dxl=\"http://greenplum.com/dxl/2010/12/\">"
+	"<dxl:Comment><![CDATA[ignored]]></dxl:Comment>"
+	"<dxl:Thing Name=\"caf\xc3\xa9 \xe2\x82\xac \xf0\x9f\x90\x98\"/>"
+	"<dxl:Thing Name=\"caf\xc3\xa9 \xe2\x82\xac \xf0\x9f\x90\x98\"/>"
+	"</dxl:DXLMessage>";
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CDXLBinaryTest::EresUnittest
+//
+//	@doc:
+//		Unittest for binary DXL
+//
+//---------------------------------------------------------------------------
+GPOS_RESULT
+CDXLBinaryTest::EresUnittest()
+{
+	CUnittest rgut[] = {
+		GPOS_UNITTEST_FUNC(CDXLBinaryTest::EresUnittest_RoundTrip),
+		GPOS_UNITTEST_FUNC(CDXLBinaryTest::EresUnittest_Parse),
+		GPOS_UNITTEST_FUNC_THROW(CDXLBinaryTest::EresUnittest_Malformed,
+								 gpdxl::ExmaDXL,
+								 gpdxl::ExmiDXLBinaryFormatError),
+		GPOS_UNITTEST_FUNC(CDXLBinaryTest::EresUnittest_Benchmark),
+	};
+
+	return CUnittest::EresExecute(rgut, GPOS_ARRAY_SIZE(rgut));
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		SerializeParseResult
+//
+//	@doc:
+//		Serialize the query and metadata parsed from a minidump
+//
+//---------------------------------------------------------------------------
+static CWStringDynamic *
+SerializeParseResult(CMemoryPool *mp, CParseHandlerDXL *parse_handler_dxl)
+{
+	CWStringDynamic *str = GPOS_NEW(mp) CWStringDynamic(mp);
+	COstreamString oss(str);
+
+	if (nullptr != parse_handler_dxl->GetQueryDXLRoot())
+	{
+		CDXLUtils::SerializeQuery(
+			mp, oss, parse_handler_dxl->GetQueryDXLRoot(),
+			parse_handler_dxl->GetOutputColumnsDXLArray(),
+			parse_handler_dxl->GetCTEProducerDXLArray(),
+			false /*serialize_document_header_footer*/, false /*indentation*/);
+	}
+
+	if (nullptr != parse_handler_dxl->GetMdIdCachedObjArray())
+	{
+		CDXLUtils::SerializeMetadata(
+			mp, parse_handler_dxl->GetMdIdCachedObjArray(), oss,
+			false /*serialize_document_header_footer*/, false /*indentation*/);
+	}
+
+	return str;
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CDXLBinaryTest::EresUnittest_RoundTrip
+//
+//	@doc:
+//		Convert minidumps to binary DXL and back to XML, and check that the
+//		XML encodes to the same binary document
+//
+//---------------------------------------------------------------------------
+GPOS_RESULT
+CDXLBinaryTest::EresUnittest_RoundTrip()
+{
+	CAutoMemoryPool amp;
+	CMemoryPool *mp = amp.Pmp();
+
+	for (ULONG ul = 0; ul < GPOS_ARRAY_SIZE(rgszMinidumpFileNames); ul++)
+	{
+		const CHAR *file_name = rgszMinidumpFileNames[ul];
+
+		ULONG size = 0;
+		CAutoRg<BYTE> binary_dxl(
+			CDXLUtils::CreateBinaryDXLFromFile(mp, file_name, &size));
+		GPOS_UNITTEST_ASSERT(
+			CDXLBinaryReader::IsBinaryDXL(binary_dxl.Rgt(), size));
+		GPOS_UNITTEST_ASSERT(size < ioutils::FileSize(file_name));
+
+		CWStringDynamic str(mp);
+		COstreamString oss(&str);
+		CDXLUtils::SerializeBinaryDXL(mp, oss, binary_dxl.Rgt(), size,
+									  true /*indentation*/);
+
+		CAutoRg<CHAR> dxl_string(
+			CDXLUtils::CreateMultiByteCharStringFromWCString(
+				mp, str.GetBuffer()));
+		ULONG size_round_trip = 0;
+		CAutoRg<BYTE> binary_dxl_round_trip(CDXLUtils::CreateBinaryDXL(
+			mp, dxl_string.Rgt(), &size_round_trip));
+
+		GPOS_UNITTEST_ASSERT(size == size_round_trip);
+		GPOS_UNITTEST_ASSERT(0 == clib::Memcmp(binary_dxl.Rgt(),
+											   binary_dxl_round_trip.Rgt(),
+											   size));
+	}
+
+	// characters outside of ASCII survive decoding and encoding again
+	ULONG size = 0;
+	CAutoRg<BYTE> binary_dxl(
+		CDXLUtils::CreateBinaryDXL(mp, szNonAsciiDXL, &size));
+
+	CDXLBinaryWriter binary_writer(mp);
+	CDXLBinaryReader binary_reader(mp, binary_dxl.Rgt(), size);
+	binary_reader.SetContentHandler(&binary_writer);
+	binary_reader.Parse();
+
+	GPOS_UNITTEST_ASSERT(size == binary_writer.Size());
+	GPOS_UNITTEST_ASSERT(
+		0 == clib::Memcmp(binary_dxl.Rgt(), binary_writer.GetBuffer(), size));
+
+	return GPOS_OK;
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CDXLBinaryTest::EresUnittest_Parse
+//
+//	@doc:
+//		Parse minidumps from XML and from binary DXL, and compare the
+//		resulting queries and metadata
+//
+//---------------------------------------------------------------------------
+GPOS_RESULT
+CDXLBinaryTest::EresUnittest_Parse()
+{
+	CAutoMemoryPool amp;
+	CMemoryPool *mp = amp.Pmp();
+
+	for (ULONG ul = 0; ul < GPOS_ARRAY_SIZE(rgszMinidumpFileNames); ul++)
+	{
+		const CHAR *file_name = rgszMinidumpFileNames[ul];
+
+		CAutoP<CParseHandlerDXL> parse_handler_xml(
+			CDXLUtils::GetParseHandlerForDXLFile(mp, file_name,
+												 nullptr /*xsd_file_path*/));
+
+		ULONG size = 0;
+		CAutoRg<BYTE> binary_dxl(
+			CDXLUtils::CreateBinaryDXLFromFile(mp, file_name, &size));
+		CAutoP<CParseHandlerDXL> parse_handler_binary(
+			CDXLUtils::GetParseHandlerForBinaryDXL(mp, binary_dxl.Rgt(), size));
+
+		CAutoP<CWStringDynamic> str_xml(
+			SerializeParseResult(mp, parse_handler_xml.Value()));
+		CAutoP<CWStringDynamic> str_binary(
+			SerializeParseResult(mp, parse_handler_binary.Value()));
+
+		GPOS_UNITTEST_ASSERT(0 < str_xml->Length());
+		GPOS_UNITTEST_ASSERT(str_xml->Equals(str_binary.Value()));
+	}
+
+	return GPOS_OK;
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CDXLBinaryTest::EresUnittest_Malformed
+//
+//	@doc:
+//		Parsing a truncated binary DXL document raises an error
+//
+//---------------------------------------------------------------------------
+GPOS_RESULT
+CDXLBinaryTest::EresUnittest_Malformed()
+{
+	CAutoMemoryPool amp;
+	CMemoryPool *mp = amp.Pmp();
+
+	ULONG size = 0;
+	CAutoRg<BYTE> binary_dxl(CDXLUtils::CreateBinaryDXLFromFile(
+		mp, rgszMinidumpFileNames[0], &size));
+
+	CAutoP<CParseHandlerDXL> parse_handler_dxl(
+		CDXLUtils::GetParseHandlerForBinaryDXL(mp, binary_dxl.Rgt(),
+											   size / 2));
+
+	return GPOS_FAILED;
+}
+
+// input and output of the steps of CDXLBinaryTest::EresUnittest_Benchmark
+struct SParseBenchmark
+{
+	const CHAR *m_file_name;
+	BYTE *m_binary_dxl;
+	ULONG m_size;
+
+	// parse results of the XML and of the binary DXL document
+	CParseHandlerDXL *m_parse_handlers[2];
+};
+
+//---------------------------------------------------------------------------
+//	@function:
+//		EresParseBenchmarkStep
+//
+//	@doc:
+//		Parse the benchmark minidump from XML (step 0) or from binary DXL
+//		(step 1), and check that it holds a query
+//
+//---------------------------------------------------------------------------
+static GPOS_RESULT
+EresParseBenchmarkStep(CMemoryPool *mp, ULONG ulStep, void *pvArg)
+{
+	SParseBenchmark *benchmark = static_cast<SParseBenchmark *>(pvArg);
+
+	CParseHandlerDXL *parse_handler_dxl =
+		(0 == ulStep)
+			? CDXLUtils::GetParseHandlerForDXLFile(
+				  mp, benchmark->m_file_name, nullptr /*xsd_file_path*/)
+			: CDXLUtils::GetParseHandlerForBinaryDXL(
+				  mp, benchmark->m_binary_dxl, benchmark->m_size);
+	benchmark->m_parse_handlers[ulStep] = parse_handler_dxl;
+
+	GPOS_UNITTEST_ASSERT(nullptr != parse_handler_dxl->GetQueryDXLRoot());
+
+	return GPOS_OK;
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CDXLBinaryTest::EresUnittest_Benchmark
+//
+//	@doc:
+//		Compare size and parse time of a large minidump in XML and in
+//		binary DXL, and check that both parse to the same query and
+//		metadata
+//
+//---------------------------------------------------------------------------
+GPOS_RESULT
+CDXLBinaryTest::EresUnittest_Benchmark()
+{
+	CAutoMemoryPool amp;
+	CMemoryPool *mp = amp.Pmp();
+
+	const CHAR *file_name = "../data/dxl/minidump/Tpcds-NonPart-Q70a.mdp";
+	const CHAR *rgszSteps[] = {"Parse XML", "Parse binary DXL"};
+
+	ULONG size = 0;
+	CAutoRg<BYTE> binary_dxl(
+		CDXLUtils::CreateBinaryDXLFromFile(mp, file_name, &size));
+
+	{
+		CAutoTrace at(mp);
+		at.Os() << file_name << ": " << ioutils::FileSize(file_name)
+				<< " bytes of XML, " << size << " bytes of binary DXL";
+	}
+	GPOS_UNITTEST_ASSERT(size < ioutils::FileSize(file_name));
+
+	SParseBenchmark benchmark = {file_name, binary_dxl.Rgt(), size, {}};
+	GPOS_RESULT eres = CTestUtils::EresUnittest_Benchmark(
+		mp, rgszSteps, GPOS_ARRAY_SIZE(rgszSteps), EresParseBenchmarkStep,
+		&benchmark);
+
+	CAutoP<CParseHandlerDXL> parse_handler_xml(
+		benchmark.m_parse_handlers[0]);
+	CAutoP<CParseHandlerDXL> parse_handler_binary(
+		benchmark.m_parse_handlers[1]);
+
+	if (GPOS_OK != eres)
+	{
+		return eres;
+	}
+
+	CAutoP<CWStringDynamic> str_xml(
+		SerializeParseResult(mp, parse_handler_xml.Value()));
+	CAutoP<CWStringDynamic> str_binary(
+		SerializeParseResult(mp, parse_handler_binary.Value()));
+
+	GPOS_UNITTEST_ASSERT(str_xml->Equals(str_binary.Value()));
+
+	return GPOS_OK;
+}
+
+// EOF
@@ -10,8 +10,13 @@
 //---------------------------------------------------------------------------
 #include "unittest/gpopt/minidump/CJoinOrderDPTest.h"
 
+#include "gpos/memory/CAutoMemoryPool.h"
+#include "gpos/test/CUnittest.h"
+
 #include "unittest/gpopt/CTestUtils.h"
 
+using namespace gpopt;
+
 
 
 //---------------------------------------------------------------------------
@@ -24,6 +29,25 @@
 //---------------------------------------------------------------------------
 gpos::GPOS_RESULT
 CJoinOrderDPTest::EresUnittest()
+{
+	CUnittest rgut[] = {
+		GPOS_UNITTEST_FUNC(EresUnittest_RunTests),
+		GPOS_UNITTEST_FUNC(EresUnittest_Benchmark),
+	};
+
+	return CUnittest::EresExecute(rgut, GPOS_ARRAY_SIZE(rgut));
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CJoinOrderDPTest::EresUnittest_RunTests
+//
+//	@doc:
+//		Run minidumps with and without dynamic join order algorithm
+//
+//---------------------------------------------------------------------------
+gpos::GPOS_RESULT
+CJoinOrderDPTest::EresUnittest_RunTests()
 {
 	ULONG ulTestCounter = 0;
 	const CHAR *rgszFileNames[] = {
@@ -35,4 +59,55 @@ CJoinOrderDPTest::EresUnittest()
 		rgszFileNames, &ulTestCounter, GPOS_ARRAY_SIZE(rgszFileNames), true,
 		true);
 }
+
+// multi-way join minidumps timed by EresUnittest_Benchmark
+static const CHAR *rgszBenchmarkFileNames[] = {
+	"../data/dxl/minidump/SixWayDPv2.mdp",
+	"../data/dxl/minidump/LargeJoins.mdp",
+	"../data/dxl/minidump/LeftJoinDPv2JoinOrder.mdp",
+	"../data/dxl/minidump/LOJReorderComplexNestedLOJs.mdp",
+	"../data/dxl/minidump/GreedyNAryJoinWithDisconnectedEdges.mdp",
+	"../data/dxl/minidump/PartTbl-MultiWayJoin.mdp",
+	"../data/dxl/minidump/JoinOrderDPE.mdp"};
+
+//---------------------------------------------------------------------------
+//	@function:
+//		EresOptimizeBenchmarkFile
+//
+//	@doc:
+//		Optimize one of the benchmark minidumps, and check that the plan
+//		matches the one recorded in the minidump; the minidump runner uses
+//		memory pools of its own
+//
+//---------------------------------------------------------------------------
+static gpos::GPOS_RESULT
+EresOptimizeBenchmarkFile(CMemoryPool *, ULONG ulStep, void *)
+{
+	ULONG ulTestCounter = 0;
+
+	return CTestUtils::EresUnittest_RunTestsWithoutAdditionalTraceFlags(
+		&rgszBenchmarkFileNames[ulStep], &ulTestCounter, 1 /*ulTests*/,
+		true /*fMatchPlans*/, true /*fTestSpacePruning*/);
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CJoinOrderDPTest::EresUnittest_Benchmark
+//
+//	@doc:
+//		Time the optimization of multi-way join minidumps, to compare the
+//		cost of join order enumeration between builds
+//
+//---------------------------------------------------------------------------
+gpos::GPOS_RESULT
+CJoinOrderDPTest::EresUnittest_Benchmark()
+{
+	CAutoMemoryPool amp;
+	CMemoryPool *mp = amp.Pmp();
+
+	return CTestUtils::EresUnittest_Benchmark(
+		mp, rgszBenchmarkFileNames, GPOS_ARRAY_SIZE(rgszBenchmarkFileNames),
+		EresOptimizeBenchmarkFile, nullptr /*pvArg*/);
+}
+
 // EOF
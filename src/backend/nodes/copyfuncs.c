@@ -1202,6 +1202,7 @@ _copyHashJoin(const HashJoin *from)
 	COPY_NODE_FIELD(hashoperators);
 	COPY_NODE_FIELD(hashcollations);
 	COPY_NODE_FIELD(hashkeys);
+	COPY_SCALAR_FIELD(runtime_filter);
 
 	return newnode;
 }
@@ -1058,6 +1058,7 @@ _outHashJoin(StringInfo str, const HashJoin *node)
 	WRITE_NODE_FIELD(hashoperators);
 	WRITE_NODE_FIELD(hashcollations);
 	WRITE_NODE_FIELD(hashkeys);
+	WRITE_BOOL_FIELD(runtime_filter);
 }
 
 static void
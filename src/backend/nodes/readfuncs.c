@@ -3194,6 +3194,7 @@ _readHashJoin(void)
 	READ_NODE_FIELD(hashoperators);
 	READ_NODE_FIELD(hashcollations);
 	READ_NODE_FIELD(hashkeys);
+	READ_BOOL_FIELD(runtime_filter);
 
 	READ_DONE();
 }
@@ -5577,9 +5577,66 @@ create_hashjoin_plan(PlannerInfo *root,
 
 	copy_generic_path_info(&join_plan->join.plan, &best_path->jpath.path);
 
+	/*
+	 * Likewise if the Hash node is to build a runtime filter for the scan on
+	 * the outer side: the filter must be complete before the scan starts.
+	 */
+	if (hashjoin_runtime_filter_eligible(join_plan))
+	{
+		join_plan->runtime_filter = true;
+		join_plan->join.prefetch_inner = true;
+	}
+
 	return join_plan;
 }
 
+/*
+ * hashjoin_runtime_filter_eligible
+ *	  Can the Hash node of 'join' build a runtime filter for its outer side?
+ *
+ * The filter is a Bloom filter over the hash values of the inner rows, which
+ * the SeqScan feeding the outer side of the join uses to drop the rows that
+ * cannot have a match.  That is only correct if the join discards such rows
+ * anyway, and only possible if the scan runs in the same slice as the join,
+ * right below it.  The outer hash keys must be plain columns; the executor
+ * checks that they are columns of the scanned relation.
+ *
+ * Shared with the ORCA translator, so 'join' must be complete, and its
+ * expressions may or may not have been through set_plan_references() yet.
+ */
+bool
+hashjoin_runtime_filter_eligible(HashJoin *join)
+{
+	Plan	   *outer_plan = outerPlan(&join->join.plan);
+	ListCell   *lc;
+
+	if (!gp_enable_runtime_filter)
+		return false;
+
+	if (join->join.jointype != JOIN_INNER &&
+		join->join.jointype != JOIN_RIGHT &&
+		join->join.jointype != JOIN_SEMI)
+		return false;
+
+	if (join->join.plan.parallel_aware ||
+		outer_plan == NULL ||
+		!IsA(outer_plan, SeqScan) ||
+		outer_plan->parallel_aware)
+		return false;
+
+	foreach(lc, join->hashkeys)
+	{
+		Node	   *key = (Node *) lfirst(lc);
+
+		if (IsA(key, RelabelType))
+			key = (Node *) ((RelabelType *) key)->arg;
+		if (!IsA(key, Var))
+			return false;
+	}
+
+	return true;
+}
+
 
 /*****************************************************************************
  *
@@ -56,6 +56,7 @@
 #include "utils/faultinjector.h"
 #include "utils/sharedsnapshot.h"
 #include "utils/gpexpand.h"
+#include "utils/orcamdcache.h"
 #include "utils/snapmgr.h"
 
 #include "libpq-fe.h"
@@ -198,6 +199,7 @@ CreateSharedMemoryAndSemaphores(int port)
 		size = add_size(size, CancelBackendMsgShmemSize());
 		size = add_size(size, WorkFileShmemSize());
 		size = add_size(size, ShareInputShmemSize());
+		size = add_size(size, OrcaMDCacheShmemSize());
 
 #ifdef FAULT_INJECTOR
 		size = add_size(size, FaultInjector_ShmemSize());
@@ -376,6 +378,7 @@ CreateSharedMemoryAndSemaphores(int port)
 	BackendCancelShmemInit();
 	WorkFileShmemInit();
 	ShareInputShmemInit();
+	OrcaMDCacheShmemInit();
 
 	/*
 	 * Set up Instrumentation free list
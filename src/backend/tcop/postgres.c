@@ -47,6 +47,7 @@
 #include "commands/async.h"
 #include "commands/extension.h"
 #include "commands/prepare.h"
+#include "common/sha2.h"
 #include "executor/spi.h"
 #include "jit/jit.h"
 #include "libpq/libpq.h"
@@ -1113,6 +1114,112 @@ pg_plan_queries(List *querytrees, int cursorOptions, ParamListInfo boundParams)
 	return stmt_list;
 }
 
+/*
+ * The dispatch plan cache of a QE: the serialized plans recently dispatched
+ * to us, by the cache slot the QD put them in. The QD keeps track of what we
+ * hold, and sends only the SHA-256 digest and length of a plan we already
+ * have. See
+ * cdbdisp_serializePlan().
+ *
+ * Once a plan has been executed, we also keep its deserialized PlannedStmt,
+ * so that executing the same plan again, e.g. a prepared statement with
+ * other parameters, needs neither decompression nor deserialization.
+ */
+typedef struct DispatchedPlan
+{
+	uint8		digest[PG_SHA256_DIGEST_LENGTH];
+	char	   *plan;
+	int			len;
+
+	MemoryContext plannedstmtContext;
+	PlannedStmt *plannedstmt;	/* NULL if not deserialized yet */
+} DispatchedPlan;
+
+static DispatchedPlan dispatchedPlans[MAX_CACHED_DISPATCH_PLANS];
+
+/*
+ * Keep a copy of a dispatched plan in the dispatch plan cache.
+ */
+static void
+storeDispatchedPlan(int slot, const uint8 *digest, const char *plan, int len)
+{
+	DispatchedPlan *entry = &dispatchedPlans[slot];
+
+	if (entry->plan)
+		pfree(entry->plan);
+	if (entry->plannedstmtContext)
+		MemoryContextDelete(entry->plannedstmtContext);
+	entry->plannedstmtContext = NULL;
+	entry->plannedstmt = NULL;
+	entry->plan = NULL;
+	entry->plan = MemoryContextAlloc(TopMemoryContext, len);
+	memcpy(entry->plan, plan, len);
+	entry->len = len;
+	memcpy(entry->digest, digest, PG_SHA256_DIGEST_LENGTH);
+}
+
+/*
+ * Look up a dispatched plan in the dispatch plan cache.
+ *
+ * The QD only refers to plans it has sent us before, so a miss means it got
+ * out of sync with us. That is an error; the QD forgets what we held once we
+ * report one, and sends the whole plan the next time.
+ */
+static const char *
+lookupDispatchedPlan(int slot, const uint8 *digest, int len)
+{
+	DispatchedPlan *entry = &dispatchedPlans[slot];
+
+	if (entry->plan == NULL || entry->len != len ||
+		memcmp(entry->digest, digest, PG_SHA256_DIGEST_LENGTH) != 0)
+		ereport(ERROR,
+				(errcode(ERRCODE_INTERNAL_ERROR),
+				 errmsg("dispatched plan not found in the plan cache"),
+				 errdetail("Slot %d holds a plan of %d bytes, expected a plan of %d bytes%s.",
+						   slot, entry->plan ? entry->len : 0, len,
+						   entry->plan && entry->len == len ? " with another digest" : "")));
+
+	return entry->plan;
+}
+
+/*
+ * Return the PlannedStmt of the plan in a slot of the dispatch plan cache,
+ * deserializing it on first use.
+ *
+ * The executor doesn't modify the plan tree, but the caller must not either,
+ * as it's reused for the next executions.
+ */
+static PlannedStmt *
+getDispatchedPlannedStmt(int slot)
+{
+	DispatchedPlan *entry = &dispatchedPlans[slot];
+	MemoryContext oldcontext;
+	PlannedStmt *plan;
+
+	Assert(entry->plan != NULL);
+
+	if (entry->plannedstmt)
+		return entry->plannedstmt;
+
+	if (entry->plannedstmtContext == NULL)
+		entry->plannedstmtContext = AllocSetContextCreate(TopMemoryContext,
+														  "DispatchedPlannedStmt",
+														  ALLOCSET_SMALL_SIZES);
+	else
+		/* left over from a failed attempt */
+		MemoryContextReset(entry->plannedstmtContext);
+
+	oldcontext = MemoryContextSwitchTo(entry->plannedstmtContext);
+	plan = (PlannedStmt *) deserializeNode(entry->plan, entry->len);
+	MemoryContextSwitchTo(oldcontext);
+
+	if (!plan || !IsA(plan, PlannedStmt))
+		elog(ERROR, "MPPEXEC: receive invalid planned statement");
+
+	entry->plannedstmt = plan;
+	return plan;
+}
+
 /*
  * exec_mpp_query
  *
@@ -1121,6 +1228,7 @@ pg_plan_queries(List *querytrees, int cursorOptions, ParamListInfo boundParams)
  * query_string -- optional query text (C string).
  * serializedPlantree[len] -- PlannedStmt node, or (NULL,0) if query provided.
  * serializedQueryDispatchDesc[len] -- QueryDispatchDesc node, or (NULL,0) if query provided.
+ * planCacheSlot -- slot of the dispatch plan cache holding the plan, or -1.
  *
  * Caller may supply either a Query (representing utility command) or
  * a PlannedStmt (representing a planned DML command), but not both.
@@ -1128,7 +1236,8 @@ pg_plan_queries(List *querytrees, int cursorOptions, ParamListInfo boundParams)
 static void
 exec_mpp_query(const char *query_string,
 			   const char * serializedPlantree, int serializedPlantreelen,
-			   const char * serializedQueryDispatchDesc, int serializedQueryDispatchDesclen)
+			   const char * serializedQueryDispatchDesc, int serializedQueryDispatchDesclen,
+			   int planCacheSlot)
 {
 	CommandDest dest = whereToSendOutput;
 	MemoryContext oldcontext;
@@ -1191,7 +1300,16 @@ exec_mpp_query(const char *query_string,
  	/*
      * Deserialize the query execution plan (a PlannedStmt node), if there is one.
      */
-	if (serializedPlantree != NULL && serializedPlantreelen > 0)
+	if (serializedPlantree != NULL && serializedPlantreelen > 0 && planCacheSlot >= 0)
+	{
+		/*
+		 * Reuse the PlannedStmt of the plan cache. Work on a flat copy of it,
+		 * as PortalStart() sets fields of it for this execution.
+		 */
+		plan = makeNode(PlannedStmt);
+		memcpy(plan, getDispatchedPlannedStmt(planCacheSlot), sizeof(PlannedStmt));
+	}
+	else if (serializedPlantree != NULL && serializedPlantreelen > 0)
 	{
 		plan = (PlannedStmt *) deserializeNode(serializedPlantree,serializedPlantreelen);
 		if (!plan || !IsA(plan, PlannedStmt))
@@ -1263,6 +1381,10 @@ exec_mpp_query(const char *query_string,
 			RangeTblEntry  *rte;
 			AclMode         removeperms = ACL_INSERT | ACL_UPDATE | ACL_DELETE | ACL_SELECT_FOR_UPDATE;
 
+			/* Don't scribble on the range table of a cached plan */
+			if (planCacheSlot >= 0)
+				plan->rtable = copyObject(plan->rtable);
+
 			/* Just reading, so don't check INS/DEL/UPD permissions. */
 			foreach(rtcell, plan->rtable)
 			{
@@ -5416,6 +5538,9 @@ PostgresMain(int argc, char *argv[],
 					int serializedPlantreelen = 0;
 					int serializedQueryDispatchDesclen = 0;
 					int resgroupInfoLen = 0;
+					int planCacheSlot;
+					uint8 planDigest[PG_SHA256_DIGEST_LENGTH];
+					int planLen;
 					TimestampTz statementStart;
 					Oid suid;
 					Oid ouid;
@@ -5465,6 +5590,15 @@ PostgresMain(int argc, char *argv[],
 					serializedPlantreelen = pq_getmsgint(&input_message, 4);
 					serializedQueryDispatchDesclen = pq_getmsgint(&input_message, 4);
 					serializedDtxContextInfolen = pq_getmsgint(&input_message, 4);
+					planCacheSlot = pq_getmsgint(&input_message, 4);
+					pq_copymsgbytes(&input_message, (char *) planDigest,
+									PG_SHA256_DIGEST_LENGTH);
+					planLen = pq_getmsgint(&input_message, 4);
+
+					if (planCacheSlot >= MAX_CACHED_DISPATCH_PLANS)
+						ereport(ERROR,
+								(errcode(ERRCODE_PROTOCOL_VIOLATION),
+								 errmsg("invalid dispatch plan cache slot %d", planCacheSlot)));
 
 					/* read in the DTX context info */
 					if (serializedDtxContextInfolen == 0)
@@ -5501,6 +5635,30 @@ PostgresMain(int argc, char *argv[],
 					if (serializedPlantreelen > 0)
 						serializedPlantree = pq_getmsgbytes(&input_message,serializedPlantreelen);
 
+					/*
+					 * Keep the plan for the next time, or pick it from the
+					 * plan cache if the QD knows we already have it.
+					 */
+					if (planCacheSlot >= 0)
+					{
+						if (serializedPlantreelen > 0)
+						{
+							if (serializedPlantreelen != planLen)
+								ereport(ERROR,
+										(errcode(ERRCODE_PROTOCOL_VIOLATION),
+										 errmsg("dispatched plan is %d bytes, expected %d bytes",
+												serializedPlantreelen, planLen)));
+							storeDispatchedPlan(planCacheSlot, planDigest,
+												serializedPlantree, serializedPlantreelen);
+						}
+						else
+						{
+							serializedPlantree = lookupDispatchedPlan(planCacheSlot, planDigest,
+																	  planLen);
+							serializedPlantreelen = planLen;
+						}
+					}
+
 					if (serializedQueryDispatchDesclen > 0)
 						serializedQueryDispatchDesc = pq_getmsgbytes(&input_message,serializedQueryDispatchDesclen);
 
@@ -5576,7 +5734,8 @@ PostgresMain(int argc, char *argv[],
 					else
 						exec_mpp_query(query_string,
 									   serializedPlantree, serializedPlantreelen,
-									   serializedQueryDispatchDesc, serializedQueryDispatchDesclen);
+									   serializedQueryDispatchDesc, serializedQueryDispatchDesclen,
+									   planCacheSlot);
 
 					SetUserIdAndSecContext(GetOuterUserId(), 0);
 
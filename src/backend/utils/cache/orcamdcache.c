@@ -0,0 +1,598 @@
+/*-------------------------------------------------------------------------
+ *
+ * orcamdcache.c
+ *	  Metadata cache of the GPORCA optimizer, shared by all backends.
+ *
+ * GPORCA keeps the metadata objects it has looked up in a per-backend cache
+ * (CMDCache). A new backend starts out with an empty cache, and has to
+ * translate every relation and statistics object it needs from the catalogs
+ * again. For wide tables with detailed statistics that is a considerable
+ * part of the planning time of the first queries in a session. This module
+ * provides a second-level cache in shared memory, holding the serialized
+ * (DXL) form of relations, relation statistics and column statistics, so
+ * that a backend can parse an object some other backend has already
+ * translated. The cache is only created on the coordinator, and only if
+ * optimizer_shared_mdcache_size is set.
+ *
+ * The serialized objects live in a DSA area that is created in place in the
+ * main shared memory segment, and is limited to its initial size. A shared
+ * hash table, keyed by the database and the string form of the object's
+ * metadata id, points to them. The same OIDs can name different objects in
+ * different databases, so objects are only shared within a database, except
+ * those of shared catalogs. When either is full, the stale entries and the
+ * least recently used quarter of the entries are evicted.
+ *
+ * Invalidation
+ * ------------
+ *
+ * Objects are not removed when the catalogs change. Instead, a shared epoch
+ * counter is advanced by every relevant catalog invalidation, and the epoch
+ * of the last invalidation is recorded in a slot of a fixed array, picked by
+ * hashing the database and the relation. A cached object carries the epoch
+ * at which the backend that stored it started to translate it, and is stale
+ * if its slot has been invalidated since. Relations that share a slot just
+ * make each other's objects stale a little more often. Column statistics are
+ * also stale after any change to pg_statistic, since those invalidations
+ * can't be attributed to a relation.
+ *
+ * Invalidations only use atomic operations, and never take OrcaMDCacheLock.
+ * Every backend processes every relcache invalidation, so a lock there would
+ * serialize all the backends of a DDL-heavy workload. Validity is checked
+ * again on every lookup, so an object stored just after an invalidation it
+ * missed is never returned.
+ *
+ * All backends register the invalidation callbacks at startup, so a catalog
+ * change is applied to the shared cache by the committing backend before it
+ * releases its locks, and by every other backend when it processes the
+ * invalidation message. A backend that translated an object from catalog
+ * data that was already out of date advances the epoch past the object when
+ * it catches up with the invalidation, so the object can't outlive the
+ * stale data it was built from.
+ *
+ * Statistics of partitioned tables are derived from their partitions, whose
+ * invalidations don't mention the parent, so they are never shared.
+ *
+ * Portions Copyright (c) 2024-Present VMware, Inc. or its affiliates.
+ *
+ *
+ * IDENTIFICATION
+ *	    src/backend/utils/cache/orcamdcache.c
+ *
+ *-------------------------------------------------------------------------
+ */
+#include "postgres.h"
+
+#include "catalog/catalog.h"
+#include "catalog/pg_class.h"
+#include "common/hashfn.h"
+#include "cdb/cdbvars.h"
+#include "miscadmin.h"
+#include "port/atomics.h"
+#include "storage/ipc.h"
+#include "storage/lwlock.h"
+#include "storage/shmem.h"
+#include "utils/dsa.h"
+#include "utils/guc.h"
+#include "utils/hsearch.h"
+#include "utils/inval.h"
+#include "utils/lsyscache.h"
+#include "utils/memutils.h"
+#include "utils/orcamdcache.h"
+#include "utils/syscache.h"
+
+/* expected size of a serialized object, for sizing the hash table */
+#define ORCA_MDCACHE_AVG_OBJECT_SIZE	4096
+#define ORCA_MDCACHE_MIN_ENTRIES		64
+
+/* number of slots recording the epoch of the last relation invalidation */
+#define ORCA_MDCACHE_INVAL_SLOTS	4096
+
+typedef struct OrcaMDCacheKey
+{
+	Oid			dbid;			/* InvalidOid for shared catalogs */
+	char		mdid[ORCA_MDCACHE_KEYLEN];	/* zero-padded metadata id */
+} OrcaMDCacheKey;
+
+typedef struct OrcaMDCacheEntry
+{
+	OrcaMDCacheKey key;			/* hash key, must be first */
+	Oid			relid;			/* relation the object belongs to */
+	OrcaMDCacheKind kind;
+	uint64		epoch;			/* epoch at which translation started */
+	dsa_pointer data;			/* serialized object */
+	Size		len;
+	pg_atomic_uint64 last_used;	/* clock value of the last lookup */
+} OrcaMDCacheEntry;
+
+typedef struct OrcaMDCacheShared
+{
+	pg_atomic_uint64 epoch;		/* advanced by every catalog invalidation */
+	pg_atomic_uint64 clock;		/* advanced by every lookup */
+	pg_atomic_uint64 reset_epoch;	/* all objects older than this are stale */
+	pg_atomic_uint64 stats_epoch;	/* column statistics older than this are
+									 * stale */
+	pg_atomic_uint64 invalidations;
+
+	/* epoch of the last invalidation of the relations hashing to each slot */
+	pg_atomic_uint64 rel_epochs[ORCA_MDCACHE_INVAL_SLOTS];
+
+	pg_atomic_uint64 hits;
+	pg_atomic_uint64 misses;
+
+	/* everything below is protected by OrcaMDCacheLock */
+	Size		area_size;		/* size of the DSA area */
+	Size		size;			/* bytes of serialized objects */
+	uint64		evictions;
+	uint64		invalidated_entries;
+} OrcaMDCacheShared;
+
+static OrcaMDCacheShared *orca_mdcache = NULL;
+static HTAB *orca_mdcache_hash = NULL;
+static dsa_area *orca_mdcache_area = NULL;
+
+static int	OrcaMDCacheMaxEntries(void);
+static Size OrcaMDCacheAreaSize(void);
+static void *OrcaMDCacheAreaSpace(void);
+static Oid	OrcaMDCacheDatabase(Oid relid);
+static pg_atomic_uint64 *OrcaMDCacheRelEpoch(Oid dbid, Oid relid);
+static void OrcaMDCacheAdvance(pg_atomic_uint64 *epoch_var, uint64 epoch);
+static bool OrcaMDCacheMakeKey(const char *key, Oid relid,
+							   OrcaMDCacheKey *keybuf);
+static bool OrcaMDCacheIsValid(Oid dbid, Oid relid, OrcaMDCacheKind kind,
+							   uint64 epoch);
+static void OrcaMDCacheRemoveEntry(OrcaMDCacheEntry *entry);
+static void OrcaMDCacheEvict(void);
+static void OrcaMDCacheRelcacheCallback(Datum arg, Oid relid);
+static void OrcaMDCacheSyscacheCallback(Datum arg, int cacheid,
+										uint32 hashvalue);
+
+/*
+ * The cache is only useful where ORCA plans queries, i.e. on the coordinator.
+ */
+static Size
+OrcaMDCacheAreaSize(void)
+{
+	if (optimizer_shared_mdcache_size <= 0 || !IS_QUERY_DISPATCHER())
+		return 0;
+
+	return Max((Size) optimizer_shared_mdcache_size * 1024,
+			   dsa_minimum_size());
+}
+
+static int
+OrcaMDCacheMaxEntries(void)
+{
+	return Max(OrcaMDCacheAreaSize() / ORCA_MDCACHE_AVG_OBJECT_SIZE,
+			   ORCA_MDCACHE_MIN_ENTRIES);
+}
+
+static void *
+OrcaMDCacheAreaSpace(void)
+{
+	return (char *) orca_mdcache + MAXALIGN(sizeof(OrcaMDCacheShared));
+}
+
+Size
+OrcaMDCacheShmemSize(void)
+{
+	Size		area_size = OrcaMDCacheAreaSize();
+	Size		size;
+
+	if (area_size == 0)
+		return 0;
+
+	size = add_size(MAXALIGN(sizeof(OrcaMDCacheShared)), area_size);
+	size = add_size(size, hash_estimate_size(OrcaMDCacheMaxEntries(),
+											 sizeof(OrcaMDCacheEntry)));
+
+	return size;
+}
+
+void
+OrcaMDCacheShmemInit(void)
+{
+	Size		area_size = OrcaMDCacheAreaSize();
+	HASHCTL		info;
+	bool		found;
+	int			i;
+
+	if (area_size == 0)
+		return;
+
+	orca_mdcache = ShmemInitStruct("ORCA metadata cache",
+								   MAXALIGN(sizeof(OrcaMDCacheShared)) + area_size,
+								   &found);
+
+	memset(&info, 0, sizeof(info));
+	info.keysize = sizeof(OrcaMDCacheKey);
+	info.entrysize = sizeof(OrcaMDCacheEntry);
+	orca_mdcache_hash = ShmemInitHash("ORCA metadata cache entries",
+									  OrcaMDCacheMaxEntries(),
+									  OrcaMDCacheMaxEntries(),
+									  &info,
+									  HASH_ELEM | HASH_BLOBS);
+
+	if (!found)
+	{
+		dsa_area   *area;
+
+		pg_atomic_init_u64(&orca_mdcache->epoch, 1);
+		pg_atomic_init_u64(&orca_mdcache->clock, 0);
+		pg_atomic_init_u64(&orca_mdcache->reset_epoch, 0);
+		pg_atomic_init_u64(&orca_mdcache->stats_epoch, 0);
+		pg_atomic_init_u64(&orca_mdcache->invalidations, 0);
+		for (i = 0; i < ORCA_MDCACHE_INVAL_SLOTS; i++)
+			pg_atomic_init_u64(&orca_mdcache->rel_epochs[i], 0);
+		pg_atomic_init_u64(&orca_mdcache->hits, 0);
+		pg_atomic_init_u64(&orca_mdcache->misses, 0);
+		orca_mdcache->area_size = area_size;
+		orca_mdcache->size = 0;
+		orca_mdcache->evictions = 0;
+		orca_mdcache->invalidated_entries = 0;
+
+		/*
+		 * The area lives as long as the shared memory segment. Backends
+		 * attach to it in InitOrcaMDCache().
+		 */
+		area = dsa_create_in_place(OrcaMDCacheAreaSpace(), area_size,
+								   LWTRANCHE_ORCA_MDCACHE_DSA, NULL);
+		dsa_set_size_limit(area, area_size);
+		dsa_detach(area);
+	}
+}
+
+/*
+ * Attach this backend to the shared cache, and register the invalidation
+ * callbacks. Called from InitPostgres(), so that catalog changes made by any
+ * backend are applied to the cache, not only those of backends using ORCA.
+ */
+void
+InitOrcaMDCache(void)
+{
+	MemoryContext oldcontext;
+
+	if (orca_mdcache == NULL)
+		return;
+
+	oldcontext = MemoryContextSwitchTo(TopMemoryContext);
+	orca_mdcache_area = dsa_attach_in_place(OrcaMDCacheAreaSpace(), NULL);
+	MemoryContextSwitchTo(oldcontext);
+
+	on_shmem_exit(dsa_on_shmem_exit_release_in_place,
+				  PointerGetDatum(OrcaMDCacheAreaSpace()));
+
+	CacheRegisterRelcacheCallback(OrcaMDCacheRelcacheCallback, (Datum) 0);
+	CacheRegisterSyscacheCallback(STATRELATTINH, OrcaMDCacheSyscacheCallback,
+								  (Datum) 0);
+}
+
+bool
+OrcaMDCacheEnabled(void)
+{
+	return orca_mdcache_area != NULL;
+}
+
+/*
+ * Return the current epoch. Objects translated after this call must be
+ * stored with this epoch, or an older one.
+ */
+uint64
+OrcaMDCacheGetEpoch(void)
+{
+	Assert(OrcaMDCacheEnabled());
+
+	return pg_atomic_read_u64(&orca_mdcache->epoch);
+}
+
+/*
+ * The database whose objects of the relation are cached: the current one,
+ * or none for shared catalogs, which may be changed from any database.
+ */
+static Oid
+OrcaMDCacheDatabase(Oid relid)
+{
+	return IsSharedRelation(relid) ? InvalidOid : MyDatabaseId;
+}
+
+static pg_atomic_uint64 *
+OrcaMDCacheRelEpoch(Oid dbid, Oid relid)
+{
+	uint32		hash;
+
+	hash = hash_combine(murmurhash32((uint32) dbid), murmurhash32((uint32) relid));
+
+	return &orca_mdcache->rel_epochs[hash % ORCA_MDCACHE_INVAL_SLOTS];
+}
+
+/*
+ * Raise an epoch variable to 'epoch', unless it's already past it.
+ */
+static void
+OrcaMDCacheAdvance(pg_atomic_uint64 *epoch_var, uint64 epoch)
+{
+	uint64		old = pg_atomic_read_u64(epoch_var);
+
+	while (old < epoch)
+	{
+		if (pg_atomic_compare_exchange_u64(epoch_var, &old, epoch))
+			break;
+	}
+}
+
+/*
+ * Build the hash key of an object of the relation. Returns false if the
+ * metadata id is too long to be cached.
+ */
+static bool
+OrcaMDCacheMakeKey(const char *key, Oid relid, OrcaMDCacheKey *keybuf)
+{
+	Size		len = strlen(key);
+
+	if (len >= ORCA_MDCACHE_KEYLEN)
+		return false;
+
+	memset(keybuf, 0, sizeof(OrcaMDCacheKey));
+	keybuf->dbid = OrcaMDCacheDatabase(relid);
+	memcpy(keybuf->mdid, key, len);
+
+	return true;
+}
+
+/*
+ * Would an object of the given relation, translated at the given epoch,
+ * still be up to date?
+ */
+static bool
+OrcaMDCacheIsValid(Oid dbid, Oid relid, OrcaMDCacheKind kind, uint64 epoch)
+{
+	if (epoch < pg_atomic_read_u64(&orca_mdcache->reset_epoch))
+		return false;
+
+	if (kind == ORCA_MDCACHE_COLSTATS &&
+		epoch < pg_atomic_read_u64(&orca_mdcache->stats_epoch))
+		return false;
+
+	if (epoch < pg_atomic_read_u64(OrcaMDCacheRelEpoch(dbid, relid)))
+		return false;
+
+	return true;
+}
+
+/*
+ * Look up a serialized object. Returns a palloc'd copy, or NULL if the
+ * object isn't cached or is stale.
+ *
+ * This must not throw errors while holding the lock: it's called from
+ * within ORCA, which turns errors into exceptions and may fall back to the
+ * Postgres planner without aborting the transaction.
+ */
+char *
+OrcaMDCacheLookup(const char *key, Oid relid, OrcaMDCacheKind kind, Size *len)
+{
+	OrcaMDCacheKey keybuf;
+	OrcaMDCacheEntry *entry;
+	char	   *result = NULL;
+
+	Assert(OrcaMDCacheEnabled());
+
+	if (!OrcaMDCacheMakeKey(key, relid, &keybuf))
+		return NULL;
+
+	LWLockAcquire(OrcaMDCacheLock, LW_SHARED);
+
+	entry = hash_search(orca_mdcache_hash, &keybuf, HASH_FIND, NULL);
+	if (entry != NULL &&
+		entry->relid == relid &&
+		entry->kind == kind &&
+		OrcaMDCacheIsValid(entry->key.dbid, entry->relid, entry->kind,
+						   entry->epoch))
+	{
+		result = MemoryContextAllocExtended(CurrentMemoryContext, entry->len,
+											MCXT_ALLOC_NO_OOM);
+		if (result != NULL)
+		{
+			memcpy(result, dsa_get_address(orca_mdcache_area, entry->data),
+				   entry->len);
+			*len = entry->len;
+			pg_atomic_write_u64(&entry->last_used,
+								pg_atomic_fetch_add_u64(&orca_mdcache->clock, 1));
+		}
+	}
+
+	LWLockRelease(OrcaMDCacheLock);
+
+	if (result != NULL)
+		pg_atomic_fetch_add_u64(&orca_mdcache->hits, 1);
+	else
+		pg_atomic_fetch_add_u64(&orca_mdcache->misses, 1);
+
+	return result;
+}
+
+/*
+ * Store a serialized object, translated from the catalogs starting at the
+ * given epoch. Nothing is stored if the cache is out of space, or if the
+ * object has already been invalidated.
+ */
+void
+OrcaMDCacheInsert(const char *key, Oid relid, OrcaMDCacheKind kind,
+				  const char *data, Size len, uint64 epoch)
+{
+	OrcaMDCacheKey keybuf;
+	OrcaMDCacheEntry *entry;
+	dsa_pointer dp;
+	bool		found;
+
+	Assert(OrcaMDCacheEnabled());
+
+	if (!OrcaMDCacheMakeKey(key, relid, &keybuf))
+		return;
+
+	/* don't let a single object flush most of the cache */
+	if (len > orca_mdcache->area_size / 4)
+		return;
+
+	/* see the comment at the top of the file */
+	if (kind != ORCA_MDCACHE_RELATION &&
+		get_rel_relkind(relid) == RELKIND_PARTITIONED_TABLE)
+		return;
+
+	LWLockAcquire(OrcaMDCacheLock, LW_EXCLUSIVE);
+
+	if (!OrcaMDCacheIsValid(keybuf.dbid, relid, kind, epoch))
+	{
+		LWLockRelease(OrcaMDCacheLock);
+		return;
+	}
+
+	entry = hash_search(orca_mdcache_hash, &keybuf, HASH_FIND, NULL);
+	if (entry != NULL)
+	{
+		/* another backend got there first */
+		if (entry->epoch >= epoch &&
+			OrcaMDCacheIsValid(entry->key.dbid, entry->relid, entry->kind,
+							   entry->epoch))
+		{
+			LWLockRelease(OrcaMDCacheLock);
+			return;
+		}
+
+		OrcaMDCacheRemoveEntry(entry);
+	}
+
+	if (hash_get_num_entries(orca_mdcache_hash) >= OrcaMDCacheMaxEntries())
+		OrcaMDCacheEvict();
+
+	dp = dsa_allocate_extended(orca_mdcache_area, len, DSA_ALLOC_NO_OOM);
+	if (!DsaPointerIsValid(dp))
+	{
+		OrcaMDCacheEvict();
+		dp = dsa_allocate_extended(orca_mdcache_area, len, DSA_ALLOC_NO_OOM);
+	}
+
+	if (DsaPointerIsValid(dp))
+	{
+		entry = hash_search(orca_mdcache_hash, &keybuf, HASH_ENTER_NULL, &found);
+		if (entry == NULL)
+			dsa_free(orca_mdcache_area, dp);
+		else
+		{
+			Assert(!found);
+			memcpy(dsa_get_address(orca_mdcache_area, dp), data, len);
+			entry->relid = relid;
+			entry->kind = kind;
+			entry->epoch = epoch;
+			entry->data = dp;
+			entry->len = len;
+			pg_atomic_init_u64(&entry->last_used,
+							   pg_atomic_fetch_add_u64(&orca_mdcache->clock, 1));
+			orca_mdcache->size += len;
+		}
+	}
+
+	LWLockRelease(OrcaMDCacheLock);
+}
+
+/*
+ * Remove an entry and free its object. Caller must hold OrcaMDCacheLock
+ * exclusively.
+ */
+static void
+OrcaMDCacheRemoveEntry(OrcaMDCacheEntry *entry)
+{
+	orca_mdcache->size -= entry->len;
+	dsa_free(orca_mdcache_area, entry->data);
+	hash_search(orca_mdcache_hash, &entry->key, HASH_REMOVE, NULL);
+}
+
+/*
+ * Make room: remove all stale entries, and the least recently used quarter
+ * of the remaining ones, judged by their position between the oldest entry
+ * and the current clock. Caller must hold OrcaMDCacheLock exclusively.
+ */
+static void
+OrcaMDCacheEvict(void)
+{
+	HASH_SEQ_STATUS status;
+	OrcaMDCacheEntry *entry;
+	uint64		clock = pg_atomic_read_u64(&orca_mdcache->clock);
+	uint64		oldest = clock;
+	uint64		cutoff;
+
+	hash_seq_init(&status, orca_mdcache_hash);
+	while ((entry = hash_seq_search(&status)) != NULL)
+		oldest = Min(oldest, pg_atomic_read_u64(&entry->last_used));
+
+	cutoff = oldest + (clock - oldest) / 4 + 1;
+
+	hash_seq_init(&status, orca_mdcache_hash);
+	while ((entry = hash_seq_search(&status)) != NULL)
+	{
+		if (!OrcaMDCacheIsValid(entry->key.dbid, entry->relid, entry->kind,
+								entry->epoch))
+		{
+			OrcaMDCacheRemoveEntry(entry);
+			orca_mdcache->invalidated_entries++;
+		}
+		else if (pg_atomic_read_u64(&entry->last_used) < cutoff)
+		{
+			OrcaMDCacheRemoveEntry(entry);
+			orca_mdcache->evictions++;
+		}
+	}
+}
+
+/*
+ * Relcache invalidation callback: everything cached about the relation
+ * until now is stale.
+ */
+static void
+OrcaMDCacheRelcacheCallback(Datum arg, Oid relid)
+{
+	uint64		epoch;
+
+	epoch = pg_atomic_add_fetch_u64(&orca_mdcache->epoch, 1);
+
+	/* InvalidOid means that all relcache entries were invalidated */
+	if (!OidIsValid(relid))
+		OrcaMDCacheAdvance(&orca_mdcache->reset_epoch, epoch);
+	else
+		OrcaMDCacheAdvance(OrcaMDCacheRelEpoch(OrcaMDCacheDatabase(relid), relid),
+						   epoch);
+
+	pg_atomic_fetch_add_u64(&orca_mdcache->invalidations, 1);
+}
+
+/*
+ * pg_statistic invalidation callback. The hash value can't be mapped back to
+ * a relation, so all column statistics cached until now are stale.
+ */
+static void
+OrcaMDCacheSyscacheCallback(Datum arg, int cacheid, uint32 hashvalue)
+{
+	uint64		epoch;
+
+	epoch = pg_atomic_add_fetch_u64(&orca_mdcache->epoch, 1);
+	OrcaMDCacheAdvance(&orca_mdcache->stats_epoch, epoch);
+
+	pg_atomic_fetch_add_u64(&orca_mdcache->invalidations, 1);
+}
+
+void
+OrcaMDCacheGetStats(OrcaMDCacheStats *stats)
+{
+	Assert(OrcaMDCacheEnabled());
+
+	LWLockAcquire(OrcaMDCacheLock, LW_SHARED);
+
+	stats->entries = hash_get_num_entries(orca_mdcache_hash);
+	stats->size = orca_mdcache->size;
+	stats->quota = orca_mdcache->area_size;
+	stats->hits = pg_atomic_read_u64(&orca_mdcache->hits);
+	stats->misses = pg_atomic_read_u64(&orca_mdcache->misses);
+	stats->evictions = orca_mdcache->evictions;
+	stats->invalidations = pg_atomic_read_u64(&orca_mdcache->invalidations);
+	stats->invalidated_entries = orca_mdcache->invalidated_entries;
+
+	LWLockRelease(OrcaMDCacheLock);
+}
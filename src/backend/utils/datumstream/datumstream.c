@@ -295,6 +295,35 @@ datumstreamread_nthlarge(DatumStreamRead * acc)
 	}
 }
 
+/*
+ * Read up to maxRows datums from the current block into values[] and nulls[],
+ * advancing past them.  Returns the number of datums read; 0 means the block
+ * is exhausted, and the caller should read the next one with
+ * datumstreamread_block().
+ */
+int
+datumstreamread_get_batch(DatumStreamRead * acc, Datum *values, bool *nulls,
+						  int maxRows)
+{
+	Assert(maxRows > 0);
+
+	if (acc->largeObjectState == DatumStreamLargeObjectState_None)
+	{
+		/*
+		 * Small objects are handled by the DatumStreamBlockRead module.
+		 */
+		return DatumStreamBlockRead_GetBatch(&acc->blockRead, values, nulls,
+											 maxRows);
+	}
+
+	/* A large object is stored alone in its block. */
+	if (datumstreamread_advancelarge(acc) == 0)
+		return 0;
+	datumstreamread_getlarge(acc, &values[0], &nulls[0]);
+
+	return 1;
+}
+
 
 int
 datumstreamwrite_put(
@@ -303,7 +332,15 @@ datumstreamwrite_put(
 					 bool null,
 					 void **toFree)
 {
-	return DatumStreamBlockWrite_Put(&acc->blockWrite, d, null, toFree);
+	int			result;
+
+	result = DatumStreamBlockWrite_Put(&acc->blockWrite, d, null, toFree);
+
+	if (result >= 0 && acc->hasZoneMap)
+		AOZoneMapEntry_AddDatum(&acc->zonemap, d, null,
+								acc->typeInfo.datumlen);
+
+	return result;
 }
 
 int
@@ -633,6 +670,11 @@ create_datumstreamwrite(
 				  /* errcontextCallback */ datumstreamwrite_context_callback,
 								/* errcontextArg */ (void *) acc);
 
+	acc->hasZoneMap = gp_appendonly_zone_maps &&
+		AOZoneMap_TypeIsSupported(attr->atttypid);
+	if (acc->hasZoneMap)
+		AOZoneMapEntry_Init(&acc->zonemap, attr->attnum);
+
 	return acc;
 }
 
@@ -1010,13 +1052,18 @@ datumstreamwrite_block(DatumStreamWrite *acc,
 			/* Never reaches here. */
 	}
 
-	/* Insert an entry to the block directory */
-	AppendOnlyBlockDirectory_InsertEntry(
+	/* Insert an entry, and the block's synopsis, to the block directory */
+	AppendOnlyBlockDirectory_InsertEntryWithZoneMap(
 		blockDirectory,
 		columnGroupNo,
 		acc->blockFirstRowNum,
 		AppendOnlyStorageWrite_LogicalBlockStartOffset(&acc->ao_write),
-		itemCount);
+		itemCount,
+		acc->hasZoneMap ? &acc->zonemap : NULL,
+		acc->hasZoneMap ? 1 : 0);
+
+	if (acc->hasZoneMap)
+		AOZoneMapEntry_Init(&acc->zonemap, acc->zonemap.attnum);
 
 	return writesz;
 }
@@ -1299,6 +1346,34 @@ datumstreamread_block_content(DatumStreamRead * acc)
 	datumstreamread_block_get_ready(acc);
 }
 
+/*
+ * Skip the block whose header was just read by datumstreamread_block_info(),
+ * without reading (or decompressing) its content.
+ */
+void
+datumstreamread_skip_block(DatumStreamRead * acc)
+{
+	Assert(acc);
+
+	AppendOnlyStorageRead_SkipCurrentBlock(&acc->ao_read);
+
+	datumstreamread_reset_block(acc);
+}
+
+/*
+ * Forget about the datums of the current block, so that the stream looks
+ * like it was exhausted until the next block is read.
+ */
+void
+datumstreamread_reset_block(DatumStreamRead * acc)
+{
+	Assert(acc);
+
+	DatumStreamBlockRead_Reset(&acc->blockRead);
+
+	acc->largeObjectState = DatumStreamLargeObjectState_None;
+}
+
 
 int
 datumstreamread_block(DatumStreamRead * acc,
@@ -406,6 +406,63 @@ DatumStreamBlockRead_Finish(
 	/* Place holder. */
 }
 
+/*
+ * Advance over up to maxRows datums of the current block, storing them in
+ * values[] and nulls[].  Returns the number of datums stored, which is less
+ * than maxRows only when the end of the block was reached.
+ *
+ * This is equivalent to calling DatumStreamBlockRead_Advance and
+ * DatumStreamBlockRead_Get in a loop, except that the copies of a repeated
+ * RLE_TYPE item are stored in one go, instead of being stepped over one row
+ * at a time.
+ */
+int
+DatumStreamBlockRead_GetBatch(
+							  DatumStreamBlockRead * dsr,
+							  Datum *values,
+							  bool *nulls,
+							  int maxRows)
+{
+	int			n = 0;
+
+	while (n < maxRows)
+	{
+		if (DatumStreamBlockRead_Advance(dsr) == 0)
+			break;
+
+		DatumStreamBlockRead_Get(dsr, &values[n], &nulls[n]);
+		n++;
+
+		if (dsr->rle_in_repeated_item)
+		{
+			Datum		value = values[n - 1];
+			int32		repeatCount;
+
+			/* a repeated item is never NULL */
+			Assert(!nulls[n - 1]);
+
+			repeatCount = Min(dsr->rle_repeated_item_count, maxRows - n);
+			for (int i = 0; i < repeatCount; i++)
+			{
+				values[n + i] = value;
+				nulls[n + i] = false;
+			}
+			n += repeatCount;
+
+			/* catch up with what DatumStreamBlockRead_AdvanceDense would do */
+			dsr->nth += repeatCount;
+			dsr->rle_repeated_item_count -= repeatCount;
+			dsr->rle_total_repeat_items_read += repeatCount;
+			if (dsr->rle_repeated_item_count <= 0)
+				dsr->rle_in_repeated_item = false;
+
+			Assert(dsr->nth < dsr->logical_row_count);
+		}
+	}
+
+	return n;
+}
+
 /*
  * Dense routines.
  */
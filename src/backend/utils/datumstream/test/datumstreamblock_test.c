@@ -4,6 +4,7 @@
 #include "cmockery.h"
 
 #include "../datumstreamblock.c"
+#include "utils/memutils.h"
 
 /* 
  * Unit test function to test the routines added for
@@ -167,13 +168,122 @@ test__DeltaCompression__Core(void **state)
 	free(dsw);
 }
 
+static int
+test__errcallback(void *arg)
+{
+	return 0;
+}
+
+/*
+ * Write a block with runs of repeated values, NULLs and small deltas, and
+ * check that DatumStreamBlockRead_GetBatch returns the same datums as
+ * reading them one at a time.
+ */
+static void
+test__DatumStreamBlockRead_GetBatch(void **state)
+{
+#define TEST_ROWS 1000
+#define TEST_BATCH_SIZE 7
+	DatumStreamTypeInfo typeInfo;
+	DatumStreamBlockWrite *dsw = palloc0(sizeof(DatumStreamBlockWrite));
+	DatumStreamBlockRead *dsr = palloc0(sizeof(DatumStreamBlockRead));
+	DatumStreamBlockRead *dsr_batch = palloc0(sizeof(DatumStreamBlockRead));
+	uint8	   *buffer = palloc(65536);
+	int64		size;
+	bool		hadToAdjustRowCount;
+	int32		adjustedRowCount;
+	Datum		values[TEST_BATCH_SIZE];
+	bool		nulls[TEST_BATCH_SIZE];
+	int			nrows = 0;
+	int			n;
+
+	memset(&typeInfo, 0, sizeof(typeInfo));
+	typeInfo.datumlen = 4;
+	typeInfo.typid = INT4OID;
+	typeInfo.align = 'i';
+	typeInfo.typstorage = 'p';
+	typeInfo.byval = true;
+
+	DatumStreamBlockWrite_Init(dsw, &typeInfo, DatumStreamVersion_Dense_Enhanced,
+							   true /* rle_want_compression */,
+							   true /* delta_want_compression */,
+							   TEST_ROWS, 2 * TEST_ROWS, 32768,
+							   test__errcallback, NULL,
+							   test__errcallback, NULL);
+	DatumStreamBlockWrite_GetReady(dsw);
+
+	for (int i = 0; i < TEST_ROWS; i++)
+	{
+		bool		null = (i % 50 == 25);
+		Datum		d = Int32GetDatum(i % 50 < 20 ? 7 : i);
+		void	   *toFree = NULL;
+
+		assert_true(DatumStreamBlockWrite_Put(dsw, d, null, &toFree) >= 0);
+	}
+	size = DatumStreamBlockWrite_Block(dsw, buffer);
+	assert_true(size > 0);
+
+	DatumStreamBlockRead_Init(dsr, &typeInfo, DatumStreamVersion_Dense_Enhanced,
+							  true /* rle_can_have_compression */,
+							  test__errcallback, NULL,
+							  test__errcallback, NULL);
+	DatumStreamBlockRead_Init(dsr_batch, &typeInfo, DatumStreamVersion_Dense_Enhanced,
+							  true /* rle_can_have_compression */,
+							  test__errcallback, NULL,
+							  test__errcallback, NULL);
+	DatumStreamBlockRead_GetReady(dsr, buffer, size, 1, TEST_ROWS,
+								  &hadToAdjustRowCount, &adjustedRowCount);
+	DatumStreamBlockRead_GetReady(dsr_batch, buffer, size, 1, TEST_ROWS,
+								  &hadToAdjustRowCount, &adjustedRowCount);
+	assert_true(dsr_batch->rle_block_was_compressed);
+
+	while ((n = DatumStreamBlockRead_GetBatch(dsr_batch, values, nulls,
+											  TEST_BATCH_SIZE)) > 0)
+	{
+		assert_true(n == TEST_BATCH_SIZE || nrows + n == TEST_ROWS);
+
+		for (int i = 0; i < n; i++)
+		{
+			Datum		d;
+			bool		null;
+
+			assert_int_equal(DatumStreamBlockRead_Advance(dsr), 1);
+			DatumStreamBlockRead_Get(dsr, &d, &null);
+
+			assert_int_equal(nulls[i], null);
+			if (!null)
+				assert_int_equal(DatumGetInt32(values[i]), DatumGetInt32(d));
+		}
+
+		nrows += n;
+
+		/* both readers are positioned at the same datum */
+		if (n == TEST_BATCH_SIZE)
+			assert_int_equal(DatumStreamBlockRead_Nth(dsr_batch),
+							 DatumStreamBlockRead_Nth(dsr));
+	}
+
+	assert_int_equal(nrows, TEST_ROWS);
+	assert_int_equal(DatumStreamBlockRead_Advance(dsr), 0);
+
+	DatumStreamBlockWrite_Finish(dsw);
+	pfree(dsw);
+	pfree(dsr);
+	pfree(dsr_batch);
+	pfree(buffer);
+}
+
 int 
 main(int argc, char* argv[]) 
 {
 	cmockery_parse_arguments(argc, argv);
 
 	const UnitTest tests[] = {
-			unit_test(test__DeltaCompression__Core)
+			unit_test(test__DeltaCompression__Core),
+			unit_test(test__DatumStreamBlockRead_GetBatch)
 	};
+
+	MemoryContextInit();
+
 	return run_tests(tests);
 }
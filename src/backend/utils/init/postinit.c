@@ -70,6 +70,7 @@
 #include "utils/fmgroids.h"
 #include "utils/guc.h"
 #include "utils/memutils.h"
+#include "utils/orcamdcache.h"
 #include "utils/pg_locale.h"
 #include "utils/portal.h"
 #include "utils/ps_status.h"
@@ -778,6 +779,7 @@ InitPostgres(const char *in_dbname, Oid dboid, const char *username,
 	RelationCacheInitialize();
 	InitCatalogCache();
 	InitPlanCache();
+	InitOrcaMDCache();
 
 	/* Initialize portal manager */
 	EnablePortalManager();
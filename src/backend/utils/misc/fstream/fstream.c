@@ -13,6 +13,7 @@
 #include <postgres.h>
 #include <commands/copy.h>
 #include <fstream/fstream.h>
+#include <port/pg_charscan.h>
 #include <assert.h>
 #include <glob.h>
 #include <stdio.h>
@@ -58,17 +59,20 @@ struct fstream_t
 static char *find_last_eol_delim (const char *start, const int size,
 								  const char *delimiter, const int delimiter_length)
 {
-	char* p;
+	PgCharScanSet	set;
+	const char*		end = start + size;
+	const char*		p;
 
 	if (size <= delimiter_length)
 		return (char*)start - 1;
 
-	for (p = (char*)start + size - delimiter_length; start <= p; p--)
+	/* look for the last byte of the delimiter, then check the rest of it */
+	pg_charscan_init(&set, delimiter + delimiter_length - 1, 1, false);
+	while ((p = pg_charscan_last(start + delimiter_length - 1, end, &set)) != NULL)
 	{
-		if (memcmp(p, delimiter, delimiter_length) == 0)
-		{
-			return (char*)p + delimiter_length - 1;
-		}
+		if (memcmp(p - (delimiter_length - 1), delimiter, delimiter_length) == 0)
+			return (char*)p;
+		end = p;
 	}
 	return (char*)start - 1;
 }
@@ -82,14 +86,19 @@ static char *find_last_eol_delim (const char *start, const int size,
 static char *find_first_eol_delim (char *start, char *end,
 								   const char *delimiter, const int delimiter_length)
 {
-	char *search_limit = (char*)end - delimiter_length;
+	PgCharScanSet	set;
+	char*			search_limit = end - delimiter_length + 1;
+
 	if (end - start <= delimiter_length)
 		return end;
 
-	for (; start <= search_limit; start++)
+	/* look for the first byte of the delimiter, then check the rest of it */
+	pg_charscan_init(&set, delimiter, 1, false);
+	while ((start = (char*)pg_charscan_first(start, search_limit, &set)) < search_limit)
 	{
 		if (memcmp(start, delimiter, delimiter_length) == 0)
-			return (char*)start + delimiter_length - 1;
+			return start + delimiter_length - 1;
+		start++;
 	}
 
 	return end;
@@ -181,45 +190,66 @@ fstream_get_error(fstream_t*fs)
  * server. That is because it may be inside a quote. We have to carefully parse
  * the data from the start in order to find the last unquoted newline.
  *
+ * Only the quote and escape characters matter inside a quote, and only the
+ * newline and quote characters outside of one, so we skip from one of those
+ * to the next with pg_charscan_first() rather than look at every byte.
  */
 
 static char*
 scan_csv_records_crlf(char *p, char* q, int one, fstream_t* fs)
 {
-	int 	in_quote = 0;
-	int 	last_was_esc = 0;
 	int 	qc = fs->options.quote;
 	int 	xc = fs->options.escape;
+	char*	start = p;
 	char*	last_record_loc = 0;
-	int 	ch = 0;
-	int 	lastch = 0;
+	char	quote_chars[2];
+	char	unquoted_chars[2];
+	PgCharScanSet	quote_set;
+	PgCharScanSet	unquoted_set;
+
+	quote_chars[0] = qc;
+	quote_chars[1] = xc;
+	pg_charscan_init(&quote_set, quote_chars, 2, false);
+	unquoted_chars[0] = qc;
+	unquoted_chars[1] = '\n';
+	pg_charscan_init(&unquoted_set, unquoted_chars, 2, false);
 
-	while (p < q)
+	for (;;)
 	{
-		lastch = ch;
+		int ch;
+
+		/* outside of a quote */
+		p = (char*)pg_charscan_first(p, q, &unquoted_set);
+		if (p >= q)
+			break;
 		ch = *p++;
 
-		if (in_quote)
-		{
-			if (!last_was_esc)
-			{
-				if (ch == qc)
-					in_quote = 0;
-				else if (ch == xc)
-					last_was_esc = 1;
-			}
-			else
-				last_was_esc = 0;
-		}
-		else if (ch == '\n' && lastch == '\r')
+		if (ch == '\n' && p - 1 > start && p[-2] == '\r')
 		{
 			last_record_loc = p;
 			fs->line_number++;
 			if (one)
 				break;
+			continue;
+		}
+		if (ch != qc)
+			continue;
+
+		/* inside a quote */
+		for (;;)
+		{
+			p = (char*)pg_charscan_first(p, q, &quote_set);
+			if (p >= q)
+				break;
+			ch = *p++;
+
+			if (ch == qc)
+				break;
+			/* an escape: skip the next character, whatever it is */
+			p++;
 		}
-		else if (ch == qc)
-			in_quote = 1;
+		if (p >= q)
+			break;
 	}
 
 	return last_record_loc;
@@ -228,37 +258,55 @@ scan_csv_records_crlf(char *p, char* q, int one, fstream_t* fs)
 static char*
 scan_csv_records_cr_or_lf(char *p, char *q, int one, fstream_t *fs, int nc)
 {
-	int 	in_quote = 0;
-	int 	last_was_esc = 0;
 	int 	qc = fs->options.quote;
 	int 	xc = fs->options.escape;
 	char*	last_record_loc = 0;
+	char	quote_chars[2];
+	char	unquoted_chars[2];
+	PgCharScanSet	quote_set;
+	PgCharScanSet	unquoted_set;
+
+	quote_chars[0] = qc;
+	quote_chars[1] = xc;
+	pg_charscan_init(&quote_set, quote_chars, 2, false);
+	unquoted_chars[0] = qc;
+	unquoted_chars[1] = nc;
+	pg_charscan_init(&unquoted_set, unquoted_chars, 2, false);
 
-	while (p < q)
+	for (;;)
 	{
-		int ch = *p++;
+		int ch;
 
-		if (in_quote)
-		{
-			if (!last_was_esc)
-			{
-				if (ch == qc)
-					in_quote = 0;
-				else if (ch == xc)
-					last_was_esc = 1;
-			}
-			else
-				last_was_esc = 0;
-		}
-		else if (ch == nc)
+		/* outside of a quote */
+		p = (char*)pg_charscan_first(p, q, &unquoted_set);
+		if (p >= q)
+			break;
+		ch = *p++;
+
+		if (ch == nc)
 		{
 			last_record_loc = p;
 			fs->line_number++;
 			if (one)
 				break;
+			continue;
+		}
+
+		/* inside a quote */
+		for (;;)
+		{
+			p = (char*)pg_charscan_first(p, q, &quote_set);
+			if (p >= q)
+				break;
+			ch = *p++;
+
+			if (ch == qc)
+				break;
+			/* an escape: skip the next character, whatever it is */
+			p++;
 		}
-		else if (ch == qc)
-			in_quote = 1;
+		if (p >= q)
+			break;
 	}
 
 	return last_record_loc;
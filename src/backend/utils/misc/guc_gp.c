@@ -25,6 +25,7 @@
 #include "access/url.h"
 #include "access/xlog_internal.h"
 #include "cdb/cdbappendonlyam.h"
+#include "cdb/cdbappendonlydecompress.h"
 #include "cdb/cdbendpoint.h"
 #include "cdb/cdbdisp.h"
 #include "cdb/cdbdisp_query.h"
@@ -82,6 +83,7 @@ static bool check_optimizer(bool *newval, void **extra, GucSource source);
 static bool check_verify_gpfdists_cert(bool *newval, void **extra, GucSource source);
 static bool check_dispatch_log_stats(bool *newval, void **extra, GucSource source);
 static bool check_gp_workfile_compression(bool *newval, void **extra, GucSource source);
+static bool check_gp_interconnect_compression(bool *newval, void **extra, GucSource source);
 
 /* Helper function for guc setter */
 bool gpvars_check_gp_resqueue_priority_default_value(char **newval,
@@ -142,7 +144,9 @@ int			gp_max_local_distributed_cache = 1024;
 bool		gp_appendonly_verify_block_checksums = true;
 bool		gp_appendonly_verify_write_block = false;
 bool		gp_appendonly_compaction = true;
+bool		gp_appendonly_compaction_copy_blocks = true;
 int			gp_appendonly_compaction_threshold = 0;
+int			gp_appendonly_read_ahead_depth = 4;
 bool		gp_heap_require_relhasoids_match = true;
 bool		gp_local_distributed_cache_stats = false;
 bool		debug_xlog_record_read = false;
@@ -258,6 +262,7 @@ bool		dml_ignore_target_partition_check = false;
 /* Planner gucs */
 bool		gp_enable_hashjoin_size_heuristic = false;
 bool		gp_enable_predicate_propagation = false;
+bool		gp_enable_runtime_filter = false;
 bool		gp_enable_minmax_optimization = true;
 bool		gp_enable_multiphase_agg = true;
 bool		gp_enable_preunique = true;
@@ -283,6 +288,9 @@ int			optimizer_minidump;
 int			optimizer_cost_model;
 bool		optimizer_metadata_caching;
 int			optimizer_mdcache_size;
+bool		optimizer_plan_caching;
+int			optimizer_plan_cache_size;
+int			optimizer_shared_mdcache_size;
 bool		optimizer_use_gpdb_allocators;
 
 /* Optimizer debugging GUCs */
@@ -408,6 +416,8 @@ bool		optimizer_enable_orderedagg;
 bool		optimizer_analyze_root_partition;
 bool		optimizer_analyze_midlevel_partition;
 
+bool		gp_analyze_skip_unchanged_ao = false;
+
 /* GUCs for replicated table */
 bool		optimizer_replicated_table_insert;
 
@@ -427,6 +437,7 @@ bool		gp_reject_internal_tcp_conn = true;
 
 /* copy */
 bool		gp_enable_segment_copy_checking = true;
+bool		gp_copy_parse_on_segments = false;
 /*
  * Default storage options GUC.  Value is comma-separated name=value
  * pairs.  E.g. "blocksize=32768,compresstype=none,checksum=true"
@@ -695,6 +706,18 @@ struct config_bool ConfigureNamesBool_gp[] =
 		false,
 		NULL, NULL, NULL
 	},
+	{
+		{"gp_enable_runtime_filter", PGC_USERSET, QUERY_TUNING_METHOD,
+			gettext_noop("Let hash joins filter the rows of the scan on their outer side."),
+			gettext_noop("The Hash node builds a Bloom filter over the join keys "
+						 "of the inner rows, which the sequential scan feeding "
+						 "the outer side of the join uses to drop rows that "
+						 "cannot have a match.")
+		},
+		&gp_enable_runtime_filter,
+		false,
+		NULL, NULL, NULL
+	},
 	{
 		{"gp_enable_direct_dispatch", PGC_USERSET, QUERY_TUNING_METHOD,
 			gettext_noop("Enable dispatch for single-row-insert targeted mirror-pairs."),
@@ -957,6 +980,33 @@ struct config_bool ConfigureNamesBool_gp[] =
 		NULL, NULL, NULL
 	},
 
+	{
+		{"gp_appendonly_compaction_copy_blocks", PGC_USERSET, APPENDONLY_TABLES,
+			gettext_noop("Copy the varblocks without deleted tuples as they are during append-only compaction."),
+			gettext_noop("Such varblocks are appended to the new segment file without "
+						 "being decompressed and compressed again. Only the varblocks "
+						 "with deleted tuples are rewritten tuple by tuple.")
+		},
+		&gp_appendonly_compaction_copy_blocks,
+		true,
+		NULL, NULL, NULL
+	},
+
+	{
+		{"gp_appendonly_zone_maps", PGC_USERSET, APPENDONLY_TABLES,
+			gettext_noop("Record and use per-block min/max zone maps of append-optimized tables."),
+			gettext_noop("While it is on, new append-optimized tables get a block directory, "
+						 "and inserts record in it the minimum and maximum of the integer, "
+						 "date and time columns of each block they write. Sequential scans "
+						 "skip the blocks that cannot satisfy the query's conditions on "
+						 "these columns. Blocks written while it was off have no zone map, "
+						 "and are always read.")
+		},
+		&gp_appendonly_zone_maps,
+		false,
+		NULL, NULL, NULL
+	},
+
 	{
 		{"gp_heap_require_relhasoids_match", PGC_USERSET, DEVELOPER_OPTIONS,
 			gettext_noop("Issue an error on discovery of a mismatch between relhasoids and a tuple header."),
@@ -1097,6 +1147,27 @@ struct config_bool ConfigureNamesBool_gp[] =
 		NULL, NULL, NULL
 	},
 
+	{
+		{"gp_interconnect_udp_gso", PGC_USERSET, GP_ARRAY_TUNING,
+			gettext_noop("Use UDP generic segmentation offload to send batches of UDP interconnect packets."),
+			gettext_noop("It is disabled for the rest of the session if the kernel or the "
+						 "network device does not support it.")
+		},
+		&gp_interconnect_udp_gso,
+		false,
+		NULL, NULL, NULL
+	},
+
+	{
+		{"gp_interconnect_compression", PGC_USERSET, GP_ARRAY_TUNING,
+			gettext_noop("Compresses the tuples sent over the interconnect."),
+			gettext_noop("Packets that do not compress well are sent uncompressed.")
+		},
+		&gp_interconnect_compression,
+		false,
+		check_gp_interconnect_compression, NULL, NULL
+	},
+
 	{
 		{"gp_interconnect_cache_future_packets", PGC_USERSET, GP_ARRAY_TUNING,
 			gettext_noop("Control whether future packets are cached."),
@@ -1968,6 +2039,18 @@ struct config_bool ConfigureNamesBool_gp[] =
 		NULL, NULL, NULL
 	},
 
+	{
+		{"optimizer_plan_caching", PGC_USERSET, QUERY_TUNING_METHOD,
+			gettext_noop("This guc enables the optimizer to cache and reuse plans across queries."),
+			gettext_noop("Plans are reused only for identical queries planned under "
+						 "identical optimizer settings, and are discarded whenever "
+						 "the optimizer's metadata cache is reset.")
+		},
+		&optimizer_plan_caching,
+		false,
+		NULL, NULL, NULL
+	},
+
 	{
 		{"optimizer_print_missing_stats", PGC_USERSET, LOGGING_WHAT,
 			gettext_noop("Print columns with missing statistics."),
@@ -2622,6 +2705,18 @@ struct config_bool ConfigureNamesBool_gp[] =
 		NULL, NULL, NULL
 	},
 
+	{
+		{"gp_analyze_skip_unchanged_ao", PGC_USERSET, STATS_ANALYZE,
+			gettext_noop("Skip ANALYZE of append-optimized partitions that have not been modified since they were last analyzed."),
+			gettext_noop("The statistics of such partitions are kept as they are, and are "
+						 "still merged into the statistics of the root partition."),
+			GUC_NOT_IN_SAMPLE
+		},
+		&gp_analyze_skip_unchanged_ao,
+		false,
+		NULL, NULL, NULL
+	},
+
 	{
 		{"optimizer_enable_constant_expression_evaluation", PGC_USERSET, QUERY_TUNING_METHOD,
 			gettext_noop("Enable constant expression evaluation in the optimizer"),
@@ -2831,6 +2926,20 @@ struct config_bool ConfigureNamesBool_gp[] =
 		NULL, NULL, NULL
 	},
 
+	{
+		{"gp_copy_parse_on_segments", PGC_USERSET, CUSTOM_OPTIONS,
+			gettext_noop("Let the segments parse the rows of COPY FROM into a hash distributed table."),
+			gettext_noop("The coordinator only splits the input into lines and spreads them over the "
+						 "segments, through a randomly distributed temporary table that is kept for the "
+						 "session. The rows are then redistributed to the right segments with "
+						 "INSERT ... SELECT."),
+			GUC_NOT_IN_SAMPLE
+		},
+		&gp_copy_parse_on_segments,
+		false,
+		NULL, NULL, NULL
+	},
+
 	{
 		{"gp_ignore_error_table", PGC_USERSET, COMPAT_OPTIONS_PREVIOUS,
 			gettext_noop("Ignore INTO error-table in external table and COPY (Deprecated)."),
@@ -3274,6 +3383,18 @@ struct config_int ConfigureNamesInt_gp[] =
 		NULL, NULL, NULL
 	},
 
+	{
+		{"gp_dispatch_plan_cache_size", PGC_USERSET, GP_ARRAY_TUNING,
+			gettext_noop("Sets the number of dispatched plans each segment worker keeps for reuse."),
+			gettext_noop("A plan that a segment worker already holds is dispatched to it as a hash "
+						 "instead of the full serialized plan. Use 0 to always dispatch the full plan."),
+			GUC_NOT_IN_SAMPLE
+		},
+		&gp_dispatch_plan_cache_size,
+		16, 0, MAX_CACHED_DISPATCH_PLANS,
+		NULL, NULL, NULL
+	},
+
 	{
 		{"gp_max_partition_level", PGC_SUSET, PRESET_OPTIONS,
 			gettext_noop("Sets the maximum number of levels allowed when creating a partitioned table using Greenplum classic syntax."),
@@ -3296,6 +3417,37 @@ struct config_int ConfigureNamesInt_gp[] =
 		NULL, NULL, NULL
 	},
 
+	{
+		{"gp_appendonly_decompress_workers", PGC_USERSET, APPENDONLY_TABLES,
+			gettext_noop("Sets the number of threads that decompress append-only blocks ahead of the scan."),
+			gettext_noop("Only zlib and zstd compressed blocks are decompressed ahead. Use 0 to disable.")
+		},
+		&gp_appendonly_decompress_workers,
+		0, 0, 32,
+		NULL, NULL, NULL
+	},
+
+	{
+		{"gp_appendonly_decompress_ahead_mem", PGC_USERSET, APPENDONLY_TABLES,
+			gettext_noop("Sets the maximum memory of the blocks decompressed ahead of the scans of a backend."),
+			NULL,
+			GUC_UNIT_KB
+		},
+		&gp_appendonly_decompress_ahead_mem,
+		16384, 1024, MAX_KILOBYTES,
+		NULL, NULL, NULL
+	},
+
+	{
+		{"gp_appendonly_read_ahead_depth", PGC_USERSET, APPENDONLY_TABLES,
+			gettext_noop("Sets the number of large reads of an append-only segment file to prefetch ahead of the scan."),
+			gettext_noop("Use 0 to disable read-ahead.")
+		},
+		&gp_appendonly_read_ahead_depth,
+		4, 0, 64,
+		NULL, NULL, NULL
+	},
+
 	{
 		{"gp_workfile_max_entries", PGC_POSTMASTER, RESOURCES,
 			gettext_noop("Sets the maximum number of entries that can be stored in the workfile directory"),
@@ -3492,6 +3644,27 @@ struct config_int ConfigureNamesInt_gp[] =
 		NULL, NULL, NULL
 	},
 
+	{
+		{"gp_interconnect_udp_batch_size", PGC_USERSET, GP_ARRAY_TUNING,
+			gettext_noop("Sets the maximum number of packets sent or received with one system call in the UDP interconnect."),
+			gettext_noop("1 sends and receives one packet per system call.")
+		},
+		&gp_interconnect_udp_batch_size,
+		16, 1, GP_INTERCONNECT_UDP_MAX_BATCH_SIZE,
+		NULL, NULL, NULL
+	},
+
+	{
+		{"gp_motion_batch_size", PGC_USERSET, GP_ARRAY_TUNING,
+			gettext_noop("Sets the maximum number of tuples a Motion sends together, stored column by column."),
+			gettext_noop("Only Motions whose columns are all fixed-width pass-by-value types use it. "
+						 "0 sends every tuple on its own.")
+		},
+		&gp_motion_batch_size,
+		0, 0, GP_MOTION_MAX_BATCH_SIZE,
+		NULL, NULL, NULL
+	},
+
 	{
 		{"gp_interconnect_cursor_ic_table_size", PGC_USERSET, GP_ARRAY_TUNING,
 			gettext_noop("Sets the size of Cursor History Table in the UDP interconnect"),
@@ -4247,6 +4420,28 @@ struct config_int ConfigureNamesInt_gp[] =
 		NULL, NULL, NULL
 	},
 
+	{
+		{"optimizer_plan_cache_size", PGC_USERSET, RESOURCES_MEM,
+			gettext_noop("Sets the size of the optimizer plan cache."),
+			NULL,
+			GUC_UNIT_KB
+		},
+		&optimizer_plan_cache_size,
+		16384, 0, INT_MAX,
+		NULL, NULL, NULL
+	},
+
+	{
+		{"optimizer_shared_mdcache_size", PGC_POSTMASTER, RESOURCES_MEM,
+			gettext_noop("Sets the size of the metadata cache shared by all backends on the coordinator."),
+			gettext_noop("0 disables the shared metadata cache."),
+			GUC_UNIT_KB
+		},
+		&optimizer_shared_mdcache_size,
+		0, 0, MAX_KILOBYTES,
+		NULL, NULL, NULL
+	},
+
 	{
 		{"memory_profiler_dataset_size", PGC_USERSET, DEVELOPER_OPTIONS,
 			gettext_noop("Set the size in GB"),
@@ -5402,6 +5597,19 @@ check_gp_workfile_compression(bool *newval, void **extra, GucSource source)
 	return true;
 }
 
+static bool
+check_gp_interconnect_compression(bool *newval, void **extra, GucSource source)
+{
+#ifndef USE_ZSTD
+	if (*newval)
+	{
+		GUC_check_errmsg("interconnect compression is not supported by this build");
+		return false;
+	}
+#endif
+	return true;
+}
+
 void
 DispatchSyncPGVariable(struct config_generic * gconfig)
 {
@@ -206,7 +206,8 @@ static struct
 	int 		k; /* The time used to clean up sessions in seconds */
 	int			compress; /* The flag to indicate whether comopression transmission is open */
 	int			multi_thread; /* The number of working threads for compression transmission */
-} opt = { 8080, 8080, 0, 0, 0, ".", 0, 0, -1, 5, 0, 32768, 0, 256, 0, 0, 0, "on", 0, 300, 0, 0};
+	int			worker_threads; /* The number of worker threads that prepare the blocks of GET requests */
+} opt = { 8080, 8080, 0, 0, 0, ".", 0, 0, -1, 5, 0, 32768, 0, 256, 0, 0, 0, "on", 0, 300, 0, 0, 0};
 
 #define START_BUFFER_SIZE (1 << 20) /* 1M as start size */
 #define MAXIMUM_BUFFER_SIZE (1 << 30) /* 1G as Maximum size */
@@ -270,6 +271,10 @@ struct session_t
 	struct timeval 	tm;             /* timeout for struct event */
 	struct event   	ev;             /* event we are watching for this session*/
 	apr_hash_t		*requests;
+#ifndef WIN32
+	pthread_mutex_t	lock;			/* serializes the reads of fstream by worker threads,
+									   and closing it */
+#endif
 };
 
 /*  An http request */
@@ -346,6 +351,20 @@ struct request_t
 	int				send_size;		/* record number of sent bytes in multi-thread or compression mode. */
 	bool			session_end;	/* mark whether the session should be ended . */
 
+#ifndef WIN32
+	/* the next block, that a worker thread prepares while outblock is sent */
+	struct
+	{
+		int			state;		/* PREPARE_IDLE, QUEUED, RUNNING or DONE */
+		block_t		block;
+		int			eof;		/* no more data in the session */
+		const char*	ferror;		/* the error reading the session's file, if any */
+		int			zstd_failed; /* the compression failed, see zstd_error */
+		apr_int64_t	read_bytes;	/* # bytes read from the session's file */
+		request_t*	next;		/* next request in the worker queue or done list */
+	} prepare;
+#endif
+
 #ifdef USE_SSL
 	/* SSL related */
 	BIO			*io;		/* for the i.o. */
@@ -357,6 +376,36 @@ struct request_t
 
 
 
+#ifndef WIN32
+#define PREPARE_IDLE	0
+#define PREPARE_QUEUED	1
+#define PREPARE_RUNNING	2
+#define PREPARE_DONE	3
+
+/*
+ * The pool of worker threads of --worker_threads.
+ *
+ * The workers prepare the blocks of GET requests: they read whole rows from
+ * the file of the request's session, fill in the block header and compress
+ * the block. The event loop only sends out the blocks that are ready, so one
+ * gpfdist can read and compress the files of many sessions at the same time.
+ * Each request has at most one block being prepared, the one after the block
+ * being sent.
+ */
+static struct
+{
+	int				nthreads;
+	pthread_mutex_t	lock;
+	pthread_cond_t	queued;		/* signaled when a request is queued */
+	pthread_cond_t	done;		/* broadcast when a worker is done with a request */
+	request_t*		queue_head;	/* requests waiting for a worker */
+	request_t*		queue_tail;
+	request_t*		done_head;	/* requests whose block is ready */
+	int				notify_pipe[2];	/* wakes up the event loop when a block is ready */
+	struct event	notify_event;
+} workers;
+#endif
+
 #if APR_IS_BIGENDIAN
 #define local_htonll(n)  (n)
 #define local_ntohll(n)  (n)
@@ -454,6 +503,14 @@ static void session_mark_end(request_t* req);
 #ifndef WIN32
 static apr_time_t shutdown_time;
 static void* watchdog_thread(void*);
+static void workers_start(void);
+static void* worker_main(void* arg);
+static void worker_prepare_block(request_t* r);
+static void worker_notify_cb(int fd, short event, void* arg);
+static void request_prepare_next(request_t* r);
+static int request_take_prepared(request_t* r);
+static void request_wait_prepare(request_t* r);
+static void do_write_prepared(request_t* r);
 #endif
 
 static const char *EMPTY_HTTP_RES = "HTTP/1.0 200 ok\r\n"
@@ -629,6 +686,9 @@ static void usage_error(const char* msg, int print_usage)
 #ifdef USE_ZSTD
 						"        --compress : open compression transmission\n"
 						"        --multi_thread num : the max number of working thread for compression transmission\n"
+#endif
+#ifndef WIN32
+						"        --worker_threads num : the number of threads that read and compress the data to send\n"
 #endif
 						"        --version  : print version information\n"
 						"        -w timeout : timeout in seconds before close target file\n"
@@ -700,6 +760,7 @@ static void parse_command_line(int argc, const char* const argv[],
 	{"compress", 258, 0, "turn on compressed transmission"},
 	{"multi_thread", 259, 1, "turn on multi-thread and compressed transmission"},
 #endif
+	{ "worker_threads", 261, 1, "number of threads that read and compress the data to send" },
 	{ NULL, 'k', 1, "timeout to clean up sessions in seconds" },
 	{ 0 } };
 
@@ -811,6 +872,20 @@ static void parse_command_line(int argc, const char* const argv[],
 		case 259:
 			usage_error("Multi-thread transmission relies on zstd, but zstd is not supported by this build", 0);
 			break;
+#endif
+#ifndef WIN32
+		case 261:
+			if (atoi(arg) <= 0)
+			{
+				usage_error("The number of worker threads must be more than zero!", 0);
+				break;
+			}
+			opt.worker_threads = atoi(arg);
+			break;
+#else
+		case 261:
+			usage_error("Flag worker_threads is not supported on this platform", 0);
+			break;
 #endif
 		case 'k':
 			opt.k = atoi(arg);
@@ -896,6 +971,19 @@ static void parse_command_line(int argc, const char* const argv[],
 
 		sem_init(&THREAD_NUM, 0, num_thread);
 	}
+
+	if (opt.worker_threads)
+	{
+		/* the threads of --multi_thread send on the sockets themselves */
+		if (opt.multi_thread)
+			usage_error("Error: --worker_threads and --multi_thread cannot be used together", 0);
+
+		if (opt.worker_threads > MAX_THREAD_NUM)
+		{
+			gwarning(NULL, "%s", "The worker thread number exceeds the restricted number! Gpfdist will use the restricted number.");
+			opt.worker_threads = MAX_THREAD_NUM;
+		}
+	}
 #endif
 
 	/* validate opt.l */
@@ -1252,6 +1340,12 @@ static void request_end(request_t* r, int error, const char* errmsg)
 {
 	session_t* s = r->session;
 
+#ifndef WIN32
+	/* a worker thread must not be working on this request any more */
+	if (opt.worker_threads)
+		request_wait_prepare(r);
+#endif
+
 #ifdef GPFXDIST
 	if (r->trans.errfile)
 	{
@@ -1295,7 +1389,11 @@ static void request_end(request_t* r, int error, const char* errmsg)
 	gprintlnif(r, "request end");
 
 	/* If we still have a block outstanding, the session is corrupted. */
-	if (r->outblock.top != r->outblock.bot)
+	if (r->outblock.top != r->outblock.bot
+#ifndef WIN32
+		|| r->prepare.block.top != r->prepare.block.bot
+#endif
+		)
 	{
 		gwarning(r, "request failure resulting in session failure: top = %d, bot = %d", r->outblock.top, r->outblock.bot);
 		if (s)
@@ -1675,6 +1773,11 @@ static void session_end(session_t* session, int error, const char *errmsg)
 {
 	gprintln(NULL, "session end. id = %ld, is_error = %d, error = %d", session->id, session->is_error, error);
 
+#ifndef WIN32
+	/* a worker thread may be reading from fstream */
+	pthread_mutex_lock(&session->lock);
+#endif
+
 	if (error) 
 	{
 		session->is_error = error;
@@ -1687,6 +1790,10 @@ static void session_end(session_t* session, int error, const char *errmsg)
 		fstream_close(session->fstream);
 		session->fstream = 0;
 	}
+
+#ifndef WIN32
+	pthread_mutex_unlock(&session->lock);
+#endif
 }
 
 /* finish the session - close the file */
@@ -1714,6 +1821,9 @@ static void session_free(session_t* session)
 
 	event_del(&session->ev);
 
+#ifndef WIN32
+	pthread_mutex_destroy(&session->lock);
+#endif
 	apr_hash_set(gcb.session.tab, session->key, APR_HASH_KEY_STRING, 0);
 	apr_pool_destroy(session->pool);
 }
@@ -1989,6 +2099,9 @@ static int session_attach(request_t* r)
 		session->maxsegs = r->totalsegs;
 		session->requests = apr_hash_make(pool);
 		event_set(&session->ev, 0, 0, 0, 0);
+#ifndef WIN32
+		pthread_mutex_init(&session->lock, NULL);
+#endif
 
 		if (session->tid == 0 || session->path == 0 || session->key == 0)
 			gfatal(r, "out of memory in session_attach");
@@ -2148,6 +2261,14 @@ static void do_write(int fd, short event, void* arg)
 		gfatal(r, "internal error - non matching fd (%d) "
 					  "and socket (%d)", fd, r->sock);
 
+#ifndef WIN32
+	if (opt.worker_threads)
+	{
+		do_write_prepared(r);
+		return;
+	}
+#endif
+
 #ifdef USE_ZSTD
 	/* 
 	 * It is essential to recycle threads before we read file.
@@ -2262,6 +2383,402 @@ static void do_write(int fd, short event, void* arg)
 		request_end(r, ERROR_CODE_GENERIC, 0);
 }
 
+#ifndef WIN32
+/*
+ * do_write_prepared
+ *
+ * do_write() for --worker_threads: send out the blocks that the worker
+ * threads prepared for this request. When the next block isn't ready yet,
+ * we stop watching the socket; worker_notify_cb() calls us again once the
+ * block is ready.
+ */
+static void do_write_prepared(request_t* r)
+{
+	block_t*	datablock = &r->outblock;
+	int 		n, i;
+
+	/* Loop at most 3 blocks or until we choke on the socket */
+	for (i = 0; i < 3; i++)
+	{
+		/* take the next block once this one is all sent */
+		if (datablock->top == datablock->bot)
+		{
+			block_t tmp;
+
+			if (!request_take_prepared(r))
+			{
+				/* only the event loop moves a request out of PREPARE_IDLE */
+				if (r->prepare.state == PREPARE_IDLE)
+					request_prepare_next(r);
+				event_del(&r->ev);
+				return;
+			}
+
+			if (r->prepare.ferror)
+			{
+				const char* ferror = r->prepare.ferror;
+
+				gwarning(NULL, "do_write_prepared end session due to %s", ferror);
+				session_end(r->session, ERROR_CODE_GENERIC, ferror);
+				request_end(r, ERROR_CODE_GENERIC, ferror);
+				gfile_printf_then_putc_newline("ERROR: %s", ferror);
+				return;
+			}
+#ifdef USE_ZSTD
+			if (r->prepare.zstd_failed)
+			{
+				request_end(r, ERROR_CODE_GENERIC, r->zstd_error);
+				return;
+			}
+#endif
+			if (r->prepare.eof)
+			{
+				gprintln(NULL, "do_write_prepared: end session due to EOF");
+				session_end(r->session, ERROR_CODE_SUCCESS, NULL);
+				request_end(r, ERROR_CODE_SUCCESS, 0);
+				return;
+			}
+
+			tmp = r->outblock;
+			r->outblock = r->prepare.block;
+			r->prepare.block = tmp;
+			r->prepare.block.bot = r->prepare.block.top = 0;
+
+			/* read the block after this one while this one is sent */
+			request_prepare_next(r);
+		}
+
+		/*
+		 * If PROTO-1: first write out the block header (metadata).
+		 */
+		int left_hbytes = send_proto_head(r);
+		if (left_hbytes < 0)
+			return;
+		else if (left_hbytes > 0)
+			break;
+
+#ifdef USE_ZSTD
+		if (r->zstd)
+			n = local_send(r, datablock->cdata + datablock->cbot, datablock->ctop - datablock->cbot);
+		else
+#endif
+			n = local_send(r, datablock->data + datablock->bot, datablock->top - datablock->bot);
+
+		if (n < 0)
+		{
+			/* see do_write() */
+			if (errno == EPIPE || errno == ECONNRESET)
+			{
+				r->outblock.bot = r->outblock.top;
+				request_wait_prepare(r);
+				r->prepare.block.bot = r->prepare.block.top;
+			}
+			request_end(r, ERROR_CODE_GENERIC, "gpfdist send data failure");
+			return;
+		}
+
+		r->last = apr_time_now();
+
+#ifdef USE_ZSTD
+		if (r->zstd)
+		{
+			gdebug(r, "send compressed bytes off buf %d .. %d (top %d)",
+				   datablock->cbot, datablock->cbot + n, datablock->ctop);
+
+			datablock->cbot += n;
+			if (datablock->cbot != datablock->ctop)
+			{ /* network chocked */
+				gdebug(r, "network full");
+				break;
+			}
+			r->bytes += datablock->top - datablock->bot;
+			datablock->bot = datablock->top;
+			continue;
+		}
+#endif
+
+		gdebug(r, "send data bytes off buf %d .. %d (top %d)",
+			   datablock->bot, datablock->bot + n, datablock->top);
+
+		r->bytes += n;
+		datablock->bot += n;
+
+		if (datablock->top != datablock->bot)
+		{ /* network chocked */
+			gdebug(r, "network full");
+			break;
+		}
+	}
+
+	/* Set up for this routine to be called again */
+	if (setup_write(r))
+		request_end(r, ERROR_CODE_GENERIC, 0);
+}
+
+/*
+ * Start the worker threads, and watch the pipe they wake up the event loop
+ * with.
+ */
+static void workers_start(void)
+{
+	int i;
+
+	pthread_mutex_init(&workers.lock, NULL);
+	pthread_cond_init(&workers.queued, NULL);
+	pthread_cond_init(&workers.done, NULL);
+
+	if (pipe(workers.notify_pipe) < 0)
+		gfatal(NULL, "failed to create the pipe of the worker threads: %s", strerror(errno));
+	if (fcntl(workers.notify_pipe[0], F_SETFL, O_NONBLOCK) < 0 ||
+		fcntl(workers.notify_pipe[1], F_SETFL, O_NONBLOCK) < 0)
+		gfatal(NULL, "failed to set up the pipe of the worker threads: %s", strerror(errno));
+
+	event_set(&workers.notify_event, workers.notify_pipe[0], EV_READ | EV_PERSIST,
+			  worker_notify_cb, NULL);
+	if (event_add(&workers.notify_event, NULL))
+		gfatal(NULL, "failed to watch the pipe of the worker threads");
+
+	for (i = 0; i < opt.worker_threads; i++)
+	{
+		pthread_t	thread;
+		int			err = pthread_create(&thread, 0, worker_main, NULL);
+
+		if (err)
+			gfatal(NULL, "pthread_create failed with error code %d", err);
+		pthread_detach(thread);
+		workers.nthreads++;
+	}
+
+	gprintln(NULL, "started %d worker threads", workers.nthreads);
+}
+
+static void* worker_main(void* arg)
+{
+	for (;;)
+	{
+		request_t*	r;
+		char		c = 0;
+
+		pthread_mutex_lock(&workers.lock);
+		while (!workers.queue_head)
+			pthread_cond_wait(&workers.queued, &workers.lock);
+		r = workers.queue_head;
+		workers.queue_head = r->prepare.next;
+		if (!workers.queue_head)
+			workers.queue_tail = NULL;
+		r->prepare.state = PREPARE_RUNNING;
+		pthread_mutex_unlock(&workers.lock);
+
+		worker_prepare_block(r);
+
+		pthread_mutex_lock(&workers.lock);
+		r->prepare.state = PREPARE_DONE;
+		r->prepare.next = workers.done_head;
+		workers.done_head = r;
+		pthread_cond_broadcast(&workers.done);
+		pthread_mutex_unlock(&workers.lock);
+
+		/* if the pipe is full, the event loop has a wakeup pending already */
+		if (write(workers.notify_pipe[1], &c, 1) < 0 && errno != EAGAIN)
+			gwarning(NULL, "failed to wake up the event loop: %s", strerror(errno));
+	}
+
+	return NULL;
+}
+
+/*
+ * worker_prepare_block
+ *
+ * Fill in the next block of a request, in a worker thread. This is
+ * session_get_block() and the compression of do_write(), except that the
+ * session is ended by the event loop, in do_write_prepared().
+ */
+static void worker_prepare_block(request_t* r)
+{
+	session_t*	session = r->session;
+	block_t*	b = &r->prepare.block;
+	const int 	whole_rows = 1; /* gpfdist must not read data with partial rows */
+	struct fstream_filename_and_offset fos;
+	apr_int64_t	position;
+	int 		size;
+
+	b->bot = b->top = b->cbot = b->ctop = 0;
+	b->hdr.hbot = b->hdr.htop = 0;
+	r->prepare.eof = 0;
+	r->prepare.ferror = NULL;
+	r->prepare.zstd_failed = 0;
+	r->prepare.read_bytes = 0;
+
+	pthread_mutex_lock(&session->lock);
+
+	if (session->is_error || 0 == session->fstream)
+	{
+		pthread_mutex_unlock(&session->lock);
+		r->prepare.eof = 1;
+		return;
+	}
+
+	/* read data from our filestream as a chunk with whole data rows */
+	position = fstream_get_compressed_position(session->fstream);
+	size = fstream_read(session->fstream, b->data, opt.m, &fos, whole_rows, r->line_delim_str, r->line_delim_length);
+	delay_watchdog_timer();
+
+	if (size == 0)
+	{
+		r->prepare.read_bytes = fstream_get_compressed_size(session->fstream) - position;
+		r->prepare.eof = 1;
+	}
+	else
+	{
+		r->prepare.read_bytes = fstream_get_compressed_position(session->fstream) - position;
+		if (size < 0)
+			r->prepare.ferror = fstream_get_error(session->fstream);
+		else
+		{
+			b->top = size;
+			/* fos points into fstream, which the event loop may close once we unlock */
+			block_fill_header(r, b, &fos);
+		}
+	}
+
+	pthread_mutex_unlock(&session->lock);
+
+#ifdef USE_ZSTD
+	if (size > 0 && r->zstd)
+	{
+		int res = compress_zstd(r, b, size);
+
+		if (res < 0)
+			r->prepare.zstd_failed = 1;
+		else
+			b->ctop = res;
+	}
+#endif
+}
+
+/*
+ * Called by the event loop when worker threads are done with some requests.
+ */
+static void worker_notify_cb(int fd, short event, void* arg)
+{
+	char		buf[256];
+	request_t*	done;
+
+	while (read(fd, buf, sizeof(buf)) > 0)
+		;
+
+	pthread_mutex_lock(&workers.lock);
+	done = workers.done_head;
+	workers.done_head = NULL;
+	pthread_mutex_unlock(&workers.lock);
+
+	while (done)
+	{
+		request_t* r = done;
+
+		done = r->prepare.next;
+		r->prepare.next = NULL;
+		if (r->prepare.state == PREPARE_DONE)
+			do_write_prepared(r);
+	}
+}
+
+/*
+ * Queue a request for a worker thread to prepare its next block.
+ */
+static void request_prepare_next(request_t* r)
+{
+	pthread_mutex_lock(&workers.lock);
+	r->prepare.state = PREPARE_QUEUED;
+	r->prepare.next = NULL;
+	if (workers.queue_tail)
+		workers.queue_tail->prepare.next = r;
+	else
+		workers.queue_head = r;
+	workers.queue_tail = r;
+	pthread_cond_signal(&workers.queued);
+	pthread_mutex_unlock(&workers.lock);
+}
+
+/* remove a request from the done list of the workers, if it's there */
+static void workers_unlink_done(request_t* r)
+{
+	request_t** p;
+
+	for (p = &workers.done_head; *p; p = &(*p)->prepare.next)
+	{
+		if (*p == r)
+		{
+			*p = r->prepare.next;
+			break;
+		}
+	}
+	r->prepare.next = NULL;
+}
+
+/*
+ * If a worker thread is done with the next block of a request, take it.
+ * Returns 0 if the block isn't ready.
+ */
+static int request_take_prepared(request_t* r)
+{
+	int ready;
+
+	pthread_mutex_lock(&workers.lock);
+	ready = (r->prepare.state == PREPARE_DONE);
+	if (ready)
+	{
+		workers_unlink_done(r);
+		r->prepare.state = PREPARE_IDLE;
+	}
+	pthread_mutex_unlock(&workers.lock);
+
+	if (ready)
+		gcb.read_bytes += r->prepare.read_bytes;
+	return ready;
+}
+
+/*
+ * Make sure that no worker thread is working on a request, before it ends.
+ * A block that a worker already prepared is left in r->prepare.block.
+ */
+static void request_wait_prepare(request_t* r)
+{
+	request_t**	p;
+
+	pthread_mutex_lock(&workers.lock);
+
+	if (r->prepare.state == PREPARE_QUEUED)
+	{
+		for (p = &workers.queue_head; *p; p = &(*p)->prepare.next)
+		{
+			if (*p == r)
+			{
+				*p = r->prepare.next;
+				break;
+			}
+		}
+		workers.queue_tail = NULL;
+		for (p = &workers.queue_head; *p; p = &(*p)->prepare.next)
+			workers.queue_tail = *p;
+		r->prepare.next = NULL;
+		r->prepare.state = PREPARE_IDLE;
+	}
+
+	while (r->prepare.state == PREPARE_RUNNING)
+		pthread_cond_wait(&workers.done, &workers.lock);
+
+	if (r->prepare.state == PREPARE_DONE)
+	{
+		workers_unlink_done(r);
+		r->prepare.state = PREPARE_IDLE;
+		gcb.read_bytes += r->prepare.read_bytes;
+	}
+
+	pthread_mutex_unlock(&workers.lock);
+}
+#endif
+
 /*
  * Log request header
  */
@@ -2590,6 +3107,10 @@ static void do_accept(int fd, short event, void* arg)
 
 	/* use the block size specified by -m option */
 	r->outblock.data = palloc_safe(r, pool, opt.m, "out of memory when allocating buffer: %d bytes", opt.m);
+#ifndef WIN32
+	if (opt.worker_threads)
+		r->prepare.block.data = palloc_safe(r, pool, opt.m, "out of memory when allocating buffer: %d bytes", opt.m);
+#endif
 
 	r->line_delim_str = "";
 	r->line_delim_length = -1;
@@ -3907,6 +4428,10 @@ static int request_parse_gp_headers(request_t *r, int opt_g)
 	{
 		OUT_BUFFER_SIZE = ZSTD_CStreamOutSize();
 		r->outblock.cdata = palloc_safe(r, r->pool, opt.m, "out of memory when allocating buffer for compressed data: %d bytes", opt.m);
+#ifndef WIN32
+		if (opt.worker_threads)
+			r->prepare.block.cdata = palloc_safe(r, r->pool, opt.m, "out of memory when allocating buffer for compressed data: %d bytes", opt.m);
+#endif
 		r->is_running = 0;
 		r->thread_id = 0;
 		if (r->is_get)
@@ -4164,6 +4689,11 @@ int gpfdist_init(int argc, const char* const argv[])
     signal_register();
 	http_setup();
 
+#ifndef WIN32
+	if (opt.worker_threads)
+		workers_start();
+#endif
+
 #ifdef USE_SSL
 	if (opt.ssl)
 		printf("Serving HTTPS on port %d, directory %s\n", opt.p, opt.d);
@@ -5195,7 +5725,7 @@ static int compress_zstd(const request_t *r, block_t *blk, int buflen)
 		cursor += in_size;
 	}
 
-	ZSTD_outBuffer output = { r->outblock.cdata + offset, OUT_BUFFER_SIZE, 0 };
+	ZSTD_outBuffer output = { blk->cdata + offset, OUT_BUFFER_SIZE, 0 };
 	size_t const remainingToFlush = ZSTD_endStream(r->zstd_cctx, &output);   /* close frame */
 	if (remainingToFlush)
 	{
@@ -0,0 +1,197 @@
+/*------------------------------------------------------------------------------
+ *
+ * appendonly_zonemap.h
+ *   Per-block min/max synopses ("zone maps") of append-optimized tables.
+ *
+ * Portions Copyright (c) 2012-Present VMware, Inc. or its affiliates.
+ *
+ *
+ * IDENTIFICATION
+ *	    src/include/access/appendonly_zonemap.h
+ *
+ *------------------------------------------------------------------------------
+ */
+#ifndef APPENDONLY_ZONEMAP_H
+#define APPENDONLY_ZONEMAP_H
+
+#include "access/attnum.h"
+#include "access/stratnum.h"
+#include "access/tupdesc.h"
+#include "nodes/pg_list.h"
+#include "utils/relcache.h"
+#include "utils/snapshot.h"
+
+extern bool gp_appendonly_zone_maps;
+
+/*
+ * Synopsis of the values of one column in one varblock.
+ *
+ * All the supported types are fixed-width integers, or have an integer
+ * representation that sorts the same way (date, time, timestamp), so the
+ * bounds are kept as signed 64-bit integers.
+ */
+typedef struct AOZoneMapEntry
+{
+	int64		minValue;
+	int64		maxValue;
+	int32		nullCount;
+	int16		attnum;			/* column summarized, 1-based */
+	uint16		flags;
+} AOZoneMapEntry;
+
+/* The synopsis was recorded for every row of the block */
+#define AOZONEMAP_VALID			0x0001
+/* minValue and maxValue are set, i.e. not all the rows are NULL */
+#define AOZONEMAP_HASVALUES		0x0002
+
+/*
+ * Varlena stored in the "zonemap" column of the block directory, next to the
+ * minipage. Entry i of the minipage is summarized by the nAtts synopses
+ * starting at entry[i * nAtts].
+ */
+typedef struct AOZoneMap
+{
+	/* Total length. Must be the first. */
+	int32		_len;
+	int32		version;
+	uint32		nEntry;
+	uint32		nAtts;
+
+	AOZoneMapEntry entry[FLEXIBLE_ARRAY_MEMBER];
+} AOZoneMap;
+
+#define AOZONEMAP_VERSION 1
+
+/*
+ * Number of columns of an AO row table that get a synopsis; each entry of a
+ * column-oriented table's minipage only summarizes its own column.
+ */
+#define AOZONEMAP_MAX_ROW_ATTS 4
+
+static inline uint32
+AOZoneMapSize(uint32 nEntry, uint32 nAtts)
+{
+	return offsetof(AOZoneMap, entry) + sizeof(AOZoneMapEntry) * nEntry * nAtts;
+}
+
+static inline void
+AOZoneMapEntry_Init(AOZoneMapEntry *entry, AttrNumber attnum)
+{
+	entry->minValue = 0;
+	entry->maxValue = 0;
+	entry->nullCount = 0;
+	entry->attnum = attnum;
+	entry->flags = AOZONEMAP_VALID;
+}
+
+static inline void
+AOZoneMapEntry_AddNull(AOZoneMapEntry *entry)
+{
+	entry->nullCount++;
+}
+
+static inline void
+AOZoneMapEntry_AddValue(AOZoneMapEntry *entry, int64 value)
+{
+	if ((entry->flags & AOZONEMAP_HASVALUES) == 0)
+	{
+		entry->minValue = entry->maxValue = value;
+		entry->flags |= AOZONEMAP_HASVALUES;
+	}
+	else if (value < entry->minValue)
+		entry->minValue = value;
+	else if (value > entry->maxValue)
+		entry->maxValue = value;
+}
+
+/*
+ * Value of a datum of one of the supported types, given its length.
+ */
+static inline int64
+AOZoneMap_DatumGetValue(Datum d, int16 typlen)
+{
+	switch (typlen)
+	{
+		case sizeof(int16):
+			return DatumGetInt16(d);
+		case sizeof(int32):
+			return DatumGetInt32(d);
+		default:
+			Assert(typlen == sizeof(int64));
+			return DatumGetInt64(d);
+	}
+}
+
+static inline void
+AOZoneMapEntry_AddDatum(AOZoneMapEntry *entry, Datum d, bool isnull, int16 typlen)
+{
+	if (isnull)
+		AOZoneMapEntry_AddNull(entry);
+	else
+		AOZoneMapEntry_AddValue(entry, AOZoneMap_DatumGetValue(d, typlen));
+}
+
+/*
+ * A restriction of the scan qual that a zone map can refute: "attnum op
+ * value" for a btree strategy, or "attnum IS [NOT] NULL" when strategy is
+ * InvalidStrategy.
+ */
+typedef struct AOZoneMapKey
+{
+	AttrNumber	attnum;
+	StrategyNumber strategy;
+	bool		isnull;			/* IS NULL, rather than IS NOT NULL */
+	int64		value;
+} AOZoneMapKey;
+
+/* Row range [firstRowNum, endRowNum) in which no row satisfies a key */
+typedef struct AOZoneMapRange
+{
+	int64		firstRowNum;
+	int64		endRowNum;
+} AOZoneMapRange;
+
+typedef struct AOZoneMapKeyRanges
+{
+	AOZoneMapRange *ranges;
+	int			nranges;
+	int			maxranges;
+	int			cur;			/* first range not yet passed by the scan */
+} AOZoneMapKeyRanges;
+
+/*
+ * State of a sequential scan that skips the blocks that the zone maps prove
+ * to have no rows satisfying the qual.
+ */
+typedef struct AOZoneMapScanData
+{
+	Relation	aoRel;
+	Snapshot	appendOnlyMetaDataSnapshot;
+	bool		isAOCol;
+	Relation	blkdirRel;
+	Relation	blkdirIdx;
+
+	int			nkeys;
+	AOZoneMapKey *keys;
+	AOZoneMapKeyRanges *keyRanges;	/* for the current segment file */
+
+	/* Reset for every segment file */
+	MemoryContext segmentContext;
+} AOZoneMapScanData;
+
+typedef AOZoneMapScanData *AOZoneMapScan;
+
+extern bool AOZoneMap_TypeIsSupported(Oid typid);
+extern int	AOZoneMap_SummarizedAtts(TupleDesc tupdesc, AttrNumber *attnums);
+extern bool AOZoneMapEntry_Excludes(const AOZoneMapEntry *entry,
+									const AOZoneMapKey *key);
+
+extern AOZoneMapScan AOZoneMapScan_Begin(Relation aoRel,
+										 Snapshot appendOnlyMetaDataSnapshot,
+										 List *qual);
+extern void AOZoneMapScan_BeginSegment(AOZoneMapScan zms, int segno);
+extern int64 AOZoneMapScan_SkipTo(AOZoneMapScan zms, int64 rowNum);
+extern int64 AOZoneMapScan_NextExcluded(AOZoneMapScan zms, int64 rowNum);
+extern void AOZoneMapScan_End(AOZoneMapScan zms);
+
+#endif							/* APPENDONLY_ZONEMAP_H */
@@ -45,6 +45,13 @@ typedef struct TableScanDescData
 	struct ParallelTableScanDescData *rs_parallel;	/* parallel scan
 													 * information */
 
+	/*
+	 * GPDB: number of blocks that were skipped without being read, because
+	 * the AM could tell that none of their tuples satisfy the scan's qual
+	 * (e.g. with the zone maps of append-optimized tables).
+	 */
+	uint64		rs_nblocks_skipped;
+
 } TableScanDescData;
 typedef struct TableScanDescData *TableScanDesc;
 
@@ -237,7 +237,7 @@ typedef struct TableAmRoutine
 	/*
 	 * GPDB: Extract columns for scan from either a projection array
 	 * or a targetlist and quals. This is currently used for AOCO
-	 * tables.
+	 * tables, and for the zone maps of AO tables.
 	 */
 	TableScanDesc	(*scan_begin_extractcolumns) (Relation rel,
 												  Snapshot snapshot,
@@ -871,7 +871,8 @@ table_beginscan(Relation rel, Snapshot snapshot,
 /*
  * GPDB: Like table_beginscan(), but first attempt to create a
  * scan key array from the targetList and the quals if the corresponding method
- * is implemented. This is an optimization needed for AOCO relations.
+ * is implemented. This is an optimization needed for AOCO relations, and
+ * lets AO relations skip blocks using the quals.
  * Otherwise, it is equivalent as passing the last two arguments as, 0, NULL.
  */
 static inline TableScanDesc
@@ -18,12 +18,16 @@
 /*
  * Macros to the attribute number for each attribute
  * in the block directory relation.
+ *
+ * Block directories created before zone maps were introduced don't have the
+ * zonemap attribute.
  */
-#define Natts_pg_aoblkdir              4
+#define Natts_pg_aoblkdir              5
 #define Anum_pg_aoblkdir_segno         1
 #define Anum_pg_aoblkdir_columngroupno 2
 #define Anum_pg_aoblkdir_firstrownum   3
 #define Anum_pg_aoblkdir_minipage      4
+#define Anum_pg_aoblkdir_zonemap       5
 
 extern void AlterTableCreateAoBlkdirTable(Oid relOid);
 
@@ -166,6 +166,54 @@ typedef struct AOCSFetchDescData
 
 typedef AOCSFetchDescData *AOCSFetchDesc;
 
+/*
+ * Number of rows read at a time by a plain sequential scan of an AOCS
+ * relation.
+ */
+#define AOCS_SCAN_BATCH_SIZE 1024
+
+/*
+ * A batch of rows read by aocs_getnext_batch(), stored column by column.
+ *
+ * The column vectors of a batch are decoded from a single varblock of each
+ * column, so pass-by-reference values point into the varblock buffers, and
+ * stay valid only until the next batch is read. Quals can be evaluated on the
+ * column vectors (see aocs_batch_filter()), narrowing down the selection
+ * vector before any tuple is formed.
+ */
+typedef struct AOCSBatchData
+{
+	/* descriptor of the tuples returned, used for missing values */
+	TupleDesc	tupdesc;
+
+	int			maxrows;		/* capacity of the vectors */
+	int			nrows;			/* number of rows in the batch */
+
+	/*
+	 * Column vectors, indexed by zero-based attribute number. Only allocated
+	 * for the projected columns, NULL for the others.
+	 */
+	int			natts;
+	Datum	  **values;
+	bool	  **isnull;
+	bool	   *hasnull;		/* does the column vector contain NULLs? */
+
+	/* TID of each row */
+	AOTupleId  *tids;
+
+	/*
+	 * Selection vector: indexes of the rows that are visible and have passed
+	 * the quals evaluated so far, in ascending order.
+	 */
+	int		   *sel;
+	int			nsel;
+
+	/* next entry of sel[] to be returned by aocs_batch_getnext() */
+	int			nextsel;
+} AOCSBatchData;
+
+typedef AOCSBatchData *AOCSBatch;
+
 /*
  * Used for scan of appendoptimized column oriented relations, should be used in
  * the tableam api related code and under it.
@@ -305,6 +353,15 @@ typedef struct AOCSScanDescData
 	 * CO table, starting at a certain logical heap block and ending in another.
 	 */
 	bool 		partialScan;
+
+	/* Batch of rows being returned by a plain sequential scan */
+	AOCSBatch	batch;
+
+	/*
+	 * Skips the varblocks that can't have rows satisfying the scan's qual,
+	 * according to the zone maps. NULL if there are none to use.
+	 */
+	AOZoneMapScan zoneMapScan;
 } AOCSScanDescData;
 
 typedef AOCSScanDescData *AOCSScanDesc;
@@ -427,6 +484,11 @@ extern void aocs_rescan(AOCSScanDesc scan);
 extern void aocs_endscan(AOCSScanDesc scan);
 
 extern bool aocs_getnext(AOCSScanDesc scan, ScanDirection direction, TupleTableSlot *slot);
+extern AOCSBatch aocs_begin_batch(AOCSScanDesc scan, TupleDesc tupdesc, int maxrows);
+extern bool aocs_getnext_batch(AOCSScanDesc scan, AOCSBatch batch);
+extern void aocs_batch_filter(AOCSBatch batch, int nkeys, ScanKey keys);
+extern bool aocs_batch_getnext(AOCSScanDesc scan, AOCSBatch batch, TupleTableSlot *slot);
+extern void aocs_end_batch(AOCSBatch batch);
 extern AOCSInsertDesc aocs_insert_init(Relation rel, int segno, int64 num_rows);
 extern void aocs_insert_values(AOCSInsertDesc idesc, Datum *d, bool *null, AOTupleId *aoTupleId);
 static inline void aocs_insert(AOCSInsertDesc idesc, TupleTableSlot *slot)
@@ -122,6 +122,15 @@ typedef struct AppendOnlyInsertDescData
 	/* The block directory for the appendonly relation. */
 	AppendOnlyBlockDirectory blockDirectory;
 	Oid segrelid;
+
+	/*
+	 * Synopses of the current varblock's values, recorded in the zone map of
+	 * the block directory (if it has one).
+	 */
+	int				zonemapNAtts;
+	AttrNumber		zonemapAtts[AOZONEMAP_MAX_ROW_ATTS];
+	int16			zonemapTypLens[AOZONEMAP_MAX_ROW_ATTS];
+	AOZoneMapEntry	zonemap[AOZONEMAP_MAX_ROW_ATTS];
 } AppendOnlyInsertDescData;
 
 typedef AppendOnlyInsertDescData *AppendOnlyInsertDesc;
@@ -216,6 +225,12 @@ typedef struct AppendOnlyScanDescData
 	/* current scan state */
 	bool		needNextBuffer;
 
+	/*
+	 * The scan is positioned on a varblock by appendonly_getnextblock(), and
+	 * the varblock's content wasn't read yet.
+	 */
+	bool		needBlockContents;
+
 	bool	initedStorageRoutines;
 
 	AppendOnlyStorageAttributes	storageAttributes;
@@ -272,6 +287,12 @@ typedef struct AppendOnlyScanDescData
 
 	AOBlkDirScan		blkdirscan;
 
+	/*
+	 * Skips the varblocks that can't have rows satisfying the scan's qual,
+	 * according to the zone maps. NULL if there are none to use.
+	 */
+	AOZoneMapScan		zoneMapScan;
+
 	/* For Bitmap scan */
 	int			rs_cindex;		/* current tuple's index in tbmres->offsets */
 	struct AppendOnlyFetchDescData *aofetch;
@@ -480,6 +501,13 @@ extern TableScanDesc appendonly_beginscan(Relation relation,
 										  int nkeys, struct ScanKeyData *key,
 										  ParallelTableScanDesc pscan,
 										  uint32 flags);
+extern TableScanDesc appendonly_beginscan_extractcolumns(Relation rel,
+														 Snapshot snapshot,
+														 List *targetlist,
+														 List *qual,
+														 bool *proj,
+														 List *constraintList,
+														 uint32 flags);
 extern void appendonly_rescan(TableScanDesc scan, ScanKey key,
 								bool set_params, bool allow_strat,
 								bool allow_sync, bool allow_pagemode);
@@ -490,6 +518,9 @@ extern bool appendonly_getnextslot(TableScanDesc scan,
 extern bool appendonly_get_target_tuple(AppendOnlyScanDesc aoscan,
 										int64 targrow,
 										TupleTableSlot *slot);
+extern bool appendonly_getnextblock(AppendOnlyScanDesc scan);
+extern bool appendonly_getnextblockslot(AppendOnlyScanDesc scan,
+										TupleTableSlot *slot);
 extern AppendOnlyFetchDesc appendonly_fetch_init(
 	Relation 	relation,
 	Snapshot    snapshot,
@@ -513,6 +544,9 @@ extern void appendonly_insert(
 		AppendOnlyInsertDesc aoInsertDesc, 
 		MemTuple instup, 
 		AOTupleId *aoTupleId);
+extern bool appendonly_insert_block(AppendOnlyInsertDesc aoInsertDesc,
+									AppendOnlyScanDesc scan,
+									int64 *firstRowNum);
 extern void appendonly_insert_finish(AppendOnlyInsertDesc aoInsertDesc);
 extern void appendonly_dml_finish(Relation relation);
 
@@ -16,6 +16,7 @@
 
 #include "access/aosegfiles.h"
 #include "access/aocssegfiles.h"
+#include "access/appendonly_zonemap.h"
 #include "access/appendonlytid.h"
 #include "access/skey.h"
 #include "catalog/indexing.h"
@@ -85,6 +86,12 @@ typedef struct MinipagePerColumnGroup
 	ItemPointerData tupleTid;
 	/* cached entry number from last call to find_minipage_entry() */
 	int cached_entry_no;
+
+	/*
+	 * Synopses of the minipage entries, if the block directory has zone maps
+	 * and is open for writing; NULL otherwise.
+	 */
+	AOZoneMap *zonemap;
 } MinipagePerColumnGroup;
 
 /*
@@ -112,6 +119,9 @@ typedef struct AppendOnlyBlockDirectory
 	int numColumnGroups;
 	bool isAOCol;
 
+	/* Does the block directory relation have the zonemap column? */
+	bool hasZoneMaps;
+
 	MemoryContext memoryContext;
 
 	int				totalSegfiles;
@@ -268,6 +278,14 @@ AppendOnlyBlockDirectory_InsertEntry(AppendOnlyBlockDirectory *blockDirectory,
 									 int64 firstRowNum,
 									 int64 fileOffset,
 									 int64 rowCount);
+extern bool
+AppendOnlyBlockDirectory_InsertEntryWithZoneMap(AppendOnlyBlockDirectory *blockDirectory,
+												int columnGroupNo,
+												int64 firstRowNum,
+												int64 fileOffset,
+												int64 rowCount,
+												const AOZoneMapEntry *synopses,
+												int nsynopses);
 extern void
 AppendOnlyBlockDirectory_DeleteSegmentFile(AppendOnlyBlockDirectory *blockDirectory,
 										   int columnGroupNo,
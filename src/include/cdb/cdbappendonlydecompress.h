@@ -0,0 +1,64 @@
+/*-------------------------------------------------------------------------
+ *
+ * cdbappendonlydecompress.h
+ *	  Decompress Append-Only Storage Blocks ahead of the scan, with helper
+ *	  threads.
+ *
+ * Portions Copyright (c) 2012-Present VMware, Inc. or its affiliates.
+ *
+ *
+ * IDENTIFICATION
+ *	    src/include/cdb/cdbappendonlydecompress.h
+ *
+ *-------------------------------------------------------------------------
+ */
+#ifndef CDBAPPENDONLYDECOMPRESS_H
+#define CDBAPPENDONLYDECOMPRESS_H
+
+struct AppendOnlyStorageRead;
+struct AppendOnlyDecompressAhead;
+
+extern int	gp_appendonly_decompress_workers;
+extern int	gp_appendonly_decompress_ahead_mem;
+
+/*
+ * Set up decompress-ahead for a read session.
+ *
+ * Returns NULL when decompress-ahead is disabled, when the compression type
+ * is not supported, or when there is no memory left in the budget of
+ * gp_appendonly_decompress_ahead_mem.
+ */
+extern struct AppendOnlyDecompressAhead *AppendOnlyDecompressAhead_Create(
+								 struct AppendOnlyStorageRead *storageRead);
+
+/*
+ * Forget the blocks decompressed so far, and start over at beginFileOffset
+ * in the current segment file.  Blocks at or after afterFileOffset are not
+ * decompressed ahead.
+ */
+extern void AppendOnlyDecompressAhead_Reset(
+								struct AppendOnlyDecompressAhead *decompressAhead,
+								int64 beginFileOffset,
+								int64 afterFileOffset);
+
+/*
+ * Copy out the decompressed content of the block at headerOffsetInFile.
+ *
+ * Returns false when the block was not decompressed ahead, in which case the
+ * caller decompresses it itself.
+ */
+extern bool AppendOnlyDecompressAhead_GetContent(
+								struct AppendOnlyDecompressAhead *decompressAhead,
+								int64 headerOffsetInFile,
+								int32 overallBlockLen,
+								int32 compressedLen,
+								uint8 *contentOut,
+								int32 contentOutLen);
+
+/*
+ * Finish with decompress-ahead, and release its memory.
+ */
+extern void AppendOnlyDecompressAhead_Finish(
+								struct AppendOnlyDecompressAhead *decompressAhead);
+
+#endif   /* CDBAPPENDONLYDECOMPRESS_H */
@@ -97,6 +97,12 @@ typedef struct AppendOnlyStorageReadCurrent
 	 * The compressed length of the content.
 	 */
 	int32		compressedLen;
+
+	/*
+	 * The whole block in the BufferedRead buffer, once the buffer was grown
+	 * to it.  NULL until then.
+	 */
+	uint8	   *blockBuffer;
 } AppendOnlyStorageReadCurrent;
 
 /*
@@ -189,6 +195,12 @@ typedef struct AppendOnlyStorageRead
 										 * pointers. The array index
 										 * corresponds to COMP_FUNC_*	*/
 
+	/*
+	 * Decompresses the following blocks on helper threads, or NULL.  See
+	 * cdbappendonlydecompress.c.
+	 */
+	struct AppendOnlyDecompressAhead *decompressAhead;
+
 } AppendOnlyStorageRead;
 
 extern void AppendOnlyStorageRead_Init(AppendOnlyStorageRead *storageRead,
@@ -222,6 +234,8 @@ extern int64 AppendOnlyStorageRead_CurrentHeaderOffsetInFile(AppendOnlyStorageRe
 extern int64 AppendOnlyStorageRead_CurrentCompressedLen(AppendOnlyStorageRead *storageRead);
 extern int64 AppendOnlyStorageRead_OverallBlockLen(AppendOnlyStorageRead *storageRead);
 extern uint8 *AppendOnlyStorageRead_GetBuffer(AppendOnlyStorageRead *storageRead);
+extern uint8 *AppendOnlyStorageRead_GetRawContent(AppendOnlyStorageRead *storageRead,
+												  int32 *rawContentLen);
 extern void AppendOnlyStorageRead_Content(AppendOnlyStorageRead *storageRead,
 							  uint8 *contentOut, int32 contentLen);
 extern void AppendOnlyStorageRead_SkipCurrentBlock(AppendOnlyStorageRead *storageRead);
@@ -220,6 +220,13 @@ extern void AppendOnlyStorageWrite_FinishBuffer(
 									int rowCount);
 
 extern void AppendOnlyStorageWrite_CancelLastBuffer(AppendOnlyStorageWrite *storageWrite);
+extern bool AppendOnlyStorageWrite_RawContent(AppendOnlyStorageWrite *storageWrite,
+											 uint8 *content,
+											 uint8 *uncompressedContent,
+											 int32 uncompressedLen,
+											 int32 compressedLen,
+											 int executorBlockKind,
+											 int rowCount);
 
 extern void AppendOnlyStorageWrite_Content(AppendOnlyStorageWrite *storageWrite,
 							   uint8 *content,
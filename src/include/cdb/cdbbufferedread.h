@@ -73,6 +73,17 @@ typedef struct BufferedRead
 	/* current read position */
 	off_t				 fileOff;
 
+	/*
+	 * Read-ahead support.
+	 */
+	int64				prefetchStart;
+	int64				prefetchPosition;
+							/*
+							 * The range of the current file that has been
+							 * handed to the kernel with FilePrefetch() ahead
+							 * of the large reads.
+							 */
+
 	/*
 	 * Temporary limit support for random reading.
 	 */
@@ -173,6 +184,15 @@ uint8 *BufferedReadGetCurrentBuffer(
 int64 BufferedReadCurrentPosition(
     BufferedRead       *bufferedRead);
 
+/*
+ * Return the address of the len bytes at position in the current file, if
+ * they are all in the current large read, or NULL otherwise.
+ */
+uint8 *BufferedReadPeek(
+    BufferedRead       *bufferedRead,
+    int64              position,
+    int32              len);
+
 /*
  * Finishes the current file for reading.  Caller is resposible for closing
  * the file afterwards.
@@ -16,6 +16,19 @@
 #ifndef CDBCONN_H
 #define CDBCONN_H
 
+#include "cdb/cdbvars.h"		/* MAX_CACHED_DISPATCH_PLANS */
+#include "common/sha2.h"
+
+
+/*
+ * A serialized plan in the dispatch plan cache of a QE is identified by its
+ * SHA-256 digest and its length; both have to match for the QE to reuse it.
+ */
+typedef struct CachedDispatchPlan
+{
+	uint8		digest[PG_SHA256_DIGEST_LENGTH];
+	int			len;			/* 0 if the slot is empty */
+} CachedDispatchPlan;
 
 /* --------------------------------------------------------------------------------------------------
  * Structure for segment database definition and working values
@@ -55,6 +68,13 @@ typedef struct SegmentDatabaseDescriptor
 	int						identifier;		/* unique identifier in the cdbcomponent segment pool */
 	double					establishConnTime; /* the time of establish connection to the segment,
 												* -1 means this connection is cached */
+
+	/*
+	 * The serialized plans the QE at the other end of the connection holds
+	 * in its dispatch plan cache, by cache slot; a len of 0 means the slot
+	 * is empty, or that we're not sure what it holds.
+	 */
+	CachedDispatchPlan		cachedPlans[MAX_CACHED_DISPATCH_PLANS];
 } SegmentDatabaseDescriptor;
 
 SegmentDatabaseDescriptor *
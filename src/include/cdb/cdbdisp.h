@@ -17,6 +17,7 @@
 #define CDBDISP_H
 
 #include "cdb/cdbtm.h"
+#include "common/sha2.h"
 #include "utils/resowner.h"
 
 #define CDB_MOTION_LOST_CONTACT_STRING "Interconnect error coordinator lost contact with segment."
@@ -51,6 +52,30 @@ typedef struct CdbDispatcherState
 	bool isGangDestroying;
 #endif
 	bool destroyIdleReaderGang;
+
+	/*
+	 * The dispatched plan, identified by its SHA-256 digest and length, if
+	 * the QEs are to keep it in cache slot planCacheSlot of their dispatch
+	 * plan cache. planCacheSlot is -1 if the plan is not cached.
+	 *
+	 * QEs that already hold the plan get a variant of the query text that
+	 * leaves the plan tree out. buildCachedPlanQueryText builds it the first
+	 * time it is needed, see cdbdisp_getCachedPlanQueryText().
+	 */
+	int planCacheSlot;
+	uint8 planDigest[PG_SHA256_DIGEST_LENGTH];
+	int planLen;
+	char *cachedPlanQueryText;
+	int cachedPlanQueryTextLen;
+	char *(*buildCachedPlanQueryText) (void *arg, int *len);
+	void *buildCachedPlanQueryTextArg;
+
+	/*
+	 * Work to do while waiting for the connections of new gangs, see
+	 * cdbgang_connectWait(). It is cleared once it has been called.
+	 */
+	void (*connectWaitCallback) (void *arg);
+	void *connectWaitArg;
 } CdbDispatcherState;
 
 typedef struct DispatcherInternalFuncs
@@ -202,6 +227,17 @@ cdbdisp_makeDispatchParams(CdbDispatcherState *ds,
 						   char *queryText,
 						   int queryTextLen);
 
+void
+cdbdisp_setCachedPlan(CdbDispatcherState *ds,
+					  int planCacheSlot,
+					  const uint8 *planDigest,
+					  int planLen,
+					  char *(*buildQueryText) (void *arg, int *len),
+					  void *buildQueryTextArg);
+
+char *
+cdbdisp_getCachedPlanQueryText(CdbDispatcherState *ds, int *queryTextLen);
+
 bool cdbdisp_checkForCancel(CdbDispatcherState * ds);
 int *cdbdisp_getWaitSocketFds(CdbDispatcherState *ds, int *nsocks);
 
@@ -73,6 +73,7 @@ extern void setupCdbProcessList(ExecSlice *slice);
 extern List *getCdbProcessesForQD(int isPrimary);
 
 extern Gang *AllocateGang(struct CdbDispatcherState *ds, enum GangType type, List *segments);
+extern void cdbgang_connectWait(void);
 extern void RecycleGang(Gang *gp, bool forceDestroy);
 extern void DisconnectAndDestroyAllGangs(bool resetSession);
 extern void DisconnectAndDestroyUnusedQEs(void);
@@ -291,6 +291,19 @@ struct MotionConn
 	uint64 stat_max_resent;
 	uint64 stat_count_dropped;
 
+	/*
+	 * used by the sender: the number of packets still to be sent without
+	 * trying to compress them, after one that did not compress well.
+	 */
+	int			compressSkip;
+
+	/*
+	 * used by the receiver: bytes of chunk data that did not go over the
+	 * network because they arrived compressed.  Moved into the motion
+	 * node's statistics as the chunks are processed.
+	 */
+	uint64		stat_bytes_saved;
+
 	/*
 	 * used by the sender.
 	 *
@@ -414,6 +427,13 @@ typedef struct MotionNodeEntry
 	 */
 	SerTupInfo      ser_tup_info;
 
+	/*
+	 * If the tuples are sent in the batch format, the batch being filled for
+	 * each target route.  The last one is for broadcasts.
+	 */
+	SerTupBatch   **send_batches;
+	int             num_send_batches;
+
 	/*
 	 * If preserve_order is false, this is used to hold completed tuples that
 	 * have not yet been consumed.  If preserve_order is true, this is NULL.
@@ -449,6 +469,8 @@ typedef struct MotionNodeEntry
 	uint64          stat_total_chunks_recvd;                /* Tuple-chunks received. */
 	uint64          stat_total_bytes_recvd; /* Bytes received, including headers. */
 	uint64          stat_tuple_bytes_recvd; /* Bytes of pure tuple-data received. */
+	uint64          stat_bytes_saved_recvd; /* Bytes not sent over the network
+											 * thanks to compression. */
 
 	uint64          stat_total_sends;               /* Total calls to SendTuple. */
 
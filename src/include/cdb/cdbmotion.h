@@ -111,12 +111,14 @@ SendEndOfStream(MotionLayerState       *mlStates,
  * To get an result for unordered receive (we used to provide a separate
  * RecvTuple() function, set the srcRoute to ANY_ROUTE
  *
- * Returns the next tuple, or NULL if end-of-stream was reached.
+ * Stores the next tuple in slot and returns it, or returns NULL if
+ * end-of-stream was reached.
  */
-extern MinimalTuple RecvTupleFrom(MotionLayerState *mlStates,
-								  ChunkTransportState *transportStates,
-								  int16 motNodeID,
-								  int16 srcRoute);
+extern TupleTableSlot *RecvTupleFrom(MotionLayerState *mlStates,
+									 ChunkTransportState *transportStates,
+									 int16 motNodeID,
+									 int16 srcRoute,
+									 TupleTableSlot *slot);
 
 extern void SendStopMessage(MotionLayerState *mlStates,
 							ChunkTransportState *transportStates,
@@ -129,4 +131,10 @@ extern void SendStopMessage(MotionLayerState *mlStates,
 extern void UpdateMotionExpectedReceivers(MotionLayerState *mlStates,
 										  struct SliceTable *sliceTable);
 
+/*
+ * Bytes that interconnect compression saved the receiving end of a motion
+ * node so far.
+ */
+extern uint64 GetMotionBytesSaved(MotionLayerState *mlStates, int16 motNodeID);
+
 #endif   /* CDBMOTION_H */
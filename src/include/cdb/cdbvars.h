@@ -398,6 +398,43 @@ extern bool gp_interconnect_full_crc;
  */
 extern bool gp_interconnect_log_stats;
 
+/*
+ * Parameter gp_interconnect_udp_batch_size
+ *
+ * The most packets the UDP interconnect hands to the kernel, or reads from
+ * it, in a single system call (sendmmsg()/recvmmsg()).  1 disables batching.
+ */
+extern int	gp_interconnect_udp_batch_size;
+
+#define GP_INTERCONNECT_UDP_MAX_BATCH_SIZE 64
+
+/*
+ * Parameter gp_interconnect_udp_gso
+ *
+ * Let the kernel split a batch of equally sized UDP interconnect packets
+ * (UDP generic segmentation offload), where it supports it.
+ */
+extern bool gp_interconnect_udp_gso;
+
+/*
+ * Parameter gp_interconnect_compression
+ *
+ * Compress the tuple chunks of every interconnect packet with zstd before
+ * sending it. Packets that do not compress well are sent as they are.
+ */
+extern bool gp_interconnect_compression;
+
+/*
+ * Parameter gp_motion_batch_size
+ *
+ * The most tuples a Motion packs into one tuple chunk, column by column,
+ * when all its columns are fixed-width pass-by-value types. 0 sends every
+ * tuple on its own.
+ */
+extern int	gp_motion_batch_size;
+
+#define GP_MOTION_MAX_BATCH_SIZE 8192
+
 extern bool gp_interconnect_cache_future_packets;
 
 #define UNDEF_SEGMENT -2
@@ -650,6 +687,10 @@ extern int gp_segworker_relative_priority;
 /*  Max size of dispatched plans; 0 if no limit */
 extern int gp_max_plan_size;
 
+/* Number of dispatched plans each QE keeps for reuse; 0 disables */
+extern int gp_dispatch_plan_cache_size;
+#define MAX_CACHED_DISPATCH_PLANS 64
+
 /* Get statistics for partitioned parent from a child */
 extern bool 	gp_statistics_pullup_from_child_partition;
 
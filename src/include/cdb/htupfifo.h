@@ -23,6 +23,7 @@
 
 #include "access/htup.h"
 #include "access/memtup.h"
+#include "nodes/pg_list.h"
 
 /* An entry in the HeapTuple FIFO.	Entries are formed into queues. */
 typedef struct htf_entry_data
@@ -46,12 +47,23 @@ typedef struct htup_fifo_state
 
 	htf_entry	freelist;
 
+	/*
+	 * Batches of tuples received in the batch format (TupleBatchData), not
+	 * yet fully retrieved.
+	 */
+	List	   *batches;
+
 }	htup_fifo_state, *htup_fifo;
 
+struct TupleBatchData;
+
 extern htup_fifo htfifo_create(void);
 extern void htfifo_destroy(htup_fifo htf);
 
 extern void htfifo_addtuple(htup_fifo htf, MinimalTuple htup);
 extern MinimalTuple htfifo_gettuple(htup_fifo htf);
 
+extern void htfifo_addbatch(htup_fifo htf, struct TupleBatchData *batch);
+extern struct TupleBatchData *htfifo_getbatch(htup_fifo htf);
+
 #endif   /* HTUPFIFO_H */
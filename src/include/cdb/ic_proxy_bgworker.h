@@ -15,9 +15,44 @@
 
 #include "port/atomics.h"
 
+/* max count of peers whose statistics are kept in SHM */
+#define IC_PROXY_MAX_PEER_STATS 2048
+
+/*
+ * Statistics of the connection to a peer, kept in SHM so they can be
+ * reported by the backends.  They are only updated by the proxy bgworker.
+ *
+ * The counters are cumulative since the launch of the proxy bgworker, the
+ * others are sampled by its per second timer.
+ */
+typedef struct ICProxyPeerStats
+{
+	pg_atomic_uint32 dbid;			/* dbid of the peer, 0 if the slot is free */
+	int16		content;			/* content of the peer */
+	pg_atomic_uint32 connected;		/* ready to send and receive DATA */
+
+	pg_atomic_uint64 sentBytes;		/* bytes sent to the peer */
+	pg_atomic_uint64 sentPackets;	/* packets sent to the peer */
+	pg_atomic_uint64 writes;		/* writes to the peer socket */
+	pg_atomic_uint64 recvBytes;		/* bytes received from the peer */
+	pg_atomic_uint64 recvPackets;	/* packets received from the peer */
+
+	pg_atomic_uint64 queuedPackets;	/* packets waiting to be written */
+	pg_atomic_uint64 writeQueueBytes;	/* bytes being written */
+	pg_atomic_uint64 sendRate;		/* bytes per second sent */
+	pg_atomic_uint64 recvRate;		/* bytes per second received */
+
+	/* private to the proxy bgworker, to calculate the rates */
+	uint64		lastSentBytes;
+	uint64		lastRecvBytes;
+} ICProxyPeerStats;
+
 /* flag (in SHM) for incidaing if peer listener bind/listen failed */
 extern pg_atomic_uint32 *ic_proxy_peer_listener_failed;
 
+/* peer statistics (in SHM), an array of IC_PROXY_MAX_PEER_STATS slots */
+extern ICProxyPeerStats *ic_proxy_peer_stats;
+
 extern bool ICProxyStartRule(Datum main_arg);
 extern void ICProxyMain(Datum main_arg);
 extern Size ICProxyShmemSize(void);
@@ -305,6 +305,7 @@ extern ChunkTransportStateEntry *removeChunkTransportState(ChunkTransportState *
 														   int16 motNodeID);
 
 extern TupleChunkListItem RecvTupleChunk(MotionConn *conn, ChunkTransportState *transportStates);
+extern void CompressTupleChunks(MotionConn *conn, int headerSize);
 
 extern void InitMotionTCP(int *listenerSocketFd, uint16 *listenerPort);
 extern void InitMotionUDPIFC(int *listenerSocketFd, uint16 *listenerPort);
@@ -60,8 +60,45 @@ typedef struct SerTupInfo
 
 	/* true if tupdesc contains record types */
 	bool		has_record_types;
+
+	/*
+	 * The most tuples sent together in the batch format, or 0 if the tuples
+	 * are sent one by one.  Only set up on the sending side.
+	 */
+	int			batch_rows;
+	int		   *batch_valoff;	/* offset of each column's values in a
+								 * SerTupBatch */
+	int			batch_size;		/* size of the values of a SerTupBatch */
 }	SerTupInfo;
 
+/*
+ * Tuples waiting to be sent together to one target route, in the batch
+ * format: each column has a null bitmap and an array of values.
+ */
+typedef struct SerTupBatch
+{
+	int			nrows;
+	bool	   *hasnulls;		/* does the column have any NULL? */
+	bits8	   *nullbits;		/* BITMAPLEN(batch_rows) bytes per column */
+	char	   *values;			/* batch_rows values per column, packed */
+}	SerTupBatch;
+
+/*
+ * A batch of tuples received in the batch format.  The tuples are not formed;
+ * TupleBatchNextTuple() hands their columns out to a slot one row at a time.
+ */
+typedef struct TupleBatchData
+{
+	int			nrows;
+	int			next;			/* next row to hand out */
+	int			natts;
+	SerAttrInfo *attrinfo;		/* of the motion node's SerTupInfo */
+	bits8	  **nullbits;		/* per column, NULL if it has no NULLs */
+	char	  **values;			/* per column */
+}	TupleBatchData;
+
+typedef TupleBatchData *TupleBatch;
+
 /*
  * forward declaration to avoid #including cdbmotion.h here, which would create a circular
  * dependency
@@ -89,4 +126,11 @@ extern int SerializeTuple(TupleTableSlot *tuple, SerTupInfo *pSerInfo, struct di
  */
 extern MinimalTuple CvtChunksToTup(TupleChunkList tclist, SerTupInfo *pSerInfo, TupleRemapper *remapper);
 
+/* The batch format */
+extern SerTupBatch *CreateSerTupBatch(SerTupInfo *pSerInfo);
+extern bool AddTupleToBatch(TupleTableSlot *slot, SerTupInfo *pSerInfo, SerTupBatch *batch);
+extern void SerializeBatchIntoChunks(SerTupInfo *pSerInfo, SerTupBatch *batch, TupleChunkList tcList);
+extern TupleBatch CvtChunkToBatch(TupleChunkListItem tcItem, SerTupInfo *pSerInfo);
+extern void TupleBatchNextTuple(TupleBatch batch, TupleTableSlot *slot);
+
 #endif   /* TUPSER_H */
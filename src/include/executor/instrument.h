@@ -36,6 +36,8 @@ typedef struct BufferUsage
 	long		temp_blks_written;	/* # of temp blocks written */
 	instr_time	blk_read_time;	/* time spent reading */
 	instr_time	blk_write_time; /* time spent writing */
+	long		ao_reads;		/* # of large reads of append-only files */
+	long		ao_reads_prefetched;	/* # of those covered by read-ahead */
 } BufferUsage;
 
 typedef struct WalUsage
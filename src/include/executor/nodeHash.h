@@ -55,6 +55,9 @@ extern bool ExecHashGetHashValue(HashState *hashState, HashJoinTable hashtable,
 								 bool keep_nulls,
 								 uint32 *hashvalue,
 								 bool *hashkeys_null);
+extern bool ExecHashRuntimeFilterRejects(RuntimeFilterState *filter,
+										 ExprContext *econtext,
+										 TupleTableSlot *slot);
 extern void ExecHashGetBucketAndBatch(HashJoinTable hashtable,
 									  uint32 hashvalue,
 									  int *bucketno,
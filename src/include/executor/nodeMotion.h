@@ -22,5 +22,6 @@ extern void ExecEndMotion(MotionState *node);
 extern void ExecReScanMotion(MotionState *node);
 
 extern void ExecSquelchMotion(MotionState *node);
+extern uint64 ExecMotionBytesSaved(MotionState *node);
 
 #endif   /* NODEMOTION_H */
@@ -21,6 +21,7 @@ extern SeqScanState *ExecInitSeqScan(SeqScan *node, EState *estate, int eflags);
 extern SeqScanState *ExecInitSeqScanForPartition(SeqScan *node, EState *estate,
 							Relation currentRelation);
 extern void ExecEndSeqScan(SeqScanState *node);
+extern uint64 ExecSeqScanBlocksSkipped(SeqScanState *node);
 extern void ExecReScanSeqScan(SeqScanState *node);
 
 /* parallel scan support */
@@ -21,6 +21,7 @@ extern "C" {
 #include "nodes/params.h"
 #include "nodes/parsenodes.h"
 #include "nodes/plannodes.h"
+#include "optimizer/orca.h"
 }
 
 class CGPOptimizer
@@ -36,6 +37,9 @@ public:
 	// serialize planned statement into DXL
 	static char *SerializeDXLPlan(Query *query);
 
+	// report counters of the optimizer's caches
+	static int GetCacheStats(OptimizerCacheStats *stats, int max_stats);
+
 	// gpopt initialize and terminate
 	static void InitGPOPT();
 
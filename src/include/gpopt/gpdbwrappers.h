@@ -25,6 +25,7 @@ extern "C" {
 #include "statistics/statistics.h"
 #include "utils/faultinjector.h"
 #include "utils/lsyscache.h"
+#include "utils/orcamdcache.h"
 }
 
 #include "gpos/types.h"
@@ -41,6 +42,7 @@ struct Query;
 using ScanKey = struct ScanKeyData *;
 struct Bitmapset;
 struct Plan;
+struct HashJoin;
 struct ListCell;
 struct TargetEntry;
 struct Expr;
@@ -172,6 +174,9 @@ List *ExtractNodesPlan(Plan *pl, int node_tag, bool descend_into_subqueries);
 List *ExtractNodesExpression(Node *node, int node_tag,
 							 bool descend_into_subqueries);
 
+// can the hash join build a runtime filter for the scan on its outer side
+bool HashJoinRuntimeFilterEligible(HashJoin *join);
+
 // intermediate result type of given aggregate
 Oid GetAggIntermediateResultType(Oid aggid);
 
@@ -615,6 +620,37 @@ FaultInjectorType_e InjectFaultInOptTasks(const char *fault_name);
 // table has been changed?)
 bool MDCacheNeedsReset(void);
 
+// Must the whole metadata cache be reset, rather than individual objects?
+bool MDCacheNeedsFullReset(void);
+
+// Was the relation with the given OID invalidated?
+bool MDCacheRelIsInvalidated(Oid relid);
+
+// Was the type, function, operator, aggregate or constraint with the given
+// OID (possibly) invalidated?
+bool MDCacheOidIsInvalidated(Oid oid);
+
+// Were any types, functions, operators, aggregates or constraints invalidated?
+bool MDCacheHasInvalidatedOids(void);
+
+// Was pg_statistic changed?
+bool MDCacheStatsAreInvalidated(void);
+
+// Is the metadata cache shared by all backends enabled?
+bool SharedMDCacheEnabled(void);
+
+// current invalidation epoch of the shared metadata cache
+uint64 SharedMDCacheGetEpoch(void);
+
+// look up a serialized metadata object in the shared metadata cache
+char *SharedMDCacheLookup(const char *key, Oid relid, OrcaMDCacheKind kind,
+						  Size *len);
+
+// store a serialized metadata object, translated starting at the given
+// epoch, in the shared metadata cache
+void SharedMDCacheInsert(const char *key, Oid relid, OrcaMDCacheKind kind,
+						 const char *data, Size len, uint64 epoch);
+
 // returns true if a query cancel is requested in GPDB
 bool IsAbortRequested(void);
 
@@ -18,6 +18,12 @@
 #ifndef GPMD_CMDProviderRelcache_H
 #define GPMD_CMDProviderRelcache_H
 
+extern "C" {
+#include "postgres.h"
+
+#include "utils/orcamdcache.h"
+}
+
 #include "gpos/base.h"
 #include "gpos/string/CWStringBase.h"
 
@@ -45,6 +51,11 @@ using namespace gpos;
 //---------------------------------------------------------------------------
 class CMDProviderRelcache : public IMDProvider
 {
+private:
+	// key of an object in the metadata cache shared by all backends
+	static BOOL GetSharedCacheKey(IMDId *mdid, CHAR *key,
+								  OrcaMDCacheKind *kind, OID *relid);
+
 public:
 	CMDProviderRelcache(const CMDProviderRelcache &) = delete;
 
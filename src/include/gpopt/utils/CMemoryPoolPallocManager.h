@@ -30,8 +30,9 @@ public:
 	CMemoryPoolPallocManager(CMemoryPool *internal,
 							 EMemoryPoolType memory_pool_type);
 
-	// allocate new memorypool
-	CMemoryPool *NewMemoryPool() override;
+	// allocate new memorypool; all kinds of pools are palloc based, so
+	// EmpkSlab only makes a difference in standalone GPORCA
+	CMemoryPool *NewMemoryPool(EMemoryPoolKind kind) override;
 
 	// free allocation
 	void DeleteImpl(void *ptr, CMemoryPool::EAllocationType eat) override;
@@ -148,6 +148,22 @@ private:
 	// create optimizer plan hints
 	static CPlanHint *GetPlanHints(CMemoryPool *mp, Query *query);
 
+	// was the given cached metadata object affected by the catalog changes
+	// since the last planned query
+	static BOOL IsMDCacheObjectInvalidated(const IMDId *mdid, void *context);
+
+	// can the plan of the given query be served from the plan cache
+	static BOOL IsPlanCacheable(const Query *query,
+								const CSearchStageArray *search_strategy_arr);
+
+	// serialize the optimizer input that determines the plan of a query
+	static CWStringDynamic *SerializePlanCacheKey(
+		CMemoryPool *mp, const CDXLNode *query_dxl,
+		const CDXLNodeArray *query_output_dxlnode_array,
+		const CDXLNodeArray *cte_dxlnode_array,
+		const COptimizerConfig *optimizer_config, ULONG num_segments,
+		ULONG num_segments_for_costing);
+
 	// print warning messages for columns with missing statistics
 	static void PrintMissingStatsWarning(CMemoryPool *mp,
 										 CMDAccessor *md_accessor,
@@ -1484,6 +1484,29 @@ typedef struct ScanState
 	TupleTableSlot *ss_ScanTupleSlot;
 } ScanState;
 
+/* ----------------
+ *	 RuntimeFilterState information
+ *
+ *		A Bloom filter over the hash values of the inner rows of a Hash
+ *		Join.  The Hash node builds it along with the hash table, and the
+ *		SeqScan feeding the outer side of the join probes it to drop the
+ *		rows that cannot have a match.
+ *
+ *		attnums			scan attribute of each outer hash key
+ *		hashfunctions	outer hash function of each key
+ *		collations		collation of each key
+ *		bloom			the filter, NULL while there is no hash table
+ * ----------------
+ */
+typedef struct RuntimeFilterState
+{
+	int			nkeys;
+	AttrNumber *attnums;
+	FmgrInfo   *hashfunctions;
+	Oid		   *collations;
+	struct bloom_filter *bloom;
+} RuntimeFilterState;
+
 /* ----------------
  *	 SeqScanState information
  * ----------------
@@ -1492,6 +1515,8 @@ typedef struct SeqScanState
 {
 	ScanState	ss;				/* its first field is NodeTag */
 	Size		pscan_len;		/* size of parallel heap scan descriptor */
+	uint64		blocks_skipped; /* blocks skipped by zone maps, for EXPLAIN */
+	RuntimeFilterState *runtimeFilter;	/* pushed down by a Hash Join */
 } SeqScanState;
 
 /* ----------------
@@ -2141,6 +2166,8 @@ typedef struct DynamicSeqScanState
 	struct PartitionPruneState *as_prune_state; /* partition dynamic pruning state */
 	Bitmapset  *as_valid_subplans; /* used to determine partitions during dynamic pruning*/
 	bool 		did_pruning; /* flag that is set once dynamic pruning is performed */
+
+	uint64		blocks_skipped; /* blocks skipped by zone maps, for EXPLAIN */
 } DynamicSeqScanState;
 
 /*
@@ -2811,6 +2838,9 @@ typedef struct HashState
 
 	/* Parallel hash state. */
 	struct ParallelHashJoinState *parallel_state;
+
+	/* Runtime filter to build along with the hash table, or NULL */
+	RuntimeFilterState *runtimeFilter;
 } HashState;
 
 /* ----------------
@@ -2988,6 +3018,8 @@ typedef struct MotionState
 	Oid		   *outputFunArray;	/* output functions for each column (debug only) */
 
 	int			numInputSegs;	/* the number of segments on the sending slice */
+
+	uint64		bytes_saved;	/* bytes saved by interconnect compression, for EXPLAIN */
 } MotionState;
 
 /* ----------------
@@ -1159,6 +1159,12 @@ typedef struct HashJoin
 	 * perform lookups in the hashtable over the inner plan.
 	 */
 	List	   *hashkeys;
+
+	/*
+	 * Build a Bloom filter over the inner join keys, for the SeqScan on the
+	 * outer side to drop the rows that cannot have a match.
+	 */
+	bool		runtime_filter;
 } HashJoin;
 
 #define SHARE_ID_NOT_SHARED (-1)
@@ -90,6 +90,7 @@ extern PGDLLIMPORT int constraint_exclusion;
 
 extern bool gp_enable_hashjoin_size_heuristic;          /*CDB*/
 extern bool gp_enable_predicate_propagation;
+extern bool gp_enable_runtime_filter;
 
 extern double index_pages_fetched(double tuples_fetched, BlockNumber pages,
 								  double index_pages, PlannerInfo *root);
@@ -201,4 +201,8 @@ extern Node *flatten_join_alias_vars(Query *query, Node *node);
 
 extern bool contain_ctid_var_reference(Scan *scan);
 
+/* in plan/createplan.c: */
+
+extern bool hashjoin_runtime_filter_eligible(HashJoin *join);
+
 #endif							/* OPTIMIZER_H */
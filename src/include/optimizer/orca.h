@@ -28,6 +28,28 @@ extern Node *transformGroupedWindows(Node *node, void *context);
 typedef void *(*plan_hint_hook_type) (Query *parse);
 extern PGDLLIMPORT plan_hint_hook_type plan_hint_hook;
 
+/*
+ * Counters of one of ORCA's caches, as reported by
+ * gp_toolkit.gp_optimizer_cache_stats.
+ */
+typedef struct OptimizerCacheStats
+{
+	const char *name;			/* which cache */
+	int64		entries;		/* number of cached objects */
+	int64		size;			/* memory used, in bytes */
+	int64		quota;			/* memory quota in bytes, 0 means unlimited */
+	int64		hits;			/* lookups that found an object */
+	int64		misses;			/* lookups that did not */
+	int64		evictions;		/* times entries were evicted to meet the quota */
+	int64		invalidations;	/* times catalog changes were applied */
+	int64		invalidated_entries;	/* objects dropped by catalog changes */
+	int64		retained_entries;	/* objects kept across catalog changes */
+} OptimizerCacheStats;
+
+#define MAX_OPTIMIZER_CACHE_STATS	4
+
+extern int GetOptimizerCacheStats(OptimizerCacheStats *stats, int max_stats);
+
 #endif
 
 #endif /* ORCA_H */
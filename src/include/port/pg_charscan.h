@@ -0,0 +1,213 @@
+/*-------------------------------------------------------------------------
+ *
+ * pg_charscan.h
+ *	  Find the next byte of a small set of special bytes in a buffer.
+ *
+ * The COPY FROM and gpfdist parsers spend most of their time walking over
+ * ordinary data bytes, looking for the few bytes that matter to them: the
+ * end of line, the quote and escape characters, and so on.  The functions
+ * here skip over the ordinary bytes 64 at a time, using SSE2 (which every
+ * x86-64 CPU has) or AVX2 when the compiler targets it.  Other platforms
+ * get a plain byte-by-byte loop.
+ *
+ * Everything is inline, so that both the backend and gpfdist, which has no
+ * libpgport, can use it.
+ *
+ * Portions Copyright (c) 2024-Present VMware, Inc. or its affiliates.
+ *
+ * src/include/port/pg_charscan.h
+ *
+ *-------------------------------------------------------------------------
+ */
+#ifndef PG_CHARSCAN_H
+#define PG_CHARSCAN_H
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define USE_CHARSCAN_AVX2
+#elif defined(__SSE2__) || defined(_M_AMD64)
+#include <emmintrin.h>
+#define USE_CHARSCAN_SSE2
+#endif
+
+#include "port/pg_bitutils.h"
+
+#define PG_CHARSCAN_MAX_CHARS 6
+
+/*
+ * The bytes to look for.  Set it up with pg_charscan_init().
+ */
+typedef struct PgCharScanSet
+{
+	int			nchars;
+	char		chars[PG_CHARSCAN_MAX_CHARS];
+	bool		highbit;		/* also stop at any byte with the high bit set */
+} PgCharScanSet;
+
+/*
+ * Look for the 'nchars' bytes in 'chars', and for the bytes with the high
+ * bit set if 'highbit' is true.  Duplicates are fine.
+ *
+ * The unused slots are filled with the first byte, so that the whole set is
+ * always initialized, and looking at a slot past 'nchars' doesn't change the
+ * result.
+ */
+static inline void
+pg_charscan_init(PgCharScanSet *set, const char *chars, int nchars, bool highbit)
+{
+	int			i;
+
+	Assert(nchars > 0 && nchars <= PG_CHARSCAN_MAX_CHARS);
+
+	set->nchars = nchars;
+	memcpy(set->chars, chars, nchars);
+	for (i = nchars; i < PG_CHARSCAN_MAX_CHARS; i++)
+		set->chars[i] = chars[0];
+	set->highbit = highbit;
+}
+
+static inline bool
+pg_charscan_match(const PgCharScanSet *set, char c)
+{
+	int			i;
+
+	if (set->highbit && IS_HIGHBIT_SET(c))
+		return true;
+	for (i = 0; i < set->nchars; i++)
+	{
+		if (c == set->chars[i])
+			return true;
+	}
+	return false;
+}
+
+#if defined(USE_CHARSCAN_AVX2) || defined(USE_CHARSCAN_SSE2)
+
+#ifdef USE_CHARSCAN_AVX2
+typedef __m256i pg_charscan_vec;
+#define CHARSCAN_VEC_LEN 32
+#define charscan_load(p)		_mm256_loadu_si256((const __m256i *) (p))
+#define charscan_set1(c)		_mm256_set1_epi8(c)
+#define charscan_cmpeq(a, b)	_mm256_cmpeq_epi8(a, b)
+#define charscan_or(a, b)		_mm256_or_si256(a, b)
+#define charscan_movemask(a)	((uint32) _mm256_movemask_epi8(a))
+#else
+typedef __m128i pg_charscan_vec;
+#define CHARSCAN_VEC_LEN 16
+#define charscan_load(p)		_mm_loadu_si128((const __m128i *) (p))
+#define charscan_set1(c)		_mm_set1_epi8(c)
+#define charscan_cmpeq(a, b)	_mm_cmpeq_epi8(a, b)
+#define charscan_or(a, b)		_mm_or_si128(a, b)
+#define charscan_movemask(a)	((uint32) _mm_movemask_epi8(a))
+#endif
+
+/* Bytes examined per iteration of the vectorized loops */
+#define CHARSCAN_STRIDE 64
+
+/*
+ * Bit i of the result is set if byte i of the CHARSCAN_STRIDE bytes at 'p'
+ * is in the set.
+ */
+static inline uint64
+pg_charscan_mask(const char *p, const pg_charscan_vec *needles,
+				 const PgCharScanSet *set)
+{
+	uint64		mask = 0;
+	int			off;
+
+	for (off = 0; off < CHARSCAN_STRIDE; off += CHARSCAN_VEC_LEN)
+	{
+		pg_charscan_vec v = charscan_load(p + off);
+		pg_charscan_vec hits = charscan_cmpeq(v, needles[0]);
+		uint32		bits;
+		int			i;
+
+		for (i = 1; i < set->nchars; i++)
+			hits = charscan_or(hits, charscan_cmpeq(v, needles[i]));
+		bits = charscan_movemask(hits);
+		/* the high bit of each byte is exactly what movemask collects */
+		if (set->highbit)
+			bits |= charscan_movemask(v);
+
+		mask |= (uint64) bits << off;
+	}
+
+	return mask;
+}
+
+static inline void
+pg_charscan_needles(pg_charscan_vec *needles, const PgCharScanSet *set)
+{
+	int			i;
+
+	for (i = 0; i < set->nchars; i++)
+		needles[i] = charscan_set1(set->chars[i]);
+}
+
+#endif							/* USE_CHARSCAN_AVX2 || USE_CHARSCAN_SSE2 */
+
+/*
+ * pg_charscan_first
+ *		Returns the first byte of [p, end) that is in the set, or 'end' if
+ *		there is none.
+ */
+static inline const char *
+pg_charscan_first(const char *p, const char *end, const PgCharScanSet *set)
+{
+#if defined(USE_CHARSCAN_AVX2) || defined(USE_CHARSCAN_SSE2)
+	if (end - p >= CHARSCAN_STRIDE)
+	{
+		pg_charscan_vec needles[PG_CHARSCAN_MAX_CHARS];
+
+		pg_charscan_needles(needles, set);
+		for (; end - p >= CHARSCAN_STRIDE; p += CHARSCAN_STRIDE)
+		{
+			uint64		mask = pg_charscan_mask(p, needles, set);
+
+			if (mask != 0)
+				return p + pg_rightmost_one_pos64(mask);
+		}
+	}
+#endif
+
+	for (; p < end; p++)
+	{
+		if (pg_charscan_match(set, *p))
+			return p;
+	}
+	return end;
+}
+
+/*
+ * pg_charscan_last
+ *		Returns the last byte of [start, end) that is in the set, or NULL if
+ *		there is none.
+ */
+static inline const char *
+pg_charscan_last(const char *start, const char *end, const PgCharScanSet *set)
+{
+#if defined(USE_CHARSCAN_AVX2) || defined(USE_CHARSCAN_SSE2)
+	if (end - start >= CHARSCAN_STRIDE)
+	{
+		pg_charscan_vec needles[PG_CHARSCAN_MAX_CHARS];
+
+		pg_charscan_needles(needles, set);
+		for (; end - start >= CHARSCAN_STRIDE; end -= CHARSCAN_STRIDE)
+		{
+			uint64		mask = pg_charscan_mask(end - CHARSCAN_STRIDE, needles, set);
+
+			if (mask != 0)
+				return end - CHARSCAN_STRIDE + pg_leftmost_one_pos64(mask);
+		}
+	}
+#endif
+
+	while (start < end)
+	{
+		if (pg_charscan_match(set, *--end))
+			return end;
+	}
+	return NULL;
+}
+
+#endif							/* PG_CHARSCAN_H */
@@ -223,6 +223,7 @@ typedef enum BuiltinTrancheIds
 	LWTRANCHE_PARALLEL_APPEND,
 	LWTRANCHE_SXACT,
 	LWTRANCHE_DISTRIBUTEDLOG_BUFFERS,
+	LWTRANCHE_ORCA_MDCACHE_DSA,
 	LWTRANCHE_FIRST_USER_DEFINED
 }			BuiltinTrancheIds;
 
@@ -15,6 +15,7 @@
 #ifndef DATUMSTREAM_H
 #define DATUMSTREAM_H
 
+#include "access/appendonly_zonemap.h"
 #include "catalog/pg_attribute.h"
 #include "utils/datumstreamblock.h"
 
@@ -65,6 +66,13 @@ typedef struct DatumStreamWrite
 
 	DatumStreamBlockWrite blockWrite;
 
+	/*
+	 * Synopsis of the values in the current block, recorded in the block
+	 * directory's zone map, if the column's type supports one.
+	 */
+	bool		hasZoneMap;
+	AOZoneMapEntry zonemap;
+
 	/*
 	 * EOFs of current segment file.
 	 */
@@ -243,6 +251,26 @@ datumstreamread_nth(DatumStreamRead * acc)
 	}
 }
 
+/*
+ * Number of datums left to read from the current block.
+ */
+inline static int
+datumstreamread_remaining(DatumStreamRead * acc)
+{
+	if (acc->largeObjectState == DatumStreamLargeObjectState_None)
+	{
+		/* nth goes one past the last datum once the block is exhausted */
+		return Max(acc->blockRead.logical_row_count - (acc->blockRead.nth + 1), 0);
+	}
+	else
+	{
+		return (acc->largeObjectState == DatumStreamLargeObjectState_HaveAoContent) ? 1 : 0;
+	}
+}
+
+extern int	datumstreamread_get_batch(DatumStreamRead * ds, Datum *values,
+									  bool *nulls, int maxRows);
+
 /* ------------------------------------------------------------------------------ */
 
 extern int datumstreamwrite_put(
@@ -324,4 +352,7 @@ extern bool datumstreamread_block_info(DatumStreamRead * acc);
  */
 extern void datumstreamread_block_content(DatumStreamRead * acc);
 
+extern void datumstreamread_skip_block(DatumStreamRead * acc);
+extern void datumstreamread_reset_block(DatumStreamRead * acc);
+
 #endif   /* DATUMSTREAM_H */
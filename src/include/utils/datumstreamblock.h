@@ -2146,6 +2146,11 @@ extern void DatumStreamBlockRead_Init(
 						  void *errcontextArg);
 extern void DatumStreamBlockRead_Finish(
 							DatumStreamBlockRead * dsr);
+extern int DatumStreamBlockRead_GetBatch(
+							  DatumStreamBlockRead * dsr,
+							  Datum *values,
+							  bool *nulls,
+							  int maxRows);
 
 extern void DatumStreamBlockWrite_Init(
 						   DatumStreamBlockWrite * dsw,
@@ -288,6 +288,7 @@ extern bool gp_local_distributed_cache_stats;
 extern bool gp_appendonly_verify_block_checksums;
 extern bool gp_appendonly_verify_write_block;
 extern bool gp_appendonly_compaction;
+extern bool gp_appendonly_compaction_copy_blocks;
 
 /*
  * Threshold of the ratio of dirty data in a segment file
@@ -298,6 +299,12 @@ extern bool gp_appendonly_compaction;
  * 10% of the tuples are hidden.
  */
 extern int  gp_appendonly_compaction_threshold;
+
+/*
+ * Number of large reads of an append-only segment file that are prefetched
+ * ahead of the current one.  0 disables read-ahead.
+ */
+extern int  gp_appendonly_read_ahead_depth;
 extern bool gp_heap_require_relhasoids_match;
 extern bool	debug_xlog_record_read;
 extern bool Debug_cancel_print;
@@ -452,6 +459,9 @@ extern int optimizer_minidump;
 extern int  optimizer_cost_model;
 extern bool optimizer_metadata_caching;
 extern int	optimizer_mdcache_size;
+extern bool optimizer_plan_caching;
+extern int	optimizer_plan_cache_size;
+extern int	optimizer_shared_mdcache_size;
 
 /* Optimizer debugging GUCs */
 extern bool optimizer_print_query;
@@ -581,6 +591,8 @@ extern bool optimizer_enable_push_join_below_union_all;
 extern bool optimizer_analyze_root_partition;
 extern bool optimizer_analyze_midlevel_partition;
 
+extern bool gp_analyze_skip_unchanged_ao;
+
 extern bool optimizer_use_gpdb_allocators;
 
 /* optimizer GUCs for replicated table */
@@ -610,6 +622,7 @@ extern bool gp_quicklz_fallback;
 
 /* copy GUC */
 extern bool gp_enable_segment_copy_checking;
+extern bool gp_copy_parse_on_segments;
 
 extern int writable_external_table_bufsize;
 
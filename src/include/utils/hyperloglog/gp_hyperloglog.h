@@ -154,8 +154,16 @@ typedef struct GpHLLData {
 	/* Number of pages in the partition */
 	float4 relPages;
 
+	/*
+	 * For an append-optimized partition, the sum of the modcounts of all its
+	 * segment files, and its relfilenode, when the counter was created.
+	 * aoRelfilenode is InvalidOid if they were not recorded.
+	 */
+	int64_t aoModCount;
+	uint32_t aoRelfilenode;
+
 	/* padding to save more values for the future */
-	int32_t padding[11];
+	int32_t padding[8];
 
     /* largest observed 'rho' for each of the 'm' buckets (uses the very same
      * trick  as in the varlena type in include/c.h where additional memory 
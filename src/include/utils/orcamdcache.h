@@ -0,0 +1,55 @@
+/*-------------------------------------------------------------------------
+ *
+ * orcamdcache.h
+ *	  Metadata cache of the GPORCA optimizer, shared by all backends.
+ *
+ * See orcamdcache.c for comments.
+ *
+ * Portions Copyright (c) 2024-Present VMware, Inc. or its affiliates.
+ *
+ *
+ * IDENTIFICATION
+ *	    src/include/utils/orcamdcache.h
+ *
+ *-------------------------------------------------------------------------
+ */
+#ifndef ORCAMDCACHE_H
+#define ORCAMDCACHE_H
+
+/* maximum length of the string form of a metadata id, including the NUL */
+#define ORCA_MDCACHE_KEYLEN		64
+
+/* kinds of metadata objects held in the shared cache */
+typedef enum OrcaMDCacheKind
+{
+	ORCA_MDCACHE_RELATION,		/* IMDRelation */
+	ORCA_MDCACHE_RELSTATS,		/* IMDRelStats */
+	ORCA_MDCACHE_COLSTATS		/* IMDColStats */
+} OrcaMDCacheKind;
+
+/* counters reported by gp_toolkit.gp_optimizer_cache_stats */
+typedef struct OrcaMDCacheStats
+{
+	int64		entries;		/* number of cached objects */
+	int64		size;			/* bytes of serialized objects */
+	int64		quota;			/* size of the shared area, in bytes */
+	int64		hits;			/* lookups that found a valid object */
+	int64		misses;			/* lookups that did not */
+	int64		evictions;		/* objects evicted to make room */
+	int64		invalidations;	/* catalog changes applied */
+	int64		invalidated_entries;	/* stale objects dropped */
+} OrcaMDCacheStats;
+
+extern Size OrcaMDCacheShmemSize(void);
+extern void OrcaMDCacheShmemInit(void);
+extern void InitOrcaMDCache(void);
+
+extern bool OrcaMDCacheEnabled(void);
+extern uint64 OrcaMDCacheGetEpoch(void);
+extern char *OrcaMDCacheLookup(const char *key, Oid relid, OrcaMDCacheKind kind,
+							   Size *len);
+extern void OrcaMDCacheInsert(const char *key, Oid relid, OrcaMDCacheKind kind,
+							  const char *data, Size len, uint64 epoch);
+extern void OrcaMDCacheGetStats(OrcaMDCacheStats *stats);
+
+#endif   /* ORCAMDCACHE_H */
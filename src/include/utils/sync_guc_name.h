@@ -38,9 +38,14 @@
 		"gin_pending_list_limit",
 		"gp_allow_date_field_width_5digits",
 		"gp_appendonly_compaction",
+		"gp_appendonly_compaction_copy_blocks",
 		"gp_appendonly_compaction_threshold",
+		"gp_appendonly_decompress_ahead_mem",
+		"gp_appendonly_decompress_workers",
+		"gp_appendonly_read_ahead_depth",
 		"gp_appendonly_verify_block_checksums",
 		"gp_appendonly_verify_write_block",
+		"gp_appendonly_zone_maps",
 		"gp_blockdirectory_entry_min_range",
 		"gp_blockdirectory_minipage_size",
 		"gp_cpu_decompress_cost",
@@ -58,6 +63,7 @@
 		"gp_initial_bad_row_limit",
 		"gp_interconnect_address_type",
 		"gp_interconnect_cache_future_packets",
+		"gp_interconnect_compression",
 		"gp_interconnect_cursor_ic_table_size",
 		"gp_interconnect_debug_retry_interval",
 		"gp_interconnect_default_rtt",
@@ -75,6 +81,8 @@
 		"gp_interconnect_timer_period",
 		"gp_interconnect_transmit_timeout",
 		"gp_interconnect_type",
+		"gp_interconnect_udp_batch_size",
+		"gp_interconnect_udp_gso",
 		"gp_log_endpoints",
 		"gp_log_interconnect",
 		"gp_log_resgroup_memory",
@@ -83,6 +91,7 @@
 		"gp_log_suboverflow_statement",
 		"gp_max_alloc_size",
 		"gp_max_packet_size",
+		"gp_motion_batch_size",
 		"gp_motion_slice_noop",
 		"gp_quicklz_fallback",
 		"gp_resgroup_debug_wait_queue",
@@ -129,6 +129,7 @@
 		"geqo_threshold",
 		"gp_adjust_selectivity_for_outerjoins",
 		"gp_allow_non_uniform_partitioning_ddl",
+		"gp_analyze_skip_unchanged_ao",
 		"gp_auth_time_override",
 		"gp_autostats_allow_nonowner",
 		"gp_autostats_lock_wait",
@@ -140,6 +141,7 @@
 		"gp_command_count",
 		"gp_connection_send_timeout",
 		"gp_contentid",
+		"gp_copy_parse_on_segments",
 		"gp_cost_hashjoin_chainwalk",
 		"gp_create_table_random_default_distribution",
 		"gp_cte_sharing",
@@ -149,6 +151,7 @@
 		"gp_dispatch_keepalives_count",
 		"gp_dispatch_keepalives_idle",
 		"gp_dispatch_keepalives_interval",
+		"gp_dispatch_plan_cache_size",
 		"gp_distinct_grouping_sets_threshold",
 		"gp_dtx_recovery_interval",
 		"gp_dtx_recovery_prepared_period",
@@ -171,6 +174,7 @@
 		"gp_enable_preunique",
 		"gp_enable_query_metrics",
 		"gp_enable_relsize_collection",
+		"gp_enable_runtime_filter",
 		"gp_enable_slow_writer_testmode",
 		"gp_enable_sort_limit",
 		"gp_enable_statement_trigger",
@@ -421,6 +425,8 @@
 		"optimizer_partition_selection_log",
 		"optimizer_penalize_broadcast_threshold",
 		"optimizer_penalize_skew",
+		"optimizer_plan_cache_size",
+		"optimizer_plan_caching",
 		"optimizer_plan_id",
 		"optimizer_print_expression_properties",
 		"optimizer_print_group_properties",
@@ -444,6 +450,7 @@
 		"optimizer_samples_number",
 		"optimizer_search_strategy_path",
 		"optimizer_segments",
+		"optimizer_shared_mdcache_size",
 		"optimizer_skew_factor",
 		"optimizer_sort_factor",
 		"optimizer_trace_fallback",
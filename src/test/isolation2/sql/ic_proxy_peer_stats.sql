@@ -0,0 +1,42 @@
+-- Test that gp_toolkit.gp_interconnect_proxy_peer_stats counts the traffic of
+-- a motion between the proxies of the segments.
+CREATE TABLE ic_proxy_peer_stats(a int, b int) DISTRIBUTED BY (a);
+INSERT INTO ic_proxy_peer_stats SELECT i, i FROM generate_series(1, 1000) i;
+-- Will ensure that all peer setup is done.
+SELECT count(*) FROM ic_proxy_peer_stats;
+
+-- Every proxy, the coordinator's included, reports its connected peers.
+SELECT count(DISTINCT gp_segment_id) = (SELECT count(*) FROM gp_segment_configuration WHERE role = 'p') AS all_proxies
+    FROM gp_toolkit.gp_interconnect_proxy_peer_stats WHERE connected;
+
+-- Reading the view gathers rows on the coordinator through the proxies, so
+-- only look at the traffic between segments, which only the redistribution
+-- below produces.
+CREATE TABLE ic_proxy_peer_stats_before AS
+    SELECT gp_segment_id, peer_dbid, sent_bytes, sent_packets, recv_bytes, recv_packets
+    FROM gp_toolkit.gp_interconnect_proxy_peer_stats WHERE gp_segment_id >= 0 AND peer_content >= 0
+    DISTRIBUTED RANDOMLY;
+
+-- Redistribute every row by b.
+SELECT count(*) FROM (SELECT b, count(*) FROM ic_proxy_peer_stats GROUP BY b) s;
+
+CREATE TABLE ic_proxy_peer_stats_after AS
+    SELECT gp_segment_id, peer_dbid, sent_bytes, sent_packets, recv_bytes, recv_packets
+    FROM gp_toolkit.gp_interconnect_proxy_peer_stats WHERE gp_segment_id >= 0 AND peer_content >= 0
+    DISTRIBUTED RANDOMLY;
+
+-- Every segment sent rows to, and received rows from, the other segments.
+SELECT count(*) = (SELECT count(*) FROM gp_segment_configuration WHERE role = 'p' AND content >= 0) AS all_segments
+    FROM (SELECT a.gp_segment_id,
+                 sum(a.sent_bytes - coalesce(b.sent_bytes, 0)) AS sent_bytes,
+                 sum(a.sent_packets - coalesce(b.sent_packets, 0)) AS sent_packets,
+                 sum(a.recv_bytes - coalesce(b.recv_bytes, 0)) AS recv_bytes,
+                 sum(a.recv_packets - coalesce(b.recv_packets, 0)) AS recv_packets
+          FROM ic_proxy_peer_stats_after a
+          LEFT JOIN ic_proxy_peer_stats_before b USING (gp_segment_id, peer_dbid)
+          GROUP BY a.gp_segment_id) d
+    WHERE sent_bytes > 0 AND sent_packets > 0 AND recv_bytes > 0 AND recv_packets > 0;
+
+DROP TABLE ic_proxy_peer_stats_before;
+DROP TABLE ic_proxy_peer_stats_after;
+DROP TABLE ic_proxy_peer_stats;
@@ -14,6 +14,9 @@ for i in $(seq ${1}); do
   cat dataset/perfdata.csv >> $MASTER_DATA_DIRECTORY/perfdataset/perfdata.csv;
 done
 
+# The same rows as CSV, with every field quoted
+sed 's/[^|]*/"&"/g' $MASTER_DATA_DIRECTORY/perfdataset/perfdata.csv > $MASTER_DATA_DIRECTORY/perfdataset/perfdata_quoted.csv
+
 # Kill gpfdist processes and host the dataset
 killall gpfdist
 sleep 5
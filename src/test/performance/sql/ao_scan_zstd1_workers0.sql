@@ -0,0 +1,2 @@
+SET gp_appendonly_decompress_workers = 0;
+SELECT count(f) > 0 AS scanned FROM ao_scan_zstd1;
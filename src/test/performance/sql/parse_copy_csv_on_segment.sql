@@ -0,0 +1,2 @@
+TRUNCATE parse_target;
+COPY parse_target FROM '<SEG_DATA_DIR>/perfparse_quoted.csv' ON SEGMENT WITH (FORMAT csv, DELIMITER '|');
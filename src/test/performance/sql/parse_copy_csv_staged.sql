@@ -0,0 +1,3 @@
+SET gp_copy_parse_on_segments = on;
+TRUNCATE parse_target;
+COPY parse_target FROM 'perfdataset/perfdata_quoted.csv' WITH (FORMAT csv, DELIMITER '|');
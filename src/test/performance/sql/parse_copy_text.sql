@@ -0,0 +1,2 @@
+TRUNCATE parse_target;
+COPY parse_target FROM 'perfdataset/perfdata.csv' WITH (DELIMITER '|');
@@ -0,0 +1,2 @@
+TRUNCATE parse_target;
+COPY parse_target FROM '<SEG_DATA_DIR>/perfparse.txt' ON SEGMENT WITH (DELIMITER '|');
@@ -0,0 +1 @@
+SELECT count(f) > 0 AS scanned FROM ext_base_table;
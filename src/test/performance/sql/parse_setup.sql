@@ -0,0 +1,9 @@
+--
+-- Create the table to COPY into, and write out the rows on each segment, in
+-- text format and as CSV with every field quoted, for the COPY ON SEGMENT
+-- parsing performance tests
+--
+CREATE TABLE parse_target (like base_table);
+
+COPY base_table TO '<SEG_DATA_DIR>/perfparse.txt' ON SEGMENT WITH (DELIMITER '|');
+COPY base_table TO '<SEG_DATA_DIR>/perfparse_quoted.csv' ON SEGMENT WITH (FORMAT csv, DELIMITER '|', FORCE_QUOTE *);
@@ -0,0 +1,17 @@
+--
+-- Create and load the compressed tables to be used for scan performance
+-- testing
+--
+CREATE TABLE ao_scan_zlib1 (like base_table) WITH (appendonly=true, compresstype=zlib, compresslevel=1);
+CREATE TABLE ao_scan_zlib9 (like base_table) WITH (appendonly=true, compresstype=zlib, compresslevel=9);
+CREATE TABLE ao_scan_zstd1 (like base_table) WITH (appendonly=true, compresstype=zstd, compresslevel=1);
+CREATE TABLE ao_scan_zstd9 (like base_table) WITH (appendonly=true, compresstype=zstd, compresslevel=9);
+CREATE TABLE ao_scan_zstd19 (like base_table) WITH (appendonly=true, compresstype=zstd, compresslevel=19);
+CREATE TABLE aoco_scan_zstd9 (like base_table) WITH (appendonly=true, orientation=column, compresstype=zstd, compresslevel=9);
+
+INSERT INTO ao_scan_zlib1 SELECT * FROM base_table;
+INSERT INTO ao_scan_zlib9 SELECT * FROM base_table;
+INSERT INTO ao_scan_zstd1 SELECT * FROM base_table;
+INSERT INTO ao_scan_zstd9 SELECT * FROM base_table;
+INSERT INTO ao_scan_zstd19 SELECT * FROM base_table;
+INSERT INTO aoco_scan_zstd9 SELECT * FROM base_table;
@@ -24,6 +24,7 @@
 
 #include "libpq-fe.h"
 #include "pgstat.h"
+#include "access/tableam.h"
 #include "access/transam.h"
 #include "access/xact.h"
 #include "access/xlog.h"
@@ -49,12 +50,14 @@
 #include "storage/buf_internals.h"
 #include "libpq/auth.h"
 #include "libpq/hba.h"
+#include "utils/array.h"
 #include "utils/builtins.h"
 #include "utils/geo_decls.h"
 #include "utils/lsyscache.h"
 #include "utils/memutils.h"
 #include "utils/vmem_tracker.h"
 #include "utils/resource_manager.h"
+#include "utils/snapmgr.h"
 #include "utils/timestamp.h"
 
 /* table_functions test */
@@ -2209,3 +2212,88 @@ gp_keepalives_check(PG_FUNCTION_ARGS)
 
 	SRF_RETURN_DONE(funcctx);
 }
+
+/*
+ * Count the rows of a table that a sequential scan with scan keys returns.
+ *
+ * Each scan key compares column attnums[i] with args[i], using the operator
+ * opers[i].  A NULL argument makes a key that no row matches.  SQL quals are
+ * not turned into scan keys, so this is how the tests get at the scan key
+ * filtering of the table AMs, e.g. the batch filter of AOCS tables.
+ *
+ * Used in the 'aocs_scankey' test, on each segment.
+ */
+PG_FUNCTION_INFO_V1(table_scankey_count);
+Datum
+table_scankey_count(PG_FUNCTION_ARGS)
+{
+	Oid			relid = PG_GETARG_OID(0);
+	ArrayType  *attnumArray = PG_GETARG_ARRAYTYPE_P(1);
+	ArrayType  *operArray = PG_GETARG_ARRAYTYPE_P(2);
+	ArrayType  *argArray = PG_GETARG_ARRAYTYPE_P(3);
+	Datum	   *attnums;
+	Datum	   *opers;
+	Datum	   *args;
+	bool	   *argnulls;
+	int			nkeys;
+	int			nopers;
+	int			nargs;
+	ScanKey		keys;
+	Relation	rel;
+	TableScanDesc scan;
+	TupleTableSlot *slot;
+	int64		count = 0;
+
+	deconstruct_array(attnumArray, INT2OID, sizeof(int16), true, 's',
+					  &attnums, NULL, &nkeys);
+	deconstruct_array(operArray, REGOPERATOROID, sizeof(Oid), true, 'i',
+					  &opers, NULL, &nopers);
+	deconstruct_array(argArray, TEXTOID, -1, false, 'i',
+					  &args, &argnulls, &nargs);
+	if (nopers != nkeys || nargs != nkeys)
+		elog(ERROR, "expected as many operators and arguments as columns");
+
+	rel = table_open(relid, AccessShareLock);
+
+	keys = (ScanKey) palloc(nkeys * sizeof(ScanKeyData));
+	for (int i = 0; i < nkeys; i++)
+	{
+		AttrNumber	attnum = DatumGetInt16(attnums[i]);
+		Oid			opno = DatumGetObjectId(opers[i]);
+		Oid			lefttype;
+		Oid			righttype;
+		Oid			typinput;
+		Oid			typioparam;
+		Oid			collation;
+		Datum		arg = (Datum) 0;
+		int			flags = 0;
+
+		if (attnum <= 0 || attnum > RelationGetNumberOfAttributes(rel))
+			elog(ERROR, "invalid attribute number %d", attnum);
+		collation = TupleDescAttr(RelationGetDescr(rel), attnum - 1)->attcollation;
+
+		op_input_types(opno, &lefttype, &righttype);
+		if (argnulls[i])
+			flags = SK_ISNULL;
+		else
+		{
+			getTypeInputInfo(righttype, &typinput, &typioparam);
+			arg = OidInputFunctionCall(typinput, TextDatumGetCString(args[i]),
+									   typioparam, -1);
+		}
+
+		ScanKeyEntryInitialize(&keys[i], flags, attnum, InvalidStrategy,
+							   righttype, collation, get_opcode(opno), arg);
+	}
+
+	scan = table_beginscan(rel, GetActiveSnapshot(), nkeys, keys);
+	slot = table_slot_create(rel, NULL);
+	while (table_scan_getnextslot(scan, ForwardScanDirection, slot))
+		count++;
+	ExecDropSingleTupleTableSlot(slot);
+	table_endscan(scan);
+
+	table_close(rel, AccessShareLock);
+
+	PG_RETURN_INT64(count);
+}
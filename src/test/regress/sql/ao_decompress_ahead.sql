@@ -0,0 +1,41 @@
+--
+-- Decompressing append-optimized blocks ahead of the scan on helper threads
+-- (gp_appendonly_decompress_workers). The scans must return the same rows
+-- with and without the helper threads.
+--
+create schema ao_decompress_ahead;
+set search_path = ao_decompress_ahead;
+
+create table da_ao_zlib (a int, b text)
+  with (appendonly=true, compresstype=zlib, compresslevel=5, blocksize=8192) distributed by (a);
+create table da_ao_zstd (a int, b text)
+  with (appendonly=true, compresstype=zstd, compresslevel=5, blocksize=8192) distributed by (a);
+create table da_aocs_zlib (a int, b text)
+  with (appendonly=true, orientation=column, compresstype=zlib, compresslevel=5, blocksize=8192) distributed by (a);
+create table da_aocs_zstd (a int, b text)
+  with (appendonly=true, orientation=column, compresstype=zstd, compresslevel=5, blocksize=8192) distributed by (a);
+insert into da_ao_zlib select i, i || repeat('x', 200) from generate_series(1, 20000) i;
+insert into da_ao_zstd select * from da_ao_zlib;
+insert into da_aocs_zlib select * from da_ao_zlib;
+insert into da_aocs_zstd select * from da_ao_zlib;
+
+set gp_appendonly_decompress_workers = 0;
+select count(*), sum(a), md5(string_agg(b, ',' order by a)) from da_ao_zlib;
+select count(*), sum(a), md5(string_agg(b, ',' order by a)) from da_ao_zstd;
+select count(*), sum(a), md5(string_agg(b, ',' order by a)) from da_aocs_zlib;
+select count(*), sum(a), md5(string_agg(b, ',' order by a)) from da_aocs_zstd;
+
+set gp_appendonly_decompress_workers = 4;
+select count(*), sum(a), md5(string_agg(b, ',' order by a)) from da_ao_zlib;
+select count(*), sum(a), md5(string_agg(b, ',' order by a)) from da_ao_zstd;
+select count(*), sum(a), md5(string_agg(b, ',' order by a)) from da_aocs_zlib;
+select count(*), sum(a), md5(string_agg(b, ',' order by a)) from da_aocs_zstd;
+
+-- With the smallest memory budget for the slots
+set gp_appendonly_decompress_ahead_mem = 1024;
+select count(*), sum(a), md5(string_agg(b, ',' order by a)) from da_aocs_zstd;
+
+reset gp_appendonly_decompress_ahead_mem;
+reset gp_appendonly_decompress_workers;
+drop table da_ao_zlib, da_ao_zstd, da_aocs_zlib, da_aocs_zstd;
+drop schema ao_decompress_ahead;
@@ -0,0 +1,48 @@
+--
+-- Read-ahead of append-optimized segment files (gp_appendonly_read_ahead_depth),
+-- and the large read counters that EXPLAIN (ANALYZE, BUFFERS) reports for it.
+--
+create schema ao_read_ahead;
+set search_path = ao_read_ahead;
+
+-- The AO read counters of the Seq Scan in the plan of a query. The counts
+-- depend on the number of segments, so they are masked.
+create or replace function ao_reads(query text) returns setof text as
+$$
+declare
+  ln text;
+  in_scan bool := false;
+begin
+  for ln in execute 'explain (analyze, buffers, costs off, timing off, summary off) ' || query
+  loop
+    if ln like '%Seq Scan%' then
+      in_scan := true;
+    elsif in_scan and ln like '%Buffers:%' then
+      return next regexp_replace(substring(ln from 'ao read=.*$'), '[0-9]+', 'N', 'g');
+      return;
+    end if;
+  end loop;
+end;
+$$ language plpgsql;
+
+create table ra_ao (a int, b text) with (appendonly=true, blocksize=8192) distributed by (a);
+create table ra_aocs (a int, b text) with (appendonly=true, orientation=column, blocksize=8192) distributed by (a);
+insert into ra_ao select i, repeat('x', 100) || i from generate_series(1, 30000) i;
+insert into ra_aocs select * from ra_ao;
+
+-- Scans read the same rows with and without read-ahead
+select count(*), sum(a), sum(length(b)) from ra_ao;
+select count(*), sum(a), sum(length(b)) from ra_aocs;
+select * from ao_reads('select count(*) from ra_ao');
+select * from ao_reads('select count(*) from ra_aocs');
+
+set gp_appendonly_read_ahead_depth = 0;
+select count(*), sum(a), sum(length(b)) from ra_ao;
+select count(*), sum(a), sum(length(b)) from ra_aocs;
+select * from ao_reads('select count(*) from ra_ao');
+select * from ao_reads('select count(*) from ra_aocs');
+
+reset gp_appendonly_read_ahead_depth;
+drop table ra_ao, ra_aocs;
+drop function ao_reads(text);
+drop schema ao_read_ahead;
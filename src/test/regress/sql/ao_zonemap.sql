@@ -0,0 +1,66 @@
+--
+-- Zone maps of append-optimized tables (gp_appendonly_zone_maps), and the
+-- "Blocks Skipped by Zone Maps" line that EXPLAIN ANALYZE reports for them.
+--
+create schema ao_zonemap;
+set search_path = ao_zonemap;
+
+-- The zone map line of the Seq Scan in the plan of a query. The number of
+-- blocks skipped depends on the number of segments, so it is masked.
+create or replace function zone_map_skips(query text) returns setof text as
+$$
+declare
+  ln text;
+begin
+  for ln in execute 'explain (analyze, costs off, timing off, summary off) ' || query
+  loop
+    if ln like '%Blocks Skipped by Zone Maps%' then
+      return next regexp_replace(trim(ln), '[0-9]+', 'N', 'g');
+    end if;
+  end loop;
+end;
+$$ language plpgsql;
+
+set gp_appendonly_zone_maps = on;
+
+-- The rows are loaded in order of a, so each varblock holds a narrow range
+-- of a, and most of them can be skipped by a selective qual.
+create table zm_ao (a int, b text) with (appendonly=true, blocksize=8192) distributed by (b);
+create table zm_aocs (a int, b text) with (appendonly=true, orientation=column, blocksize=8192) distributed by (b);
+insert into zm_ao select i, repeat('x', 100) || i from generate_series(1, 30000) i;
+insert into zm_aocs select i, repeat('x', 100) || i from generate_series(1, 30000) i;
+
+select count(*), sum(a) from zm_ao where a <= 100;
+select count(*), sum(a) from zm_ao where a > 29900;
+select count(*) from zm_ao where a is null;
+select * from zone_map_skips('select count(*) from zm_ao where a <= 100');
+select count(*), sum(a) from zm_aocs where a <= 100;
+select count(*), sum(a) from zm_aocs where a > 29900;
+select count(*) from zm_aocs where a is null;
+select * from zone_map_skips('select count(*) from zm_aocs where a <= 100');
+
+-- A qual that no zone map can exclude skips nothing
+select * from zone_map_skips('select count(*) from zm_ao where a > 0');
+select * from zone_map_skips('select count(*) from zm_aocs where a > 0');
+
+-- The same rows are returned with zone maps off, and nothing is skipped
+set gp_appendonly_zone_maps = off;
+select count(*), sum(a) from zm_ao where a <= 100;
+select count(*), sum(a) from zm_ao where a > 29900;
+select count(*), sum(a) from zm_aocs where a <= 100;
+select count(*), sum(a) from zm_aocs where a > 29900;
+select * from zone_map_skips('select count(*) from zm_ao where a <= 100');
+select * from zone_map_skips('select count(*) from zm_aocs where a <= 100');
+
+-- Blocks inserted while zone maps are off carry no zone maps, and are
+-- always read
+create table zm_off (a int, b text) with (appendonly=true, blocksize=8192) distributed by (b);
+insert into zm_off select i, repeat('x', 100) || i from generate_series(1, 30000) i;
+set gp_appendonly_zone_maps = on;
+select count(*), sum(a) from zm_off where a <= 100;
+select * from zone_map_skips('select count(*) from zm_off where a <= 100');
+
+reset gp_appendonly_zone_maps;
+drop table zm_ao, zm_aocs, zm_off;
+drop function zone_map_skips(text);
+drop schema ao_zonemap;
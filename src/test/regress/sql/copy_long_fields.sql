@@ -0,0 +1,34 @@
+--
+-- COPY FROM steps over the plain data of lines and fields many bytes at a
+-- time.  Round-trip long values with delimiters, quotes, escapes and
+-- newlines at every position through text and CSV files.
+--
+CREATE TABLE copy_long_fields (id int, t text, u text) DISTRIBUTED BY (id);
+INSERT INTO copy_long_fields
+  SELECT i,
+         repeat('abcdefgh', i % 23) ||
+           (ARRAY[E'\n', '"', E'\\', ',', E'\t', E'\r', 'x', E'\r\n', '""', E'\\.'])[i % 10 + 1] ||
+           repeat('ijklmnop', i % 17),
+         CASE WHEN i % 7 = 0 THEN NULL ELSE repeat('q', i) END
+  FROM generate_series(1, 300) i;
+CREATE TABLE copy_long_fields_in (LIKE copy_long_fields) DISTRIBUTED BY (id);
+
+COPY copy_long_fields TO '/tmp/copy_long_fields.txt';
+COPY copy_long_fields_in FROM '/tmp/copy_long_fields.txt';
+SELECT count(*) FROM copy_long_fields_in;
+SELECT count(*) FROM (SELECT * FROM copy_long_fields EXCEPT SELECT * FROM copy_long_fields_in) d;
+TRUNCATE copy_long_fields_in;
+
+COPY copy_long_fields TO '/tmp/copy_long_fields.csv' (FORMAT csv);
+COPY copy_long_fields_in FROM '/tmp/copy_long_fields.csv' (FORMAT csv);
+SELECT count(*) FROM copy_long_fields_in;
+SELECT count(*) FROM (SELECT * FROM copy_long_fields EXCEPT SELECT * FROM copy_long_fields_in) d;
+TRUNCATE copy_long_fields_in;
+
+COPY copy_long_fields TO '/tmp/copy_long_fields_esc.csv' (FORMAT csv, QUOTE '''', ESCAPE E'\\', FORCE_QUOTE *);
+COPY copy_long_fields_in FROM '/tmp/copy_long_fields_esc.csv' (FORMAT csv, QUOTE '''', ESCAPE E'\\');
+SELECT count(*) FROM copy_long_fields_in;
+SELECT count(*) FROM (SELECT * FROM copy_long_fields EXCEPT SELECT * FROM copy_long_fields_in) d;
+
+DROP TABLE copy_long_fields;
+DROP TABLE copy_long_fields_in;
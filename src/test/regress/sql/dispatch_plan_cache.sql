@@ -0,0 +1,56 @@
+--
+-- QEs keep the plans dispatched to them, and get only the digest of a plan
+-- they already hold (gp_dispatch_plan_cache_size).
+--
+create schema dispatch_plan_cache;
+set search_path = dispatch_plan_cache;
+
+create table dpc (a int, b int) distributed by (a);
+insert into dpc select i, i % 10 from generate_series(1, 1000) i;
+
+-- The same plan dispatched again and again, with different parameters
+prepare dpc_count(int) as select count(*) from dpc where b = $1;
+execute dpc_count(1);
+execute dpc_count(2);
+execute dpc_count(3);
+execute dpc_count(11);
+select count(*), sum(a) from dpc;
+select count(*), sum(a) from dpc;
+
+-- QEs reuse the deserialized plan, whichever slice they run
+create table dpc2 (a int, b int) distributed by (b);
+prepare dpc_insert(int) as insert into dpc2 select d1.a, d2.b from dpc d1 join dpc d2 on d1.a = d2.b where d1.b = $1;
+execute dpc_insert(1);
+execute dpc_insert(2);
+execute dpc_insert(1);
+select count(*), sum(a), sum(b) from dpc2;
+prepare dpc_join(int) as select count(*) from dpc d1 join dpc2 d2 on d1.b = d2.a where d2.b = $1;
+execute dpc_join(1);
+execute dpc_join(2);
+execute dpc_join(1);
+
+-- A QE that errors out gets the whole plan again next time
+select a / (b - 5) from dpc where a = 5;
+select count(*), sum(a) from dpc;
+execute dpc_count(1);
+
+-- Other cache sizes move the plans to other slots
+set gp_dispatch_plan_cache_size = 1;
+execute dpc_count(1);
+select count(*), sum(a) from dpc;
+execute dpc_count(2);
+select count(*), sum(a) from dpc;
+
+set gp_dispatch_plan_cache_size = 0;
+execute dpc_count(1);
+select count(*), sum(a) from dpc;
+
+reset gp_dispatch_plan_cache_size;
+execute dpc_count(1);
+select count(*), sum(a) from dpc;
+
+deallocate dpc_count;
+deallocate dpc_insert;
+deallocate dpc_join;
+drop table dpc, dpc2;
+drop schema dispatch_plan_cache;
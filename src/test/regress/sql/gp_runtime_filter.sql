@@ -0,0 +1,65 @@
+--
+-- Runtime filters that a Hash Join pushes down to the scan on its outer side
+-- (gp_enable_runtime_filter).
+--
+create schema gp_runtime_filter;
+set search_path = gp_runtime_filter;
+
+-- Lines of EXPLAIN ANALYZE that report rows removed by a runtime filter. The
+-- counts depend on the number of segments, so they are masked.
+create or replace function rows_removed(query text) returns setof text as
+$$
+declare
+  ln text;
+begin
+  for ln in execute 'explain (analyze, costs off, timing off, summary off) ' || query
+  loop
+    if ln like '%Rows Removed by Runtime Filter%' then
+      return next regexp_replace(trim(ln), '[0-9]+', 'N');
+    end if;
+  end loop;
+end;
+$$ language plpgsql;
+
+create table fact_heap (id int, dim_id int, dim_id2 int, val int) distributed by (id);
+create table fact_ao (like fact_heap) with (appendonly=true) distributed by (id);
+create table fact_aocs (like fact_heap) with (appendonly=true, orientation=column) distributed by (id);
+create table dim (id int, id2 int, name text) distributed replicated;
+
+insert into fact_heap select i, i % 1000, i % 1000 + 1, i from generate_series(1, 100000) i;
+insert into fact_heap select i, null, null, i from generate_series(100001, 100100) i;
+insert into fact_ao select * from fact_heap;
+insert into fact_aocs select * from fact_heap;
+insert into dim select i, i + 1, 'dim ' || i from generate_series(1, 1000) i;
+analyze fact_heap;
+analyze fact_ao;
+analyze fact_aocs;
+analyze dim;
+
+set gp_enable_runtime_filter = on;
+
+-- Inner joins against a selective dimension filter
+select count(*), sum(f.val) from fact_heap f join dim d on f.dim_id = d.id where d.id <= 10;
+select count(*), sum(f.val) from fact_ao f join dim d on f.dim_id = d.id where d.id <= 10;
+select count(*), sum(f.val) from fact_aocs f join dim d on f.dim_id = d.id where d.id <= 10;
+select * from rows_removed('select count(*) from fact_heap f join dim d on f.dim_id = d.id where d.id <= 10');
+select * from rows_removed('select count(*) from fact_aocs f join dim d on f.dim_id = d.id where d.id <= 10');
+
+-- Several join keys
+select count(*), sum(f.val) from fact_heap f join dim d on f.dim_id = d.id and f.dim_id2 = d.id2 where d.id <= 10;
+
+-- A semi join
+select count(*) from fact_heap f where f.dim_id in (select id from dim where id <= 10);
+
+-- Outer joins must keep every outer row
+select count(*), count(d.id) from fact_heap f left join dim d on f.dim_id = d.id and d.id <= 10;
+
+-- No filter without the GUC
+set gp_enable_runtime_filter = off;
+select count(*), sum(f.val) from fact_heap f join dim d on f.dim_id = d.id where d.id <= 10;
+select * from rows_removed('select count(*) from fact_heap f join dim d on f.dim_id = d.id where d.id <= 10');
+
+reset gp_enable_runtime_filter;
+drop table fact_heap, fact_ao, fact_aocs, dim;
+drop function rows_removed(text);
+drop schema gp_runtime_filter;
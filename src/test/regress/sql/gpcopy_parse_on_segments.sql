@@ -0,0 +1,119 @@
+--
+-- COPY FROM with gp_copy_parse_on_segments: the QD only splits the input into
+-- lines, and the segments parse the rows and redistribute them.
+--
+SET test_copy_qd_qe_split = on;
+
+CREATE TABLE copy_seg_ref (a int, b text, c int DEFAULT 7) DISTRIBUTED BY (a);
+CREATE TABLE copy_seg (a int, b text, c int DEFAULT 7) DISTRIBUTED BY (a);
+
+COPY copy_seg_ref (a, b) FROM stdin;
+1	one
+2	two
+3	three
+4	four
+5	five
+6	six
+7	seven
+8	eight
+9	nine
+10	ten
+\.
+
+SET gp_copy_parse_on_segments = on;
+
+-- The QD doesn't parse any field, as it copies into the staging table.
+COPY copy_seg (a, b) FROM stdin;
+1	one
+2	two
+3	three
+4	four
+5	five
+6	six
+7	seven
+8	eight
+9	nine
+10	ten
+\.
+
+-- Every row is on the segment that its distribution key hashes to, and the
+-- missing column got its default.
+SELECT gp_segment_id, * FROM copy_seg
+EXCEPT
+SELECT gp_segment_id, * FROM copy_seg_ref;
+SELECT count(*), sum(c) FROM copy_seg;
+
+-- The staging table is kept for the session, empty once the COPY committed,
+-- and reused by the next COPY into the same table.
+SELECT 'gp_copy_staging_' || 'copy_seg'::regclass::oid AS staging_name \gset
+SELECT oid AS staging_oid FROM pg_class WHERE relname = :'staging_name' \gset
+SELECT count(*) FROM pg_temp.:staging_name;
+COPY copy_seg (a, b) FROM stdin;
+11	eleven
+\.
+SELECT oid = :staging_oid AS reused FROM pg_class WHERE relname = :'staging_name';
+SELECT count(*) FROM copy_seg;
+
+-- CSV, with a header and a reject limit
+TRUNCATE copy_seg;
+\set QUIET off
+COPY copy_seg FROM stdin CSV HEADER SEGMENT REJECT LIMIT 2;
+a,b,c
+1,"one, quoted",10
+2,two,20
+x,bad,30
+\.
+\set QUIET on
+SELECT * FROM copy_seg ORDER BY a;
+
+-- Constraints of the real table are checked when the rows are moved into it.
+CREATE TABLE copy_seg_notnull (a int, b text NOT NULL) DISTRIBUTED BY (a);
+COPY copy_seg_notnull (a) FROM stdin;
+1
+\.
+SELECT count(*) FROM copy_seg_notnull;
+
+-- Rules are not fired, like with a COPY without the staging table.
+CREATE TABLE copy_seg_rule (a int, b text) DISTRIBUTED BY (a);
+CREATE RULE copy_seg_rule_nothing AS ON INSERT TO copy_seg_rule DO INSTEAD NOTHING;
+COPY copy_seg_rule FROM stdin;
+1	one
+2	two
+\.
+SELECT * FROM copy_seg_rule ORDER BY a;
+
+-- Partitioned table
+CREATE TABLE copy_seg_part (a int, b int) DISTRIBUTED BY (a)
+  PARTITION BY RANGE (b) (START (0) END (20) EVERY (10));
+COPY copy_seg_part FROM stdin;
+1	1
+2	11
+3	5
+4	15
+\.
+SELECT tableoid::regclass, * FROM copy_seg_part ORDER BY a;
+
+-- LOG ERRORS and randomly distributed tables don't use a staging table.
+TRUNCATE copy_seg;
+COPY copy_seg FROM stdin LOG ERRORS SEGMENT REJECT LIMIT 2;
+1	one	1
+\.
+CREATE TABLE copy_seg_random (a int, b text) DISTRIBUTED RANDOMLY;
+COPY copy_seg_random FROM stdin;
+1	one
+\.
+
+-- Within a transaction, the staging table is emptied before it is reused.
+BEGIN;
+COPY copy_seg (a, b) FROM stdin;
+2	two
+\.
+COPY copy_seg (a, b) FROM stdin;
+3	three
+\.
+COMMIT;
+SELECT * FROM copy_seg ORDER BY a;
+
+RESET gp_copy_parse_on_segments;
+RESET test_copy_qd_qe_split;
+DROP TABLE copy_seg_ref, copy_seg, copy_seg_notnull, copy_seg_rule, copy_seg_part, copy_seg_random;
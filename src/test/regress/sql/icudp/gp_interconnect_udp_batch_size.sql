@@ -0,0 +1,26 @@
+-- Sending and receiving batches of UDP interconnect packets with one system
+-- call must not change query results.
+CREATE TEMP TABLE udp_batch(a INT, b INT, t TEXT) DISTRIBUTED BY (a);
+INSERT INTO udp_batch SELECT i, i % 97, repeat('x', 100) FROM generate_series(1, 20000) i;
+
+-- One packet per system call
+SET gp_interconnect_udp_batch_size = 1;
+SELECT count(*), sum(x.a) FROM udp_batch x JOIN udp_batch y ON x.b = y.a;
+SELECT count(*), sum(length(t)) FROM (SELECT b, t FROM udp_batch ORDER BY a) foo;
+
+-- The largest batches
+SET gp_interconnect_udp_batch_size = 64;
+SELECT count(*), sum(x.a) FROM udp_batch x JOIN udp_batch y ON x.b = y.a;
+SELECT count(*), sum(length(t)) FROM (SELECT b, t FROM udp_batch ORDER BY a) foo;
+
+-- Segmentation offload falls back to plain batches where it is unsupported
+SET gp_interconnect_udp_gso = on;
+SELECT count(*), sum(x.a) FROM udp_batch x JOIN udp_batch y ON x.b = y.a;
+SELECT count(*), sum(length(t)) FROM (SELECT b, t FROM udp_batch ORDER BY a) foo;
+
+RESET gp_interconnect_udp_gso;
+RESET gp_interconnect_udp_batch_size;
+
+-- Out of range
+SET gp_interconnect_udp_batch_size = 0;
+SET gp_interconnect_udp_batch_size = 65;
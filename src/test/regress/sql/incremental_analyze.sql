@@ -961,3 +961,57 @@ alter table hll_part_def set (analyze_hll_non_part_table=true);
 select reloptions from pg_class where relname='hll_part_def';
 select reloptions from pg_class where relname='hll_part_def_1_prt_2';
 
+
+-- Test gp_analyze_skip_unchanged_ao. Re-analyzing an append-optimized
+-- partitioned table should only sample the partitions that were modified
+-- since they were last analyzed, and keep the statistics of the others.
+create table skip_unchanged_ao (a int, b int) with (appendonly=true) distributed by (a)
+partition by range(b)
+(start(1) end(4) every(1));
+set gp_autostats_mode = none;
+insert into skip_unchanged_ao select i, i % 3 + 1 from generate_series(1, 300) i;
+set gp_analyze_skip_unchanged_ao = on;
+analyze skip_unchanged_ao;
+select xmin as prt1_xmin from pg_statistic where starelid = 'skip_unchanged_ao_1_prt_1'::regclass and staattnum = 1 \gset
+select xmin as prt2_xmin from pg_statistic where starelid = 'skip_unchanged_ao_1_prt_2'::regclass and staattnum = 1 \gset
+
+-- nothing changed, so the partition is not sampled again, but still counts
+-- as analyzed, and keeps its reltuples
+analyze verbose skip_unchanged_ao_1_prt_1;
+select reltuples from pg_class where relname = 'skip_unchanged_ao_1_prt_1';
+
+-- only the second partition is modified, and analyzed again
+insert into skip_unchanged_ao select i, 2 from generate_series(301, 400) i;
+analyze skip_unchanged_ao;
+select xmin = :'prt1_xmin' as prt1_unchanged from pg_statistic where starelid = 'skip_unchanged_ao_1_prt_1'::regclass and staattnum = 1;
+select xmin = :'prt2_xmin' as prt2_unchanged from pg_statistic where starelid = 'skip_unchanged_ao_1_prt_2'::regclass and staattnum = 1;
+select reltuples from pg_class where relname = 'skip_unchanged_ao_1_prt_2';
+
+-- deletes count as modifications too
+select xmin as prt2_xmin from pg_statistic where starelid = 'skip_unchanged_ao_1_prt_2'::regclass and staattnum = 1 \gset
+delete from skip_unchanged_ao where b = 2 and a > 300;
+analyze skip_unchanged_ao;
+select xmin = :'prt2_xmin' as prt2_unchanged from pg_statistic where starelid = 'skip_unchanged_ao_1_prt_2'::regclass and staattnum = 1;
+
+-- a truncated and reloaded partition has a new relfilenode, and its modcount
+-- starts over, so it is analyzed again even if it ends up with the same
+-- modcount
+truncate skip_unchanged_ao_1_prt_1;
+insert into skip_unchanged_ao select i, 1 from generate_series(1, 50) i;
+analyze skip_unchanged_ao;
+select xmin = :'prt1_xmin' as prt1_unchanged from pg_statistic where starelid = 'skip_unchanged_ao_1_prt_1'::regclass and staattnum = 1;
+select reltuples from pg_class where relname = 'skip_unchanged_ao_1_prt_1';
+
+-- a new column has no statistics yet, so the partitions are analyzed again
+alter table skip_unchanged_ao add column c int default 7;
+select xmin as prt3_xmin from pg_statistic where starelid = 'skip_unchanged_ao_1_prt_3'::regclass and staattnum = 1 \gset
+analyze skip_unchanged_ao;
+select xmin = :'prt3_xmin' as prt3_unchanged from pg_statistic where starelid = 'skip_unchanged_ao_1_prt_3'::regclass and staattnum = 1;
+select count(*) from pg_statistic where starelid = 'skip_unchanged_ao_1_prt_3'::regclass and staattnum = 3;
+
+-- without the GUC, every partition is analyzed
+reset gp_analyze_skip_unchanged_ao;
+select xmin as prt3_xmin from pg_statistic where starelid = 'skip_unchanged_ao_1_prt_3'::regclass and staattnum = 1 \gset
+analyze skip_unchanged_ao;
+select xmin = :'prt3_xmin' as prt3_unchanged from pg_statistic where starelid = 'skip_unchanged_ao_1_prt_3'::regclass and staattnum = 1;
+reset gp_autostats_mode;
@@ -0,0 +1,38 @@
+--
+-- Motions that send their tuples in batches, column by column
+-- (gp_motion_batch_size).
+--
+CREATE TABLE motion_batch (a int, b int8, c int2, d float8, e bool, f date) DISTRIBUTED BY (a);
+INSERT INTO motion_batch
+SELECT i, i * 1000000000::int8, (i % 100)::int2,
+       CASE WHEN i % 7 = 0 THEN NULL ELSE i / 4.0 END,
+       i % 3 = 0, date '2000-01-01' + i
+FROM generate_series(1, 10000) i;
+
+SET gp_motion_batch_size = 1000;
+
+-- Redistribute or Broadcast Motion
+SELECT count(*) AS cnt, sum(x.b) AS sum_b, sum(y.c) AS sum_c
+FROM motion_batch x JOIN motion_batch y ON x.c = y.a;
+
+-- Sorted Gather Motion, with NULLs and every supported width
+SELECT count(*) AS cnt, sum(b) AS sum_b, sum(c) AS sum_c, sum(d) AS sum_d,
+       count(d) AS cnt_d, sum(e::int) AS sum_e,
+       min(f - date '2000-01-01') AS min_f, max(f - date '2000-01-01') AS max_f
+FROM (SELECT * FROM motion_batch ORDER BY a LIMIT 20000) s;
+
+-- The receiver stops early
+SELECT a, c, d, e FROM motion_batch ORDER BY a LIMIT 5;
+
+-- The smallest batches
+SET gp_motion_batch_size = 2;
+SELECT count(*) AS cnt, sum(x.b) AS sum_b, sum(y.c) AS sum_c
+FROM motion_batch x JOIN motion_batch y ON x.c = y.a;
+
+-- Motions with a column of a variable-width type send tuples one by one
+SET gp_motion_batch_size = 1000;
+SELECT count(*) AS cnt, sum(length(t)) AS len
+FROM (SELECT a::text AS t FROM motion_batch ORDER BY a LIMIT 20000) s;
+
+RESET gp_motion_batch_size;
+DROP TABLE motion_batch;
@@ -0,0 +1,56 @@
+-- @Description Test that vacuum copies the varblocks without deleted tuples as they are
+
+CREATE TABLE uao_copy_blocks (a INT, b INT, c TEXT) WITH (appendonly=true, compresstype=zlib) DISTRIBUTED BY (a);
+CREATE INDEX uao_copy_blocks_index ON uao_copy_blocks(b);
+INSERT INTO uao_copy_blocks SELECT i, i, repeat('x', i % 50) FROM generate_series(1, 1000) AS i;
+INSERT INTO uao_copy_blocks SELECT i, i, repeat('x', i % 50) FROM generate_series(1001, 2000) AS i;
+INSERT INTO uao_copy_blocks SELECT i, i, repeat('x', i % 50) FROM generate_series(2001, 3000) AS i;
+
+-- Only the varblocks of the second insert have deleted tuples
+DELETE FROM uao_copy_blocks WHERE a BETWEEN 1001 AND 1500;
+VACUUM uao_copy_blocks;
+SELECT COUNT(*), SUM(a), SUM(length(c)) FROM uao_copy_blocks;
+
+-- The index points to the new location of the copied tuples
+SET enable_seqscan = off;
+SELECT a, b, c FROM uao_copy_blocks WHERE b = 2500;
+SELECT a, b, c FROM uao_copy_blocks WHERE b = 1050;
+RESET enable_seqscan;
+
+-- The rows of a column added afterwards are rewritten tuple by tuple
+ALTER TABLE uao_copy_blocks ADD COLUMN d INT DEFAULT 7;
+DELETE FROM uao_copy_blocks WHERE a <= 400;
+VACUUM uao_copy_blocks;
+SELECT COUNT(*), SUM(a), SUM(d) FROM uao_copy_blocks;
+
+-- check if we can still insert into the relation
+INSERT INTO uao_copy_blocks VALUES (3001, 3001, 'y', 8);
+SET enable_seqscan = off;
+SELECT a, b, c, d FROM uao_copy_blocks WHERE b IN (2500, 3001) ORDER BY a;
+RESET enable_seqscan;
+
+-- Same result when all the tuples are moved one by one
+CREATE TABLE uao_copy_blocks_off (a INT, b INT, c TEXT) WITH (appendonly=true, compresstype=zlib) DISTRIBUTED BY (a);
+INSERT INTO uao_copy_blocks_off SELECT i, i, repeat('x', i % 50) FROM generate_series(1, 1000) AS i;
+INSERT INTO uao_copy_blocks_off SELECT i, i, repeat('x', i % 50) FROM generate_series(1001, 2000) AS i;
+INSERT INTO uao_copy_blocks_off SELECT i, i, repeat('x', i % 50) FROM generate_series(2001, 3000) AS i;
+DELETE FROM uao_copy_blocks_off WHERE a BETWEEN 1001 AND 1500;
+SET gp_appendonly_compaction_copy_blocks = off;
+VACUUM uao_copy_blocks_off;
+RESET gp_appendonly_compaction_copy_blocks;
+SELECT COUNT(*), SUM(a), SUM(length(c)) FROM uao_copy_blocks_off;
+
+-- The copied varblocks are verified like the ones compressed again
+CREATE TABLE uao_copy_blocks_verify (a INT, b INT, c TEXT) WITH (appendonly=true, compresstype=zlib) DISTRIBUTED BY (a);
+INSERT INTO uao_copy_blocks_verify SELECT i, i, repeat('x', i % 50) FROM generate_series(1, 1000) AS i;
+INSERT INTO uao_copy_blocks_verify SELECT i, i, repeat('x', i % 50) FROM generate_series(1001, 2000) AS i;
+INSERT INTO uao_copy_blocks_verify SELECT i, i, repeat('x', i % 50) FROM generate_series(2001, 3000) AS i;
+DELETE FROM uao_copy_blocks_verify WHERE a BETWEEN 1001 AND 1500;
+SET gp_appendonly_verify_write_block = on;
+VACUUM uao_copy_blocks_verify;
+RESET gp_appendonly_verify_write_block;
+SELECT COUNT(*), SUM(a), SUM(length(c)) FROM uao_copy_blocks_verify;
+
+DROP TABLE uao_copy_blocks;
+DROP TABLE uao_copy_blocks_off;
+DROP TABLE uao_copy_blocks_verify;